@@ -0,0 +1,3 @@
+DELETE FROM `command` WHERE `name` IN ('server mapstats');
+INSERT INTO `command` (`name`,`security`,`help`) VALUES
+('server mapstats',2,'Syntax: .server mapstats [#count]\r\n\r\nShow the #count maps (default 10) with the highest average update time, with their last and maximum update time and player count.');
@@ -0,0 +1,3 @@
+DELETE FROM `command` WHERE `name` IN ('server dbstats');
+INSERT INTO `command` (`name`,`security`,`help`) VALUES
+('server dbstats',3,'Syntax: .server dbstats\r\n\r\nShow, for every connection of the login, world and character databases, the operations queued for it, the operations executed and their average and maximum duration.');
@@ -0,0 +1,3 @@
+DELETE FROM `command` WHERE `name` IN ('server pathstats');
+INSERT INTO `command` (`name`,`security`,`help`) VALUES
+('server pathstats',3,'Syntax: .server pathstats\r\n\r\nShow, for every map with navmesh data, the paths built since startup, the share of poly corridors taken from the path cache and the average and total time spent in Detour.');
@@ -0,0 +1,3 @@
+DELETE FROM `command` WHERE `name` IN ('server elunastats');
+INSERT INTO `command` (`name`,`security`,`help`) VALUES
+('server elunastats',3,'Syntax: .server elunastats\r\n\r\nShow, for the world Lua state and every per-map Lua state, the hooks run since startup, the time spent in them, and how often and how long a thread had to wait for the state lock, and how many of its hooks were skipped because a hook of another state fired them.');
@@ -0,0 +1,3 @@
+DELETE FROM `command` WHERE `name` IN ('server movestats');
+INSERT INTO `command` (`name`,`security`,`help`) VALUES
+('server movestats',3,'Syntax: .server movestats\r\n\r\nShow how many moves were sent in SMSG_COMPRESSED_MOVES packets since startup, how many packets that saved and the compressed size of the batched moves.');
@@ -0,0 +1,3 @@
+DELETE FROM `command` WHERE `name` IN ('server whostats');
+INSERT INTO `command` (`name`,`security`,`help`) VALUES
+('server whostats',3,'Syntax: .server whostats\r\n\r\nShow the number of players in the who list snapshot, its age and build time, and the count, average and maximum duration of the /who queries answered from it.');
@@ -0,0 +1,3 @@
+DELETE FROM `command` WHERE `name` IN ('server guidstats');
+INSERT INTO `command` (`name`,`security`,`help`) VALUES
+('server guidstats',3,'Syntax: .server guidstats\r\n\r\nShow for each global guid storage the number of objects, the lookups and the inserts and removes done, and how many of them had to wait for another thread holding the same shard.');
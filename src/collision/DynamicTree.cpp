@@ -244,6 +244,20 @@ bool DynamicMapTree::isInLineOfSight(float x1, float y1, float z1, float x2, flo
     return !callback.did_hit;
 }
 
+void DynamicMapTree::isInLineOfSight(VMAP::LineOfSightQuery* queries, uint32 count) const
+{
+    // most maps have no collidable gameobject at all
+    if (!impl.size())
+        return;
+
+    for (uint32 i = 0; i < count; ++i)
+    {
+        VMAP::LineOfSightQuery& query = queries[i];
+        if (query.result)
+            query.result = isInLineOfSight(query.x1, query.y1, query.z1, query.x2, query.y2, query.z2);
+    }
+}
+
 float DynamicMapTree::getHeight(float x, float y, float z, float maxSearchDist) const
 {
     Vector3 v(x,y,z);
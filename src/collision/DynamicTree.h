@@ -19,6 +19,7 @@
 #define _DYNTREE_H
 
 #include "Platform/Define.h"
+#include "IVMapManager.h"
 
 namespace G3D
 {
@@ -37,6 +38,8 @@ class DynamicMapTree
         ~DynamicMapTree();
 
         bool isInLineOfSight(float x1, float y1, float z1, float x2, float y2, float z2) const;
+        // only the queries whose result is still true are checked
+        void isInLineOfSight(VMAP::LineOfSightQuery* queries, uint32 count) const;
         bool getIntersectionTime(const G3D::Ray& ray, const G3D::Vector3& endPos, float& maxDist) const;
         bool getObjectHitPos(const G3D::Vector3& pPos1, const G3D::Vector3& pPos2, G3D::Vector3& pResultHitPos, float pModifyDist) const;
         float getHeight(float x, float y, float z, float maxSearchDist) const;
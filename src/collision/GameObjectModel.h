@@ -59,6 +59,7 @@ class GameObjectModel /*, public Intersectable*/
         /**    Enables\disables collision. */
         void disable() { collision_enabled = false;}
         void enable(bool enable) { collision_enabled = enable;}
+        bool isEnabled() const { return collision_enabled; }
 
         bool intersectRay(const G3D::Ray& Ray, float& MaxDist, bool StopAtFirstHit) const;
 
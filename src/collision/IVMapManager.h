@@ -41,6 +41,16 @@ enum VMAPLoadResult
 #define VMAP_INVALID_HEIGHT_VALUE -200000.0f            // real assigned value in unknown height case
 
     //===========================================================
+
+// one ray of a batched line of sight check, in map coordinates
+struct LineOfSightQuery
+{
+    float x1, y1, z1;
+    float x2, y2, z2;
+    bool result;                                        // [out] nothing blocks the ray
+};
+
+    //===========================================================
 class IVMapManager
 {
     private:
@@ -60,6 +70,10 @@ class IVMapManager
         virtual void unloadMap(unsigned int pMapId) = 0;
 
         virtual bool isInLineOfSight(unsigned int pMapId, float x1, float y1, float z1, float x2, float y2, float z2) = 0;
+        /**
+        check many rays of the same map at once, the result of each is stored in the query
+        */
+        virtual void isInLineOfSight(unsigned int pMapId, LineOfSightQuery* queries, uint32 count) = 0;
         virtual float getHeight(unsigned int pMapId, float x, float y, float z, float maxSearchDist) = 0;
             /**
         test if we hit an object. return true if we hit one. rx,ry,rz will hold the hit position or the dest position, if no intersection was found
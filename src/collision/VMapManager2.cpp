@@ -180,6 +180,29 @@ bool VMapManager2::isInLineOfSight(unsigned int mapId, float x1, float y1, float
     return true;
 }
 
+void VMapManager2::isInLineOfSight(unsigned int mapId, LineOfSightQuery* queries, uint32 count)
+{
+    InstanceTreeMap::const_iterator instanceTree = iInstanceMapTrees.end();
+    if (isLineOfSightCalcEnabled())
+        instanceTree = GetMapTree(mapId);
+
+    // the map tree is looked up once for the whole batch
+    if (instanceTree == iInstanceMapTrees.end())
+    {
+        for (uint32 i = 0; i < count; ++i)
+            queries[i].result = true;
+        return;
+    }
+
+    for (uint32 i = 0; i < count; ++i)
+    {
+        LineOfSightQuery& query = queries[i];
+        Vector3 pos1 = convertPositionToInternalRep(query.x1, query.y1, query.z1);
+        Vector3 pos2 = convertPositionToInternalRep(query.x2, query.y2, query.z2);
+        query.result = pos1 == pos2 || instanceTree->second->isInLineOfSight(pos1, pos2);
+    }
+}
+
 /**
 get the hit position and return true if we hit something
 otherwise the result pos will be the dest pos
@@ -96,6 +96,7 @@ class VMapManager2 : public IVMapManager
         void unloadMap(unsigned int mapId);
 
         bool isInLineOfSight(unsigned int mapId, float x1, float y1, float z1, float x2, float y2, float z2) ;
+        void isInLineOfSight(unsigned int mapId, LineOfSightQuery* queries, uint32 count);
         /**
         fill the hit pos and return true, if an object was hit
         */
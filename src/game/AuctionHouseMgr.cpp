@@ -490,16 +490,55 @@ AuctionHouseEntry const* AuctionHouseMgr::GetAuctionHouseEntry(uint32 factionTem
 
     return sAuctionHouseStore.LookupEntry(houseid);
 }
+
+std::wstring const& AuctionHouseMgr::GetSearchName(ItemTemplate const* proto, int loc_idx)
+{
+    ItemSearchNameMap::iterator itr = mSearchNames.find(proto->ItemId);
+    if (itr == mSearchNames.end())
+    {
+        std::vector<std::wstring>& names = mSearchNames[proto->ItemId];
+
+        // an empty name never matches, like a failed conversion
+        names.resize(1);
+        if (Utf8toWStr(proto->Name1, names[0]))
+            wstrToLower(names[0]);
+        else
+            names[0].clear();
+
+        if (ItemLocale const* il = sObjectMgr.GetItemLocale(proto->ItemId))
+        {
+            names.resize(il->Name.size() + 1, names[0]);
+            for (size_t i = 0; i < il->Name.size(); ++i)
+            {
+                if (il->Name[i].empty())
+                    continue;
+
+                if (Utf8toWStr(il->Name[i], names[i + 1]))
+                    wstrToLower(names[i + 1]);
+                else
+                    names[i + 1].clear();
+            }
+        }
+
+        itr = mSearchNames.find(proto->ItemId);
+    }
+
+    std::vector<std::wstring> const& names = itr->second;
+    return (loc_idx >= 0 && size_t(loc_idx) + 1 < names.size()) ? names[loc_idx + 1] : names[0];
+}
+
 void AuctionHouseObject::AddAuction(AuctionEntry* ah)
 {
     ASSERT(ah);
     AuctionsMap[ah->Id] = ah;
+    IndexAuction(ah, true);
     auctionbot.IncrementItemCounts(ah);
 }
 
 bool AuctionHouseObject::RemoveAuction(AuctionEntry* auction, uint32 item_template)
 {
     auctionbot.DecrementItemCounts(auction, item_template);
+    IndexAuction(auction, false);
     bool wasInMap = AuctionsMap.erase(auction->Id) ? true : false;
 
     // we need to delete the entry, it is not referenced any more
@@ -507,6 +546,36 @@ bool AuctionHouseObject::RemoveAuction(AuctionEntry* auction, uint32 item_templa
     return wasInMap;
 }
 
+void AuctionHouseObject::IndexAuction(AuctionIndex& index, uint32 key, AuctionEntry* auction, bool add)
+{
+    if (add)
+        index[key].insert(auction);
+    else
+    {
+        AuctionIndex::iterator itr = index.find(key);
+        if (itr == index.end())
+            return;
+
+        itr->second.erase(auction);
+        if (itr->second.empty())
+            index.erase(itr);
+    }
+}
+
+void AuctionHouseObject::IndexAuction(AuctionEntry* auction, bool add)
+{
+    ItemTemplate const* proto = sObjectMgr.GetItemTemplate(auction->item_template);
+    if (!proto)
+        return;
+
+    IndexAuction(m_byClass, proto->Class, auction, add);
+    IndexAuction(m_bySubClass, proto->Class << 16 | proto->SubClass, auction, add);
+    IndexAuction(m_byInventoryType, proto->InventoryType, auction, add);
+    IndexAuction(m_byQuality, proto->Quality, auction, add);
+    IndexAuction(m_byRequiredLevel, proto->RequiredLevel, auction, add);
+    IndexAuction(m_byEntry, proto->ItemId, auction, add);
+}
+
 void AuctionHouseObject::Update()
 {
     time_t curTime = sWorld.GetGameTime();
@@ -598,69 +667,174 @@ void AuctionHouseObject::BuildListOwnerItems(WorldPacket& data, Player* player,
     }
 }
 
-void AuctionHouseObject::BuildListAuctionItems(WorldPacket& data, Player* player,
-        std::wstring const& wsearchedname, uint32 listfrom, uint32 levelmin, uint32 levelmax, uint32 usable,
-        uint32 inventoryType, uint32 itemClass, uint32 itemSubClass, uint32 quality,
-        uint32& count, uint32& totalcount)
+size_t AuctionHouseObject::AddCandidates(AuctionIndex const& index, uint32 key, AuctionCandidates& candidates)
 {
-    int loc_idx = player->GetSession()->GetSessionDbLocaleIndex();
+    AuctionIndex::const_iterator itr = index.find(key);
+    if (itr == index.end())
+        return 0;
 
-    time_t curTime = sWorld.GetGameTime();
+    candidates.push_back(&itr->second);
+    return itr->second.size();
+}
 
-    for (AuctionEntryMap::const_iterator itr = AuctionsMap.begin(); itr != AuctionsMap.end(); ++itr)
+size_t AuctionHouseObject::AddCandidates(AuctionIndex const& index, uint32 minKey, uint32 maxKey, AuctionCandidates& candidates)
+{
+    size_t count = 0;
+    for (AuctionIndex::const_iterator itr = index.begin(); itr != index.end(); ++itr)
     {
-        AuctionEntry* Aentry = itr->second;
-        // Skip expired auctions
-        if (Aentry->expire_time < curTime)
+        if (itr->first < minKey || itr->first > maxKey)
             continue;
 
-        Item* item = sAuctionMgr->GetAItem(Aentry->item_guidlow);
-        if (!item)
-            continue;
+        candidates.push_back(&itr->second);
+        count += itr->second.size();
+    }
 
-        ItemTemplate const* proto = item->GetProto();
+    return count;
+}
 
-        if (itemClass != 0xffffffff && proto->Class != itemClass)
-            continue;
+// keeps the smaller of the two candidate lists, found is left empty
+void AuctionHouseObject::KeepSmallest(AuctionCandidates& found, size_t n, AuctionCandidates& candidates, size_t& candidateCount, bool& indexed)
+{
+    if (!indexed || n < candidateCount)
+    {
+        candidates.swap(found);
+        candidateCount = n;
+        indexed = true;
+    }
 
-        if (itemSubClass != 0xffffffff && proto->SubClass != itemSubClass)
-            continue;
+    found.clear();
+}
 
-        if (inventoryType != 0xffffffff && proto->InventoryType != inventoryType)
-            continue;
+bool AuctionHouseObject::MatchesSearch(AuctionEntry const* auction, ItemTemplate const* proto, Player* player,
+                                       std::wstring const& wsearchedname, int loc_idx, uint32 levelmin, uint32 levelmax, uint32 usable,
+                                       uint32 inventoryType, uint32 itemClass, uint32 itemSubClass, uint32 quality, time_t curTime) const
+{
+    // Skip expired auctions
+    if (auction->expire_time < curTime)
+        return false;
 
-        if (quality != 0xffffffff && proto->Quality < quality)
-            continue;
+    if (!proto)
+        return false;
 
-        if (levelmin != 0x00 && (proto->RequiredLevel < levelmin || (levelmax != 0x00 && proto->RequiredLevel > levelmax)))
-            continue;
+    if (itemClass != 0xffffffff && proto->Class != itemClass)
+        return false;
 
-        if (usable != 0x00)
-        {
-            if (player->CanUseItem(item) != EQUIP_ERR_OK)
-                continue;
+    if (itemSubClass != 0xffffffff && proto->SubClass != itemSubClass)
+        return false;
 
-            if (proto->Class == ITEM_CLASS_RECIPE)
-                if (player->HasSpell(proto->Spells[1].SpellId))
-                    continue;
-        }
+    if (inventoryType != 0xffffffff && proto->InventoryType != inventoryType)
+        return false;
 
-        std::string name = proto->Name1;
-        if (name.empty())
-            continue;
+    if (quality != 0xffffffff && proto->Quality < quality)
+        return false;
+
+    if (levelmin != 0x00 && (proto->RequiredLevel < levelmin || (levelmax != 0x00 && proto->RequiredLevel > levelmax)))
+        return false;
+
+    Item* item = sAuctionMgr->GetAItem(auction->item_guidlow);
+    if (!item)
+        return false;
+
+    if (usable != 0x00)
+    {
+        if (player->CanUseItem(item) != EQUIP_ERR_OK)
+            return false;
+
+        if (proto->Class == ITEM_CLASS_RECIPE)
+            if (player->HasSpell(proto->Spells[1].SpellId))
+                return false;
+    }
+
+    if (!*proto->Name1)
+        return false;
+
+    if (!wsearchedname.empty() && sAuctionMgr->GetSearchName(proto, loc_idx).find(wsearchedname) == std::wstring::npos)
+        return false;
+
+    return true;
+}
+
+void AuctionHouseObject::BuildListAuctionItems(WorldPacket& data, Player* player,
+        std::wstring const& wsearchedname, uint32 listfrom, uint32 levelmin, uint32 levelmax, uint32 usable,
+        uint32 inventoryType, uint32 itemClass, uint32 itemSubClass, uint32 quality,
+        uint32& count, uint32& totalcount)
+{
+    int loc_idx = player->GetSession()->GetSessionDbLocaleIndex();
+
+    time_t curTime = sWorld.GetGameTime();
+
+    // candidates come from the most selective index matching a requested filter,
+    // every candidate is then checked against all the filters
+    AuctionCandidates candidates, found;
+    size_t candidateCount = AuctionsMap.size();
+    bool indexed = false;
+
+    if (itemClass != 0xffffffff)
+    {
+        size_t n = itemSubClass != 0xffffffff ? AddCandidates(m_bySubClass, itemClass << 16 | itemSubClass, found) : AddCandidates(m_byClass, itemClass, found);
+        KeepSmallest(found, n, candidates, candidateCount, indexed);
+    }
+
+    if (inventoryType != 0xffffffff)
+    {
+        size_t n = AddCandidates(m_byInventoryType, inventoryType, found);
+        KeepSmallest(found, n, candidates, candidateCount, indexed);
+    }
+
+    if (quality != 0xffffffff && quality)
+    {
+        size_t n = AddCandidates(m_byQuality, quality, 0xffffffff, found);
+        KeepSmallest(found, n, candidates, candidateCount, indexed);
+    }
+
+    if (levelmin != 0x00)
+    {
+        size_t n = AddCandidates(m_byRequiredLevel, levelmin, levelmax != 0x00 ? levelmax : 0xffffffff, found);
+        KeepSmallest(found, n, candidates, candidateCount, indexed);
+    }
 
-        // local name
-        if (loc_idx >= 0)
+    // name test once per distinct item, only worth it if it beats the other filters
+    if (!wsearchedname.empty() && (!indexed || m_byEntry.size() < candidateCount))
+    {
+        size_t n = 0;
+        for (AuctionIndex::const_iterator itr = m_byEntry.begin(); itr != m_byEntry.end(); ++itr)
         {
-            ItemLocale const* il = sObjectMgr.GetItemLocale(proto->ItemId);
-            if (il)
+            ItemTemplate const* proto = sObjectMgr.GetItemTemplate(itr->first);
+            if (proto && sAuctionMgr->GetSearchName(proto, loc_idx).find(wsearchedname) != std::wstring::npos)
             {
-                if (il->Name.size() > size_t(loc_idx) && !il->Name[loc_idx].empty())
-                    name = il->Name[loc_idx];
+                found.push_back(&itr->second);
+                n += itr->second.size();
             }
         }
 
-        if (!wsearchedname.empty() && !Utf8FitTo(name, wsearchedname))
+        KeepSmallest(found, n, candidates, candidateCount, indexed);
+    }
+
+    std::vector<AuctionEntry*> auctions;
+    if (!indexed)
+    {
+        auctions.reserve(AuctionsMap.size());
+        for (AuctionEntryMap::const_iterator itr = AuctionsMap.begin(); itr != AuctionsMap.end(); ++itr)
+            auctions.push_back(itr->second);
+    }
+    else
+    {
+        // keep the auction id order of the unindexed listing, pages must be stable
+        auctions.reserve(candidateCount);
+        for (AuctionCandidates::const_iterator itr = candidates.begin(); itr != candidates.end(); ++itr)
+            auctions.insert(auctions.end(), (*itr)->begin(), (*itr)->end());
+
+        if (candidates.size() > 1)
+            std::sort(auctions.begin(), auctions.end(), AuctionEntryIdOrder());
+    }
+
+    for (std::vector<AuctionEntry*>::const_iterator itr = auctions.begin(); itr != auctions.end(); ++itr)
+    {
+        AuctionEntry* Aentry = *itr;
+        ItemTemplate const* proto = sObjectMgr.GetItemTemplate(Aentry->item_template);
+
+        if (!MatchesSearch(Aentry, proto, player, wsearchedname, loc_idx, levelmin, levelmax, usable,
+                           inventoryType, itemClass, itemSubClass, quality, curTime))
             continue;
 
         if (count < 50 && totalcount >= listfrom)
@@ -25,6 +25,7 @@
 class Item;
 class Player;
 class WorldPacket;
+struct ItemTemplate;
 
 #define MIN_AUCTION_TIME (12*HOUR)
 
@@ -75,6 +76,14 @@ struct AuctionEntry
     void SaveToDB() const;
 };
 
+struct AuctionEntryIdOrder
+{
+    bool operator()(AuctionEntry const* a, AuctionEntry const* b) const
+    {
+        return a->Id < b->Id;
+    }
+};
+
 // this class is used as auctionhouse instance
 class AuctionHouseObject
 {
@@ -126,8 +135,29 @@ class AuctionHouseObject
                                    uint32& count, uint32& totalcount);
 
     private:
+        // search indexes, sets are ordered by auction id like AuctionsMap
+        typedef std::set<AuctionEntry*, AuctionEntryIdOrder> AuctionEntrySet;
+        typedef UNORDERED_MAP<uint32, AuctionEntrySet> AuctionIndex;
+        typedef std::vector<AuctionEntrySet const*> AuctionCandidates;
+
+        void IndexAuction(AuctionEntry* auction, bool add);
+        static void IndexAuction(AuctionIndex& index, uint32 key, AuctionEntry* auction, bool add);
+        static size_t AddCandidates(AuctionIndex const& index, uint32 key, AuctionCandidates& candidates);
+        static size_t AddCandidates(AuctionIndex const& index, uint32 minKey, uint32 maxKey, AuctionCandidates& candidates);
+        static void KeepSmallest(AuctionCandidates& found, size_t n, AuctionCandidates& candidates, size_t& candidateCount, bool& indexed);
+        bool MatchesSearch(AuctionEntry const* auction, ItemTemplate const* proto, Player* player,
+                           std::wstring const& searchedname, int loc_idx, uint32 levelmin, uint32 levelmax, uint32 usable,
+                           uint32 inventoryType, uint32 itemClass, uint32 itemSubClass, uint32 quality, time_t curTime) const;
+
         AuctionEntryMap AuctionsMap;
 
+        AuctionIndex m_byClass;                             // proto Class
+        AuctionIndex m_bySubClass;                          // proto Class << 16 | SubClass
+        AuctionIndex m_byInventoryType;
+        AuctionIndex m_byQuality;
+        AuctionIndex m_byRequiredLevel;
+        AuctionIndex m_byEntry;                             // for name searches, one name test per item entry
+
         // storage for "next" auction item for next Update()
         AuctionEntryMap::const_iterator next;
 };
@@ -143,6 +173,11 @@ class AuctionHouseMgr
         AuctionHouseObject* GetAuctionsMap(uint32 factionTemplateId);
         AuctionHouseObject* GetBidsMap(uint32 factionTemplateId);
 
+        // lower-cased item name in the given locale, as searched by the auction browser
+        std::wstring const& GetSearchName(ItemTemplate const* proto, int loc_idx);
+        // forget the names built so far, after the item locales are reloaded
+        void ClearSearchNames() { mSearchNames.clear(); }
+
         Item* GetAItem(uint32 id)
         {
             ItemMap::const_iterator itr = mAitems.find(id);
@@ -175,6 +210,10 @@ class AuctionHouseMgr
         AuctionHouseObject mNeutralAuctions;
 
         ItemMap mAitems;
+
+        // lower-cased names per item entry: default name then one per locale index
+        typedef UNORDERED_MAP<uint32, std::vector<std::wstring> > ItemSearchNameMap;
+        ItemSearchNameMap mSearchNames;
 };
 
 #define sAuctionMgr ACE_Singleton<AuctionHouseMgr, ACE_Null_Mutex>::instance()
@@ -27,6 +27,7 @@
 #include "World.h"
 #include "GridNotifiersImpl.h"
 #include "Formulas.h"
+#include "SharedWorldPacket.h"
 #include "LuaEngine.h"
 
 namespace Oregon
@@ -216,8 +217,7 @@ Battleground::~Battleground()
     if (GetInstanceID())                                     // not spam by useless queries in case BG templates
     {
         // delete creature and go respawn times
-        WorldDatabase.PExecute("DELETE FROM creature_respawn WHERE instance = '%u'", GetInstanceID());
-        WorldDatabase.PExecute("DELETE FROM gameobject_respawn WHERE instance = '%u'", GetInstanceID());
+        sObjectMgr.DeleteRespawnTimeForInstance(GetInstanceID());
         // delete instance from db
         CharacterDatabase.PExecute("DELETE FROM instance WHERE id = '%u'", GetInstanceID());
         // remove from battlegrounds
@@ -491,6 +491,7 @@ void Battleground::SetTeamStartLoc(uint32 TeamID, float X, float Y, float Z, flo
 
 void Battleground::SendPacketToAll(WorldPacket* packet)
 {
+    SharedWorldPacketPtr shared(*packet);
     for (std::map<uint64, BattlegroundPlayer>::iterator itr = m_Players.begin(); itr != m_Players.end(); ++itr)
     {
         if (itr->second.LastOnlineTime)
@@ -498,7 +499,7 @@ void Battleground::SendPacketToAll(WorldPacket* packet)
 
         Player* plr = sObjectMgr.GetPlayer(itr->first);
         if (plr)
-            plr->GetSession()->SendPacket(packet);
+            plr->GetSession()->SendPacket(shared);
         else
             sLog.outError("Battleground: Player (GUID: %u) not found!", GUID_LOPART(itr->first));
     }
@@ -506,6 +507,7 @@ void Battleground::SendPacketToAll(WorldPacket* packet)
 
 void Battleground::SendPacketToTeam(uint32 TeamID, WorldPacket* packet, Player* sender, bool self)
 {
+    SharedWorldPacketPtr shared(*packet);
     for (std::map<uint64, BattlegroundPlayer>::iterator itr = m_Players.begin(); itr != m_Players.end(); ++itr)
     {
         if (itr->second.LastOnlineTime)
@@ -526,7 +528,7 @@ void Battleground::SendPacketToTeam(uint32 TeamID, WorldPacket* packet, Player*
         if (!team) team = plr->GetTeam();
 
         if (team == TeamID)
-            plr->GetSession()->SendPacket(packet);
+            plr->GetSession()->SendPacket(shared);
     }
 }
 
@@ -19,6 +19,7 @@
 #include "ObjectMgr.h"
 #include "SocialMgr.h"
 #include "World.h"
+#include "SharedWorldPacket.h"
 
 Channel::Channel(const std::string& name, uint32 channel_id)
     : m_name(name), m_announce(true), m_moderate(false), m_password(""), m_flags(0), m_channelId(channel_id), m_ownerGUID(0)
@@ -661,26 +662,28 @@ void Channel::SetOwner(uint64 guid, bool exclaim)
 
 void Channel::SendToAll(WorldPacket* data, uint64 p)
 {
+    SharedWorldPacketPtr shared(*data);
     for (PlayerList::const_iterator i = players.begin(); i != players.end(); ++i)
     {
         Player* plr = sObjectMgr.GetPlayer(i->first, true);
         if (plr)
         {
             if (!p || !plr->GetSocial()->HasIgnore(GUID_LOPART(p)))
-                plr->GetSession()->SendPacket(data);
+                plr->GetSession()->SendPacket(shared);
         }
     }
 }
 
 void Channel::SendToAllButOne(WorldPacket* data, uint64 who)
 {
+    SharedWorldPacketPtr shared(*data);
     for (PlayerList::const_iterator i = players.begin(); i != players.end(); ++i)
     {
         if (i->first != who)
         {
             Player* plr = sObjectMgr.GetPlayer(i->first);
             if (plr)
-                plr->GetSession()->SendPacket(data);
+                plr->GetSession()->SendPacket(shared);
         }
     }
 }
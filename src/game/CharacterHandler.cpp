@@ -137,6 +137,8 @@ class CharacterHandler
 
 void WorldSession::HandleCharEnum(QueryResult_AutoPtr result)
 {
+    Database::KeyGuard dbKey(GetAccountId());
+
     WorldPacket data(SMSG_CHAR_ENUM, 100);                  // we guess size
 
     uint8 num = 0;
@@ -499,6 +501,8 @@ void WorldSession::HandlePlayerLoginOpcode(WorldPacket& recv_data)
 
 void WorldSession::HandlePlayerLogin(LoginQueryHolder* holder)
 {
+    Database::KeyGuard dbKey(GetAccountId());
+
     uint64 playerGuid = holder->GetGuid();
 
     Player* pCurrChar = new Player(this);
@@ -710,7 +714,7 @@ void WorldSession::HandlePlayerLogin(LoginQueryHolder* holder)
 
     // used by eluna
     if (pCurrChar->HasAtLoginFlag(AT_LOGIN_FIRST))
-        sEluna->OnFirstLogin(pCurrChar);
+        pCurrChar->GetEluna()->OnFirstLogin(pCurrChar);
 
     if (pCurrChar->HasAtLoginFlag(AT_LOGIN_FIRST))
         pCurrChar->RemoveAtLoginFlag(AT_LOGIN_FIRST);
@@ -793,7 +797,7 @@ void WorldSession::HandlePlayerLogin(LoginQueryHolder* holder)
     sScriptMgr.OnLogin(pCurrChar);
 
     // used by eluna
-    sEluna->OnLogin(pCurrChar);
+    pCurrChar->GetEluna()->OnLogin(pCurrChar);
 
     delete holder;
 }
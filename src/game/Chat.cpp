@@ -97,15 +97,22 @@ ChatCommand* ChatHandler::getCommandTable()
     static ChatCommand serverCommandTable[] =
     {
         { "corpses",        SEC_GAMEMASTER,     true,  &ChatHandler::HandleServerCorpsesCommand,       "", NULL },
+        { "dbstats",        SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleServerDBStatsCommand,       "", NULL },
+        { "elunastats",     SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleServerElunaStatsCommand,    "", NULL },
         { "exit",           SEC_CONSOLE,        true,  &ChatHandler::HandleServerExitCommand,          "", NULL },
+        { "guidstats",      SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleServerGuidStatsCommand,     "", NULL },
         { "idlerestart",    SEC_ADMINISTRATOR,  true,  NULL,                                           "", serverIdleRestartCommandTable },
         { "idleshutdown",   SEC_ADMINISTRATOR,  true,  NULL,                                           "", serverIdleShutdownCommandTable },
         { "info",           SEC_PLAYER,         true,  &ChatHandler::HandleServerInfoCommand,          "", NULL },
+        { "mapstats",       SEC_GAMEMASTER,     true,  &ChatHandler::HandleServerMapStatsCommand,      "", NULL },
         { "motd",           SEC_PLAYER,         true,  &ChatHandler::HandleServerMotdCommand,          "", NULL },
+        { "movestats",      SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleServerMoveStatsCommand,     "", NULL },
+        { "pathstats",      SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleServerPathStatsCommand,     "", NULL },
         { "plimit",         SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleServerPLimitCommand,        "", NULL },
         { "restart",        SEC_ADMINISTRATOR,  true,  NULL,                                           "", serverRestartCommandTable },
         { "shutdown",       SEC_ADMINISTRATOR,  true,  NULL,                                           "", serverShutdownCommandTable },
         { "set",            SEC_ADMINISTRATOR,  true,  NULL,                                           "", serverSetCommandTable },
+        { "whostats",       SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleServerWhoStatsCommand,      "", NULL },
         { NULL,             0,                  false, NULL,                                           "", NULL }
     };
 
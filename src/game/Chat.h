@@ -323,6 +323,13 @@ class ChatHandler
         bool HandleServerIdleRestartCommand(const char* args);
         bool HandleServerIdleShutDownCommand(const char* args);
         bool HandleServerInfoCommand(const char* args);
+        bool HandleServerMapStatsCommand(const char* args);
+        bool HandleServerDBStatsCommand(const char* args);
+        bool HandleServerPathStatsCommand(const char* args);
+        bool HandleServerElunaStatsCommand(const char* args);
+        bool HandleServerMoveStatsCommand(const char* args);
+        bool HandleServerWhoStatsCommand(const char* args);
+        bool HandleServerGuidStatsCommand(const char* args);
         bool HandleServerMotdCommand(const char* args);
         bool HandleServerPLimitCommand(const char* args);
         bool HandleServerRestartCommand(const char* args);
@@ -240,21 +240,21 @@ void WorldSession::HandleMessagechatOpcode(WorldPacket& recv_data)
         {
             if (type == CHAT_MSG_SAY)
             {
-                if (!sEluna->OnChat(GetPlayer(), type, lang, msg))
+                if (!GetPlayer()->GetEluna()->OnChat(GetPlayer(), type, lang, msg))
                     return;
 
                 GetPlayer()->Say(msg, lang);
             }
             else if (type == CHAT_MSG_EMOTE)
             {
-                if (!sEluna->OnChat(GetPlayer(), type, LANG_UNIVERSAL, msg))
+                if (!GetPlayer()->GetEluna()->OnChat(GetPlayer(), type, LANG_UNIVERSAL, msg))
                     return;
 
                 GetPlayer()->TextEmote(msg);
             }
             else if (type == CHAT_MSG_YELL)
             {
-                if (!sEluna->OnChat(GetPlayer(), type, lang, msg))
+                if (!GetPlayer()->GetEluna()->OnChat(GetPlayer(), type, lang, msg))
                     return;
 
                 GetPlayer()->Yell(msg, lang);
@@ -297,7 +297,7 @@ void WorldSession::HandleMessagechatOpcode(WorldPacket& recv_data)
             }
 
             // used by eluna
-            sEluna->OnChat(GetPlayer(), type, lang, msg, player);
+            GetPlayer()->GetEluna()->OnChat(GetPlayer(), type, lang, msg, player);
 
             GetPlayer()->Whisper(msg, lang, player);
         }
@@ -315,7 +315,7 @@ void WorldSession::HandleMessagechatOpcode(WorldPacket& recv_data)
             }
 			
             // used by eluna
-            if (!sEluna->OnChat(GetPlayer(), type, lang, msg, group))
+            if (!GetPlayer()->GetEluna()->OnChat(GetPlayer(), type, lang, msg, group))
                 return;
 
             WorldPacket data;
@@ -335,7 +335,7 @@ void WorldSession::HandleMessagechatOpcode(WorldPacket& recv_data)
                 if (guild)
                 {
                     // used by eluna
-                    if (!sEluna->OnChat(GetPlayer(), type, lang, msg, guild))
+                    if (!GetPlayer()->GetEluna()->OnChat(GetPlayer(), type, lang, msg, guild))
                         return;
 
                     guild->BroadcastToGuild(this, msg, lang == LANG_ADDON ? LANG_ADDON : LANG_UNIVERSAL);
@@ -362,7 +362,7 @@ void WorldSession::HandleMessagechatOpcode(WorldPacket& recv_data)
                 if (guild)
                 {
                     // used by eluna
-                    if (!sEluna->OnChat(GetPlayer(), type, lang, msg, guild))
+                    if (!GetPlayer()->GetEluna()->OnChat(GetPlayer(), type, lang, msg, guild))
                         return;
 
                     guild->BroadcastToOfficers(this, msg, lang == LANG_ADDON ? LANG_ADDON : LANG_UNIVERSAL);
@@ -383,7 +383,7 @@ void WorldSession::HandleMessagechatOpcode(WorldPacket& recv_data)
                 return;
 
             // used by eluna
-            if (!sEluna->OnChat(GetPlayer(), type, lang, msg, group))
+            if (!GetPlayer()->GetEluna()->OnChat(GetPlayer(), type, lang, msg, group))
                 return;
 
             WorldPacket data;
@@ -403,7 +403,7 @@ void WorldSession::HandleMessagechatOpcode(WorldPacket& recv_data)
                 return;
 
             // used by eluna
-            if (!sEluna->OnChat(GetPlayer(), type, lang, msg, group))
+            if (!GetPlayer()->GetEluna()->OnChat(GetPlayer(), type, lang, msg, group))
                 return;
 
             WorldPacket data;
@@ -422,7 +422,7 @@ void WorldSession::HandleMessagechatOpcode(WorldPacket& recv_data)
                 return;
 
             // used by eluna
-            if (!sEluna->OnChat(GetPlayer(), type, lang, msg, group))
+            if (!GetPlayer()->GetEluna()->OnChat(GetPlayer(), type, lang, msg, group))
                 return;
 
             WorldPacket data;
@@ -444,7 +444,7 @@ void WorldSession::HandleMessagechatOpcode(WorldPacket& recv_data)
                 return;
 
             // used by eluna
-            if (!sEluna->OnChat(GetPlayer(), type, lang, msg, group))
+            if (!GetPlayer()->GetEluna()->OnChat(GetPlayer(), type, lang, msg, group))
                 return;
 
             WorldPacket data;
@@ -465,7 +465,7 @@ void WorldSession::HandleMessagechatOpcode(WorldPacket& recv_data)
                 return;
 
             // used by eluna
-            if (!sEluna->OnChat(GetPlayer(), type, lang, msg, group))
+            if (!GetPlayer()->GetEluna()->OnChat(GetPlayer(), type, lang, msg, group))
                 return;
 
             WorldPacket data;
@@ -485,7 +485,7 @@ void WorldSession::HandleMessagechatOpcode(WorldPacket& recv_data)
                 if (Channel* chn = cMgr->GetChannel(channel, _player))
                 {
                     // used by eluna
-                    if (!sEluna->OnChat(GetPlayer(), type, lang, msg, chn))
+                    if (!GetPlayer()->GetEluna()->OnChat(GetPlayer(), type, lang, msg, chn))
                         return;
 
                     chn->Say(_player->GetGUID(), msg.c_str(), lang);
@@ -523,7 +523,7 @@ void WorldSession::HandleMessagechatOpcode(WorldPacket& recv_data)
                 }
 
                 // used by eluna
-                if (!sEluna->OnChat(GetPlayer(), type, lang, msg))
+                if (!GetPlayer()->GetEluna()->OnChat(GetPlayer(), type, lang, msg))
                     return;
             }
         }
@@ -548,7 +548,7 @@ void WorldSession::HandleMessagechatOpcode(WorldPacket& recv_data)
             }
 
             // used by eluna
-            if (!sEluna->OnChat(GetPlayer(), type, lang, msg))
+            if (!GetPlayer()->GetEluna()->OnChat(GetPlayer(), type, lang, msg))
                 return;
         }
         break;
@@ -568,7 +568,7 @@ void WorldSession::HandleEmoteOpcode(WorldPacket& recv_data)
     recv_data >> emote;
 
     // used by eluna
-    sEluna->OnEmote(GetPlayer(), emote);
+    GetPlayer()->GetEluna()->OnEmote(GetPlayer(), emote);
 
     GetPlayer()->HandleEmoteCommand(emote);
 }
@@ -593,7 +593,7 @@ void WorldSession::HandleTextEmoteOpcode(WorldPacket& recv_data)
     recv_data >> guid;
 
     // used by eluna
-    sEluna->OnTextEmote(GetPlayer(), text_emote, emoteNum, guid);
+    GetPlayer()->GetEluna()->OnTextEmote(GetPlayer(), text_emote, emoteNum, guid);
 
     EmotesTextEntry const* em = sEmotesTextStore.LookupEntry(text_emote);
     if (!em)
@@ -190,9 +190,10 @@ void Creature::AddToWorld()
         if (m_zoneScript)
             m_zoneScript->OnCreatureCreate(this, true);
 
-        sEluna->OnAddToWorld(this);
+        GetEluna()->OnAddToWorld(this);
 
         ObjectAccessor::Instance().AddObject(this);
+        GetMap()->AddToGuidStore(this);
         Unit::AddToWorld();
         SearchFormation();
         AIM_Initialize();
@@ -206,13 +207,14 @@ void Creature::RemoveFromWorld()
         if (m_zoneScript)
             m_zoneScript->OnCreatureCreate(this, false);
 
-        sEluna->OnRemoveFromWorld(this);
+        GetEluna()->OnRemoveFromWorld(this);
 
         if (m_formation)
             sFormationMgr.RemoveCreatureFromGroup(m_formation, this);
 
         Unit::RemoveFromWorld();
 
+        GetMap()->RemoveFromGuidStore(this);
         ObjectAccessor::Instance().RemoveObject(this);
     }
 }
@@ -14,7 +14,7 @@
 using namespace Hooks;
 
 #define START_HOOK(EVENT, CREATURE) \
-    if (!IsEnabled())\
+    if (!CanRunHooks("creature", EVENT))\
         return;\
     auto entry_key = EntryKey<CreatureEvents>(EVENT, CREATURE->GetEntry());\
     auto unique_key = UniqueObjectKey<CreatureEvents>(EVENT, CREATURE->GET_GUID(), CREATURE->GetInstanceId());\
@@ -24,7 +24,7 @@ using namespace Hooks;
     LOCK_ELUNA
 
 #define START_HOOK_WITH_RETVAL(EVENT, CREATURE, RETVAL) \
-    if (!IsEnabled())\
+    if (!CanRunHooks("creature", EVENT))\
         return RETVAL;\
     auto entry_key = EntryKey<CreatureEvents>(EVENT, CREATURE->GetEntry());\
     auto unique_key = UniqueObjectKey<CreatureEvents>(EVENT, CREATURE->GET_GUID(), CREATURE->GetInstanceId());\
@@ -45,6 +45,7 @@ void DynamicObject::AddToWorld()
     if (!IsInWorld())
     {
         ObjectAccessor::Instance().AddObject(this);
+        GetMap()->AddToGuidStore(this);
         WorldObject::AddToWorld();
     }
 }
@@ -65,6 +66,7 @@ void DynamicObject::RemoveFromWorld()
                 sLog.outError("Crash alert! DynamicObject::RemoveFromWorld cannot find viewpoint owner");
         }
         WorldObject::RemoveFromWorld();
+        GetMap()->RemoveFromGuidStore(this);
         ObjectAccessor::Instance().RemoveObject(this);
     }
 }
@@ -1468,7 +1468,7 @@ void GameEventMgr::RunSmartAIScripts(uint16 event_id, bool activate)
     //! Iterate over every supported source type (creature and gameobject)
     //! Not entirely sure how this will affect units in non-loaded grids.
     {
-        ObjectAccessor::Guard guard(*HashMapHolder<Creature>::GetLock());
+        HashMapHolder<Creature>::ReadGuard guard;
         HashMapHolder<Creature>::MapType const& m = ObjectAccessor::Instance().GetCreatures();
         for (HashMapHolder<Creature>::MapType::const_iterator iter = m.begin(); iter != m.end(); ++iter)
             if (iter->second && iter->second->IsInWorld())
@@ -1476,7 +1476,7 @@ void GameEventMgr::RunSmartAIScripts(uint16 event_id, bool activate)
                     iter->second->AI()->sOnGameEvent(activate, event_id);
     }
     {
-        ObjectAccessor::Guard guard(*HashMapHolder<GameObject>::GetLock());
+        HashMapHolder<GameObject>::ReadGuard guard;
         HashMapHolder<GameObject>::MapType const& m = ObjectAccessor::GetGameObjects();
         for (HashMapHolder<GameObject>::MapType::const_iterator iter = m.begin(); iter != m.end(); ++iter)
             if (iter->second && iter->second->IsInWorld())
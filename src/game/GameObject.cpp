@@ -133,9 +133,10 @@ void GameObject::AddToWorld()
         if (m_zoneScript)
             m_zoneScript->OnGameObjectCreate(this, true);
 
-        sEluna->OnAddToWorld(this);
+        GetEluna()->OnAddToWorld(this);
 
         ObjectAccessor::Instance().AddObject(this);
+        GetMap()->AddToGuidStore(this);
 
         // The state can be changed after GameObject::Create but before GameObject::AddToWorld
         bool toggledState = GetGoType() == GAMEOBJECT_TYPE_CHEST ? getLootState () == GO_READY : (GetGoState() == GO_STATE_READY || IsTransport());
@@ -159,7 +160,7 @@ void GameObject::RemoveFromWorld()
         if (m_zoneScript)
             m_zoneScript->OnGameObjectCreate(this, false);
 		
-        sEluna->OnRemoveFromWorld(this);
+        GetEluna()->OnRemoveFromWorld(this);
 
         RemoveFromOwner();
 
@@ -167,6 +168,7 @@ void GameObject::RemoveFromWorld()
             if (GetMap()->Contains(*m_model))
                 GetMap()->Remove(*m_model);
         WorldObject::RemoveFromWorld();
+        GetMap()->RemoveFromGuidStore(this);
         ObjectAccessor::Instance().RemoveObject(this);
     }
 }
@@ -230,7 +232,7 @@ bool GameObject::Create(uint32 guidlow, uint32 name_id, Map* map, float x, float
 
     AIM_Initialize();
 
-    sEluna->OnSpawn(this);
+    GetEluna()->OnSpawn(this);
 
     return true;
 }
@@ -249,7 +251,7 @@ void GameObject::Update(uint32 diff)
         sLog.outError("Could not initialize GameObjectAI");
 
     // used by eluna
-    sEluna->UpdateAI(this, diff);
+    GetEluna()->UpdateAI(this, diff);
 
     switch (m_lootState)
     {
@@ -1510,7 +1512,7 @@ void GameObject::SetLootState(LootState s, Unit* unit)
     m_lootState = s;
 
     AI()->OnStateChanged(s, unit);
-    sEluna->OnLootStateChanged(this, s);
+    GetEluna()->OnLootStateChanged(this, s);
 
     if (m_model)
     {
@@ -1669,7 +1671,7 @@ void GameObject::SetGoState(GOState state)
 {
     SetUInt32Value(GAMEOBJECT_STATE, state);
 
-    sEluna->OnGameObjectStateChanged(this, state);
+    GetEluna()->OnGameObjectStateChanged(this, state);
 
     if (m_model && !IsTransport())
     {
@@ -1723,10 +1725,14 @@ void GameObject::SetDisplayId(uint32 displayid)
 
 void GameObject::EnableCollision(bool enable)
 {
-    if (!m_model)
+    if (!m_model || m_model->isEnabled() == enable)
        return;
 
     m_model->enable(enable);
+
+    // doors opening or closing change what can be seen through them
+    if (IsInWorld())
+        GetMap()->InvalidateLineOfSightCache();
 }
 
 void GameObject::UpdateModel()
@@ -144,7 +144,7 @@ namespace LuaGlobalFunctions
         uint32 i = 0;
 
         {
-            ObjectAccessor::Guard g(*HashMapHolder<Player>::GetLock());
+            HashMapHolder<Player>::ReadGuard g;
             HashMapHolder<Player>::MapType& m = ObjectAccessor::Instance().GetPlayers();
             for (HashMapHolder<Player>::MapType::const_iterator it = m.begin(); it != m.end(); ++it)
             {
@@ -552,6 +552,7 @@ namespace LuaGlobalFunctions
      *         // Eluna
      *         ELUNA_EVENT_ON_LUA_STATE_CLOSE          =     16,       // (event) - triggers just before shutting down eluna (on shutdown and restart)
      *         ELUNA_EVENT_ON_LUA_STATE_OPEN           =     33,       // (event) - triggers after all scripts are loaded
+     *         ELUNA_EVENT_ON_STATE_MESSAGE            =     34,       // (event, channel, data, mapId, instanceId) - sent by SendStateMessage, mapId and instanceId are nil if sent by the world state
      *
      *         // Map
      *         MAP_EVENT_ON_CREATE                     =     17,       // (event, map)
@@ -1158,6 +1159,33 @@ namespace LuaGlobalFunctions
         return 0;
     }
 
+    /**
+     * Sends a message to another Lua state, it is received by the ELUNA_EVENT_ON_STATE_MESSAGE server event
+     * when that state is next updated.
+     *
+     * With `Eluna.PerMapStates` enabled every map runs the scripts in a Lua state of its own and
+     * the world level hooks run in the world state. Without a map the message goes to the world state,
+     * otherwise to the state of the given map instance. When the option is disabled there is only
+     * the world state and it receives all messages.
+     *
+     * @param string channel : name telling the receiver what the message is about
+     * @param string data : content of the message
+     * @param uint32 mapId = nil : map of the receiving state, nil for the world state
+     * @param uint32 instanceId = 0
+     * @return bool sent : false if the map has no Lua state
+     */
+    int SendStateMessage(Eluna* E, lua_State* L)
+    {
+        std::string channel = Eluna::CHECKVAL<std::string>(L, 1);
+        std::string data = Eluna::CHECKVAL<std::string>(L, 2);
+        bool toWorld = lua_isnoneornil(L, 3);
+        uint32 mapId = Eluna::CHECKVAL<uint32>(L, 3, 0);
+        uint32 instanceId = Eluna::CHECKVAL<uint32>(L, 4, 0);
+
+        Eluna::Push(L, Eluna::SendStateMessage(E, toWorld, mapId, instanceId, channel, data));
+        return 1;
+    }
+
     /**
      * Sends a message to all [Player]s online.
      *
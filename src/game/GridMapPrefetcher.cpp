@@ -0,0 +1,222 @@
+/*
+ * This file is part of the OregonCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "GridMapPrefetcher.h"
+#include "Map.h"
+#include "World.h"
+#include "VMapFactory.h"
+#include "MapTree.h"
+#include "MoveMap.h"
+
+#include <ace/Guard_T.h>
+#include <ace/Method_Request.h>
+
+class GridMapPrefetchRequest : public ACE_Method_Request
+{
+    private:
+
+        GridMapPrefetcher& m_prefetcher;
+        uint32 m_mapId;
+        int m_gx;
+        int m_gy;
+
+    public:
+
+        GridMapPrefetchRequest(GridMapPrefetcher& p, uint32 mapId, int gx, int gy)
+            : m_prefetcher(p), m_mapId(mapId), m_gx(gx), m_gy(gy)
+        {
+        }
+
+        virtual int call()
+        {
+            m_prefetcher.load(m_mapId, m_gx, m_gy);
+            return 0;
+        }
+};
+
+// pull a file into the OS cache, the contents are not kept
+static void ReadAhead(std::string const& filename)
+{
+    FILE* file = fopen(filename.c_str(), "rb");
+    if (!file)
+        return;
+
+    char buffer[64 * 1024];
+    while (fread(buffer, 1, sizeof(buffer), file) == sizeof(buffer))
+        ;
+
+    fclose(file);
+}
+
+GridMapPrefetcher::GridMapPrefetcher()
+    : m_executor(), m_mutex()
+{
+    memset(&m_stats, 0, sizeof(m_stats));
+}
+
+GridMapPrefetcher::~GridMapPrefetcher()
+{
+    deactivate();
+}
+
+int GridMapPrefetcher::activate(size_t num_threads)
+{
+    return m_executor.activate((int)num_threads);
+}
+
+int GridMapPrefetcher::deactivate()
+{
+    int result = m_executor.deactivate();
+
+    ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_mutex, -1);
+
+    for (EntryMap::iterator itr = m_entries.begin(); itr != m_entries.end(); ++itr)
+        delete itr->second.gridMap;
+    m_entries.clear();
+
+    return result;
+}
+
+bool GridMapPrefetcher::activated()
+{
+    return m_executor.activated();
+}
+
+void GridMapPrefetcher::Prefetch(uint32 mapId, int gx, int gy)
+{
+    if (!activated())
+        return;
+
+    {
+        ACE_GUARD(ACE_Thread_Mutex, guard, m_mutex);
+
+        uint32 key = MakeKey(mapId, gx, gy);
+        if (m_entries.find(key) != m_entries.end())
+            return;
+
+        purge_expired(time(NULL));
+
+        if (m_entries.size() >= GRID_PREFETCH_MAX_ENTRIES)
+            return;
+
+        Entry& entry = m_entries[key];
+        entry.gridMap = NULL;
+        entry.readyTime = 0;
+        entry.cancelled = false;
+
+        ++m_stats.requested;
+        ++m_stats.pending;
+    }
+
+    if (m_executor.execute(new GridMapPrefetchRequest(*this, mapId, gx, gy)) == -1)
+    {
+        ACE_GUARD(ACE_Thread_Mutex, guard, m_mutex);
+        m_entries.erase(MakeKey(mapId, gx, gy));
+        --m_stats.pending;
+    }
+}
+
+GridMap* GridMapPrefetcher::Take(uint32 mapId, int gx, int gy)
+{
+    if (!activated())
+        return NULL;
+
+    ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_mutex, NULL);
+
+    EntryMap::iterator itr = m_entries.find(MakeKey(mapId, gx, gy));
+    if (itr == m_entries.end() || itr->second.cancelled)
+    {
+        ++m_stats.misses;
+        return NULL;
+    }
+
+    // still loading, the map thread loads it itself rather than waiting
+    if (!itr->second.gridMap)
+    {
+        itr->second.cancelled = true;
+        ++m_stats.misses;
+        return NULL;
+    }
+
+    GridMap* gridMap = itr->second.gridMap;
+    m_entries.erase(itr);
+
+    ++m_stats.hits;
+    --m_stats.ready;
+    return gridMap;
+}
+
+void GridMapPrefetcher::GetStats(GridMapPrefetchStats& stats)
+{
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_mutex);
+    stats = m_stats;
+}
+
+void GridMapPrefetcher::load(uint32 mapId, int gx, int gy)
+{
+    char name[32];
+    snprintf(name, sizeof(name), "maps/%03u%02u%02u.map", mapId, gx, gy);
+
+    GridMap* gridMap = new GridMap();
+    if (!gridMap->loadData((sWorld.GetDataPath() + name).c_str()))
+        sLog.outError("Error loading map file: \n %s%s\n", sWorld.GetDataPath().c_str(), name);
+
+    if (VMAP::VMapFactory::createOrGetVMapManager()->isMapLoadingEnabled())
+        ReadAhead(sWorld.GetDataPath() + "vmaps/" + VMAP::StaticMapTree::getTileFileName(mapId, gx, gy));
+
+    if (MMAP::MMapFactory::IsPathfindingEnabled(mapId))
+    {
+        snprintf(name, sizeof(name), "mmaps/%03u%02u%02u.mmtile", mapId, gx, gy);
+        ReadAhead(sWorld.GetDataPath() + name);
+    }
+
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_mutex);
+
+    --m_stats.pending;
+
+    EntryMap::iterator itr = m_entries.find(MakeKey(mapId, gx, gy));
+    if (itr == m_entries.end() || itr->second.cancelled)
+    {
+        if (itr != m_entries.end())
+            m_entries.erase(itr);
+
+        ++m_stats.wasted;
+        delete gridMap;
+        return;
+    }
+
+    itr->second.gridMap = gridMap;
+    itr->second.readyTime = time(NULL);
+    ++m_stats.ready;
+}
+
+void GridMapPrefetcher::purge_expired(time_t now)
+{
+    for (EntryMap::iterator itr = m_entries.begin(); itr != m_entries.end();)
+    {
+        if (itr->second.gridMap && itr->second.readyTime + GRID_PREFETCH_EXPIRY < now)
+        {
+            delete itr->second.gridMap;
+            m_entries.erase(itr++);
+
+            --m_stats.ready;
+            ++m_stats.wasted;
+        }
+        else
+            ++itr;
+    }
+}
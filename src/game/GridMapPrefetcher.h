@@ -0,0 +1,99 @@
+/*
+ * This file is part of the OregonCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _GRID_MAP_PREFETCHER_H_INCLUDED
+#define _GRID_MAP_PREFETCHER_H_INCLUDED
+
+#include <ace/Thread_Mutex.h>
+
+#include "DelayExecutor.h"
+#include "Platform/Define.h"
+#include "Utilities/UnorderedMap.h"
+
+class GridMap;
+
+// prefetched grid maps not attached within this time are dropped
+#define GRID_PREFETCH_EXPIRY        (5 * MINUTE)
+// upper bound of grid maps queued or waiting to be attached
+#define GRID_PREFETCH_MAX_ENTRIES   64
+
+struct GridMapPrefetchStats
+{
+    uint64 requested;                                       // prefetches queued
+    uint64 hits;                                            // grid maps attached from the prefetcher
+    uint64 misses;                                          // grid maps loaded by the map thread itself
+    uint64 wasted;                                          // prefetched but never attached
+    uint32 pending;
+    uint32 ready;
+};
+
+/**
+ * Loads the terrain of base map grids ahead of the players on a pool of
+ * threads, see Map::PrefetchGridMaps. Terrain (.map) files are read into a
+ * GridMap that Map::LoadMap only has to attach. The vmap and mmap managers
+ * are not thread safe, so their tile files are only read ahead and the load
+ * on the map thread is served from the file cache of the OS.
+ */
+class GridMapPrefetcher
+{
+    public:
+
+        GridMapPrefetcher();
+        virtual ~GridMapPrefetcher();
+
+        friend class GridMapPrefetchRequest;
+
+        int activate(size_t num_threads);
+
+        int deactivate();
+
+        bool activated();
+
+        // queue the grid, ignored if it is already queued or ready
+        void Prefetch(uint32 mapId, int gx, int gy);
+
+        // hand over a prefetched grid map, NULL if there is none ready
+        GridMap* Take(uint32 mapId, int gx, int gy);
+
+        void GetStats(GridMapPrefetchStats& stats);
+
+    private:
+
+        struct Entry
+        {
+            GridMap* gridMap;                               // NULL while pending
+            time_t readyTime;
+            bool cancelled;                                 // taken or expired while pending
+        };
+
+        typedef UNORDERED_MAP<uint32, Entry> EntryMap;
+
+        static uint32 MakeKey(uint32 mapId, int gx, int gy)
+        {
+            return (mapId << 12) | (uint32(gx) << 6) | uint32(gy);
+        }
+
+        void load(uint32 mapId, int gx, int gy);
+        void purge_expired(time_t now);
+
+        DelayExecutor m_executor;
+        ACE_Thread_Mutex m_mutex;
+        EntryMap m_entries;
+        GridMapPrefetchStats m_stats;
+};
+
+#endif //_GRID_MAP_PREFETCHER_H_INCLUDED
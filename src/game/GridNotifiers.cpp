@@ -36,10 +36,8 @@ VisibleNotifier::SendToSelf()
     if (Transport* transport = i_player.GetTransport())
         for (Transport::PlayerSet::const_iterator itr = transport->GetPassengers().begin(); itr != transport->GetPassengers().end(); ++itr)
         {
-            if (vis_guids.find((*itr)->GetGUID()) != vis_guids.end())
+            if (i_player.m_clientGUIDs.Mark((*itr)->GetGUID()))
             {
-                vis_guids.erase((*itr)->GetGUID());
-
                 switch ((*itr)->GetTypeId())
                 {
                 case TYPEID_GAMEOBJECT:
@@ -56,9 +54,9 @@ VisibleNotifier::SendToSelf()
             }
         }
 
-    for (Player::ClientGUIDs::const_iterator it = vis_guids.begin(); it != vis_guids.end(); ++it)
+    std::vector<uint64> const& outOfSight = i_player.m_clientGUIDs.EraseUnmarked();
+    for (std::vector<uint64>::const_iterator it = outOfSight.begin(); it != outOfSight.end(); ++it)
     {
-        i_player.m_clientGUIDs.erase(*it);
         i_data.AddOutOfRangeGUID(*it);
 
         if (IS_PLAYER_GUID(*it))
@@ -138,7 +136,7 @@ void PlayerRelocationNotifier::Visit(PlayerMapType& m)
     {
         Player* plr = iter->GetSource();
 
-        vis_guids.erase(plr->GetGUID());
+        i_player.m_clientGUIDs.Mark(plr->GetGUID());
 
         i_player.UpdateVisibilityOf(plr, i_data, i_visibleNow);
 
@@ -157,7 +155,7 @@ void PlayerRelocationNotifier::Visit(CreatureMapType& m)
     {
         Creature* c = iter->GetSource();
 
-        vis_guids.erase(c->GetGUID());
+        i_player.m_clientGUIDs.Mark(c->GetGUID());
 
         i_player.UpdateVisibilityOf(c, i_data, i_visibleNow);
 
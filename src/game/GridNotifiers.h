@@ -20,6 +20,7 @@
 
 #include "ObjectGridLoader.h"
 #include "ByteBuffer.h"
+#include "SharedWorldPacket.h"
 #include "UpdateData.h"
 #include <iostream>
 
@@ -41,9 +42,9 @@ struct VisibleNotifier
     Player& i_player;
     UpdateData i_data;
     std::set<Unit*> i_visibleNow;
-    Player::ClientGUIDs vis_guids;
 
-    VisibleNotifier(Player& player) : i_player(player), vis_guids(player.m_clientGUIDs) {}
+    // objects not marked during the visit went out of sight
+    VisibleNotifier(Player& player) : i_player(player) { player.m_clientGUIDs.BeginPass(); }
     template<class T> void Visit(GridRefManager<T>& m);
     void SendToSelf(void);
 };
@@ -139,11 +140,14 @@ struct MessageDistDeliverer
 {
     WorldObject* i_source;
     WorldPacket* i_message;
+    SharedWorldPacketPtr i_shared;                          // of i_message
     float i_distSq;
     uint32 team;
-    MessageDistDeliverer(WorldObject* src, WorldPacket* msg, float dist, bool own_team_only = false)
-        : i_source(src), i_message(msg), i_distSq(dist* dist)
+    bool i_movement;                                        // batched by the receiving sessions
+    MessageDistDeliverer(WorldObject* src, WorldPacket* msg, float dist, bool own_team_only = false, bool movement = false)
+        : i_source(src), i_message(msg), i_shared(*msg), i_distSq(dist* dist)
         , team((own_team_only && src->GetTypeId() == TYPEID_PLAYER) ? ((Player*)src)->GetTeam() : 0)
+        , i_movement(movement)
     {
     }
     void Visit(PlayerMapType& m);
@@ -161,7 +165,12 @@ struct MessageDistDeliverer
             return;
 
         if (WorldSession* session = plr->GetSession())
-            session->SendPacket(i_message);
+        {
+            if (i_movement)
+                session->SendMovementPacket(i_message);
+            else
+                session->SendPacket(i_shared);
+        }
     }
 };
 
@@ -34,7 +34,7 @@ Oregon::VisibleNotifier::Visit(GridRefManager<T>& m)
     for (typename GridRefManager<T>::iterator iter = m.begin(); iter != m.end(); ++iter)
     {
         i_player.UpdateVisibilityOf(iter->GetSource(), i_data, i_visibleNow);
-        vis_guids.erase(iter->GetSource()->GetGUID());
+        i_player.m_clientGUIDs.Mark(iter->GetSource()->GetGUID());
     }
 }
 
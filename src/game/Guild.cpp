@@ -16,6 +16,7 @@
  */
 #include "Database/DatabaseEnv.h"
 #include "WorldPacket.h"
+#include "SharedWorldPacket.h"
 #include "WorldSession.h"
 #include "Player.h"
 #include "Opcodes.h"
@@ -693,23 +694,25 @@ void Guild::BroadcastToOfficers(WorldSession* session, const std::string& msg, u
 
 void Guild::BroadcastPacket(WorldPacket* packet)
 {
+    SharedWorldPacketPtr shared(*packet);
     for (MemberList::iterator itr = members.begin(); itr != members.end(); ++itr)
     {
         Player* player = ObjectAccessor::FindPlayer(MAKE_NEW_GUID(itr->first, 0, HIGHGUID_PLAYER), true);
         if (player)
-            player->GetSession()->SendPacket(packet);
+            player->GetSession()->SendPacket(shared);
     }
 }
 
 void Guild::BroadcastPacketToRank(WorldPacket* packet, uint32 rankId)
 {
+    SharedWorldPacketPtr shared(*packet);
     for (MemberList::iterator itr = members.begin(); itr != members.end(); ++itr)
     {
         if (itr->second.RankId == rankId)
         {
             Player* player = ObjectAccessor::FindPlayer(MAKE_NEW_GUID(itr->first, 0, HIGHGUID_PLAYER), true);
             if (player)
-                player->GetSession()->SendPacket(packet);
+                player->GetSession()->SendPacket(shared);
         }
     }
 }
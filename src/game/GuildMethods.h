@@ -24,7 +24,7 @@ namespace LuaGuild
         uint32 i = 0;
 
         {
-            ObjectAccessor::Guard g(*HashMapHolder<Player>::GetLock());
+            HashMapHolder<Player>::ReadGuard g;
             HashMapHolder<Player>::MapType& m = ObjectAccessor::Instance().GetPlayers();
             for (HashMapHolder<Player>::MapType::const_iterator it = m.begin(); it != m.end(); ++it)
             {
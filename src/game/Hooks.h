@@ -151,6 +151,7 @@ namespace Hooks
 
         // Eluna
         ELUNA_EVENT_ON_LUA_STATE_OPEN           =     33,       // (event) - triggers after all scripts are loaded
+        ELUNA_EVENT_ON_STATE_MESSAGE            =     34,       // (event, channel, data, mapId, instanceId) - sent by SendStateMessage, mapId and instanceId are nil if sent by the world state
 
         SERVER_EVENT_COUNT
     };
@@ -285,7 +285,7 @@ void Item::UpdateDuration(Player* owner, uint32 diff)
     if (GetUInt32Value(ITEM_FIELD_DURATION) <= diff)
     {
         // used by eluna
-        sEluna->OnExpire(owner, GetProto());
+        owner->GetEluna()->OnExpire(owner, GetProto());
 
         owner->DestroyItem(GetBagSlot(), GetSlot(), true);
         return;
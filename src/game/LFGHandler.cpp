@@ -29,7 +29,7 @@ static void AttemptJoin(Player* _player)
     if (!_player->m_lookingForGroup.canAutoJoin() || _player->GetGroup())
         return;
 
-    ObjectAccessor::Guard guard(*HashMapHolder<Player>::GetLock());
+    HashMapHolder<Player>::ReadGuard guard;
     HashMapHolder<Player>::MapType const& players = ObjectAccessor::Instance().GetPlayers();
     for (HashMapHolder<Player>::MapType::const_iterator iter = players.begin(); iter != players.end(); ++iter)
     {
@@ -89,7 +89,7 @@ static void AttemptAddMore(Player* _player)
     if (!_player->m_lookingForGroup.more.canAutoJoin())
         return;
 
-    ObjectAccessor::Guard guard(*HashMapHolder<Player>::GetLock());
+    HashMapHolder<Player>::ReadGuard guard;
     HashMapHolder<Player>::MapType const& players = ObjectAccessor::Instance().GetPlayers();
     for (HashMapHolder<Player>::MapType::const_iterator iter = players.begin(); iter != players.end(); ++iter)
     {
@@ -258,7 +258,7 @@ void WorldSession::SendLfgResult(uint32 type, uint32 entry, uint8 lfg_type)
     data << uint32(0);                                      // count, placeholder
     data << uint32(0);                                      // count again, strange, placeholder
 
-    //@todo Guard Player map
+    HashMapHolder<Player>::ReadGuard guard;
     HashMapHolder<Player>::MapType const& players = ObjectAccessor::Instance().GetPlayers();
     for (HashMapHolder<Player>::MapType::const_iterator iter = players.begin(); iter != players.end(); ++iter)
     {
@@ -35,6 +35,9 @@
 #include "AccountMgr.h"
 #include "WaypointManager.h"
 #include "CreatureGroups.h"
+#include "MoveMap.h"
+#include "LuaEngine.h"
+#include "WhoListCache.h"
 #include "Utilities/Util.h"
 #include <cctype>
 #include <iostream>
@@ -3688,6 +3691,174 @@ bool ChatHandler::HandleServerCorpsesCommand(const char* /*args*/)
     return true;
 }
 
+struct MapUpdateStatsOrder
+{
+    bool operator()(MapUpdateStats const& left, MapUpdateStats const& right) const
+    {
+        return left.avgTime > right.avgTime;
+    }
+};
+
+// Show the maps with the highest average update time
+bool ChatHandler::HandleServerMapStatsCommand(const char* args)
+{
+    uint32 count = 10;
+    if (*args)
+    {
+        count = (uint32)atoi(args);
+        if (!count)
+            return false;
+    }
+
+    std::vector<MapUpdateStats> stats;
+    MapManager::Instance().GetMapUpdateStats(stats);
+    std::sort(stats.begin(), stats.end(), MapUpdateStatsOrder());
+
+    if (stats.size() > count)
+        stats.resize(count);
+
+    PSendSysMessage("Map update times (avg / last / max, in ms), %u map updater threads:", sWorld.getConfig(CONFIG_NUMTHREADS));
+    for (std::vector<MapUpdateStats>::const_iterator itr = stats.begin(); itr != stats.end(); ++itr)
+    {
+        uint64 blocks = itr->blocksBuilt + itr->blocksReused;
+        PSendSysMessage("Map %u instance %u, %u players: %.2f / %.2f / %.2f, update blocks reused %.1f%%, LOS cached %.1f%%",
+                        itr->mapId, itr->instanceId, itr->players,
+                        itr->avgTime / 1000.0f, itr->lastTime / 1000.0f, itr->maxTime / 1000.0f,
+                        blocks ? itr->blocksReused * 100.0f / blocks : 0.0f,
+                        itr->losChecks ? itr->losCacheHits * 100.0f / itr->losChecks : 0.0f);
+    }
+
+    GridMapPrefetchStats prefetch;
+    MapManager::Instance().GetGridMapPrefetcher().GetStats(prefetch);
+    if (prefetch.requested)
+        PSendSysMessage("Grid prefetch: " UI64FMTD " hits, " UI64FMTD " misses, " UI64FMTD " unused, %u loading, %u ready",
+                        prefetch.hits, prefetch.misses, prefetch.wasted, prefetch.pending, prefetch.ready);
+
+    return true;
+}
+
+bool ChatHandler::HandleServerDBStatsCommand(const char* /*args*/)
+{
+    Database* databases[] = { &LoginDatabase, &WorldDatabase, &CharacterDatabase };
+    const char* names[] = { "Login", "World", "Character" };
+
+    for (uint8 i = 0; i < 3; ++i)
+    {
+        std::vector<SqlConnectionStats> stats;
+        databases[i]->GetConnectionStats(stats);
+
+        PSendSysMessage("%s database connections (queued, executed, avg / max in ms):", names[i]);
+        for (uint32 j = 0; j < stats.size(); ++j)
+        {
+            SqlConnectionStats const& conn = stats[j];
+            PSendSysMessage("#%u %s: %u, " UI64FMTD ", %.2f / %.2f", j, conn.async ? "async" : "sync",
+                            conn.queued, conn.executed,
+                            conn.executed ? conn.totalTime / 1000.0f / conn.executed : 0.0f, conn.maxTime / 1000.0f);
+        }
+    }
+
+    PlayerSaveStats saves;
+    Player::GetSaveStats(saves);
+    PSendSysMessage("Player saves: " UI64FMTD ", rows per save %.1f (max %u), bytes per save %.0f (max %u)", saves.saves,
+                    saves.saves ? float(saves.rows) / saves.saves : 0.0f, saves.maxRows,
+                    saves.saves ? float(saves.bytes) / saves.saves : 0.0f, saves.maxBytes);
+
+    return true;
+}
+
+// Show the pathfinding requests of every map and how many were served by the corridor cache
+bool ChatHandler::HandleServerPathStatsCommand(const char* /*args*/)
+{
+    std::vector<std::pair<uint32, MMAP::MMapPathStats> > stats;
+    MMAP::MMapFactory::createOrGetMMapManager()->GetPathStats(stats);
+
+    PSendSysMessage("Pathfinding (requests, cache hits, avg / total detour time in ms):");
+    for (std::vector<std::pair<uint32, MMAP::MMapPathStats> >::const_iterator itr = stats.begin(); itr != stats.end(); ++itr)
+    {
+        MMAP::MMapPathStats const& path = itr->second;
+        if (!path.requests)
+            continue;
+
+        PSendSysMessage("Map %u: " UI64FMTD ", %.1f%%, %.3f / %.1f", itr->first, path.requests,
+                        path.cacheHits * 100.0f / path.requests,
+                        path.detourTime / 1000.0f / path.requests, path.detourTime / 1000.0f);
+    }
+
+    return true;
+}
+
+// Show the hook time of every Lua state, how often its lock was contended
+// and how many of its hooks were skipped because another state fired them
+bool ChatHandler::HandleServerElunaStatsCommand(const char* /*args*/)
+{
+    std::vector<ElunaStateStats> stats;
+    Eluna::GetStateStats(stats);
+
+    PSendSysMessage("Lua states (hooks, hook time in ms, contended, wait time in ms, skipped):");
+    for (std::vector<ElunaStateStats>::const_iterator itr = stats.begin(); itr != stats.end(); ++itr)
+    {
+        if (itr->world)
+            PSendSysMessage("World: " UI64FMTD ", %.1f, " UI64FMTD ", %.1f, " UI64FMTD, itr->hooks,
+                            itr->hookTime / 1000.0f, itr->contended, itr->waitTime / 1000.0f, itr->skipped);
+        else
+            PSendSysMessage("Map %u instance %u: " UI64FMTD ", %.1f, " UI64FMTD ", %.1f, " UI64FMTD, itr->mapId, itr->instanceId,
+                            itr->hooks, itr->hookTime / 1000.0f, itr->contended, itr->waitTime / 1000.0f, itr->skipped);
+    }
+
+    return true;
+}
+
+// Show how many movement packets Movement.Batching saved
+bool ChatHandler::HandleServerMoveStatsCommand(const char* /*args*/)
+{
+    MovementBatchStats stats = WorldSession::GetMovementBatchStats();
+
+    PSendSysMessage("Movement batching is %s.", sWorld.getConfig(CONFIG_MOVEMENT_BATCHING) ? "enabled" : "disabled");
+    if (!stats.packets)
+        return true;
+
+    PSendSysMessage("Moves: " UI64FMTD " in " UI64FMTD " packets, " UI64FMTD " packets saved", stats.moves, stats.packets, stats.moves - stats.packets);
+    PSendSysMessage("Bytes: " UI64FMTD " batched, " UI64FMTD " sent (%.1f%%)", stats.bytesIn, stats.bytesOut,
+                    stats.bytesIn ? stats.bytesOut * 100.0f / stats.bytesIn : 0.0f);
+    return true;
+}
+
+// Show the age of the who list snapshot and how long /who queries take
+bool ChatHandler::HandleServerWhoStatsCommand(const char* /*args*/)
+{
+    WhoListStats stats = sWhoListCache.GetStats();
+
+    PSendSysMessage("Who list: %u players, built %u ms ago in %.3f ms", stats.players, stats.age, stats.buildTime / 1000.0f);
+    if (stats.queries)
+        PSendSysMessage("Queries: " UI64FMTD ", avg %.3f ms, max %.3f ms", stats.queries,
+                        stats.queryTime / 1000.0f / stats.queries, stats.maxQueryTime / 1000.0f);
+    return true;
+}
+
+namespace
+{
+    template<class T>
+    void SendGuidStats(ChatHandler* handler, char const* name)
+    {
+        HashMapHolderStats stats = HashMapHolder<T>::GetStats();
+        handler->PSendSysMessage("%s: " UI64FMTD ", " UI64FMTD " (" UI64FMTD "), " UI64FMTD " (" UI64FMTD ")", name,
+                                 stats.objects, stats.reads, stats.contendedReads, stats.writes, stats.contendedWrites);
+    }
+}
+
+// Show how busy the global guid storages are and how often their shards were contended
+bool ChatHandler::HandleServerGuidStatsCommand(const char* /*args*/)
+{
+    PSendSysMessage("Guid storages (objects, lookups (contended), inserts and removes (contended)):");
+    SendGuidStats<Player>(this, "Players");
+    SendGuidStats<Creature>(this, "Creatures");
+    SendGuidStats<Pet>(this, "Pets");
+    SendGuidStats<GameObject>(this, "GameObjects");
+    SendGuidStats<DynamicObject>(this, "DynamicObjects");
+    SendGuidStats<Corpse>(this, "Corpses");
+    return true;
+}
+
 bool ChatHandler::HandleRepairitemsCommand(const char* /*args*/)
 {
     Player* target = getSelectedPlayer();
@@ -149,7 +149,7 @@ void WorldSession::HandleAutostoreLootItemOpcode(WorldPacket& recv_data)
 
         player->SendNewItem(newitem, uint32(item->count), false, false, true);
 
-        sEluna->OnLootItem(player, newitem, item->count, lguid);
+        player->GetEluna()->OnLootItem(player, newitem, item->count, lguid);
     }
     else
         player->SendEquipError(msg, NULL, NULL);
@@ -248,7 +248,7 @@ void WorldSession::HandleLootMoneyOpcode(WorldPacket& /*recv_data*/)
 
                 (*i)->GetSession()->SendPacket(&data);
 
-                sEluna->OnLootMoney((*i), money_per_player);
+                (*i)->GetEluna()->OnLootMoney((*i), money_per_player);
             }
 
         }
@@ -256,7 +256,7 @@ void WorldSession::HandleLootMoneyOpcode(WorldPacket& /*recv_data*/)
         {
             player->ModifyMoney(pLoot->gold);
 
-            sEluna->OnLootMoney(player, pLoot->gold);
+            player->GetEluna()->OnLootMoney(player, pLoot->gold);
         }
 
         pLoot->gold = 0;
@@ -548,7 +548,7 @@ void WorldSession::HandleLootMasterGiveOpcode(WorldPacket& recv_data)
     Item* newitem = target->StoreNewItem(dest, item.itemid, true, item.randomPropertyId);
     target->SendNewItem(newitem, uint32(item.count), false, false, true);
 
-    sEluna->OnLootItem(target, newitem, item.count, lootguid);
+    target->GetEluna()->OnLootItem(target, newitem, item.count, lootguid);
 
     // mark as looted
     item.count = 0;
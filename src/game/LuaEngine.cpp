@@ -17,6 +17,7 @@
 #include <ace/ACE.h>
 #include <ace/Dirent.h>
 #include <ace/OS_NS_sys_stat.h>
+#include <ace/TSS_T.h>
 
 extern "C"
 {
@@ -35,17 +36,29 @@ std::string Eluna::lua_requirepath;
 Eluna* Eluna::GEluna = NULL;
 bool Eluna::reload = false;
 bool Eluna::initialized = false;
-Eluna::LockType Eluna::lock;
+bool Eluna::perMapStates = false;
+bool Eluna::scriptsLoaded = false;
+ACE_Atomic_Op<ACE_Thread_Mutex, long> Eluna::scriptsGeneration(0);
+Eluna::LockType Eluna::globalLock;
+Eluna::StateList Eluna::states;
+ACE_Thread_Mutex Eluna::statesLock;
+
+// Lua state whose hook the thread runs, set by the outermost Eluna::Guard
+static ACE_TSS<ACE_TSS_Type_Adapter<Eluna*> > currentState;
 
 extern void RegisterFunctions(Eluna* E);
 
 void Eluna::Initialize()
 {
-    LOCK_ELUNA;
+    LOCK_ELUNA_GLOBAL;
     ASSERT(!IsInitialized());
 
     LoadScriptPaths();
 
+    perMapStates = sConfig.GetBoolDefault("Eluna.PerMapStates", false);
+    if (perMapStates)
+        ELUNA_LOG_INFO("[Eluna]: Maps run the scripts in Lua states of their own");
+
     // Must be before creating GEluna
     // This is checked on Eluna creation
     initialized = true;
@@ -56,18 +69,37 @@ void Eluna::Initialize()
 
 void Eluna::Uninitialize()
 {
-    LOCK_ELUNA;
     ASSERT(IsInitialized());
 
     delete GEluna;
     GEluna = NULL;
 
+    LOCK_ELUNA_GLOBAL;
     lua_scripts.clear();
     lua_extensions.clear();
 
+    scriptsLoaded = false;
     initialized = false;
 }
 
+Eluna* Eluna::CreateMapState(Map* map)
+{
+    if (!perMapStates || !IsInitialized())
+        return NULL;
+
+    Eluna* E = new Eluna(map);
+
+    // maps created at startup run the scripts with the world state
+    if (scriptsLoaded)
+        E->RunScripts();
+    return E;
+}
+
+void Eluna::DestroyMapState(Eluna* E)
+{
+    delete E;
+}
+
 void Eluna::LoadScriptPaths()
 {
     uint32 oldMSTime = ElunaUtil::GetCurrTime();
@@ -93,30 +125,179 @@ void Eluna::LoadScriptPaths()
 
 void Eluna::_ReloadEluna()
 {
-    LOCK_ELUNA;
     ASSERT(IsInitialized());
 
     sWorld.SendServerMessage(SERVER_MSG_STRING, "Reloading Eluna...");
 
+    {
+        LOCK_ELUNA_GLOBAL;
+
+        // Reload script paths
+        LoadScriptPaths();
+
+        // map states reload at their next update
+        ++scriptsGeneration;
+        reload = false;
+    }
+
+    sEluna->ReloadState();
+}
+
+void Eluna::ReloadState()
+{
+    LOCK_ELUNA;
+
     // Remove all timed events
-    sEluna->eventMgr->SetStates(LUAEVENT_STATE_ERASE);
+    eventMgr->SetStates(LUAEVENT_STATE_ERASE);
 
     // Close lua
-    sEluna->CloseLua();
-
-    // Reload script paths
-    LoadScriptPaths();
+    CloseLua();
 
     // Open new lua and libaraies
-    sEluna->OpenLua();
+    OpenLua();
 
     // Run scripts from laoded paths
-    sEluna->RunScripts();
+    RunScripts();
+}
+
+Eluna::Guard::Guard(Eluna* _E) : E(_E)
+{
+    if (E->lock.tryacquire() == -1)
+    {
+        ACE_Time_Value waitStart = ACE_OS::gettimeofday();
+        E->lock.acquire();
+        ACE_Time_Value waited = ACE_OS::gettimeofday() - waitStart;
+
+        ++E->stats.contended;
+        E->stats.waitTime += uint64(waited.sec()) * 1000000 + waited.usec();
+    }
+
+    outermost = E->lock.get_nesting_level() == 1;
+    if (outermost)
+    {
+        start = ACE_OS::gettimeofday();
+        previous = *currentState;
+        *currentState = E;
+    }
+}
+
+Eluna::Guard::~Guard()
+{
+    if (outermost)
+    {
+        ACE_Time_Value held = ACE_OS::gettimeofday() - start;
+
+        ++E->stats.hooks;
+        E->stats.hookTime += uint64(held.sec()) * 1000000 + held.usec();
+
+        *currentState = previous;
+    }
 
-    reload = false;
+    E->lock.release();
+}
+
+Eluna* Eluna::GetCurrentState()
+{
+    return *currentState;
 }
 
-Eluna::Eluna() :
+static std::string DescribeState(Map const* owner)
+{
+    if (!owner)
+        return "the world state";
+
+    std::ostringstream ss;
+    ss << "the state of map " << owner->GetId() << " instance " << owner->GetInstanceId();
+    return ss.str();
+}
+
+void Eluna::SkipHook(const char* category, int event) const
+{
+    ++skippedHooks;
+    ELUNA_LOG_DEBUG("[Eluna]: Skipped %s event %d of %s, fired from a hook of %s", category, event,
+                    DescribeState(owner).c_str(), DescribeState(GetCurrentState()->owner).c_str());
+}
+
+void Eluna::UpdateMapState(uint32 diff)
+{
+    {
+        LOCK_ELUNA;
+        if (loadedGeneration != scriptsGeneration.value())
+            ReloadState();
+    }
+
+    DeliverStateMessages();
+
+    eventMgr->globalProcessor->Update(diff);
+}
+
+bool Eluna::SendStateMessage(Eluna* from, bool toWorld, uint32 mapId, uint32 instanceId, std::string const& channel, std::string const& data)
+{
+    ElunaStateMessage message;
+    message.fromWorld = !from->owner;
+    message.fromMapId = from->owner ? from->owner->GetId() : 0;
+    message.fromInstanceId = from->owner ? from->owner->GetInstanceId() : 0;
+    message.channel = channel;
+    message.data = data;
+
+    ACE_Guard<ACE_Thread_Mutex> guard(statesLock);
+
+    // without map states the world state receives everything
+    Eluna* target = NULL;
+    for (StateList::const_iterator itr = states.begin(); itr != states.end() && !target; ++itr)
+    {
+        Map* map = (*itr)->owner;
+        if (toWorld || !perMapStates)
+        {
+            if (!map)
+                target = *itr;
+        }
+        else if (map && map->GetId() == mapId && map->GetInstanceId() == instanceId)
+            target = *itr;
+    }
+
+    if (!target)
+        return false;
+
+    ACE_Guard<ACE_Thread_Mutex> messagesGuard(target->messagesLock);
+    target->messages.push_back(message);
+    return true;
+}
+
+void Eluna::DeliverStateMessages()
+{
+    std::list<ElunaStateMessage> received;
+    {
+        ACE_Guard<ACE_Thread_Mutex> guard(messagesLock);
+        if (messages.empty())
+            return;
+        received.swap(messages);
+    }
+
+    for (std::list<ElunaStateMessage>::const_iterator itr = received.begin(); itr != received.end(); ++itr)
+        OnStateMessage(*itr);
+}
+
+void Eluna::GetStateStats(std::vector<ElunaStateStats>& result)
+{
+    ACE_Guard<ACE_Thread_Mutex> guard(statesLock);
+    for (StateList::const_iterator itr = states.begin(); itr != states.end(); ++itr)
+    {
+        ElunaStateStats stats = (*itr)->stats;
+        stats.skipped = (*itr)->skippedHooks.value();
+        Map* map = (*itr)->owner;
+        stats.world = !map;
+        stats.mapId = map ? map->GetId() : 0;
+        stats.instanceId = map ? map->GetInstanceId() : 0;
+        result.push_back(stats);
+    }
+}
+
+Eluna::Eluna(Map* map) :
+owner(map),
+self(this),
+loadedGeneration(scriptsGeneration.value()),
+
 event_level(0),
 push_counter(0),
 enabled(false),
@@ -146,19 +327,29 @@ CreatureUniqueBindings(NULL)
 {
     ASSERT(IsInitialized());
 
+    memset(&stats, 0, sizeof(stats));
+
     OpenLua();
 
-    // Replace this with map insert if making multithread version
+    // Set event manager
+    eventMgr = new EventMgr(&self);
 
-    // Set event manager. Must be after setting sEluna
-    // on multithread have a map of state pointers and here insert this pointer to the map and then save a pointer of that pointer to the EventMgr
-    eventMgr = new EventMgr(&Eluna::GEluna);
+    ACE_Guard<ACE_Thread_Mutex> guard(statesLock);
+    if (map)
+        states.push_back(this);
+    else
+        states.push_front(this);
 }
 
 Eluna::~Eluna()
 {
     ASSERT(IsInitialized());
 
+    {
+        ACE_Guard<ACE_Thread_Mutex> guard(statesLock);
+        states.remove(this);
+    }
+
     CloseLua();
 
     delete eventMgr;
@@ -381,10 +572,14 @@ void Eluna::RunScripts()
     uint32 count = 0;
 
     ScriptList scripts;
-    lua_extensions.sort(ScriptPathComparator);
-    lua_scripts.sort(ScriptPathComparator);
-    scripts.insert(scripts.end(), lua_extensions.begin(), lua_extensions.end());
-    scripts.insert(scripts.end(), lua_scripts.begin(), lua_scripts.end());
+    {
+        LOCK_ELUNA_GLOBAL;
+        lua_extensions.sort(ScriptPathComparator);
+        lua_scripts.sort(ScriptPathComparator);
+        scripts.insert(scripts.end(), lua_extensions.begin(), lua_extensions.end());
+        scripts.insert(scripts.end(), lua_scripts.begin(), lua_scripts.end());
+        loadedGeneration = scriptsGeneration.value();
+    }
 
     std::unordered_map<std::string, std::string> loaded; // filename, path
 
@@ -444,9 +639,31 @@ void Eluna::RunScripts()
     }
     // Stack: package, modules
     lua_pop(L, 2);
-    ELUNA_LOG_INFO("[Eluna]: Executed %u Lua scripts in %u ms", count, ElunaUtil::GetTimeDiff(oldMSTime));
+    if (owner)
+    {
+        ELUNA_LOG_DEBUG("[Eluna]: Executed %u Lua scripts in %u ms for map %u instance %u", count, ElunaUtil::GetTimeDiff(oldMSTime), owner->GetId(), owner->GetInstanceId());
+    }
+    else
+    {
+        ELUNA_LOG_INFO("[Eluna]: Executed %u Lua scripts in %u ms", count, ElunaUtil::GetTimeDiff(oldMSTime));
+    }
 
     OnLuaStateOpen();
+
+    // the world state runs the scripts first, then the maps created before
+    if (!owner && !scriptsLoaded)
+    {
+        scriptsLoaded = true;
+
+        StateList mapStates;
+        {
+            ACE_Guard<ACE_Thread_Mutex> guard(statesLock);
+            mapStates.assign(++states.begin(), states.end());
+        }
+
+        for (StateList::const_iterator itr = mapStates.begin(); itr != mapStates.end(); ++itr)
+            (*itr)->RunScripts();
+    }
 }
 
 void Eluna::InvalidateObjects()
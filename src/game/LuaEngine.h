@@ -71,19 +71,84 @@ struct LuaScript
 };
 
 #define ELUNA_OBJECT_STORE  "Eluna Object Store"
-#define LOCK_ELUNA Eluna::Guard __guard(Eluna::GetLock())
+// locks the Lua state the hook runs in, see Eluna::Guard
+#define LOCK_ELUNA Eluna::Guard __guard(this)
+// locks the data shared by all Lua states
+#define LOCK_ELUNA_GLOBAL Eluna::GlobalGuard __guard(Eluna::GetGlobalLock())
+
+// Lock contention and hook time of a Lua state
+struct ElunaStateStats
+{
+    uint64 hooks;                                           // outermost lock acquisitions
+    uint64 hookTime;                                        // in microseconds, with the lock held
+    uint64 contended;                                       // acquisitions that had to wait for another thread
+    uint64 waitTime;                                        // in microseconds
+    uint64 skipped;                                         // hooks fired from a hook of another state
+
+    // Filled in by GetStateStats
+    bool world;
+    uint32 mapId;
+    uint32 instanceId;
+};
+
+// Message sent by SendStateMessage, delivered when the receiving state is updated
+struct ElunaStateMessage
+{
+    bool fromWorld;
+    uint32 fromMapId;
+    uint32 fromInstanceId;
+    std::string channel;
+    std::string data;
+};
 
 class Eluna
 {
 public:
     typedef std::list<LuaScript> ScriptList;
     typedef ACE_Recursive_Thread_Mutex LockType;
-    typedef ACE_Guard<LockType> Guard;
+    typedef ACE_Guard<LockType> GlobalGuard;
+    typedef std::list<Eluna*> StateList;
+
+    // Locks a Lua state, counting the time waited for and held by the outermost guard.
+    // The outermost guard also makes E the current state of the thread.
+    class Guard
+    {
+    public:
+        explicit Guard(Eluna* E);
+        ~Guard();
+
+    private:
+        Eluna* E;
+        Eluna* previous;
+        ACE_Time_Value start;
+        bool outermost;
+
+        Guard(Guard const&);
+        Guard& operator=(Guard const&);
+    };
 
 private:
     static bool reload;
     static bool initialized;
-    static LockType lock;
+    static bool perMapStates;
+    static bool scriptsLoaded;
+    static ACE_Atomic_Op<ACE_Thread_Mutex, long> scriptsGeneration; // changes when the script paths are reloaded
+    static LockType globalLock;
+
+    // All Lua states, the world one first
+    static StateList states;
+    static ACE_Thread_Mutex statesLock;
+
+    // Map running this state, NULL for the world state
+    Map* owner;
+    Eluna* self;                                            // for the global timed events
+    LockType lock;
+    ElunaStateStats stats;
+    mutable ACE_Atomic_Op<ACE_Thread_Mutex, uint64> skippedHooks; // counted without the lock
+    long loadedGeneration;
+
+    std::list<ElunaStateMessage> messages;
+    ACE_Thread_Mutex messagesLock;
 
     // Lua script locations
     static ScriptList lua_scripts;
@@ -105,7 +170,7 @@ private:
     // Map from map ID -> Lua table ref
     std::unordered_map<uint32, int> continentDataRefs;
 
-    Eluna();
+    explicit Eluna(Map* map = NULL);
     ~Eluna();
 
     // Prevent copy
@@ -122,6 +187,8 @@ private:
     // Use ReloadEluna() to make eluna reload
     // This is called on world update to reload eluna
     static void _ReloadEluna();
+    void ReloadState();
+    void DeliverStateMessages();
     static void LoadScriptPaths();
     static void GetScripts(std::string path);
     static void AddScriptPath(std::string filename, const std::string& fullpath);
@@ -199,10 +266,27 @@ public:
     static void Initialize();
     static void Uninitialize();
     // This function is used to make eluna reload
-    static void ReloadEluna() { LOCK_ELUNA; reload = true; }
-    static LockType& GetLock() { return lock; };
+    static void ReloadEluna() { LOCK_ELUNA_GLOBAL; reload = true; }
+    static LockType& GetGlobalLock() { return globalLock; };
     static bool IsInitialized() { return initialized; }
 
+    // Lua state of its own for the map when Eluna.PerMapStates is enabled, NULL otherwise
+    static Eluna* CreateMapState(Map* map);
+    static void DestroyMapState(Eluna* E);
+    static bool IsPerMapStates() { return perMapStates; }
+    Map* GetOwner() const { return owner; }
+    // State the calling thread runs a hook of, NULL if none
+    static Eluna* GetCurrentState();
+    // Packet hooks run in the state that sent the packet, the world state if none did
+    static Eluna* GetPacketState() { return GetCurrentState() ? GetCurrentState() : GEluna; }
+
+    // Map states only: reload if the world state did, deliver messages and run the timed events
+    void UpdateMapState(uint32 diff);
+
+    // Queues a message for the world state, or for the state of the given map if toWorld is false
+    static bool SendStateMessage(Eluna* from, bool toWorld, uint32 mapId, uint32 instanceId, std::string const& channel, std::string const& data);
+    static void GetStateStats(std::vector<ElunaStateStats>& result);
+
     // Static pushes, can be used by anything, including methods.
     static void Push(lua_State* luastate); // nil
     static void Push(lua_State* luastate, const long long);
@@ -254,6 +338,21 @@ public:
     void RunScripts();
     bool ShouldReload() const { return reload; }
     bool IsEnabled() const { return enabled && IsInitialized(); }
+    // Hooks of a state don't run while the thread runs a hook of another one: waiting for
+    // the second lock could deadlock with a thread going the other way. Scripts reach other
+    // states with SendStateMessage. Skipped hooks are counted and logged with their event.
+    bool CanRunHooks(const char* category, int event) const
+    {
+        if (!IsEnabled())
+            return false;
+
+        if (!GetCurrentState() || GetCurrentState() == this)
+            return true;
+
+        SkipHook(category, event);
+        return false;
+    }
+    void SkipHook(const char* category, int event) const;
     bool HasLuaState() const { return L != NULL; }
     int Register(lua_State* L, uint8 reg, uint32 entry, uint64 guid, uint32 instanceId, uint32 event_id, int functionRef, uint32 shots);
 
@@ -288,6 +387,7 @@ public:
     uint8 OnCanUseItem(const Player* pPlayer, uint32 itemEntry);
     void OnLuaStateClose();
     void OnLuaStateOpen();
+    void OnStateMessage(ElunaStateMessage const& message);
     bool OnAddonMessage(Player* sender, uint32 type, std::string& msg, Player* receiver, Guild* guild, Group* group, Channel* channel);
 
     /* Item */
@@ -345,6 +445,7 @@ public:
     void OnSpawn(GameObject* gameobject);
 
     /* Packet */
+    bool HasPacketSendHooks(uint16 opcode) const;
     bool OnPacketSend(WorldSession* session, WorldPacket& packet);
     void OnPacketSendAny(Player* player, WorldPacket& packet, bool& result);
     void OnPacketSendOne(Player* player, WorldPacket& packet, bool& result);
@@ -118,6 +118,7 @@ ElunaGlobal::ElunaRegister GlobalMethods[] =
     // Other
     { "ReloadEluna", &LuaGlobalFunctions::ReloadEluna },
     { "SendWorldMessage", &LuaGlobalFunctions::SendWorldMessage },
+    { "SendStateMessage", &LuaGlobalFunctions::SendStateMessage },
     { "WorldDBQuery", &LuaGlobalFunctions::WorldDBQuery },
     { "WorldDBExecute", &LuaGlobalFunctions::WorldDBExecute },
     { "CharDBQuery", &LuaGlobalFunctions::CharDBQuery },
@@ -27,10 +27,16 @@
 #include "Transports.h"
 #include "InstanceData.h"
 #include "ObjectAccessor.h"
+#include "Pet.h"
+#include "DynamicObject.h"
 #include "ObjectMgr.h"
 #include "DynamicTree.h"
 #include "MoveMap.h"
 #include "LuaEngine.h"
+#include "MapRegion.h"
+#include "MapUpdater.h"
+
+#include <ace/Mem_Map.h>
 
 #define DEFAULT_GRID_EXPIRY     300
 #define MAX_GRID_LOAD_TIME      50
@@ -40,7 +46,9 @@ GridState* si_GridStates[MAX_GRID_STATE];
 
 Map::~Map()
 {
-    sEluna->OnDestroy(this);
+    GetEluna()->OnDestroy(this);
+
+    delete m_regionUpdater;
 
     UnloadAll();
 
@@ -57,11 +65,24 @@ Map::~Map()
         sWorld.DecreaseScheduledScriptCount(m_scriptSchedule.size());
 
     if (Instanceable())
-        sEluna->FreeInstanceId(GetInstanceId());
+        GetEluna()->FreeInstanceId(GetInstanceId());
+
+    // after the objects, their timed events are in the state
+    Eluna::DestroyMapState(m_eluna);
 
     MMAP::MMapFactory::createOrGetMMapManager()->unloadMapInstance(GetId(), i_InstanceId);
 }
 
+Eluna* Map::GetEluna() const
+{
+    return m_eluna ? m_eluna : Eluna::GEluna;
+}
+
+Eluna** Map::GetElunaPtr()
+{
+    return m_eluna ? &m_eluna : &Eluna::GEluna;
+}
+
 bool Map::ExistMap(uint32 mapid, int gx, int gy)
 {
     int len = sWorld.GetDataPath().length() + strlen("maps/%03u%02u%02u.map") + 1;
@@ -131,6 +152,8 @@ void Map::LoadVMap(int gx, int gy)
     {
     case VMAP::VMAP_LOAD_RESULT_OK:
         sLog.outVMap("VMAP loaded name:%s, id:%d, x:%d, y:%d (vmap rep.: x:%d, y:%d)", GetMapName(), GetId(), gx, gy, gx, gy);
+        // rays through the new tile may be blocked now
+        InvalidateLineOfSightCache();
         break;
     case VMAP::VMAP_LOAD_RESULT_ERROR:
         sLog.outVMap("Could not load VMAP name:%s, id:%d, x:%d, y:%d (vmap rep.: x:%d, y:%d)", GetMapName(), GetId(), gx, gy, gx, gy);
@@ -160,6 +183,17 @@ void Map::LoadMap(int gx, int gy, bool reload)
     if (GridMaps[gx][gy] && !reload)
         return;
 
+    // read in advance by the prefetch threads, only needs to be attached
+    if (!reload)
+    {
+        if (GridMap* gridMap = MapManager::Instance().GetGridMapPrefetcher().Take(GetId(), gx, gy))
+        {
+            sLog.outDetail("Attaching prefetched map %03u%02u%02u", GetId(), gx, gy);
+            GridMaps[gx][gy] = gridMap;
+            return;
+        }
+    }
+
     //map already load, delete it before reloading (Is it necessary? Do we really need the ability the reload maps during runtime?)
     if (GridMaps[gx][gy])
     {
@@ -181,6 +215,36 @@ void Map::LoadMap(int gx, int gy, bool reload)
     delete [] tmp;
 }
 
+// Queue the terrain of the grids ahead of a moving player. Only base maps
+// own their grid maps, instances attach the ones of their parent.
+void Map::PrefetchGridMaps(float oldX, float oldY, float x, float y)
+{
+    if (i_InstanceId != 0 || !MapManager::Instance().GetGridMapPrefetcher().activated())
+        return;
+
+    float dx = x - oldX;
+    float dy = y - oldY;
+    float dist = sqrt(dx * dx + dy * dy);
+    if (dist < 0.1f)
+        return;
+
+    // half a grid and a whole grid ahead, enough for the fastest flying mounts
+    for (uint8 i = 1; i <= 2; ++i)
+    {
+        float px = x + dx / dist * SIZE_OF_GRIDS * i / 2;
+        float py = y + dy / dist * SIZE_OF_GRIDS * i / 2;
+        if (!Oregon::IsValidMapCoord(px, py))
+            break;
+
+        GridCoord p = Oregon::ComputeGridCoord(px, py);
+        int gx = (MAX_NUMBER_OF_GRIDS - 1) - p.x_coord;
+        int gy = (MAX_NUMBER_OF_GRIDS - 1) - p.y_coord;
+
+        if (!GridMaps[gx][gy])
+            MapManager::Instance().GetGridMapPrefetcher().Prefetch(GetId(), gx, gy);
+    }
+}
+
 void Map::LoadMapAndVMap(int gx, int gy)
 {
     LoadMap(gx, gy);
@@ -213,10 +277,28 @@ Map::Map(uint32 id, time_t expiry, uint32 InstanceId, uint8 SpawnMode, Map* _par
     m_unloadTimer(0), m_VisibleDistance(DEFAULT_VISIBILITY_DISTANCE),
     m_VisibilityNotifyPeriod(DEFAULT_VISIBILITY_NOTIFY_PERIOD),
     m_activeNonPlayersIter(m_activeNonPlayers.end()), i_gridExpiry(expiry),
-    i_scriptLock(false)
+    i_scriptLock(false), m_lastUpdateTime(0), m_avgUpdateTime(0), m_maxUpdateTime(0),
+    m_updateBlocksBuilt(0), m_updateBlocksReused(0),
+    m_losChecks(0), m_losCacheHits(0), m_losCacheGeneration(0), m_losCacheTimer(0),
+    m_eluna(NULL), m_regionUpdater(NULL), i_regionUpdate(false)
 {
     m_parentMap = (_parent ? _parent : this);
 
+    // the maps holding the instances of a map have no objects to script
+    if (_parent || !Instanceable())
+        m_eluna = Eluna::CreateMapState(this);
+
+    if (i_mapEntry && i_mapEntry->IsContinent() && sWorld.getConfig(CONFIG_MAPUPDATE_REGION_THREADS))
+    {
+        m_regionUpdater = new MapUpdater;
+        if (m_regionUpdater->activate(sWorld.getConfig(CONFIG_MAPUPDATE_REGION_THREADS)) == -1)
+        {
+            sLog.outError("Map %u: failed to start the region update threads, regions are updated by the map thread.", id);
+            delete m_regionUpdater;
+            m_regionUpdater = NULL;
+        }
+    }
+
     for (unsigned int idx = 0; idx < MAX_NUMBER_OF_GRIDS; ++idx)
     {
         for (unsigned int j = 0; j < MAX_NUMBER_OF_GRIDS; ++j)
@@ -230,7 +312,7 @@ Map::Map(uint32 id, time_t expiry, uint32 InstanceId, uint8 SpawnMode, Map* _par
     //lets initialize visibility distance for map
     Map::InitVisibilityDistance();
 
-    sEluna->OnCreate(this);
+    GetEluna()->OnCreate(this);
 }
 
 void Map::InitVisibilityDistance()
@@ -373,6 +455,8 @@ void Map::EnsureGridLoadedForActiveObject(const Cell &cell, WorldObject* object)
 //Create NGrid and load the object data in it
 bool Map::EnsureGridLoaded(const Cell& cell)
 {
+    ACE_GUARD_RETURN(ACE_Recursive_Thread_Mutex, guard, i_regionLock, false);
+
     EnsureGridCreated(GridCoord(cell.GridX(), cell.GridY()));
     NGridType* grid = getNGrid(cell.GridX(), cell.GridY());
 
@@ -427,8 +511,8 @@ bool Map::AddPlayerToMap(Player* player)
     player->m_clientGUIDs.clear();
     player->UpdateObjectVisibility(false);
 
-    sEluna->OnMapChanged(player);
-    sEluna->OnPlayerEnter(this, player);
+    GetEluna()->OnMapChanged(player);
+    GetEluna()->OnPlayerEnter(this, player);
 
     return true;
 }
@@ -436,6 +520,8 @@ bool Map::AddPlayerToMap(Player* player)
 template<class T>
 bool Map::AddToMap(T *obj)
 {
+    ACE_GUARD_RETURN(ACE_Recursive_Thread_Mutex, guard, i_regionLock, false);
+
     if (obj->IsInWorld()) // need some clean up later
     {
         ASSERT(obj->IsInGrid());
@@ -491,10 +577,9 @@ void Map::VisitNearbyCellsOf(WorldObject* obj, TypeContainerVisitor<Oregon::Obje
             // marked cells are those that have been visited
             // don't visit the same cell twice
             uint32 cell_id = (y * TOTAL_NUMBER_OF_CELLS_PER_MAP) + x;
-            if (isCellMarked(cell_id))
+            if (!MarkCellForUpdate(cell_id))
                 continue;
 
-            markCell(cell_id);
             CellCoord pair(x, y);
             Cell cell(pair);
             cell.SetNoCreate();
@@ -504,16 +589,194 @@ void Map::VisitNearbyCellsOf(WorldObject* obj, TypeContainerVisitor<Oregon::Obje
     }
 }
 
+void Map::VisitNearbyCellsOfOrDefer(WorldObject* obj, TypeContainerVisitor<Oregon::ObjectUpdater, GridTypeMapContainer> &gridVisitor, TypeContainerVisitor<Oregon::ObjectUpdater, WorldTypeMapContainer> &worldVisitor, MapRegion const* region)
+{
+    if (region)
+    {
+        GridCoord p = Oregon::ComputeGridCoord(obj->GetPositionX(), obj->GetPositionY());
+        if (MapRegionId(p.x_coord, p.y_coord) != region->id)
+        {
+            ACE_GUARD(ACE_Recursive_Thread_Mutex, guard, i_regionLock);
+            i_deferredVisits.push_back(obj->GetGUID());
+            return;
+        }
+    }
+
+    VisitNearbyCellsOf(obj, gridVisitor, worldVisitor);
+}
+
+bool Map::MarkCellForUpdate(uint32 cell_id)
+{
+    if (i_regionUpdate)
+    {
+        // regions updated at the same time can share words of the bitset
+        ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, i_markedCellsLock, false);
+        if (isCellMarked(cell_id))
+            return false;
+
+        markCell(cell_id);
+        return true;
+    }
+
+    if (isCellMarked(cell_id))
+        return false;
+
+    markCell(cell_id);
+    return true;
+}
+
 bool Map::IsGridLoaded(const GridCoord &p) const
 {
     return (getNGrid(p.x_coord, p.y_coord) && isGridObjectDataLoaded(p.x_coord, p.y_coord));
 }
 
+void Map::UpdatePlayer(Player* player, const uint32& t_diff, TypeContainerVisitor<Oregon::ObjectUpdater, GridTypeMapContainer> &grid_object_update, TypeContainerVisitor<Oregon::ObjectUpdater, WorldTypeMapContainer> &world_object_update, MapRegion const* region)
+{
+    // async queries of the player's update stay on the session's read worker
+    Database::KeyGuard dbKey(player->GetSession()->GetAccountId());
+
+    // handle map-affine packets of the player before updating him
+    if (sWorld.getConfig(CONFIG_MAPUPDATE_SESSION_PACKETS))
+    {
+        player->GetSession()->UpdateMap(this);
+
+        if (!player->IsInWorld())
+            return;
+    }
+
+    player->Update(t_diff);
+
+    VisitNearbyCellsOf(player, grid_object_update, world_object_update);
+
+    // If player is using far sight, visit that object too
+    if (WorldObject* viewPoint = player->GetViewpoint())
+    {
+        if (Creature* viewCreature = viewPoint->ToCreature())
+            VisitNearbyCellsOfOrDefer(viewCreature, grid_object_update, world_object_update, region);
+        else if (DynamicObject* viewObject = viewPoint->ToDynObject())
+            VisitNearbyCellsOfOrDefer(viewObject, grid_object_update, world_object_update, region);
+    }
+
+    // Handle updates for creatures in combat with player and are more than 60 yards away
+    if (player->IsInCombat())
+    {
+        std::vector<Creature*> updateList;
+        HostileReference* ref = player->getHostileRefManager().getFirst();
+
+        while (ref)
+        {
+            if (Unit* unit = ref->GetSource()->getOwner())
+                if (unit->ToCreature() && unit->GetMapId() == player->GetMapId() && !unit->IsWithinDistInMap(player, GetVisibilityRange(), false))
+                    updateList.push_back(unit->ToCreature());
+
+            ref = ref->next();
+        }
+
+        // Process deferred update list for player
+        for (Creature* c : updateList)
+            VisitNearbyCellsOfOrDefer(c, grid_object_update, world_object_update, region);
+    }
+}
+
+void Map::UpdateRegions(const uint32& t_diff, TypeContainerVisitor<Oregon::ObjectUpdater, GridTypeMapContainer> &grid_object_update, TypeContainerVisitor<Oregon::ObjectUpdater, WorldTypeMapContainer> &world_object_update)
+{
+    typedef std::map<uint32, MapRegion> RegionMap;
+    RegionMap regions;
+
+    for (MapRefManager::iterator itr = m_mapRefManager.begin(); itr != m_mapRefManager.end(); ++itr)
+    {
+        Player* player = itr->GetSource();
+        if (!player || !player->IsInWorld())
+            continue;
+
+        GridCoord p = Oregon::ComputeGridCoord(player->GetPositionX(), player->GetPositionY());
+        uint32 regionId = MapRegionId(p.x_coord, p.y_coord);
+
+        MapRegion& region = regions[regionId];
+        region.id = regionId;
+        region.players.push_back(player);
+    }
+
+    // regions of one color never share cells, update them together and
+    // go on with the next color once all of them are done
+    i_regionUpdate = true;
+    for (uint32 color = 0; color < MAP_REGION_COLORS; ++color)
+    {
+        for (RegionMap::iterator itr = regions.begin(); itr != regions.end(); ++itr)
+            if (MapRegionColor(itr->first) == color)
+                m_regionUpdater->schedule_update(*this, itr->second, t_diff);
+
+        m_regionUpdater->wait();
+    }
+    i_regionUpdate = false;
+
+    // merge phase
+    for (std::vector<DeferredRelocation>::const_iterator itr = i_deferredRelocations.begin(); itr != i_deferredRelocations.end(); ++itr)
+    {
+        Player* player = ObjectAccessor::FindPlayer(itr->guid);
+        if (player && player->IsInWorld() && player->GetMap() == this)
+            PlayerRelocation(player, itr->x, itr->y, itr->z, itr->orientation);
+    }
+    i_deferredRelocations.clear();
+
+    for (std::vector<uint64>::const_iterator itr = i_deferredVisits.begin(); itr != i_deferredVisits.end(); ++itr)
+    {
+        WorldObject* obj;
+        if (GUID_HIPART(*itr) == HIGHGUID_DYNAMICOBJECT)
+            obj = GetDynamicObject(*itr);
+        else
+            obj = GetCreature(*itr);
+
+        if (obj && obj->IsInWorld())
+            VisitNearbyCellsOf(obj, grid_object_update, world_object_update);
+    }
+    i_deferredVisits.clear();
+}
+
+void Map::UpdateRegion(MapRegion& region, const uint32& t_diff)
+{
+    Oregon::ObjectUpdater updater(t_diff);
+    TypeContainerVisitor<Oregon::ObjectUpdater, GridTypeMapContainer  > grid_object_update(updater);
+    TypeContainerVisitor<Oregon::ObjectUpdater, WorldTypeMapContainer > world_object_update(updater);
+
+    for (std::vector<Player*>::const_iterator itr = region.players.begin(); itr != region.players.end(); ++itr)
+    {
+        Player* player = *itr;
+        if (!player->IsInWorld() || player->GetMap() != this)
+            continue;
+
+        UpdatePlayer(player, t_diff, grid_object_update, world_object_update, &region);
+    }
+}
+
+void Map::TimedUpdate(const uint32& t_diff)
+{
+    ACE_Time_Value start = ACE_OS::gettimeofday();
+
+    Update(t_diff);
+
+    ACE_Time_Value elapsed = ACE_OS::gettimeofday() - start;
+    uint64 usec = uint64(elapsed.sec()) * 1000000 + elapsed.usec();
+    m_lastUpdateTime = usec > 0xFFFFFFFF ? 0xFFFFFFFF : uint32(usec);
+
+    m_avgUpdateTime = m_avgUpdateTime ? uint32((uint64(m_avgUpdateTime) * 7 + m_lastUpdateTime) / 8) : m_lastUpdateTime;
+    if (m_lastUpdateTime > m_maxUpdateTime)
+        m_maxUpdateTime = m_lastUpdateTime;
+}
+
 void Map::Update(const uint32& t_diff)
 {
     if (t_diff)
         m_dyn_tree.update(t_diff);
 
+    // line of sight results are only kept for a short while, units move on
+    m_losCacheTimer += t_diff;
+    if (m_losCacheTimer >= sWorld.getConfig(CONFIG_VMAP_LOS_CACHE_TIME))
+    {
+        m_losCacheTimer = 0;
+        InvalidateLineOfSightCache();
+    }
+
     // update active cells around players and active objects
     resetMarkedCells();
 
@@ -523,46 +786,20 @@ void Map::Update(const uint32& t_diff)
     // for pets
     TypeContainerVisitor<Oregon::ObjectUpdater, WorldTypeMapContainer > world_object_update(updater);
 
-    // the player iterator is stored in the map object
-    // to make sure calls to Map::RemoveFromMap don't invalidate it
-    for (m_mapRefIter = m_mapRefManager.begin(); m_mapRefIter != m_mapRefManager.end(); ++m_mapRefIter)
+    if (m_regionUpdater && m_mapRefManager.getSize() >= sWorld.getConfig(CONFIG_MAPUPDATE_REGION_MIN_PLAYERS))
+        UpdateRegions(t_diff, grid_object_update, world_object_update);
+    else
     {
-        Player* player = m_mapRefIter->GetSource();
-
-        if (!player || !player->IsInWorld())
-            continue;
-
-        player->Update(t_diff);
-
-        VisitNearbyCellsOf(player, grid_object_update, world_object_update);
-
-        // If player is using far sight, visit that object too
-        if (WorldObject* viewPoint = player->GetViewpoint())
-        {
-            if (Creature* viewCreature = viewPoint->ToCreature())
-                VisitNearbyCellsOf(viewCreature, grid_object_update, world_object_update);
-            else if (DynamicObject* viewObject = viewPoint->ToDynObject())
-                VisitNearbyCellsOf(viewObject, grid_object_update, world_object_update);
-        }
-
-        // Handle updates for creatures in combat with player and are more than 60 yards away
-        if (player->IsInCombat())
+        // the player iterator is stored in the map object
+        // to make sure calls to Map::RemoveFromMap don't invalidate it
+        for (m_mapRefIter = m_mapRefManager.begin(); m_mapRefIter != m_mapRefManager.end(); ++m_mapRefIter)
         {
-            std::vector<Creature*> updateList;
-            HostileReference* ref = player->getHostileRefManager().getFirst();
-
-            while (ref)
-            {
-                if (Unit* unit = ref->GetSource()->getOwner())
-                    if (unit->ToCreature() && unit->GetMapId() == player->GetMapId() && !unit->IsWithinDistInMap(player, GetVisibilityRange(), false))
-                        updateList.push_back(unit->ToCreature());
+            Player* player = m_mapRefIter->GetSource();
 
-                ref = ref->next();
-            }
+            if (!player || !player->IsInWorld())
+                continue;
 
-            // Process deferred update list for player
-            for (Creature* c : updateList)
-                VisitNearbyCellsOf(c, grid_object_update, world_object_update);
+            UpdatePlayer(player, t_diff, grid_object_update, world_object_update, NULL);
         }
     }
 
@@ -591,7 +828,42 @@ void Map::Update(const uint32& t_diff)
     if (!m_mapRefManager.isEmpty() || !m_activeNonPlayers.empty())
         ProcessRelocationNotifies(t_diff);
 
-    sEluna->OnUpdate(this, t_diff);
+    if (m_eluna)
+        m_eluna->UpdateMapState(t_diff);
+    GetEluna()->OnUpdate(this, t_diff);
+
+    SendObjectUpdates();
+
+    // movement batched during the update goes after the object updates
+    for (MapRefManager::iterator itr = m_mapRefManager.begin(); itr != m_mapRefManager.end(); ++itr)
+        if (Player* player = itr->GetSource())
+            player->GetSession()->SendMovementBatch(false);
+}
+
+void Map::SendObjectUpdates()
+{
+    UpdateDataMapType update_players;
+
+    // Critical section, other maps may still change our objects
+    {
+        ACE_GUARD(ACE_Thread_Mutex, guard, i_updateObjectsLock);
+
+        while (!i_updateObjects.empty())
+        {
+            Object* obj = *i_updateObjects.begin();
+            ASSERT(obj && obj->IsInWorld());
+            i_updateObjects.erase(i_updateObjects.begin());
+            obj->BuildUpdate(update_players);
+        }
+    }
+
+    WorldPacket packet;                                     // here we allocate a std::vector with a size of 0x10000
+    for (UpdateDataMapType::iterator iter = update_players.begin(); iter != update_players.end(); ++iter)
+    {
+        iter->second.BuildPacket(&packet);
+        iter->first->GetSession()->SendPacket(&packet);
+        packet.clear();                                     // clean the string
+    }
 }
 
 struct ResetNotifier
@@ -693,6 +965,12 @@ void Map::ProcessRelocationNotifies(const uint32& diff)
 
 void Map::RemovePlayerFromMap(Player* player, bool remove)
 {
+    // moves seen on this map mean nothing on the next one
+    player->GetSession()->ClearMovementBatch();
+
+    // far teleports remove the player from a region worker
+    ACE_GUARD(ACE_Recursive_Thread_Mutex, guard, i_regionLock);
+
     player->RemoveFromWorld();
     SendRemoveTransports(player);
 
@@ -710,7 +988,9 @@ template<class T>
 void Map::RemoveFromMap(T *obj, bool remove)
 {
     if (obj->ToPlayer());
-        sEluna->OnPlayerLeave(this, obj->ToPlayer());
+        GetEluna()->OnPlayerLeave(this, obj->ToPlayer());
+
+    ACE_GUARD(ACE_Recursive_Thread_Mutex, guard, i_regionLock);
 
     obj->RemoveFromWorld();
     if (obj->isActiveObject())
@@ -738,6 +1018,19 @@ Map::PlayerRelocation(Player* player, float x, float y, float z, float orientati
     Cell old_cell(player->GetPositionX(), player->GetPositionY());
     Cell new_cell(x, y);
 
+    if (old_cell.DiffGrid(new_cell) || old_cell.DiffCell(new_cell))
+        PrefetchGridMaps(player->GetPositionX(), player->GetPositionY(), x, y);
+
+    // moving to another grid may load it or leave the region, do it after the regions
+    if (i_regionUpdate && old_cell.DiffGrid(new_cell))
+    {
+        DeferredRelocation relocation = { player->GetGUID(), x, y, z, orientation };
+
+        ACE_GUARD(ACE_Recursive_Thread_Mutex, guard, i_regionLock);
+        i_deferredRelocations.push_back(relocation);
+        return;
+    }
+
     if (old_cell.DiffGrid(new_cell) || old_cell.DiffCell(new_cell))
     {
         DEBUG_LOG("Player %s relocation grid[%u,%u]cell[%u,%u]->grid[%u,%u]cell[%u,%u]", player->GetName(), old_cell.GridX(), old_cell.GridY(), old_cell.CellX(), old_cell.CellY(), new_cell.GridX(), new_cell.GridY(), new_cell.CellX(), new_cell.CellY());
@@ -789,6 +1082,7 @@ void Map::AddCreatureToMoveList(Creature* c, float x, float y, float z, float an
     if (!c)
         return;
 
+    ACE_GUARD(ACE_Recursive_Thread_Mutex, guard, i_regionLock);
     i_creaturesToMove[c] = CreatureMover(x, y, z, ang);
 }
 
@@ -1035,6 +1329,7 @@ void Map::UnloadAll()
 //*****************************
 GridMap::GridMap()
 {
+    m_mapping = NULL;
     m_flags = 0;
     // Area data
     m_gridArea = 0;
@@ -1066,6 +1361,9 @@ bool GridMap::loadData(const char* filename)
     // Unload old data if exist
     unloadData();
 
+    if (sWorld.getConfig(CONFIG_GRID_MEMORY_MAPPED) && mapData(filename))
+        return true;
+
     map_fileheader header;
     // Not return error if file not found
     FILE* in = fopen(filename, "rb");
@@ -1111,12 +1409,20 @@ bool GridMap::loadData(const char* filename)
 
 void GridMap::unloadData()
 {
-    delete[] m_area_map;
-    delete[] m_V9;
-    delete[] m_V8;
-    delete[] _liquidEntry;
-    delete[] _liquidFlags;
-    delete[] _liquidMap;
+    if (m_mapping)
+    {
+        delete m_mapping;
+        m_mapping = NULL;
+    }
+    else
+    {
+        delete[] m_area_map;
+        delete[] m_V9;
+        delete[] m_V8;
+        delete[] _liquidEntry;
+        delete[] _liquidFlags;
+        delete[] _liquidMap;
+    }
     m_area_map = NULL;
     m_V9 = NULL;
     m_V8 = NULL;
@@ -1224,6 +1530,135 @@ bool  GridMap::loadLiquidData(FILE* in, uint32 offset, uint32 /*size*/)
     return true;
 }
 
+// Returns a typed pointer to count elements at offset of a mapped file, NULL
+// if they don't fit in it or are not aligned. None of the types has members
+// larger than 4 bytes.
+template<class T>
+static T* GetMappedSection(uint8 const* data, size_t size, uint32 offset, size_t count)
+{
+    size_t align = sizeof(T) < 4 ? sizeof(T) : 4;
+    if (offset % align != 0 || offset > size || (size - offset) / sizeof(T) < count)
+        return NULL;
+
+    return reinterpret_cast<T*>(const_cast<uint8*>(data + offset));
+}
+
+// Uses the arrays of the file in place. Fails if the file is missing, invalid
+// or was written without aligning its sections, loadData then copies it.
+bool GridMap::mapData(const char* filename)
+{
+    ACE_Mem_Map* mapping = new ACE_Mem_Map();
+    if (mapping->map(filename, static_cast<size_t>(-1), O_RDONLY, ACE_DEFAULT_FILE_PERMS, PROT_READ, ACE_MAP_PRIVATE) == -1)
+    {
+        delete mapping;
+        return false;
+    }
+
+    // the pages stay mapped without the descriptor, don't keep one open per grid
+    mapping->close_handle();
+
+    // from here on unloadData releases the mapping
+    m_mapping = mapping;
+
+    uint8 const* data = static_cast<uint8 const*>(mapping->addr());
+    size_t size = mapping->size();
+
+    map_fileheader const* header = GetMappedSection<map_fileheader const>(data, size, 0, 1);
+    if (!header || header->mapMagic != uint32(MAP_MAGIC) || header->versionMagic != uint32(MAP_VERSION_MAGIC) ||
+        (header->areaMapOffset && !mapAreaData(data, size, header->areaMapOffset)) ||
+        (header->heightMapOffset && !mapHeightData(data, size, header->heightMapOffset)) ||
+        (header->liquidMapOffset && !mapLiquidData(data, size, header->liquidMapOffset)))
+    {
+        unloadData();
+        return false;
+    }
+
+    return true;
+}
+
+bool GridMap::mapAreaData(uint8 const* data, size_t size, uint32 offset)
+{
+    map_areaHeader const* header = GetMappedSection<map_areaHeader const>(data, size, offset, 1);
+    if (!header || header->fourcc != uint32(MAP_AREA_MAGIC))
+        return false;
+
+    m_gridArea = header->gridArea;
+    if (!(header->flags & MAP_AREA_NO_AREA))
+    {
+        m_area_map = GetMappedSection<uint16>(data, size, offset + sizeof(*header), 16 * 16);
+        if (!m_area_map)
+            return false;
+    }
+    return true;
+}
+
+bool GridMap::mapHeightData(uint8 const* data, size_t size, uint32 offset)
+{
+    map_heightHeader const* header = GetMappedSection<map_heightHeader const>(data, size, offset, 1);
+    if (!header || header->fourcc != uint32(MAP_HEIGHT_MAGIC))
+        return false;
+
+    m_gridHeight = header->gridHeight;
+    m_gridGetHeight = &GridMap::getHeightFromFlat;
+    if (header->flags & MAP_HEIGHT_NO_HEIGHT)
+        return true;
+
+    offset += sizeof(*header);
+    if ((header->flags & MAP_HEIGHT_AS_INT16))
+    {
+        m_uint16_V9 = GetMappedSection<uint16>(data, size, offset, 129 * 129);
+        m_uint16_V8 = GetMappedSection<uint16>(data, size, offset + 129 * 129 * sizeof(uint16), 128 * 128);
+        m_gridIntHeightMultiplier = (header->gridMaxHeight - header->gridHeight) / 65535;
+        m_gridGetHeight = &GridMap::getHeightFromUint16;
+    }
+    else if ((header->flags & MAP_HEIGHT_AS_INT8))
+    {
+        m_uint8_V9 = GetMappedSection<uint8>(data, size, offset, 129 * 129);
+        m_uint8_V8 = GetMappedSection<uint8>(data, size, offset + 129 * 129 * sizeof(uint8), 128 * 128);
+        m_gridIntHeightMultiplier = (header->gridMaxHeight - header->gridHeight) / 255;
+        m_gridGetHeight = &GridMap::getHeightFromUint8;
+    }
+    else
+    {
+        m_V9 = GetMappedSection<float>(data, size, offset, 129 * 129);
+        m_V8 = GetMappedSection<float>(data, size, offset + 129 * 129 * sizeof(float), 128 * 128);
+        m_gridGetHeight = &GridMap::getHeightFromFloat;
+    }
+
+    return m_V9 && m_V8;
+}
+
+bool GridMap::mapLiquidData(uint8 const* data, size_t size, uint32 offset)
+{
+    map_liquidHeader const* header = GetMappedSection<map_liquidHeader const>(data, size, offset, 1);
+    if (!header || header->fourcc != uint32(MAP_LIQUID_MAGIC))
+        return false;
+
+    m_liquidType   = header->liquidType;
+    m_liquid_offX  = header->offsetX;
+    m_liquid_offY  = header->offsetY;
+    m_liquid_width = header->width;
+    m_liquid_height = header->height;
+    m_liquidLevel  = header->liquidLevel;
+
+    offset += sizeof(*header);
+    if (!(header->flags & MAP_LIQUID_NO_TYPE))
+    {
+        _liquidEntry = GetMappedSection<uint16>(data, size, offset, 16 * 16);
+        _liquidFlags = GetMappedSection<uint8>(data, size, offset + 16 * 16 * sizeof(uint16), 16 * 16);
+        if (!_liquidEntry || !_liquidFlags)
+            return false;
+        offset += 16 * 16 * (sizeof(uint16) + sizeof(uint8));
+    }
+    if (!(header->flags & MAP_LIQUID_NO_HEIGHT))
+    {
+        _liquidMap = GetMappedSection<float>(data, size, offset, m_liquid_width * m_liquid_height);
+        if (!_liquidMap)
+            return false;
+    }
+    return true;
+}
+
 uint16 GridMap::getArea(float x, float y)
 {
     if (!m_area_map)
@@ -1826,8 +2261,102 @@ float Map::GetWaterLevel(float x, float y) const
 
 bool Map::isInLineOfSight(float x1, float y1, float z1, float x2, float y2, float z2) const
 {
-    return VMAP::VMapFactory::createOrGetVMapManager()->isInLineOfSight(GetId(), x1, y1, z1, x2, y2, z2)
-        && m_dyn_tree.isInLineOfSight(x1, y1, z1, x2, y2, z2);
+    VMAP::LineOfSightQuery query = { x1, y1, z1, x2, y2, z2, true };
+    isInLineOfSight(&query, 1);
+    return query.result;
+}
+
+uint64 Map::GetLineOfSightKey(VMAP::LineOfSightQuery const& query, int32* pos)
+{
+    float const coords[6] = { query.x1, query.y1, query.z1, query.x2, query.y2, query.z2 };
+
+    uint64 key = UI64LIT(14695981039346656037);
+    for (uint8 i = 0; i < 6; ++i)
+    {
+        pos[i] = int32(floor(coords[i] * LOS_CACHE_PRECISION));
+        key = (key ^ uint32(pos[i])) * UI64LIT(1099511628211);
+    }
+    return key;
+}
+
+void Map::isInLineOfSight(VMAP::LineOfSightQuery* queries, uint32 count) const
+{
+    if (!sWorld.getConfig(CONFIG_VMAP_LOS_CACHE_TIME))
+    {
+        VMAP::VMapFactory::createOrGetVMapManager()->isInLineOfSight(GetId(), queries, count);
+        m_dyn_tree.isInLineOfSight(queries, count);
+        return;
+    }
+
+    // the queries are handled in chunks, the ones not found in the cache are
+    // gathered and traced through the static and the dynamic tree together
+    VMAP::LineOfSightQuery misses[LOS_BATCH_SIZE];
+    uint32 missIndex[LOS_BATCH_SIZE];
+    uint64 missKey[LOS_BATCH_SIZE];
+    LineOfSightCacheEntry missEntry[LOS_BATCH_SIZE];
+
+    for (uint32 first = 0; first < count; first += LOS_BATCH_SIZE)
+    {
+        uint32 last = std::min<uint32>(count, first + LOS_BATCH_SIZE);
+        uint32 missCount = 0;
+        uint32 generation;
+
+        {
+            ACE_GUARD(ACE_Thread_Mutex, guard, m_losCacheLock);
+
+            generation = m_losCacheGeneration;
+            m_losChecks += last - first;
+            for (uint32 i = first; i < last; ++i)
+            {
+                LineOfSightCacheEntry& entry = missEntry[missCount];
+                uint64 key = GetLineOfSightKey(queries[i], entry.pos);
+
+                LineOfSightCache::const_iterator itr = m_losCache.find(key);
+                if (itr != m_losCache.end() && !memcmp(itr->second.pos, entry.pos, sizeof(entry.pos)))
+                {
+                    queries[i].result = itr->second.result;
+                    ++m_losCacheHits;
+                    continue;
+                }
+
+                misses[missCount] = queries[i];
+                missIndex[missCount] = i;
+                missKey[missCount] = key;
+                ++missCount;
+            }
+        }
+
+        if (!missCount)
+            continue;
+
+        VMAP::VMapFactory::createOrGetVMapManager()->isInLineOfSight(GetId(), misses, missCount);
+        m_dyn_tree.isInLineOfSight(misses, missCount);
+
+        for (uint32 i = 0; i < missCount; ++i)
+            queries[missIndex[i]].result = misses[i].result;
+
+        ACE_GUARD(ACE_Thread_Mutex, guard, m_losCacheLock);
+
+        // a gameobject changed while tracing, the results may already be stale
+        if (generation != m_losCacheGeneration)
+            continue;
+
+        if (m_losCache.size() + missCount > LOS_CACHE_MAX_ENTRIES)
+            m_losCache.clear();
+
+        for (uint32 i = 0; i < missCount; ++i)
+        {
+            missEntry[i].result = misses[i].result;
+            m_losCache[missKey[i]] = missEntry[i];
+        }
+    }
+}
+
+void Map::InvalidateLineOfSightCache()
+{
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_losCacheLock);
+    m_losCache.clear();
+    ++m_losCacheGeneration;
 }
 
 bool Map::getObjectHitPos(float x1, float y1, float z1, float x2, float y2, float z2, float& rx, float& ry, float& rz, float modifyDist)
@@ -2062,12 +2591,13 @@ void Map::AddObjectToRemoveList(WorldObject* obj)
     ASSERT(obj->GetMapId() == GetId() && obj->GetInstanceId() == GetInstanceId());
 
     if (Creature* creature = obj->ToCreature())
-        sEluna->OnRemove(creature);
+        GetEluna()->OnRemove(creature);
     else if (GameObject* gameobject = obj->ToGameObject())
-        sEluna->OnRemove(gameobject);
+        GetEluna()->OnRemove(gameobject);
 
     obj->CleanupsBeforeDelete();                            // remove or simplify at least cross referenced links
 
+    ACE_GUARD(ACE_Recursive_Thread_Mutex, guard, i_regionLock);
     i_objectsToRemove.insert(obj);
     //sLog.outMap("Object (GUID: %u TypeId: %u) added to removing list.",obj->GetGUIDLow(),obj->GetTypeId());
 }
@@ -2080,6 +2610,7 @@ void Map::AddObjectToSwitchList(WorldObject* obj, bool on)
     if (obj->GetTypeId() != TYPEID_UNIT)
         return;
 
+    ACE_GUARD(ACE_Recursive_Thread_Mutex, guard, i_regionLock);
     std::map<WorldObject*, bool>::iterator itr = i_objectsToSwitch.find(obj);
     if (itr == i_objectsToSwitch.end())
         i_objectsToSwitch.insert(itr, std::make_pair(obj, on));
@@ -2196,6 +2727,7 @@ bool Map::ActiveObjectsNearGrid(NGridType const& ngrid) const
 
 void Map::AddToActive(Creature* c)
 {
+    ACE_GUARD(ACE_Recursive_Thread_Mutex, guard, i_regionLock);
     AddToActiveHelper(c);
 
     // also not allow unloading spawn grid to prevent creating creature clone at load
@@ -2217,6 +2749,7 @@ void Map::AddToActive(Creature* c)
 
 void Map::RemoveFromActive(Creature* c)
 {
+    ACE_GUARD(ACE_Recursive_Thread_Mutex, guard, i_regionLock);
     RemoveFromActiveHelper(c);
 
     // also allow unloading spawn grid
@@ -2449,7 +2982,7 @@ void InstanceMap::CreateInstanceData(bool load)
     if (i_data != NULL)
         return;
 
-    i_data = sEluna->GetInstanceData(this);
+    i_data = GetEluna()->GetInstanceData(this);
 
     if (!i_data)
     {
@@ -2661,26 +3194,91 @@ void BattlegroundMap::RemoveAllPlayers()
 
 }
 
+template<> UNORDERED_MAP<uint64, Creature*>& Map::GetGuidStore<Creature>() { return i_creaturesByGuid; }
+template<> UNORDERED_MAP<uint64, Pet*>& Map::GetGuidStore<Pet>() { return i_petsByGuid; }
+template<> UNORDERED_MAP<uint64, GameObject*>& Map::GetGuidStore<GameObject>() { return i_gameObjectsByGuid; }
+template<> UNORDERED_MAP<uint64, DynamicObject*>& Map::GetGuidStore<DynamicObject>() { return i_dynObjectsByGuid; }
+
+template<class T>
+void Map::AddToGuidStore(T* obj)
+{
+    // out of region updates only the map thread touches the store
+    if (i_regionUpdate)
+    {
+        ACE_WRITE_GUARD(ACE_RW_Thread_Mutex, guard, i_guidStoreLock);
+        GetGuidStore<T>()[obj->GetGUID()] = obj;
+    }
+    else
+        GetGuidStore<T>()[obj->GetGUID()] = obj;
+}
+
+template<class T>
+void Map::RemoveFromGuidStore(T* obj)
+{
+    if (i_regionUpdate)
+    {
+        ACE_WRITE_GUARD(ACE_RW_Thread_Mutex, guard, i_guidStoreLock);
+        GetGuidStore<T>().erase(obj->GetGUID());
+    }
+    else
+        GetGuidStore<T>().erase(obj->GetGUID());
+}
+
+template<class T>
+T* Map::FindInGuidStore(uint64 guid)
+{
+    UNORDERED_MAP<uint64, T*>& store = GetGuidStore<T>();
+    if (i_regionUpdate)
+    {
+        ACE_READ_GUARD_RETURN(ACE_RW_Thread_Mutex, guard, i_guidStoreLock, NULL);
+        typename UNORDERED_MAP<uint64, T*>::const_iterator itr = store.find(guid);
+        return itr != store.end() ? itr->second : NULL;
+    }
+
+    typename UNORDERED_MAP<uint64, T*>::const_iterator itr = store.find(guid);
+    return itr != store.end() ? itr->second : NULL;
+}
+
+template void Map::AddToGuidStore(Creature*);
+template void Map::AddToGuidStore(Pet*);
+template void Map::AddToGuidStore(GameObject*);
+template void Map::AddToGuidStore(DynamicObject*);
+
+template void Map::RemoveFromGuidStore(Creature*);
+template void Map::RemoveFromGuidStore(Pet*);
+template void Map::RemoveFromGuidStore(GameObject*);
+template void Map::RemoveFromGuidStore(DynamicObject*);
+
 Creature*
 Map::GetCreature(uint64 guid)
 {
-    return ObjectAccessor::GetObjectInMap(guid, this, (Creature*)NULL);
+    return FindInGuidStore<Creature>(guid);
+}
+
+Pet*
+Map::GetPet(uint64 guid)
+{
+    return FindInGuidStore<Pet>(guid);
 }
 
 GameObject*
 Map::GetGameObject(uint64 guid)
 {
-    return ObjectAccessor::GetObjectInMap(guid, this, (GameObject*)NULL);
+    return FindInGuidStore<GameObject>(guid);
 }
 
 DynamicObject*
 Map::GetDynamicObject(uint64 guid)
 {
-    return ObjectAccessor::GetObjectInMap(guid, this, (DynamicObject*)NULL);
+    return FindInGuidStore<DynamicObject>(guid);
 }
 
 void Map::UpdateIteratorBack(Player* player)
 {
+    // the player list is only changed by the world thread, the regions are
+    // updated from a copy of it and must not see it change
+    ASSERT(!i_regionUpdate);
+
     if (m_mapRefIter == player->GetMapRef())
         m_mapRefIter = m_mapRefIter->nocheck_prev();
 }
@@ -22,6 +22,8 @@
 #include "Policies/ThreadingModel.h"
 #include "ace/RW_Thread_Mutex.h"
 #include "ace/Thread_Mutex.h"
+#include "ace/Recursive_Thread_Mutex.h"
+#include "ace/Guard_T.h"
 
 #include "DBCStructure.h"
 #include "GridDefines.h"
@@ -53,6 +55,10 @@ struct ScriptAction;
 struct Position;
 class Battleground;
 class InstanceMap;
+class MapUpdater;
+struct MapRegion;
+class ACE_Mem_Map;
+class Eluna;
 namespace Oregon { struct ObjectUpdater; }
 
 struct ScriptAction
@@ -154,6 +160,7 @@ struct LiquidData
 
 class GridMap
 {
+        ACE_Mem_Map* m_mapping;                             // the arrays point into it if set
         uint32  m_flags;
         // Area data
         uint16  m_gridArea;
@@ -188,6 +195,11 @@ class GridMap
         bool  loadHeightData(FILE* in, uint32 offset, uint32 size);
         bool  loadLiquidData(FILE* in, uint32 offset, uint32 size);
 
+        bool  mapData(const char* filename);
+        bool  mapAreaData(uint8 const* data, size_t size, uint32 offset);
+        bool  mapHeightData(uint8 const* data, size_t size, uint32 offset);
+        bool  mapLiquidData(uint8 const* data, size_t size, uint32 offset);
+
         // Get height functions and pointers
         typedef float (GridMap::*pGetHeightPtr) (float x, float y) const;
         pGetHeightPtr m_gridGetHeight;
@@ -261,6 +273,10 @@ typedef UNORDERED_MAP<Creature*, CreatureMover> CreatureMoveList;
 #define DEFAULT_HEIGHT_SEARCH     50.0f                     // default search distance to find height at nearby locations
 #define MIN_UNLOAD_DELAY      1                             // immediate unload
 
+#define LOS_CACHE_PRECISION       4.0f                      // line of sight endpoints are cached in quarters of a yard
+#define LOS_CACHE_MAX_ENTRIES     8192
+#define LOS_BATCH_SIZE            32                        // rays traced together by a batched line of sight check
+
 typedef std::map<uint32/*leaderDBGUID*/, CreatureGroup*>        CreatureGroupHolderType;
 
 class Map : public GridRefManager<NGridType>, public Oregon::ObjectLevelLockable<Map, ACE_Thread_Mutex>
@@ -288,6 +304,25 @@ class Map : public GridRefManager<NGridType>, public Oregon::ObjectLevelLockable
         void VisitNearbyCellsOf(WorldObject* obj, TypeContainerVisitor<Oregon::ObjectUpdater, GridTypeMapContainer> &gridVisitor, TypeContainerVisitor<Oregon::ObjectUpdater, WorldTypeMapContainer> &worldVisitor);
         virtual void Update(const uint32&);
 
+        // Update() wrapped in a wall clock measurement, used by the MapUpdater
+        void TimedUpdate(const uint32& t_diff);
+        // update the players of one region, called by the region MapUpdater
+        void UpdateRegion(MapRegion& region, const uint32& t_diff);
+
+        // update times in microseconds, average is a moving average over ~8 updates
+        uint32 GetLastUpdateTime() const { return m_lastUpdateTime; }
+        uint32 GetAverageUpdateTime() const { return m_avgUpdateTime; }
+        uint32 GetMaxUpdateTime() const { return m_maxUpdateTime; }
+
+        // values update blocks built for nearby players and reused by players of the same observer class
+        void AddUpdateBlockStats(uint32 built, uint32 reused) { m_updateBlocksBuilt += built; m_updateBlocksReused += reused; }
+        uint64 GetUpdateBlocksBuilt() const { return m_updateBlocksBuilt; }
+        uint64 GetUpdateBlocksReused() const { return m_updateBlocksReused; }
+
+        // line of sight checks and the ones answered by the cache
+        uint64 GetLineOfSightChecks() const { return m_losChecks; }
+        uint64 GetLineOfSightCacheHits() const { return m_losCacheHits; }
+
         float GetVisibilityRange() const { return m_VisibleDistance; }
 
         //function for setting up visibility distance for maps on per-type/per-Id basis
@@ -391,6 +426,10 @@ class Map : public GridRefManager<NGridType>, public Oregon::ObjectLevelLockable
         {
             return i_InstanceId;
         }
+
+        // Lua state running the hooks of this map, the world one unless Eluna.PerMapStates is enabled
+        Eluna* GetEluna() const;
+        Eluna** GetElunaPtr();
         uint8 GetSpawnMode() const
         {
             return (i_spawnMode);
@@ -478,10 +517,25 @@ class Map : public GridRefManager<NGridType>, public Oregon::ObjectLevelLockable
 
         void AddWorldObject(WorldObject* obj)
         {
+            ACE_GUARD(ACE_Recursive_Thread_Mutex, guard, i_regionLock);
             i_worldObjects.insert(obj);
         }
+
+        // objects with changed values, built and sent at the end of Map::Update
+        void AddUpdateObject(Object* obj)
+        {
+            ACE_GUARD(ACE_Thread_Mutex, guard, i_updateObjectsLock);
+            i_updateObjects.insert(obj);
+        }
+        void RemoveUpdateObject(Object* obj)
+        {
+            ACE_GUARD(ACE_Thread_Mutex, guard, i_updateObjectsLock);
+            i_updateObjects.erase(obj);
+        }
+        void SendObjectUpdates();
         void RemoveWorldObject(WorldObject* obj)
         {
+            ACE_GUARD(ACE_Recursive_Thread_Mutex, guard, i_regionLock);
             i_worldObjects.erase(obj);
         }
 
@@ -501,6 +555,7 @@ class Map : public GridRefManager<NGridType>, public Oregon::ObjectLevelLockable
         template<class T>
         void AddToActive(T* obj)
         {
+            ACE_GUARD(ACE_Recursive_Thread_Mutex, guard, i_regionLock);
             AddToActiveHelper(obj);
         }
 
@@ -510,6 +565,7 @@ class Map : public GridRefManager<NGridType>, public Oregon::ObjectLevelLockable
         template<class T>
         void RemoveFromActive(T* obj)
         {
+            ACE_GUARD(ACE_Recursive_Thread_Mutex, guard, i_regionLock);
             RemoveFromActiveHelper(obj);
         }
 
@@ -525,13 +581,22 @@ class Map : public GridRefManager<NGridType>, public Oregon::ObjectLevelLockable
 
         TempSummon* SummonCreature(uint32 entry, const Position& pos, SummonPropertiesEntry const* properties = NULL, uint32 duration = 0, Unit* summoner = NULL, uint32 spellId = 0, TempSummonType spwType = TEMPSUMMON_MANUAL_DESPAWN);
         Creature* GetCreature(uint64 guid);
+        Pet* GetPet(uint64 guid);
         GameObject* GetGameObject(uint64 guid);
         DynamicObject* GetDynamicObject(uint64 guid);
 
+        // map local guid lookup, kept by AddToWorld and RemoveFromWorld of the objects
+        template<class T> void AddToGuidStore(T* obj);
+        template<class T> void RemoveFromGuidStore(T* obj);
+
         bool isInLineOfSight(float x1, float y1, float z1, float x2, float y2, float z2) const;
+        // check many rays at once, the result of each is stored in the query
+        void isInLineOfSight(VMAP::LineOfSightQuery* queries, uint32 count) const;
+        // forget the cached line of sight results, needed when a gameobject model changes
+        void InvalidateLineOfSightCache();
         void Balance() { m_dyn_tree.balance(); }
-        void Remove(const GameObjectModel& mdl) { m_dyn_tree.remove(mdl); }
-        void Insert(const GameObjectModel& mdl) { m_dyn_tree.insert(mdl); }
+        void Remove(const GameObjectModel& mdl) { m_dyn_tree.remove(mdl); InvalidateLineOfSightCache(); }
+        void Insert(const GameObjectModel& mdl) { m_dyn_tree.insert(mdl); InvalidateLineOfSightCache(); }
         bool Contains(const GameObjectModel& mdl) const { return m_dyn_tree.contains(mdl);}
         bool getObjectHitPos(float x1, float y1, float z1, float x2, float y2, float z2, float& rx, float &ry, float& rz, float modifyDist);
     private:
@@ -539,6 +604,7 @@ class Map : public GridRefManager<NGridType>, public Oregon::ObjectLevelLockable
         void LoadVMap(int gx, int gy);
         void LoadMMap(int gx, int gy);
         void LoadMap(int gx, int gy, bool reload = false);
+        void PrefetchGridMaps(float oldX, float oldY, float x, float y);
         GridMap* GetGrid(float x, float y);
 
         void SetTimer(uint32 t)
@@ -636,10 +702,70 @@ class Map : public GridRefManager<NGridType>, public Oregon::ObjectLevelLockable
         //visibility calculations. Highly optimized for massive calculations
         void ProcessRelocationNotifies(const uint32& diff);
 
+        void UpdatePlayer(Player* player, const uint32& t_diff, TypeContainerVisitor<Oregon::ObjectUpdater, GridTypeMapContainer> &gridVisitor, TypeContainerVisitor<Oregon::ObjectUpdater, WorldTypeMapContainer> &worldVisitor, MapRegion const* region);
+        void VisitNearbyCellsOfOrDefer(WorldObject* obj, TypeContainerVisitor<Oregon::ObjectUpdater, GridTypeMapContainer> &gridVisitor, TypeContainerVisitor<Oregon::ObjectUpdater, WorldTypeMapContainer> &worldVisitor, MapRegion const* region);
+        bool MarkCellForUpdate(uint32 cell_id);
+
+        // checkerboard update of the players region by region on continents,
+        // see MapRegion.h. Work reaching out of the updated region is
+        // deferred and done by the map thread once all regions are updated.
+        void UpdateRegions(const uint32& t_diff, TypeContainerVisitor<Oregon::ObjectUpdater, GridTypeMapContainer> &gridVisitor, TypeContainerVisitor<Oregon::ObjectUpdater, WorldTypeMapContainer> &worldVisitor);
+
+        struct DeferredRelocation
+        {
+            uint64 guid;
+            float x, y, z, orientation;
+        };
+
+        Eluna* m_eluna;                                     // own Lua state, see Eluna::CreateMapState
+
+        MapUpdater* m_regionUpdater;
+        bool i_regionUpdate;                                // regions are being updated right now
+        ACE_Recursive_Thread_Mutex i_regionLock;            // map wide containers changed from the regions
+        ACE_Thread_Mutex i_markedCellsLock;
+        std::vector<DeferredRelocation> i_deferredRelocations;
+        std::vector<uint64> i_deferredVisits;
+
+        // objects in world by guid, so lookups from this map never need the
+        // global HashMapHolder storages
+        template<class T> UNORDERED_MAP<uint64, T*>& GetGuidStore();
+        template<class T> T* FindInGuidStore(uint64 guid);
+
+        UNORDERED_MAP<uint64, Creature*> i_creaturesByGuid;
+        UNORDERED_MAP<uint64, Pet*> i_petsByGuid;
+        UNORDERED_MAP<uint64, GameObject*> i_gameObjectsByGuid;
+        UNORDERED_MAP<uint64, DynamicObject*> i_dynObjectsByGuid;
+        ACE_RW_Thread_Mutex i_guidStoreLock;                // only taken while the regions are updated
+
         bool i_scriptLock;
         std::set<WorldObject*> i_objectsToRemove;
         std::map<WorldObject*, bool> i_objectsToSwitch;
         std::set<WorldObject*> i_worldObjects;
+        std::set<Object*> i_updateObjects;
+        ACE_Thread_Mutex i_updateObjectsLock;
+
+        uint32 m_lastUpdateTime;
+        uint32 m_avgUpdateTime;
+        uint32 m_maxUpdateTime;
+        uint64 m_updateBlocksBuilt;
+        uint64 m_updateBlocksReused;
+
+        // results of recent line of sight checks, keyed by the quantized endpoints
+        struct LineOfSightCacheEntry
+        {
+            int32 pos[6];
+            bool result;
+        };
+        typedef UNORDERED_MAP<uint64, LineOfSightCacheEntry> LineOfSightCache;
+
+        static uint64 GetLineOfSightKey(VMAP::LineOfSightQuery const& query, int32* pos);
+
+        mutable LineOfSightCache m_losCache;
+        mutable ACE_Thread_Mutex m_losCacheLock;
+        mutable uint64 m_losChecks;
+        mutable uint64 m_losCacheHits;
+        uint32 m_losCacheGeneration;                        // bumped on every invalidation
+        uint32 m_losCacheTimer;
         std::multimap<time_t, ScriptAction> m_scriptSchedule;
 
         // Type specific code for add/remove to/from grid
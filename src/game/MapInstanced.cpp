@@ -60,7 +60,7 @@ void MapInstanced::Update(const uint32& t)
             if (MapManager::Instance().GetMapUpdater()->activated())
                 MapManager::Instance().GetMapUpdater()->schedule_update(*i->second, t);
             else
-                i->second->Update(t);
+                i->second->TimedUpdate(t);
             ++i;
         }
     }
@@ -27,6 +27,8 @@
 #include "Corpse.h"
 #include "ObjectMgr.h"
 
+#include <algorithm>
+
 #define CLASS_LOCK Oregon::ClassLevelLockable<MapManager, ACE_Thread_Mutex>
 INSTANTIATE_SINGLETON_2(MapManager, CLASS_LOCK);
 INSTANTIATE_CLASS_MUTEX(MapManager, ACE_Thread_Mutex);
@@ -66,6 +68,10 @@ void MapManager::Initialize()
     if (num_threads > 0 && m_updater.activate(num_threads) == -1)
         abort();
 
+    if (uint32 prefetch_threads = sWorld.getConfig(CONFIG_GRID_PREFETCH_THREADS))
+        if (m_prefetcher.activate(prefetch_threads) == -1)
+            sLog.outError("MapManager: failed to start the grid prefetch threads, grids are loaded by the map threads.");
+
     InitMaxInstanceId();
 }
 
@@ -222,22 +228,41 @@ Map::EnterState MapManager::PlayerCannotEnter(uint32 mapid, Player* player, bool
         return Map::CANNOT_ENTER_UNSPECIFIED_REASON;
 }
 
+struct MapUpdateCostOrder
+{
+    bool operator()(Map const* left, Map const* right) const
+    {
+        return left->GetLastUpdateTime() > right->GetLastUpdateTime();
+    }
+};
+
 void MapManager::Update(time_t diff)
 {
     i_timer.Update(diff);
     if (!i_timer.Passed())
         return;
 
-    MapMapType::iterator iter = i_maps.begin();
-    for (; iter != i_maps.end(); ++iter)
-    {
-        if (m_updater.activated())
-            m_updater.schedule_update(*iter->second, i_timer.GetCurrent());
-        else
-            iter->second->Update(i_timer.GetCurrent());
-    }
+    MapMapType::iterator iter;
     if (m_updater.activated())
+    {
+        // start the most expensive maps first so they don't end up last on a worker
+        std::vector<Map*> maps;
+        maps.reserve(i_maps.size());
+        for (iter = i_maps.begin(); iter != i_maps.end(); ++iter)
+            maps.push_back(iter->second);
+
+        std::sort(maps.begin(), maps.end(), MapUpdateCostOrder());
+
+        for (std::vector<Map*>::iterator itr = maps.begin(); itr != maps.end(); ++itr)
+            m_updater.schedule_update(**itr, i_timer.GetCurrent());
+
         m_updater.wait();
+    }
+    else
+    {
+        for (iter = i_maps.begin(); iter != i_maps.end(); ++iter)
+            iter->second->TimedUpdate(i_timer.GetCurrent());
+    }
 
     for (iter = i_maps.begin(); iter != i_maps.end(); ++iter)
         iter->second->DelayedUpdate(uint32(i_timer.GetCurrent()));
@@ -282,6 +307,9 @@ void MapManager::UnloadAll()
 
     if (m_updater.activated())
         m_updater.deactivate();
+
+    if (m_prefetcher.activated())
+        m_prefetcher.deactivate();
 }
 
 void MapManager::InitMaxInstanceId()
@@ -328,3 +356,39 @@ uint32 MapManager::GetNumPlayersInInstances()
     return ret;
 }
 
+static void FillMapUpdateStats(Map* map, MapUpdateStats& stat)
+{
+    stat.mapId = map->GetId();
+    stat.instanceId = map->GetInstanceId();
+    stat.players = map->GetPlayers().getSize();
+    stat.lastTime = map->GetLastUpdateTime();
+    stat.avgTime = map->GetAverageUpdateTime();
+    stat.maxTime = map->GetMaxUpdateTime();
+    stat.blocksBuilt = map->GetUpdateBlocksBuilt();
+    stat.blocksReused = map->GetUpdateBlocksReused();
+    stat.losChecks = map->GetLineOfSightChecks();
+    stat.losCacheHits = map->GetLineOfSightCacheHits();
+}
+
+void MapManager::GetMapUpdateStats(std::vector<MapUpdateStats>& stats)
+{
+    Guard guard(*this);
+
+    MapUpdateStats stat;
+    for (MapMapType::iterator itr = i_maps.begin(); itr != i_maps.end(); ++itr)
+    {
+        Map* map = itr->second;
+        FillMapUpdateStats(map, stat);
+        stats.push_back(stat);
+
+        if (!map->Instanceable())
+            continue;
+
+        MapInstanced::InstancedMaps& maps = ((MapInstanced*)map)->GetInstancedMaps();
+        for (MapInstanced::InstancedMaps::iterator mitr = maps.begin(); mitr != maps.end(); ++mitr)
+        {
+            FillMapUpdateStats(mitr->second, stat);
+            stats.push_back(stat);
+        }
+    }
+}
@@ -25,9 +25,24 @@
 #include "Map.h"
 #include "GridStates.h"
 #include "MapUpdater.h"
+#include "GridMapPrefetcher.h"
 
 class Transport;
 
+struct MapUpdateStats
+{
+    uint32 mapId;
+    uint32 instanceId;
+    uint32 players;
+    uint32 lastTime;                                        // in microseconds
+    uint32 avgTime;
+    uint32 maxTime;
+    uint64 blocksBuilt;                                     // values update blocks built / reused from the cache
+    uint64 blocksReused;
+    uint64 losChecks;                                       // line of sight checks / answered by the cache
+    uint64 losCacheHits;
+};
+
 class MapManager : public Oregon::Singleton<MapManager, Oregon::ClassLevelLockable<MapManager, ACE_Thread_Mutex> >
 {
 
@@ -140,8 +155,10 @@ class MapManager : public Oregon::Singleton<MapManager, Oregon::ClassLevelLockab
         /* statistics */
         uint32 GetNumInstances();
         uint32 GetNumPlayersInInstances();
+        void GetMapUpdateStats(std::vector<MapUpdateStats>& stats);
 
         MapUpdater * GetMapUpdater() { return &m_updater; }
+        GridMapPrefetcher& GetGridMapPrefetcher() { return m_prefetcher; }
 
     private:
         // debugging code, should be deleted some day
@@ -169,6 +186,7 @@ class MapManager : public Oregon::Singleton<MapManager, Oregon::ClassLevelLockab
 
         uint32 i_MaxInstanceId;
         MapUpdater m_updater;
+        GridMapPrefetcher m_prefetcher;
 };
 #endif
 
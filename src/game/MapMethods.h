@@ -200,7 +200,7 @@ namespace LuaMap
                 Eluna::Push(L, map->GetCreature(guid));
                 break;
             case HIGHGUID_PET:
-                Eluna::Push(L, ObjectAccessor::GetObjectInMap(guid, map, (Pet*)NULL));
+                Eluna::Push(L, map->GetPet(guid));
                 break;
             case HIGHGUID_DYNAMICOBJECT:
                 Eluna::Push(L, map->GetDynamicObject(guid));
@@ -258,7 +258,7 @@ namespace LuaMap
         ElunaInstanceAI* iAI = dynamic_cast<ElunaInstanceAI*>(((InstanceMap*)map)->GetInstanceData());
 
         if (iAI)
-            sEluna->PushInstanceData(L, iAI, false);
+            E->PushInstanceData(L, iAI, false);
         else
             Eluna::Push(L); // nil
 
@@ -0,0 +1,53 @@
+/*
+ * This file is part of the OregonCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _MAP_REGION_H_INCLUDED
+#define _MAP_REGION_H_INCLUDED
+
+#include "GridDefines.h"
+#include "Platform/Define.h"
+
+#include <vector>
+
+class Player;
+
+// Regions are squares of MAP_REGION_SIZE x MAP_REGION_SIZE grids. Regions of
+// the same color are at least one whole region (4 grids, ~2133 yards) apart,
+// which is more than twice the largest grid activation range plus the reach
+// of the objects updated in it, so they never touch the same cells.
+#define MAP_REGION_SIZE             4
+#define MAP_REGIONS_PER_MAP         (MAX_NUMBER_OF_GRIDS / MAP_REGION_SIZE)
+#define MAP_REGION_COLORS           4
+
+struct MapRegion
+{
+    uint32 id;
+    std::vector<Player*> players;
+};
+
+inline uint32 MapRegionId(uint32 gridX, uint32 gridY)
+{
+    return (gridX / MAP_REGION_SIZE) * MAP_REGIONS_PER_MAP + gridY / MAP_REGION_SIZE;
+}
+
+// checkerboard coloring, regions of one color can be updated concurrently
+inline uint32 MapRegionColor(uint32 regionId)
+{
+    return ((regionId / MAP_REGIONS_PER_MAP) & 1) | ((regionId % MAP_REGIONS_PER_MAP & 1) << 1);
+}
+
+#endif //_MAP_REGION_H_INCLUDED
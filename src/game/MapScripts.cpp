@@ -53,14 +53,18 @@ void Map::ScriptsStart(ScriptMapMap const& scripts, uint32 id, Object* source, O
         sa.ownerGUID  = ownerGUID;
 
         sa.script = &iter->second;
-        m_scriptSchedule.insert(std::pair<time_t, ScriptAction>(time_t(sWorld.GetGameTime() + iter->first), sa));
+        {
+            ACE_GUARD(ACE_Recursive_Thread_Mutex, guard, i_regionLock);
+            m_scriptSchedule.insert(std::pair<time_t, ScriptAction>(time_t(sWorld.GetGameTime() + iter->first), sa));
+        }
         if (iter->first == 0)
             immedScript = true;
 
         sWorld.IncreaseScheduledScriptsCount();
     }
     // If one of the effects should be immediate, launch the script execution
-    if (/*start &&*/ immedScript && !i_scriptLock)
+    // (started from a region it runs with the other scripts once the regions are done)
+    if (/*start &&*/ immedScript && !i_scriptLock && !i_regionUpdate)
     {
         i_scriptLock = true;
         ScriptsProcess();
@@ -83,12 +87,15 @@ void Map::ScriptCommandStart(ScriptInfo const& script, uint32 delay, Object* sou
     sa.ownerGUID  = ownerGUID;
 
     sa.script = &script;
-    m_scriptSchedule.insert(std::pair<time_t, ScriptAction>(time_t(sWorld.GetGameTime() + delay), sa));
+    {
+        ACE_GUARD(ACE_Recursive_Thread_Mutex, guard, i_regionLock);
+        m_scriptSchedule.insert(std::pair<time_t, ScriptAction>(time_t(sWorld.GetGameTime() + delay), sa));
+    }
 
     sWorld.IncreaseScheduledScriptsCount();
 
     // If effects should be immediate, launch the script execution
-    if (delay == 0 && !i_scriptLock)
+    if (delay == 0 && !i_scriptLock && !i_regionUpdate)
     {
         i_scriptLock = true;
         ScriptsProcess();
@@ -16,76 +16,63 @@
  */
 
 #include "MapUpdater.h"
-#include "DelayExecutor.h"
 #include "Map.h"
+#include "MapRegion.h"
 #include "Database/DatabaseEnv.h"
 
 #include <ace/Guard_T.h>
-#include <ace/Method_Request.h>
+#include <ace/OS_NS_Thread.h>
 
-class WDBThreadStartReq1 : public ACE_Method_Request
+MapUpdater::MapUpdater()
+    : m_workCondition(m_workMutex), m_queuedRequests(0), m_shutdown(false),
+      m_condition(m_mutex), pending_requests(0), m_activated(false)
 {
-    public:
-
-        WDBThreadStartReq1()
-        {
-        }
-
-        virtual int call()
-        {
-            WorldDatabase.ThreadStart();
-            return 0;
-        }
-};
+}
 
-class WDBThreadEndReq1 : public ACE_Method_Request
+MapUpdater::~MapUpdater()
 {
-    public:
-
-        WDBThreadEndReq1()
-        {
-        }
-
-        virtual int call()
-        {
-            WorldDatabase.ThreadEnd();
-            return 0;
-        }
-};
+    deactivate();
+}
 
-class MapUpdateRequest : public ACE_Method_Request
+int MapUpdater::activate(size_t num_threads)
 {
-    private:
+    if (m_activated || num_threads < 1)
+        return -1;
 
-        Map& m_map;
-        MapUpdater& m_updater;
-        ACE_UINT32 m_diff;
+    for (size_t i = 0; i < num_threads; ++i)
+        m_queues.push_back(new WorkerQueue);
 
-    public:
+    m_shutdown = false;
 
-        MapUpdateRequest(Map& m, MapUpdater& u, ACE_UINT32 d)
-            : m_map(m), m_updater(u), m_diff(d)
-        {
-        }
-
-        virtual int call()
-        {
-            m_map.Update (m_diff);
-            m_updater.update_finished();
-            return 0;
-        }
-};
+    if (ACE_Task_Base::activate(THR_NEW_LWP | THR_JOINABLE | THR_INHERIT_SCHED, int(num_threads)) == -1)
+        return -1;
 
-int MapUpdater::activate(size_t num_threads)
-{
-    return m_executor.activate((int)num_threads, new WDBThreadStartReq1, new WDBThreadEndReq1);
+    m_activated = true;
+    return 0;
 }
 
 int MapUpdater::deactivate()
 {
+    if (!m_activated)
+        return -1;
+
     wait();
 
-    return m_executor.deactivate();
+    {
+        ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_workMutex, -1);
+        m_shutdown = true;
+        m_workCondition.broadcast();
+    }
+
+    ACE_Task_Base::wait();
+
+    for (size_t i = 0; i < m_queues.size(); ++i)
+        delete m_queues[i];
+
+    m_queues.clear();
+    m_workers.clear();
+    m_activated = false;
+    return 0;
 }
 
 int MapUpdater::wait()
@@ -100,16 +87,65 @@ int MapUpdater::wait()
 
 int MapUpdater::schedule_update(Map& map, ACE_UINT32 diff)
 {
-    ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_mutex, -1);
+    UpdateRequest request;
+    request.map = &map;
+    request.region = NULL;
+    request.diff = diff;
+    request.cost = map.GetLastUpdateTime();
 
-    ++pending_requests;
+    return queue_request(request);
+}
 
-    if (m_executor.execute(new MapUpdateRequest(map, *this, diff)) == -1)
-    {
-        ACE_DEBUG((LM_ERROR, ACE_TEXT("(%t) \n"), ACE_TEXT("Failed to schedule Map Update")));
+int MapUpdater::schedule_update(Map& map, MapRegion& region, ACE_UINT32 diff)
+{
+    UpdateRequest request;
+    request.map = &map;
+    request.region = &region;
+    request.diff = diff;
+    // regions are not timed, start the busiest ones first
+    request.cost = uint32(region.players.size());
+
+    return queue_request(request);
+}
 
-        --pending_requests;
+int MapUpdater::queue_request(UpdateRequest const& request)
+{
+    if (!m_activated)
         return -1;
+
+    {
+        ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_mutex, -1);
+        ++pending_requests;
+    }
+
+    // nested updates (instances of a MapInstanced) stay with the scheduling
+    // worker, anything else goes to the worker with the least queued work
+    int worker = current_worker();
+    if (worker < 0)
+    {
+        worker = 0;
+        for (size_t i = 1; i < m_queues.size(); ++i)
+            if (m_queues[i]->cost.value() < m_queues[worker]->cost.value())
+                worker = int(i);
+    }
+
+    {
+        WorkerQueue& queue = *m_queues[worker];
+        ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, queue.lock, -1);
+
+        std::deque<UpdateRequest>::iterator itr = queue.requests.begin();
+        while (itr != queue.requests.end() && itr->cost >= request.cost)
+            ++itr;
+
+        queue.requests.insert(itr, request);
+        queue.cost += request.cost;
+        ++queue.size;
+    }
+
+    {
+        ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_workMutex, -1);
+        ++m_queuedRequests;
+        m_workCondition.signal();
     }
 
     return 0;
@@ -117,7 +153,103 @@ int MapUpdater::schedule_update(Map& map, ACE_UINT32 diff)
 
 bool MapUpdater::activated()
 {
-    return m_executor.activated();
+    return m_activated;
+}
+
+int MapUpdater::current_worker()
+{
+    ACE_thread_t self = ACE_OS::thr_self();
+
+    ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_workMutex, -1);
+    for (size_t i = 0; i < m_workers.size(); ++i)
+        if (ACE_OS::thr_equal(m_workers[i], self))
+            return int(i);
+
+    return -1;
+}
+
+// Pop the most expensive map of our own queue, or steal the most expensive
+// one from the queue with the most work left
+bool MapUpdater::take_request(size_t worker, UpdateRequest& request)
+{
+    size_t victim = worker;
+    {
+        WorkerQueue& queue = *m_queues[worker];
+        ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, queue.lock, false);
+        if (queue.requests.empty())
+        {
+            victim = m_queues.size();
+            uint64 victimCost = 0;
+            for (size_t i = 0; i < m_queues.size(); ++i)
+            {
+                // size and cost are only hints here, the victim is locked below
+                if (i == worker || !m_queues[i]->size.value())
+                    continue;
+
+                uint64 cost = m_queues[i]->cost.value();
+                if (victim == m_queues.size() || cost > victimCost)
+                {
+                    victim = i;
+                    victimCost = cost;
+                }
+            }
+
+            if (victim == m_queues.size())
+                return false;
+        }
+    }
+
+    WorkerQueue& queue = *m_queues[victim];
+    ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, queue.lock, false);
+    if (queue.requests.empty())
+        return false;
+
+    request = queue.requests.front();
+    queue.requests.pop_front();
+    queue.cost -= request.cost;
+    --queue.size;
+    return true;
+}
+
+int MapUpdater::svc()
+{
+    WorldDatabase.ThreadStart();
+
+    size_t worker;
+    {
+        ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_workMutex, -1);
+        worker = m_workers.size();
+        m_workers.push_back(ACE_OS::thr_self());
+    }
+
+    for (;;)
+    {
+        // reserve one of the queued requests, it stays in some queue until we find it
+        {
+            ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_workMutex, -1);
+
+            while (!m_queuedRequests && !m_shutdown)
+                m_workCondition.wait();
+
+            if (!m_queuedRequests)
+                break;
+
+            --m_queuedRequests;
+        }
+
+        UpdateRequest request;
+        while (!take_request(worker, request))
+            ACE_OS::thr_yield();
+
+        if (request.region)
+            request.map->UpdateRegion(*request.region, request.diff);
+        else
+            request.map->TimedUpdate(request.diff);
+        update_finished();
+    }
+
+    WorldDatabase.ThreadEnd();
+    return 0;
 }
 
 void MapUpdater::update_finished()
@@ -14,27 +14,44 @@
  * You should have received a copy of the GNU General Public License along
  * with this program. If not, see <http://www.gnu.org/licenses/>.
  */
-
 #ifndef _MAP_UPDATER_H_INCLUDED
 #define _MAP_UPDATER_H_INCLUDED
 
+#include <ace/Task.h>
 #include <ace/Thread_Mutex.h>
 #include <ace/Condition_Thread_Mutex.h>
+#include <ace/Atomic_Op.h>
+
+#include <deque>
+#include <vector>
 
-#include "DelayExecutor.h"
+#include "Platform/Define.h"
 
 class Map;
+struct MapRegion;
 
-class MapUpdater
+/**
+ * Runs map updates on a pool of worker threads.
+ *
+ * Every worker owns a queue kept ordered by the last measured update time of
+ * its maps, so the most expensive maps start first. New maps go to the worker
+ * with the least queued work (or to the scheduling worker itself for nested
+ * instance updates) and a worker that runs out of maps steals the most
+ * expensive one from the busiest queue.
+ *
+ * Continents with region updates own an updater of their own for the
+ * regions of their players, see Map::UpdateRegions, so waiting for the
+ * regions of one map never waits for another map.
+ */
+class MapUpdater : protected ACE_Task_Base
 {
     public:
 
-        MapUpdater() : m_executor(), m_condition(m_mutex), m_mutex(), pending_requests(0) {}
-        ~MapUpdater() { };
-
-        friend class MapUpdateRequest;
+        MapUpdater();
+        ~MapUpdater() override;
 
         int schedule_update(Map& map, ACE_UINT32 diff);
+        int schedule_update(Map& map, MapRegion& region, ACE_UINT32 diff);
 
         int wait();
 
@@ -44,14 +61,50 @@ class MapUpdater
 
         bool activated();
 
+        int svc() override;
+
     private:
 
-        DelayExecutor m_executor;
-        ACE_Condition_Thread_Mutex m_condition;
+        struct UpdateRequest
+        {
+            Map* map;
+            MapRegion* region;                              // NULL for the update of the whole map
+            ACE_UINT32 diff;
+            uint32 cost;                                    // last update time of the map, in microseconds
+        };
+
+        struct WorkerQueue
+        {
+            WorkerQueue() : cost(0), size(0) {}
+
+            ACE_Thread_Mutex lock;
+            std::deque<UpdateRequest> requests;             // most expensive first
+
+            // changed under the lock, read without it by the other workers
+            ACE_Atomic_Op<ACE_Thread_Mutex, unsigned long> cost; // sum of the queued costs
+            ACE_Atomic_Op<ACE_Thread_Mutex, long> size;     // queued requests
+        };
+
+        int queue_request(UpdateRequest const& request);
+        int current_worker();
+        bool take_request(size_t worker, UpdateRequest& request);
+        void update_finished();
+
+        std::vector<WorkerQueue*> m_queues;
+        std::vector<ACE_thread_t> m_workers;
+
+        // worker wakeup, counts queued requests nobody reserved yet
+        ACE_Thread_Mutex m_workMutex;
+        ACE_Condition_Thread_Mutex m_workCondition;
+        size_t m_queuedRequests;
+        bool m_shutdown;
+
+        // wait() for the scheduled requests to finish
         ACE_Thread_Mutex m_mutex;
+        ACE_Condition_Thread_Mutex m_condition;
         size_t pending_requests;
 
-        void update_finished();
+        bool m_activated;
 };
 
 #endif //_MAP_UPDATER_H_INCLUDED
@@ -21,9 +21,24 @@
 
 #include "MoveMap.h"
 #include "MoveMapSharedDefines.h"
+#include "Threading.h"
+
+#include <ace/TSS_T.h>
 
 namespace MMAP
 {
+// queries of the calling thread by [mapId, instanceId], looked up without MMapData::lock
+struct NavMeshQueryLookup
+{
+    NavMeshQueryLookup() : generation(0) {}
+
+    long generation;                    // MMapManager::queryGeneration when filled
+    UNORDERED_MAP<uint64, dtNavMeshQuery*> queries;
+};
+
+typedef ACE_TSS<NavMeshQueryLookup> NavMeshQueryLookupTSS;
+static NavMeshQueryLookupTSS navMeshQueryLookup;
+
 // ######################## MMapFactory ########################
 // our global singelton copy
 MMapManager* g_MMapManager = NULL;
@@ -240,6 +255,7 @@ bool MMapManager::loadMap(uint32 mapId, int32 x, int32 y)
     if (dtStatusSucceed(mmap->navMesh->addTile(data, fileHeader.size, DT_TILE_FREE_DATA, 0, &tileRef)))
     {
         mmap->mmapLoadedTiles.insert(std::pair<uint32, dtTileRef>(packedGridPos, tileRef));
+        mmap->pathCache.Clear();                            // a shorter way may exist now
         ++loadedTiles;
         sLog.outDetail("MMAP:loadMap: Loaded mmtile %03i[%02i,%02i] into %03i[%02i,%02i]", mapId, x, y, mapId, header->x, header->y);
         return true;
@@ -288,6 +304,7 @@ bool MMapManager::unloadMap(uint32 mapId, int32 x, int32 y)
     else
     {
         mmap->mmapLoadedTiles.erase(packedGridPos);
+        mmap->pathCache.Clear();
         --loadedTiles;
         sLog.outDetail("MMAP:unloadMap: Unloaded mmtile %03i[%02i,%02i] from %03i", mapId, x, y, mapId);
         return true;
@@ -323,6 +340,7 @@ bool MMapManager::unloadMap(uint32 mapId)
 
     delete mmap;
     itr->second = nullptr;
+    ++queryGeneration;
     sLog.outDetail("MMAP:unloadMap: Unloaded %03i.mmap", mapId);
 
     return true;
@@ -340,16 +358,22 @@ bool MMapManager::unloadMapInstance(uint32 mapId, uint32 instanceId)
     }
 
     MMapData* mmap = itr->second;
-    if (mmap->navMeshQueries.find(instanceId) == mmap->navMeshQueries.end())
+    ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, mmap->lock, false);
+
+    // queries of all the threads that updated the instance
+    NavMeshQuerySet::iterator i = mmap->navMeshQueries.lower_bound(std::make_pair(instanceId, ACE_thread_t()));
+    if (i == mmap->navMeshQueries.end() || i->first.first != instanceId)
     {
         sLog.outMMap("MMAP:unloadMapInstance: Asked to unload not loaded dtNavMeshQuery mapId %03u instanceId %u", mapId, instanceId);
         return false;
     }
 
-    dtNavMeshQuery* query = mmap->navMeshQueries[instanceId];
-
-    dtFreeNavMeshQuery(query);
-    mmap->navMeshQueries.erase(instanceId);
+    while (i != mmap->navMeshQueries.end() && i->first.first == instanceId)
+    {
+        dtFreeNavMeshQuery(i->second);
+        mmap->navMeshQueries.erase(i++);
+    }
+    ++queryGeneration;
     sLog.outDetail("MMAP:unloadMapInstance: Unloaded mapId %03u instanceId %u", mapId, instanceId);
 
     return true;
@@ -370,23 +394,143 @@ dtNavMeshQuery const* MMapManager::GetNavMeshQuery(uint32 mapId, uint32 instance
     if (itr == loadedMMaps.end())
         return NULL;
 
+    NavMeshQueryLookup* lookup = navMeshQueryLookup;
+    long generation = queryGeneration.value();
+    if (lookup->generation != generation)
+    {
+        lookup->queries.clear();
+        lookup->generation = generation;
+    }
+
+    uint64 lookupKey = MAKE_PAIR64(mapId, instanceId);
+    UNORDERED_MAP<uint64, dtNavMeshQuery*>::const_iterator known = lookup->queries.find(lookupKey);
+    if (known != lookup->queries.end())
+        return known->second;
+
     MMapData* mmap = itr->second;
-    if (mmap->navMeshQueries.find(instanceId) == mmap->navMeshQueries.end())
+    ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, mmap->lock, NULL);
+
+    std::pair<uint32, ACE_thread_t> key(instanceId, ACE_Based::Thread::currentId());
+    NavMeshQuerySet::iterator query = mmap->navMeshQueries.find(key);
+    if (query == mmap->navMeshQueries.end())
     {
         // allocate mesh query
-        dtNavMeshQuery* query = dtAllocNavMeshQuery();
-        ASSERT(query);
-        if (dtStatusFailed(query->init(mmap->navMesh, 1024)))
+        dtNavMeshQuery* newQuery = dtAllocNavMeshQuery();
+        ASSERT(newQuery);
+        if (dtStatusFailed(newQuery->init(mmap->navMesh, 1024)))
         {
-            dtFreeNavMeshQuery(query);
+            dtFreeNavMeshQuery(newQuery);
             sLog.outError("MMAP:GetNavMeshQuery: Failed to initialize dtNavMeshQuery for mapId %03u instanceId %u", mapId, instanceId);
             return NULL;
         }
 
         sLog.outDetail("MMAP:GetNavMeshQuery: created dtNavMeshQuery for mapId %03u instanceId %u", mapId, instanceId);
-        mmap->navMeshQueries.insert(std::pair<uint32, dtNavMeshQuery*>(instanceId, query));
+        query = mmap->navMeshQueries.insert(NavMeshQuerySet::value_type(key, newQuery)).first;
+    }
+
+    lookup->queries[lookupKey] = query->second;
+    return query->second;
+}
+
+NavMeshPathCache* MMapManager::GetPathCache(uint32 mapId)
+{
+    MMapDataSet::const_iterator itr = GetMMapData(mapId);
+    if (itr == loadedMMaps.end())
+        return NULL;
+
+    return &itr->second->pathCache;
+}
+
+void MMapManager::AddPathStats(uint32 mapId, uint32 cacheHits, uint64 detourTime)
+{
+    MMapDataSet::const_iterator itr = GetMMapData(mapId);
+    if (itr == loadedMMaps.end())
+        return;
+
+    MMapData* mmap = itr->second;
+    ++mmap->pathRequests;
+    mmap->pathCacheHits += cacheHits;
+    mmap->pathDetourTime += detourTime;
+}
+
+void MMapManager::GetPathStats(std::vector<std::pair<uint32, MMapPathStats> >& stats)
+{
+    for (MMapDataSet::const_iterator itr = loadedMMaps.begin(); itr != loadedMMaps.end(); ++itr)
+    {
+        MMapData* mmap = itr->second;
+        if (!mmap || !mmap->pathRequests.value())
+            continue;
+
+        MMapPathStats path;
+        path.requests = mmap->pathRequests.value();
+        path.cacheHits = mmap->pathCacheHits.value();
+        path.detourTime = mmap->pathDetourTime.value();
+        stats.push_back(std::make_pair(itr->first, path));
+    }
+}
+
+// ######################## NavMeshPathCache ########################
+bool NavMeshPathCache::Find(dtNavMesh const* navMesh, dtPolyRef startPoly, dtPolyRef endPoly, dtQueryFilter const& filter,
+                            dtPolyRef* path, uint32& length, uint32 maxLength)
+{
+    uint32 flags = (uint32(filter.getExcludeFlags()) << 16) | filter.getIncludeFlags();
+
+    ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_lock, false);
+
+    EntryIndex::iterator itr = m_index.find(MakeKey(startPoly, endPoly, flags));
+    if (itr == m_index.end())
+        return false;
+
+    Entry& entry = *itr->second;
+    if (entry.startPoly != startPoly || entry.endPoly != endPoly || entry.flags != flags || entry.path.size() > maxLength)
+        return false;
+
+    for (uint32 i = 0; i < entry.path.size(); ++i)
+        if (!navMesh->isValidPolyRef(entry.path[i]))
+            return false;
+
+    std::copy(entry.path.begin(), entry.path.end(), path);
+    length = entry.path.size();
+
+    m_entries.splice(m_entries.begin(), m_entries, itr->second);
+    return true;
+}
+
+void NavMeshPathCache::Store(dtPolyRef startPoly, dtPolyRef endPoly, dtQueryFilter const& filter, dtPolyRef const* path, uint32 length)
+{
+    uint32 flags = (uint32(filter.getExcludeFlags()) << 16) | filter.getIncludeFlags();
+    uint64 key = MakeKey(startPoly, endPoly, flags);
+
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_lock);
+
+    EntryIndex::iterator itr = m_index.find(key);
+    if (itr != m_index.end())
+    {
+        m_entries.erase(itr->second);
+        m_index.erase(itr);
     }
+    else if (m_entries.size() >= m_capacity)
+    {
+        m_index.erase(m_entries.back().key);
+        m_entries.pop_back();
+    }
+
+    Entry entry;
+    entry.key = key;
+    entry.startPoly = startPoly;
+    entry.endPoly = endPoly;
+    entry.flags = flags;
+    entry.path.assign(path, path + length);
+
+    m_entries.push_front(entry);
+    m_index[key] = m_entries.begin();
+}
+
+void NavMeshPathCache::Clear()
+{
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_lock);
 
-    return mmap->navMeshQueries[instanceId];
+    m_entries.clear();
+    m_index.clear();
 }
 }
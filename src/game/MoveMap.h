@@ -19,8 +19,14 @@
 #define _MOVE_MAP_H
 
 #include <vector>
+#include <list>
+#include <map>
 #include "Utilities/UnorderedMap.h"
 
+#include <ace/Thread.h>
+#include <ace/Thread_Mutex.h>
+#include <ace/Atomic_Op.h>
+
 #include "DetourAlloc.h"
 #include "DetourNavMesh.h"
 #include "DetourNavMeshQuery.h"
@@ -39,13 +45,62 @@ inline void dtCustomFree(void* ptr)
 //  move map related classes
 namespace MMAP
 {
+// poly corridors kept per map
+#define MMAP_PATH_CACHE_SIZE    512
+
 typedef UNORDERED_MAP<uint32, dtTileRef> MMapTileSet;
-typedef UNORDERED_MAP<uint32, dtNavMeshQuery*> NavMeshQuerySet;
+typedef std::map<std::pair<uint32, ACE_thread_t>, dtNavMeshQuery*> NavMeshQuerySet;
+
+// pathfinding counters of one map, summed over its instances
+struct MMapPathStats
+{
+    uint64 requests;                    // paths built on the navmesh
+    uint64 cacheHits;                   // corridors taken from the cache instead of findPath
+    uint64 detourTime;                  // in microseconds
+};
+
+// LRU cache of the poly corridors found between two polygons, shared by the
+// instances of a map. It is emptied whenever a tile is added or removed, and
+// corridors holding refs that are no longer valid are never returned.
+class NavMeshPathCache
+{
+    public:
+        explicit NavMeshPathCache(uint32 capacity) : m_capacity(capacity) {}
+
+        bool Find(dtNavMesh const* navMesh, dtPolyRef startPoly, dtPolyRef endPoly, dtQueryFilter const& filter,
+                  dtPolyRef* path, uint32& length, uint32 maxLength);
+        void Store(dtPolyRef startPoly, dtPolyRef endPoly, dtQueryFilter const& filter, dtPolyRef const* path, uint32 length);
+        void Clear();
+
+    private:
+        struct Entry
+        {
+            uint64 key;
+            dtPolyRef startPoly;
+            dtPolyRef endPoly;
+            uint32 flags;                   // include and exclude flags of the filter
+            std::vector<dtPolyRef> path;
+        };
+
+        typedef std::list<Entry> EntryList;
+        typedef UNORDERED_MAP<uint64, EntryList::iterator> EntryIndex;
+
+        static uint64 MakeKey(dtPolyRef startPoly, dtPolyRef endPoly, uint32 flags)
+        {
+            return (uint64(startPoly) * UI64LIT(0x9E3779B97F4A7C15)) ^ (uint64(endPoly) << 16) ^ flags;
+        }
+
+        uint32 m_capacity;
+        EntryList m_entries;                // most recently used first
+        EntryIndex m_index;
+        ACE_Thread_Mutex m_lock;
+};
 
 // dummy struct to hold map's mmap data
 struct MMapData
 {
-    MMapData(dtNavMesh* mesh) : navMesh(mesh) {}
+    MMapData(dtNavMesh* mesh) : navMesh(mesh), pathCache(MMAP_PATH_CACHE_SIZE),
+        pathRequests(0), pathCacheHits(0), pathDetourTime(0) {}
     ~MMapData()
     {
         for (NavMeshQuerySet::iterator i = navMeshQueries.begin(); i != navMeshQueries.end(); ++i)
@@ -57,9 +112,17 @@ struct MMapData
 
     dtNavMesh* navMesh;
 
-    // we have to use single dtNavMeshQuery for every instance, since those are not thread safe
-    NavMeshQuerySet navMeshQueries;     // instanceId to query
+    // dtNavMeshQuery is not thread safe, every thread updating an instance gets its own
+    NavMeshQuerySet navMeshQueries;     // [instanceId, thread] to query
     MMapTileSet mmapLoadedTiles;        // maps [map grid coords] to [dtTile]
+
+    NavMeshPathCache pathCache;
+    ACE_Thread_Mutex lock;              // guards navMeshQueries
+
+    // MMapPathStats, counted by all the map threads without the lock
+    ACE_Atomic_Op<ACE_Thread_Mutex, unsigned long> pathRequests;
+    ACE_Atomic_Op<ACE_Thread_Mutex, unsigned long> pathCacheHits;
+    ACE_Atomic_Op<ACE_Thread_Mutex, unsigned long> pathDetourTime;
 };
 
 
@@ -70,7 +133,7 @@ typedef UNORDERED_MAP<uint32, MMapData*> MMapDataSet;
 class MMapManager
 {
     public:
-        MMapManager() : loadedTiles(0), thread_safe_environment(true) {}
+        MMapManager() : loadedTiles(0), thread_safe_environment(true), queryGeneration(0) {}
         ~MMapManager();
 
         void InitializeThreadUnsafe(const std::vector<uint32>& mapIds);
@@ -79,9 +142,13 @@ class MMapManager
         bool unloadMap(uint32 mapId);
         bool unloadMapInstance(uint32 mapId, uint32 instanceId);
 
-        // the returned [dtNavMeshQuery const*] is NOT threadsafe
+        // the returned [dtNavMeshQuery const*] belongs to the calling thread, don't share it
         dtNavMeshQuery const* GetNavMeshQuery(uint32 mapId, uint32 instanceId);
         dtNavMesh const* GetNavMesh(uint32 mapId);
+        NavMeshPathCache* GetPathCache(uint32 mapId);
+
+        void AddPathStats(uint32 mapId, uint32 cacheHits, uint64 detourTime);
+        void GetPathStats(std::vector<std::pair<uint32, MMapPathStats> >& stats);
 
         uint32 getLoadedTilesCount() const
         {
@@ -99,6 +166,8 @@ class MMapManager
         MMapDataSet loadedMMaps;
         uint32 loadedTiles;
         bool thread_safe_environment;
+        // bumped whenever queries are freed, the per-thread lookups of GetNavMeshQuery are dropped then
+        ACE_Atomic_Op<ACE_Thread_Mutex, long> queryGeneration;
 };
 
 // static class
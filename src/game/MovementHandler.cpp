@@ -350,9 +350,9 @@ void WorldSession::HandleMovementOpcodes(WorldPacket& recv_data)
     data << mover->GetPackGUID();
     data.append(recv_data.contents(), recv_data.size());
     if (mover->isCharmed() && mover->GetCharmer())
-        mover->GetCharmer()->SendMessageToSet(&data, false);
+        mover->GetCharmer()->SendMovementMessageToSet(&data);
     else
-        mover->SendMessageToSet(&data, false);
+        mover->SendMovementMessageToSet(&data);
 
     mover->m_movementInfo = movementInfo;
     mover->SetPosition(movementInfo.pos);
@@ -42,6 +42,18 @@
 #include "LuaEngine.h"
 #include "ElunaEventMgr.h"
 
+// values update blocks of one object, by observer class
+struct UpdateBlockCache
+{
+    typedef std::map<uint32, ByteBuffer> BlockMap;
+
+    UpdateBlockCache() : built(0), reused(0) {}
+
+    BlockMap blocks;
+    uint32 built;
+    uint32 reused;
+};
+
 uint32 GuidHigh2TypeId(uint32 guid_hi)
 {
     switch (guid_hi)
@@ -229,6 +241,13 @@ void Object::BuildValuesUpdateBlockForPlayer(UpdateData* data, Player* target) c
 {
     ByteBuffer buf(500);
 
+    _BuildValuesUpdateBlock(buf, target);
+
+    data->AddUpdateBlock(buf);
+}
+
+void Object::_BuildValuesUpdateBlock(ByteBuffer& buf, Player* target) const
+{
     buf << (uint8) UPDATETYPE_VALUES;
     //buf << GetPackGUID();                                 //client crashes when using this. but not have crash in debug mode
     buf << (uint8)0xFF;
@@ -239,8 +258,77 @@ void Object::BuildValuesUpdateBlockForPlayer(UpdateData* data, Player* target) c
 
     _SetUpdateBits(&updateMask, target);
     _BuildValuesUpdate(UPDATETYPE_VALUES, &buf, &updateMask, target);
+}
 
-    data->AddUpdateBlock(buf);
+// Everything _SetUpdateBits and _BuildValuesUpdate look at in the target when
+// building a values update. Players of the same observer class get the same
+// block, so it is built once and copied to all of them.
+enum UpdateObserverClass
+{
+    UPDATE_OBSERVER_SELF        = 0x001,
+    UPDATE_OBSERVER_GM          = 0x002,
+    UPDATE_OBSERVER_QUEST       = 0x004,                    // gameobject activated for quest
+    UPDATE_OBSERVER_HEALTH      = 0x008,                    // real health revealed
+    UPDATE_OBSERVER_LOOTER      = 0x010,
+    UPDATE_OBSERVER_TAPPER      = 0x020,
+    UPDATE_OBSERVER_RAF         = 0x040,
+    UPDATE_OBSERVER_GROUP       = 0x080,
+    UPDATE_OBSERVER_UNCACHED    = 0x100                     // gets a faction of its own, build separately
+};
+
+uint32 Object::_GetUpdateObserverClass(Player* target) const
+{
+    uint32 observer = 0;
+
+    if (target == this)
+        observer |= UPDATE_OBSERVER_SELF;
+
+    if (target->IsGameMaster())
+        observer |= UPDATE_OBSERVER_GM;
+
+    // only the changed fields are sent, so only they split the observers
+    if (isType(TYPEMASK_GAMEOBJECT))
+    {
+        if (!((GameObject*)this)->IsTransport() && ((GameObject*)this)->ActivateToQuest(target))
+            observer |= UPDATE_OBSERVER_QUEST;
+    }
+    else if (isType(TYPEMASK_UNIT))
+    {
+        if ((_IsValueChanged(UNIT_FIELD_HEALTH) || _IsValueChanged(UNIT_FIELD_MAXHEALTH)) &&
+            ((Unit const*)this)->ShouldRevealHealthTo(target))
+            observer |= UPDATE_OBSERVER_HEALTH;
+
+        if (GetTypeId() == TYPEID_UNIT)
+        {
+            if (_IsValueChanged(UNIT_DYNAMIC_FLAGS))
+            {
+                if (target->isAllowedToLoot(ToCreature()))
+                    observer |= UPDATE_OBSERVER_LOOTER;
+                if (ToCreature()->isTappedBy(target))
+                    observer |= UPDATE_OBSERVER_TAPPER;
+            }
+        }
+        else if (target != this)
+        {
+            Player const* player = ToPlayer();
+
+            if (_IsValueChanged(UNIT_DYNAMIC_FLAGS) && sObjectMgr.GetRAFLinkStatus(target, player) != RAF_LINK_NONE)
+                observer |= UPDATE_OBSERVER_RAF;
+
+            if ((_IsValueChanged(UNIT_FIELD_BYTES_2) || _IsValueChanged(UNIT_FIELD_FACTIONTEMPLATE)) &&
+                (target->IsInSameGroupWith(player) || target->IsInSameRaidWith(player)))
+            {
+                observer |= UPDATE_OBSERVER_GROUP;
+
+                FactionTemplateEntry const* ft1 = player->GetFactionTemplateEntry();
+                FactionTemplateEntry const* ft2 = target->GetFactionTemplateEntry();
+                if (_IsValueChanged(UNIT_FIELD_FACTIONTEMPLATE) && ft1 && ft2 && !ft1->IsFriendlyTo(*ft2))
+                    observer |= UPDATE_OBSERVER_UNCACHED;
+            }
+        }
+    }
+
+    return observer;
 }
 
 void Object::BuildOutOfRangeUpdateBlock(UpdateData* data) const
@@ -691,12 +779,31 @@ void Object::ClearUpdateMask(bool remove)
     if (m_objectUpdated)
     {
         if (remove)
-            ObjectAccessor::Instance().RemoveUpdateObject(this);
+            RemoveFromObjectUpdate();
         m_objectUpdated = false;
     }
 }
 
-void Object::BuildFieldsUpdate(Player* pl, UpdateDataMapType& data_map) const
+void Object::AddToObjectUpdateIfNeeded()
+{
+    if (m_inWorld && !m_objectUpdated)
+    {
+        AddToObjectUpdate();
+        m_objectUpdated = true;
+    }
+}
+
+void Object::AddToObjectUpdate()
+{
+    ObjectAccessor::Instance().AddUpdateObject(this);
+}
+
+void Object::RemoveFromObjectUpdate()
+{
+    ObjectAccessor::Instance().RemoveUpdateObject(this);
+}
+
+void Object::BuildFieldsUpdate(Player* pl, UpdateDataMapType& data_map, UpdateBlockCache* cache) const
 {
     UpdateDataMapType::iterator iter = data_map.find(pl);
 
@@ -707,7 +814,31 @@ void Object::BuildFieldsUpdate(Player* pl, UpdateDataMapType& data_map) const
         iter = p.first;
     }
 
-    BuildValuesUpdateBlockForPlayer(&iter->second, iter->first);
+    if (!cache)
+    {
+        BuildValuesUpdateBlockForPlayer(&iter->second, iter->first);
+        return;
+    }
+
+    uint32 observer = _GetUpdateObserverClass(pl);
+    if (observer & UPDATE_OBSERVER_UNCACHED)
+    {
+        BuildValuesUpdateBlockForPlayer(&iter->second, iter->first);
+        ++cache->built;
+        return;
+    }
+
+    UpdateBlockCache::BlockMap::iterator block = cache->blocks.find(observer);
+    if (block == cache->blocks.end())
+    {
+        block = cache->blocks.insert(UpdateBlockCache::BlockMap::value_type(observer, ByteBuffer(500))).first;
+        _BuildValuesUpdateBlock(block->second, pl);
+        ++cache->built;
+    }
+    else
+        ++cache->reused;
+
+    iter->second.AddUpdateBlock(block->second);
 }
 
 bool Object::LoadValues(const char* data)
@@ -774,14 +905,7 @@ void Object::SetInt32Value(uint16 index, int32 value)
     {
         m_int32Values[ index ] = value;
 
-        if (m_inWorld)
-        {
-            if (!m_objectUpdated)
-            {
-                ObjectAccessor::Instance().AddUpdateObject(this);
-                m_objectUpdated = true;
-            }
-        }
+        AddToObjectUpdateIfNeeded();
     }
 }
 
@@ -793,14 +917,7 @@ void Object::SetUInt32Value(uint16 index, uint32 value)
     {
         m_uint32Values[ index ] = value;
 
-        if (m_inWorld)
-        {
-            if (!m_objectUpdated)
-            {
-                ObjectAccessor::Instance().AddUpdateObject(this);
-                m_objectUpdated = true;
-            }
-        }
+        AddToObjectUpdateIfNeeded();
     }
 }
 
@@ -819,14 +936,7 @@ void Object::SetUInt64Value(uint16 index, const uint64& value)
         m_uint32Values[ index ] = *((uint32*)&value);
         m_uint32Values[ index + 1 ] = *(((uint32*)&value) + 1);
 
-        if (m_inWorld)
-        {
-            if (!m_objectUpdated)
-            {
-                ObjectAccessor::Instance().AddUpdateObject(this);
-                m_objectUpdated = true;
-            }
-        }
+        AddToObjectUpdateIfNeeded();
     }
 }
 
@@ -838,14 +948,7 @@ bool Object::AddUInt64Value(uint16 index, const uint64& value)
         m_uint32Values[ index ] = *((uint32*)&value);
         m_uint32Values[ index + 1 ] = *(((uint32*)&value) + 1);
 
-        if (m_inWorld)
-        {
-            if (!m_objectUpdated)
-            {
-                ObjectAccessor::Instance().AddUpdateObject(this);
-                m_objectUpdated = true;
-            }
-        }
+        AddToObjectUpdateIfNeeded();
         return true;
     }
     return false;
@@ -859,14 +962,7 @@ bool Object::RemoveUInt64Value(uint16 index, const uint64& value)
         m_uint32Values[ index ] = 0;
         m_uint32Values[ index + 1 ] = 0;
 
-        if (m_inWorld)
-        {
-            if (!m_objectUpdated)
-            {
-                ObjectAccessor::Instance().AddUpdateObject(this);
-                m_objectUpdated = true;
-            }
-        }
+        AddToObjectUpdateIfNeeded();
         return true;
     }
     return false;
@@ -880,14 +976,7 @@ void Object::SetFloatValue(uint16 index, float value)
     {
         m_floatValues[ index ] = value;
 
-        if (m_inWorld)
-        {
-            if (!m_objectUpdated)
-            {
-                ObjectAccessor::Instance().AddUpdateObject(this);
-                m_objectUpdated = true;
-            }
-        }
+        AddToObjectUpdateIfNeeded();
     }
 }
 
@@ -906,14 +995,7 @@ void Object::SetByteValue(uint16 index, uint8 offset, uint8 value)
         m_uint32Values[ index ] &= ~uint32(uint32(0xFF) << (offset * 8));
         m_uint32Values[ index ] |= uint32(uint32(value) << (offset * 8));
 
-        if (m_inWorld)
-        {
-            if (!m_objectUpdated)
-            {
-                ObjectAccessor::Instance().AddUpdateObject(this);
-                m_objectUpdated = true;
-            }
-        }
+        AddToObjectUpdateIfNeeded();
     }
 }
 
@@ -932,14 +1014,7 @@ void Object::SetUInt16Value(uint16 index, uint8 offset, uint16 value)
         m_uint32Values[ index ] &= ~uint32(uint32(0xFFFF) << (offset * 16));
         m_uint32Values[ index ] |= uint32(uint32(value) << (offset * 16));
 
-        if (m_inWorld)
-        {
-            if (!m_objectUpdated)
-            {
-                ObjectAccessor::Instance().AddUpdateObject(this);
-                m_objectUpdated = true;
-            }
-        }
+        AddToObjectUpdateIfNeeded();
     }
 }
 
@@ -1008,14 +1083,7 @@ void Object::SetFlag(uint16 index, uint32 newFlag)
     {
         m_uint32Values[ index ] = newval;
 
-        if (m_inWorld)
-        {
-            if (!m_objectUpdated)
-            {
-                ObjectAccessor::Instance().AddUpdateObject(this);
-                m_objectUpdated = true;
-            }
-        }
+        AddToObjectUpdateIfNeeded();
     }
 }
 
@@ -1031,14 +1099,7 @@ void Object::RemoveFlag(uint16 index, uint32 oldFlag)
     {
         m_uint32Values[ index ] = newval;
 
-        if (m_inWorld)
-        {
-            if (!m_objectUpdated)
-            {
-                ObjectAccessor::Instance().AddUpdateObject(this);
-                m_objectUpdated = true;
-            }
-        }
+        AddToObjectUpdateIfNeeded();
     }
 }
 
@@ -1056,14 +1117,7 @@ void Object::SetByteFlag(uint16 index, uint8 offset, uint8 newFlag)
     {
         m_uint32Values[ index ] |= uint32(uint32(newFlag) << (offset * 8));
 
-        if (m_inWorld)
-        {
-            if (!m_objectUpdated)
-            {
-                ObjectAccessor::Instance().AddUpdateObject(this);
-                m_objectUpdated = true;
-            }
-        }
+        AddToObjectUpdateIfNeeded();
     }
 }
 
@@ -1081,14 +1135,7 @@ void Object::RemoveByteFlag(uint16 index, uint8 offset, uint8 oldFlag)
     {
         m_uint32Values[ index ] &= ~uint32(uint32(oldFlag) << (offset * 8));
 
-        if (m_inWorld)
-        {
-            if (!m_objectUpdated)
-            {
-                ObjectAccessor::Instance().AddUpdateObject(this);
-                m_objectUpdated = true;
-            }
-        }
+        AddToObjectUpdateIfNeeded();
     }
 }
 
@@ -1190,6 +1237,22 @@ void WorldObject::RemoveFromWorld()
     Object::RemoveFromWorld();
 }
 
+// objects placed in a map are built and sent by that map at the end of its update
+void WorldObject::AddToObjectUpdate()
+{
+    if (Map* map = FindMap())
+        map->AddUpdateObject(this);
+    else
+        Object::AddToObjectUpdate();
+}
+
+void WorldObject::RemoveFromObjectUpdate()
+{
+    if (Map* map = FindMap())
+        map->RemoveUpdateObject(this);
+    Object::RemoveFromObjectUpdate();
+}
+
 uint32 WorldObject::GetZoneId() const
 {
     return GetBaseMap()->GetZoneId(m_positionX, m_positionY, m_positionZ);
@@ -1245,13 +1308,35 @@ bool WorldObject::IsWithinLOSInMap(const WorldObject* obj) const
     if (!IsInMap(obj))
         return false;
 
-    float x, y, z;
+    if (!IsInWorld())
+        return true;
+
+    VMAP::LineOfSightQuery query;
+    GetLineOfSightTo(obj, query);
+    return GetMap()->isInLineOfSight(query.x1, query.y1, query.z1, query.x2, query.y2, query.z2);
+}
+
+void WorldObject::GetLineOfSightTo(const WorldObject* obj, VMAP::LineOfSightQuery& query) const
+{
+    float ox, oy, oz;
     if (obj->GetTypeId() == TYPEID_PLAYER)
-        obj->GetPosition(x, y, z);
+        obj->GetPosition(ox, oy, oz);
+    else
+        obj->GetHitSpherePointFor(GetPosition(), ox, oy, oz);
+
+    float x, y, z;
+    if (GetTypeId() == TYPEID_PLAYER)
+        GetPosition(x, y, z);
     else
-        obj->GetHitSpherePointFor(GetPosition(), x, y, z);
+        GetHitSpherePointFor({ ox, oy, oz }, x, y, z);
 
-    return IsWithinLOS(x, y, z);
+    query.x1 = x;
+    query.y1 = y;
+    query.z1 = z + 2.0f;
+    query.x2 = ox;
+    query.y2 = oy;
+    query.z2 = oz + 2.0f;
+    query.result = true;
 }
 
 bool WorldObject::IsWithinLOS(float ox, float oy, float oz) const
@@ -1814,14 +1899,7 @@ void WorldObject::SendPlaySound(uint32 Sound, bool OnlySelf)
 void Object::ForceValuesUpdateAtIndex(uint32 i)
 {
     m_uint32Values_mirror[i] = GetUInt32Value(i) + 1; // makes server think the field changed
-    if (m_inWorld)
-    {
-        if (!m_objectUpdated)
-        {
-            ObjectAccessor::Instance().AddUpdateObject(this);
-            m_objectUpdated = true;
-        }
-    }
+    AddToObjectUpdateIfNeeded();
 }
 
 namespace Oregon
@@ -1950,6 +2028,19 @@ void WorldObject::SendMessageToSetInRange(WorldPacket* data, float dist, bool /*
     VisitNearbyWorldObject(dist, notifier);
 }
 
+// Moves of this object, batched per receiver when Movement.Batching is on
+void WorldObject::SendMovementMessageToSet(WorldPacket* data)
+{
+    if (!sWorld.getConfig(CONFIG_MOVEMENT_BATCHING))
+    {
+        SendMessageToSet(data, false);
+        return;
+    }
+
+    Oregon::MessageDistDeliverer notifier(this, data, GetVisibilityRange(), false, true);
+    VisitNearbyWorldObject(GetVisibilityRange(), notifier);
+}
+
 void WorldObject::SendObjectDeSpawnAnim(uint64 guid)
 {
     WorldPacket data(SMSG_GAMEOBJECT_DESPAWN_ANIM, 8);
@@ -1983,8 +2074,7 @@ void WorldObject::SetMap(Map* map)
         m_currMap->AddWorldObject(this);
 
     delete elunaEvents;
-    // On multithread replace this with a pointer to map's Eluna pointer stored in a map
-    elunaEvents = new ElunaEventProcessor(&Eluna::GEluna, this);
+    elunaEvents = new ElunaEventProcessor(map->GetElunaPtr(), this);
 }
 
 void WorldObject::ResetMap()
@@ -2008,6 +2098,13 @@ Map const* WorldObject::GetBaseMap() const
     return m_currMap->GetParent();
 }
 
+Eluna* WorldObject::GetEluna() const
+{
+    if (m_currMap)
+        return m_currMap->GetEluna();
+    return Eluna::GEluna;
+}
+
 void WorldObject::AddObjectToRemoveList()
 {
     ASSERT(m_uint32Values);
@@ -2115,7 +2212,7 @@ TempSummon* WorldObject::SummonCreature(uint32 entry, const Position& pos, TempS
         if (TempSummon* summon = map->SummonCreature(entry, pos, NULL, duration, isType(TYPEMASK_UNIT) ? (Unit*)this : NULL, NULL, spwtype))
         {
             if (Unit* summoner = ToUnit())
-                sEluna->OnSummoned(summon, summoner);
+                summon->GetEluna()->OnSummoned(summon, summoner);
             return summon;
         }
     }
@@ -2662,6 +2759,7 @@ struct WorldObjectChangeAccumulator
     UpdateDataMapType& i_updateDatas;
     WorldObject& i_object;
     std::set<uint64> plr_list;
+    UpdateBlockCache i_blocks;
     WorldObjectChangeAccumulator(WorldObject& obj, UpdateDataMapType& d) : i_updateDatas(d), i_object(obj) {}
     void Visit(PlayerMapType& m)
     {
@@ -2708,7 +2806,7 @@ struct WorldObjectChangeAccumulator
         // Only send update once to a player
         if (plr_list.find(plr->GetGUID()) == plr_list.end() && plr->HaveAtClient(&i_object))
         {
-            i_object.BuildFieldsUpdate(plr, i_updateDatas);
+            i_object.BuildFieldsUpdate(plr, i_updateDatas, &i_blocks);
             plr_list.insert(plr->GetGUID());
         }
     }
@@ -2727,6 +2825,8 @@ void WorldObject::BuildUpdate(UpdateDataMapType& data_map)
     //we must build packets for all visible players
     cell.Visit(p, player_notifier, map, *this, GetVisibilityRange());
 
+    map.AddUpdateBlockStats(notifier.i_blocks.built, notifier.i_blocks.reused);
+
     ClearUpdateMask(false);
 }
 
@@ -119,6 +119,8 @@ class CreatureAI;
 class ZoneScript;
 class Unit;
 class ElunaEventProcessor;
+class Eluna;
+struct UpdateBlockCache;
 
 typedef UNORDERED_MAP<Player*, UpdateData> UpdateDataMapType;
 
@@ -364,6 +366,9 @@ class Object
 
         void ClearUpdateMask(bool remove);
 
+        // queue the object for the changes update, see AddToObjectUpdate()
+        void AddToObjectUpdateIfNeeded();
+
         bool LoadValues(const char* data);
 
         uint16 GetValuesCount() const
@@ -380,7 +385,7 @@ class Object
             return false;
         }
         virtual void BuildUpdate(UpdateDataMapType&) {}
-        void BuildFieldsUpdate(Player*, UpdateDataMapType&) const;
+        void BuildFieldsUpdate(Player*, UpdateDataMapType&, UpdateBlockCache* cache = NULL) const;
 
         // FG: some hacky helpers
         void ForceValuesUpdateAtIndex(uint32);
@@ -411,11 +416,18 @@ class Object
         void _Create (uint32 guidlow, uint32 entry, HighGuid guidhigh);
         void _LoadIntoDataField(const char* data, uint32 startOffset, uint32 count);
 
+        // objects outside any map are built by ObjectAccessor::Update
+        virtual void AddToObjectUpdate();
+        virtual void RemoveFromObjectUpdate();
+
         virtual void _SetUpdateBits(UpdateMask* updateMask, Player* target) const;
 
         virtual void _SetCreateBits(UpdateMask* updateMask, Player* target) const;
         void _BuildMovementUpdate(ByteBuffer* data, uint8 updateFlags) const;
         void _BuildValuesUpdate(uint8 updatetype, ByteBuffer* data, UpdateMask* updateMask, Player* target) const;
+        void _BuildValuesUpdateBlock(ByteBuffer& buf, Player* target) const;
+        uint32 _GetUpdateObserverClass(Player* target) const;
+        bool _IsValueChanged(uint16 index) const { return m_uint32Values[index] != m_uint32Values_mirror[index]; }
 
         uint16 m_objectType;
 
@@ -769,6 +781,8 @@ class WorldObject : public Object, public WorldLocation
         }
         bool IsWithinLOS(float x, float y, float z) const;
         bool IsWithinLOSInMap(const WorldObject* obj) const;
+        // the ray IsWithinLOSInMap traces, for checking many objects with one Map::isInLineOfSight call
+        void GetLineOfSightTo(const WorldObject* obj, VMAP::LineOfSightQuery& query) const;
         Position GetHitSpherePointFor(Position const& dest) const;
         void GetHitSpherePointFor(Position const& dest, float& x, float& y, float& z) const;
         bool GetDistanceOrder(WorldObject const* obj1, WorldObject const* obj2, bool is3D = true) const;
@@ -780,6 +794,7 @@ class WorldObject : public Object, public WorldLocation
 
         virtual void SendMessageToSet(WorldPacket *data, bool self) { SendMessageToSetInRange(data, GetVisibilityRange(), self); }
         virtual void SendMessageToSetInRange(WorldPacket* data, float dist, bool self);
+        void SendMovementMessageToSet(WorldPacket* data);
 
         virtual uint8 getLevelForTarget(WorldObject const* /*target*/) const { return 1; }
 
@@ -840,6 +855,9 @@ class WorldObject : public Object, public WorldLocation
         //this function should be removed in nearest time...
         Map const* GetBaseMap() const;
 
+        // Lua state owning this object's hooks: its map's state, or the world state
+        Eluna* GetEluna() const;
+
         void SetZoneScript();
 
         TempSummon* SummonCreature(uint32 id, const Position& pos, TempSummonType spwtype = TEMPSUMMON_MANUAL_DESPAWN, uint32 despwtime = 0);
@@ -926,6 +944,9 @@ class WorldObject : public Object, public WorldLocation
         const bool m_isWorldObject;
         ZoneScript* m_zoneScript;
 
+        void AddToObjectUpdate() override;
+        void RemoveFromObjectUpdate() override;
+
         //these functions are used mostly for Relocate() and Corpse/Player specific stuff...
         //use them ONLY in LoadFromDB()/Create() funcs and nowhere else!
         //mapId/instanceId should be set in SetMap() function!
@@ -105,29 +105,37 @@ Corpse* ObjectAccessor::GetCorpse(WorldObject const& u, uint64 guid)
     return GetObjectInMap(guid, u.GetMap(), (Corpse*)NULL);
 }
 
+// objects of the same map are looked up in the map's own guid store
+
 GameObject* ObjectAccessor::GetGameObject(WorldObject const& u, uint64 guid)
 {
-    return GetObjectInMap(guid, u.GetMap(), (GameObject*)NULL);
+    return u.GetMap()->GetGameObject(guid);
 }
 
 DynamicObject* ObjectAccessor::GetDynamicObject(WorldObject const& u, uint64 guid)
 {
-    return GetObjectInMap(guid, u.GetMap(), (DynamicObject*)NULL);
+    return u.GetMap()->GetDynamicObject(guid);
 }
 
 Unit* ObjectAccessor::GetUnit(WorldObject const& u, uint64 guid)
 {
-    return GetObjectInMap(guid, u.GetMap(), (Unit*)NULL);
+    if (IS_PLAYER_GUID(guid))
+        return GetPlayer(u, guid);
+
+    if (IS_PET_GUID(guid))
+        return GetPet(u, guid);
+
+    return GetCreature(u, guid);
 }
 
 Creature* ObjectAccessor::GetCreature(WorldObject const& u, uint64 guid)
 {
-    return GetObjectInMap(guid, u.GetMap(), (Creature*)NULL);
+    return u.GetMap()->GetCreature(guid);
 }
 
 Pet* ObjectAccessor::GetPet(WorldObject const& u, uint64 guid)
 {
-    return GetObjectInMap(guid, u.GetMap(), (Pet*)NULL);
+    return u.GetMap()->GetPet(guid);
 }
 
 Player* ObjectAccessor::GetPlayer(WorldObject const& u, uint64 guid)
@@ -156,14 +164,7 @@ Player* ObjectAccessor::FindPlayer(uint64 guid, bool force)
     if (!force)
         return GetObjectInWorld(guid, (Player*)NULL);
 
-    Guard guard(*HashMapHolder<Player>::GetLock());
-
-    HashMapHolder<Player>::MapType& m = HashMapHolder<Player>::GetContainer();
-    for (HashMapHolder<Player>::MapType::iterator iter = m.begin(); iter != m.end(); ++iter)
-        if (iter->second->GetGUID() == guid)
-            return iter->second;
-
-    return NULL;
+    return HashMapHolder<Player>::Find(guid);
 }
 
 Unit* ObjectAccessor::FindUnit(uint64 guid)
@@ -173,7 +174,7 @@ Unit* ObjectAccessor::FindUnit(uint64 guid)
 
 Player* ObjectAccessor::FindPlayerByName(const char* name, bool force)
 {
-    Guard guard(*HashMapHolder<Player>::GetLock());
+    HashMapHolder<Player>::ReadGuard guard;
 
     HashMapHolder<Player>::MapType& m = HashMapHolder<Player>::GetContainer();
     for (HashMapHolder<Player>::MapType::iterator iter = m.begin(); iter != m.end(); ++iter)
@@ -185,7 +186,7 @@ Player* ObjectAccessor::FindPlayerByName(const char* name, bool force)
 
 Player* ObjectAccessor::FindPlayerByAccountId(uint64 Id, bool force)
 {
-    Guard guard(*HashMapHolder<Player>::GetLock());
+    HashMapHolder<Player>::ReadGuard guard;
     HashMapHolder<Player>::MapType& m = HashMapHolder<Player>::GetContainer();
     for (HashMapHolder<Player>::MapType::iterator iter = m.begin(); iter != m.end(); ++iter)
         if (iter->second->GetSession()->GetAccountId() == Id && (iter->second->IsInWorld() || force))
@@ -196,7 +197,7 @@ Player* ObjectAccessor::FindPlayerByAccountId(uint64 Id, bool force)
 
 void ObjectAccessor::SaveAllPlayers()
 {
-    Guard guard(*HashMapHolder<Player>::GetLock());
+    HashMapHolder<Player>::ReadGuard guard;
     HashMapHolder<Player>::MapType& m = HashMapHolder<Player>::GetContainer();
     for (HashMapHolder<Player>::MapType::iterator itr = m.begin(); itr != m.end(); ++itr)
         itr->second->SaveToDB();
@@ -372,6 +373,8 @@ void ObjectAccessor::RemoveOldCorpses()
     }
 }
 
+// Objects placed in a map are handled by Map::SendObjectUpdates, only the
+// ones outside any map (items and the like) are left to us
 void ObjectAccessor::Update(uint32 /*diff*/)
 {
     UpdateDataMapType update_players;
@@ -400,8 +403,7 @@ void ObjectAccessor::Update(uint32 /*diff*/)
 
 // Define the static members of HashMapHolder
 
-template <class T> UNORDERED_MAP< uint64, T* > HashMapHolder<T>::m_objectMap;
-template <class T> ACE_Thread_Mutex HashMapHolder<T>::i_lock;
+template <class T> typename HashMapHolder<T>::MapType HashMapHolder<T>::m_objectMap;
 
 // Global definitions for the hashmap storage
 
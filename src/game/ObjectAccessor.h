@@ -21,6 +21,8 @@
 #include "Platform/Define.h"
 #include "Policies/Singleton.h"
 #include <ace/Thread_Mutex.h>
+#include <ace/RW_Thread_Mutex.h>
+#include <ace/Atomic_Op.h>
 #include "Utilities/UnorderedMap.h"
 #include "Policies/ThreadingModel.h"
 
@@ -41,50 +43,205 @@ class DynamicObject;
 class WorldObject;
 class Map;
 
+#define HASHMAPHOLDER_SHARDS 16
+
+// lookup counters of one HashMapHolder, summed over its shards
+struct HashMapHolderStats
+{
+    uint64 objects;
+    uint64 reads;
+    uint64 contendedReads;                                  // had to wait for a writer
+    uint64 writes;
+    uint64 contendedWrites;                                 // had to wait for readers or a writer
+};
+
+/**
+ * Global guid storage of the objects of one type.
+ *
+ * The objects are spread over HASHMAPHOLDER_SHARDS maps by guid, each one
+ * behind its own reader/writer lock: lookups from the map threads run side
+ * by side and only wait for inserts and removes into the same shard. The
+ * whole storage can only be walked under a ReadGuard, which holds every
+ * shard for reading.
+ */
 template <class T>
 class HashMapHolder
 {
     public:
 
-        typedef UNORDERED_MAP<uint64, T*> MapType;
-        typedef ACE_Thread_Mutex LockType;
-        typedef Oregon::GeneralLock<LockType > Guard;
+        typedef UNORDERED_MAP<uint64, T*> ShardMapType;
+        typedef ACE_RW_Thread_Mutex LockType;
+        typedef ACE_Atomic_Op<ACE_Thread_Mutex, long> CounterType;
+
+        struct Shard
+        {
+            LockType lock;
+            ShardMapType objects;
+            CounterType reads;
+            CounterType contendedReads;
+            CounterType writes;
+            CounterType contendedWrites;
+        };
+
+        // the shards, iterated as one map
+        class MapType
+        {
+            public:
+                class const_iterator
+                {
+                    public:
+                        const_iterator() : m_shard(NULL), m_end(NULL) {}
+                        const_iterator(Shard const* shard, Shard const* end) : m_shard(shard), m_end(end)
+                        {
+                            if (m_shard != m_end)
+                            {
+                                m_itr = m_shard->objects.begin();
+                                Skip();
+                            }
+                        }
+
+                        typename ShardMapType::value_type const& operator*() const { return *m_itr; }
+                        typename ShardMapType::value_type const* operator->() const { return &*m_itr; }
+                        const_iterator& operator++() { ++m_itr; Skip(); return *this; }
+
+                        bool operator==(const_iterator const& other) const
+                        {
+                            return m_shard == other.m_shard && (m_shard == m_end || m_itr == other.m_itr);
+                        }
+                        bool operator!=(const_iterator const& other) const { return !(*this == other); }
+
+                    private:
+                        // moves on to the next shard with objects left
+                        void Skip()
+                        {
+                            while (m_itr == m_shard->objects.end())
+                            {
+                                if (++m_shard == m_end)
+                                    return;
+                                m_itr = m_shard->objects.begin();
+                            }
+                        }
+
+                        Shard const* m_shard;
+                        Shard const* m_end;
+                        typename ShardMapType::const_iterator m_itr;
+                };
+                typedef const_iterator iterator;
+
+                const_iterator begin() const { return const_iterator(&m_shards[0], &m_shards[HASHMAPHOLDER_SHARDS]); }
+                const_iterator end() const { return const_iterator(&m_shards[HASHMAPHOLDER_SHARDS], &m_shards[HASHMAPHOLDER_SHARDS]); }
+
+                size_t size() const
+                {
+                    size_t count = 0;
+                    for (uint32 i = 0; i < HASHMAPHOLDER_SHARDS; ++i)
+                        count += m_shards[i].objects.size();
+                    return count;
+                }
+
+            private:
+                friend class HashMapHolder<T>;
+
+                Shard m_shards[HASHMAPHOLDER_SHARDS];
+        };
+
+        // holds every shard for reading, needed to walk GetContainer()
+        class ReadGuard
+        {
+            public:
+                ReadGuard() { HashMapHolder<T>::AcquireAll(); }
+                ~ReadGuard() { HashMapHolder<T>::ReleaseAll(); }
+        };
+        friend class ReadGuard;
 
         static void Insert(T* o)
         {
-            Guard guard(i_lock);
-            m_objectMap[o->GetGUID()] = o;
+            Shard& shard = GetShard(o->GetGUID());
+            ACE_Write_Guard<LockType> guard(shard.lock, false);
+            if (!guard.locked())
+            {
+                ++shard.contendedWrites;
+                guard.acquire_write();
+            }
+            ++shard.writes;
+            shard.objects[o->GetGUID()] = o;
         }
 
         static void Remove(T* o)
         {
-            Guard guard(i_lock);
-            m_objectMap.erase(o->GetGUID());
+            Shard& shard = GetShard(o->GetGUID());
+            ACE_Write_Guard<LockType> guard(shard.lock, false);
+            if (!guard.locked())
+            {
+                ++shard.contendedWrites;
+                guard.acquire_write();
+            }
+            ++shard.writes;
+            shard.objects.erase(o->GetGUID());
         }
 
         static T* Find(uint64 guid)
         {
-            Guard guard(i_lock);
-            typename MapType::iterator itr = m_objectMap.find(guid);
-            return (itr != m_objectMap.end()) ? itr->second : NULL;
+            Shard& shard = GetShard(guid);
+            ACE_Read_Guard<LockType> guard(shard.lock, false);
+            if (!guard.locked())
+            {
+                ++shard.contendedReads;
+                guard.acquire_read();
+            }
+            ++shard.reads;
+            typename ShardMapType::const_iterator itr = shard.objects.find(guid);
+            return (itr != shard.objects.end()) ? itr->second : NULL;
         }
 
+        // when using this, you must hold a ReadGuard
         static MapType& GetContainer()
         {
             return m_objectMap;
         }
 
-        static LockType* GetLock()
+        static HashMapHolderStats GetStats()
         {
-            return &i_lock;
+            HashMapHolderStats stats = { 0, 0, 0, 0, 0 };
+            for (uint32 i = 0; i < HASHMAPHOLDER_SHARDS; ++i)
+            {
+                Shard& shard = m_objectMap.m_shards[i];
+                {
+                    ACE_Read_Guard<LockType> guard(shard.lock);
+                    stats.objects += shard.objects.size();
+                }
+                stats.reads += shard.reads.value();
+                stats.contendedReads += shard.contendedReads.value();
+                stats.writes += shard.writes.value();
+                stats.contendedWrites += shard.contendedWrites.value();
+            }
+            return stats;
         }
     private:
 
         //Non instanceable only static
         HashMapHolder() {}
 
-        static LockType i_lock;
-        static MapType  m_objectMap;
+        static Shard& GetShard(uint64 guid)
+        {
+            // the low part is a counter, its low bits spread the objects evenly
+            return m_objectMap.m_shards[uint32(guid) % HASHMAPHOLDER_SHARDS];
+        }
+
+        // writers only ever hold one shard, so taking them all in order can't deadlock
+        static void AcquireAll()
+        {
+            for (uint32 i = 0; i < HASHMAPHOLDER_SHARDS; ++i)
+                m_objectMap.m_shards[i].lock.acquire_read();
+        }
+
+        static void ReleaseAll()
+        {
+            for (uint32 i = HASHMAPHOLDER_SHARDS; i > 0; --i)
+                m_objectMap.m_shards[i - 1].lock.release();
+        }
+
+        static MapType m_objectMap;
 };
 
 class ObjectAccessor : public Oregon::Singleton<ObjectAccessor, Oregon::ClassLevelLockable<ObjectAccessor, ACE_Thread_Mutex> >
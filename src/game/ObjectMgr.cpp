@@ -277,7 +277,7 @@ LanguageDesc const* GetLanguageDescByID(uint32 lang)
     return NULL;
 }
 
-ObjectMgr::ObjectMgr()
+ObjectMgr::ObjectMgr() : mCreatureRespawnTimes("creature_respawn"), mGORespawnTimes("gameobject_respawn")
 {
     m_hiCharGuid        = 1;
     m_hiCreatureGuid    = 1;
@@ -1627,32 +1627,7 @@ void ObjectMgr::RemoveGameobjectFromGrid(uint32 guid, GameObjectData const* data
 
 void ObjectMgr::LoadCreatureRespawnTimes()
 {
-    uint32 count = 0;
-
-    QueryResult_AutoPtr result = WorldDatabase.Query("SELECT guid,respawntime,instance FROM creature_respawn");
-
-    if (!result)
-    {
-
-
-        sLog.outString(">> Loaded 0 creature respawn time.");
-        return;
-    }
-
-
-    do
-    {
-        Field* fields = result->Fetch();
-
-        uint32 loguid       = fields[0].GetUInt32();
-        uint64 respawn_time = fields[1].GetUInt64();
-        uint32 instance     = fields[2].GetUInt32();
-
-        mCreatureRespawnTimes[MAKE_PAIR64(loguid, instance)] = time_t(respawn_time);
-
-        ++count;
-    }
-    while (result->NextRow());
+    mCreatureRespawnTimes.LoadFromDB();
 
     sLog.outString(">> Loaded %lu creature respawn times", mCreatureRespawnTimes.size());
 }
@@ -1662,32 +1637,7 @@ void ObjectMgr::LoadGameobjectRespawnTimes()
     // remove outdated data
     WorldDatabase.DirectExecute("DELETE FROM gameobject_respawn WHERE respawntime <= UNIX_TIMESTAMP(NOW())");
 
-    uint32 count = 0;
-
-    QueryResult_AutoPtr result = WorldDatabase.Query("SELECT guid,respawntime,instance FROM gameobject_respawn");
-
-    if (!result)
-    {
-
-
-        sLog.outString(">> Loaded 0 gameobject respawn time.");
-        return;
-    }
-
-
-    do
-    {
-        Field* fields = result->Fetch();
-
-        uint32 loguid       = fields[0].GetUInt32();
-        uint64 respawn_time = fields[1].GetUInt64();
-        uint32 instance     = fields[2].GetUInt32();
-
-        mGORespawnTimes[MAKE_PAIR64(loguid, instance)] = time_t(respawn_time);
-
-        ++count;
-    }
-    while (result->NextRow());
+    mGORespawnTimes.LoadFromDB();
 
     sLog.outString(">> Loaded %lu gameobject respawn times", mGORespawnTimes.size());
 }
@@ -6337,10 +6287,7 @@ void ObjectMgr::LoadWeatherZoneChances()
 
 void ObjectMgr::SaveCreatureRespawnTime(uint32 loguid, uint32 instance, time_t t)
 {
-    mCreatureRespawnTimes[MAKE_PAIR64(loguid, instance)] = t;
-    WorldDatabase.PExecute("DELETE FROM creature_respawn WHERE guid = '%u' AND instance = '%u'", loguid, instance);
-    if (t)
-        WorldDatabase.PExecute("INSERT INTO creature_respawn VALUES ('%u', '" UI64FMTD "', '%u')", loguid, uint64(t), instance);
+    mCreatureRespawnTimes.Set(loguid, instance, t);
 }
 
 void ObjectMgr::DeleteCreatureData(uint32 guid)
@@ -6355,36 +6302,19 @@ void ObjectMgr::DeleteCreatureData(uint32 guid)
 
 void ObjectMgr::SaveGORespawnTime(uint32 loguid, uint32 instance, time_t t)
 {
-    mGORespawnTimes[MAKE_PAIR64(loguid, instance)] = t;
-    WorldDatabase.PExecute("DELETE FROM gameobject_respawn WHERE guid = '%u' AND instance = '%u'", loguid, instance);
-    if (t)
-        WorldDatabase.PExecute("INSERT INTO gameobject_respawn VALUES ('%u', '" UI64FMTD "', '%u')", loguid, uint64(t), instance);
+    mGORespawnTimes.Set(loguid, instance, t);
 }
 
 void ObjectMgr::DeleteRespawnTimeForInstance(uint32 instance)
 {
-    RespawnTimes::iterator next;
-
-    for (RespawnTimes::iterator itr = mGORespawnTimes.begin(); itr != mGORespawnTimes.end(); itr = next)
-    {
-        next = itr;
-        ++next;
-
-        if (GUID_HIPART(itr->first) == instance)
-            mGORespawnTimes.erase(itr);
-    }
-
-    for (RespawnTimes::iterator itr = mCreatureRespawnTimes.begin(); itr != mCreatureRespawnTimes.end(); itr = next)
-    {
-        next = itr;
-        ++next;
-
-        if (GUID_HIPART(itr->first) == instance)
-            mCreatureRespawnTimes.erase(itr);
-    }
+    mGORespawnTimes.DeleteInstance(instance);
+    mCreatureRespawnTimes.DeleteInstance(instance);
+}
 
-    WorldDatabase.PExecute("DELETE FROM creature_respawn WHERE instance = '%u'", instance);
-    WorldDatabase.PExecute("DELETE FROM gameobject_respawn WHERE instance = '%u'", instance);
+void ObjectMgr::SaveRespawnTimes()
+{
+    mCreatureRespawnTimes.SaveToDB();
+    mGORespawnTimes.SaveToDB();
 }
 
 void ObjectMgr::DeleteGOData(uint32 guid)
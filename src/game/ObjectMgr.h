@@ -38,6 +38,7 @@
 #include "Database/SQLStorage.h"
 #include "Path.h"
 #include "ConditionMgr.h"
+#include "RespawnStore.h"
 
 #include <string>
 #include <map>
@@ -359,8 +360,6 @@ struct CellObjectGuids
 typedef UNORDERED_MAP<uint32/*cell_id*/, CellObjectGuids> CellObjectGuidsMap;
 typedef UNORDERED_MAP<uint32/*(mapid,spawnMode) pair*/, CellObjectGuidsMap> MapObjectGuids;
 
-typedef UNORDERED_MAP<uint64/*(instance,guid) pair*/, time_t> RespawnTimes;
-
 
 // Oregon string ranges
 #define MIN_OREGON_STRING_ID           1                    // 'mangos_string'
@@ -1030,17 +1029,19 @@ class ObjectMgr
         void AddCorpseCellData(uint32 mapid, uint32 cellid, uint32 player_guid, uint32 instance);
         void DeleteCorpseCellData(uint32 mapid, uint32 cellid, uint32 player_guid);
 
+        // thread safe, the times are written to the db by SaveRespawnTimes()
         time_t GetCreatureRespawnTime(uint32 loguid, uint32 instance)
         {
-            return mCreatureRespawnTimes[MAKE_PAIR64(loguid, instance)];
+            return mCreatureRespawnTimes.Get(loguid, instance);
         }
         void SaveCreatureRespawnTime(uint32 loguid, uint32 instance, time_t t);
         time_t GetGORespawnTime(uint32 loguid, uint32 instance)
         {
-            return mGORespawnTimes[MAKE_PAIR64(loguid, instance)];
+            return mGORespawnTimes.Get(loguid, instance);
         }
         void SaveGORespawnTime(uint32 loguid, uint32 instance, time_t t);
         void DeleteRespawnTimeForInstance(uint32 instance);
+        void SaveRespawnTimes();
 
         // grid objects
         void AddCreatureToGrid(uint32 guid, CreatureData const* data);
@@ -1268,8 +1269,8 @@ class ObjectMgr
         PageTextLocaleMap mPageTextLocaleMap;
         OregonStringLocaleMap mOregonStringLocaleMap;
         GossipMenuItemsLocaleMap mGossipMenuItemsLocaleMap;
-        RespawnTimes mCreatureRespawnTimes;
-        RespawnTimes mGORespawnTimes;
+        RespawnStore mCreatureRespawnTimes;
+        RespawnStore mGORespawnTimes;
 
         typedef std::vector<uint32> GuildBankTabPriceMap;
         GuildBankTabPriceMap mGuildBankTabPrice;
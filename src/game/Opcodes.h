@@ -1104,12 +1104,21 @@ enum SessionStatus
     STATUS_PROTECTED        = 0x10  //!< Using this opcode is time protected
 };
 
+/// Where a received opcode is allowed to be handled
+enum PacketProcessing
+{
+    PROCESS_INPLACE         = 0,    //!< Process whenever received (not handled, server side or handled by the socket)
+    PROCESS_THREADUNSAFE,           //!< Touches global state, always processed in World::UpdateSessions()
+    PROCESS_THREADSAFE              //!< Touches only the player and its map, may be processed in Map::Update()
+};
+
 class WorldPacket;
 
 struct OpcodeHandler
 {
     char const* name;
     unsigned long status;
+    PacketProcessing packetProcessing;
     void (WorldSession::*handler)(WorldPacket& recvPacket);
 };
 
@@ -164,7 +164,7 @@ bool OPvPCapturePoint::DelCreature(uint32 type)
     if (Map* map = MapManager::Instance().FindMap(cr->GetMapId()))
         map->RemoveFromMap(cr, false);
     // delete respawn time for this creature
-    WorldDatabase.PExecute("DELETE FROM creature_respawn WHERE guid = '%u'", guid);
+    sObjectMgr.SaveCreatureRespawnTime(guid, 0, 0);
     cr->AddObjectToRemoveList();
     sObjectMgr.DeleteCreatureData(guid);
     m_CreatureTypes[m_Creatures[type]] = 0;
@@ -14,7 +14,7 @@
 using namespace Hooks;
 
 #define START_HOOK_SERVER(EVENT) \
-    if (!IsEnabled())\
+    if (!CanRunHooks("server", EVENT))\
         return;\
     auto key = EventKey<ServerEvents>(EVENT);\
     if (!ServerEventBindings->HasBindingsFor(key))\
@@ -22,13 +22,22 @@ using namespace Hooks;
     LOCK_ELUNA
 
 #define START_HOOK_PACKET(EVENT, OPCODE) \
-    if (!IsEnabled())\
+    if (!CanRunHooks("packet", EVENT))\
         return;\
     auto key = EntryKey<PacketEvents>(EVENT, OPCODE);\
     if (!PacketEventBindings->HasBindingsFor(key))\
         return;\
     LOCK_ELUNA
 
+bool Eluna::HasPacketSendHooks(uint16 opcode) const
+{
+    if (!CanRunHooks("packet", PACKET_EVENT_ON_PACKET_SEND))
+        return false;
+
+    return ServerEventBindings->HasBindingsFor(EventKey<ServerEvents>(SERVER_EVENT_ON_PACKET_SEND)) ||
+        PacketEventBindings->HasBindingsFor(EntryKey<PacketEvents>(PACKET_EVENT_ON_PACKET_SEND, opcode));
+}
+
 bool Eluna::OnPacketSend(WorldSession* session, WorldPacket& packet)
 {
     bool result = true;
@@ -27,7 +27,7 @@
 PathInfo::PathInfo(const Unit* owner) :
     m_polyLength(0), m_type(PATHFIND_BLANK),
     m_useStraightPath(true), m_forceDestination(false), m_pointPathLimit(MAX_POINT_PATH_LENGTH),
-    m_sourceUnit(owner), m_navMesh(NULL), m_navMeshQuery(NULL)
+    m_sourceUnit(owner), m_navMesh(NULL), m_navMeshQuery(NULL), m_pathCache(NULL), m_pathCacheHits(0)
 {
     //DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ PathInfo::PathInfo for %u \n", m_sourceUnit->GetGUIDLow());
 
@@ -37,6 +37,7 @@ PathInfo::PathInfo(const Unit* owner) :
         MMAP::MMapManager* mmap = MMAP::MMapFactory::createOrGetMMapManager();
         m_navMesh = mmap->GetNavMesh(mapId);
         m_navMeshQuery = mmap->GetNavMeshQuery(mapId, m_sourceUnit->GetInstanceId());
+        m_pathCache = mmap->GetPathCache(mapId);
     }
 
     createFilter();
@@ -70,6 +71,11 @@ bool PathInfo::Update(float destX, float destY, float destZ, bool forceDest)
 
     sLog.outMMap("PathInfo::Update() for %u \n", m_sourceUnit->GetGUIDLow());
 
+    // the map may be updated by another thread than the last time, take the query of this one
+    MMAP::MMapManager* mmap = MMAP::MMapFactory::createOrGetMMapManager();
+    if (m_navMesh)
+        m_navMeshQuery = mmap->GetNavMeshQuery(m_sourceUnit->GetMapId(), m_sourceUnit->GetInstanceId());
+
     // make sure navMesh works - we can run on map w/o mmap
     // check if the start and end point have a .mmtile loaded (can we pass via not loaded tile on the way?)
     if (!m_navMesh || !m_navMeshQuery || m_sourceUnit->HasUnitState(UNIT_STATE_IGNORE_PATHFINDING) ||
@@ -82,7 +88,13 @@ bool PathInfo::Update(float destX, float destY, float destZ, bool forceDest)
 
     updateFilter();
 
+    ACE_Time_Value startTime = ACE_OS::gettimeofday();
+    m_pathCacheHits = 0;
+
     BuildPolyPath(newStart, newDest);
+
+    ACE_Time_Value detourTime = ACE_OS::gettimeofday() - startTime;
+    mmap->AddPathStats(m_sourceUnit->GetMapId(), m_pathCacheHits, uint64(detourTime.sec()) * 1000000 + detourTime.usec());
     return true;
 }
 
@@ -345,14 +357,13 @@ void PathInfo::BuildPolyPath(const Vector3& startPos, const Vector3& endPos)
 
         // generate suffix
         uint32 suffixPolyLength = 0;
-        dtResult = m_navMeshQuery->findPath(
+        dtResult = findPolyPath(
             suffixStartPoly,    // start polygon
             endPoly,            // end polygon
             suffixEndPoint,     // start position
             endPoint,           // end position
-            &m_filter,            // polygon search filter
             m_pathPolyRefs + prefixPolyLength - 1,    // [out] path
-            (int*)&suffixPolyLength,
+            &suffixPolyLength,
             MAX_PATH_LENGTH - prefixPolyLength); // max number of polygons in output path
 
         if (!suffixPolyLength || dtStatusFailed(dtResult))
@@ -379,14 +390,13 @@ void PathInfo::BuildPolyPath(const Vector3& startPos, const Vector3& endPos)
         // free and invalidate old path data
         clear();
 
-        dtResult = m_navMeshQuery->findPath(
+        dtResult = findPolyPath(
                                 startPoly,          // start polygon
                                 endPoly,            // end polygon
                                 startPoint,         // start position
                                 endPoint,           // end position
-                                &m_filter,           // polygon search filter
                                 m_pathPolyRefs,     // [out] path
-                                (int*)&m_polyLength,
+                                &m_polyLength,
                                 MAX_PATH_LENGTH);   // max number of polygons in output path
 
         if (!m_polyLength || dtStatusFailed(dtResult))
@@ -409,6 +419,25 @@ void PathInfo::BuildPolyPath(const Vector3& startPos, const Vector3& endPos)
     BuildPointPath(startPoint, endPoint);
 }
 
+dtStatus PathInfo::findPolyPath(dtPolyRef startPoly, dtPolyRef endPoly, const float* startPos, const float* endPos,
+                                dtPolyRef* path, uint32* pathSize, uint32 maxPathSize)
+{
+    if (m_pathCache && m_pathCache->Find(m_navMesh, startPoly, endPoly, m_filter, path, *pathSize, maxPathSize))
+    {
+        ++m_pathCacheHits;
+        return DT_SUCCESS;
+    }
+
+    dtStatus dtResult = m_navMeshQuery->findPath(startPoly, endPoly, startPos, endPos, &m_filter, path, (int*)pathSize, maxPathSize);
+
+    // only corridors that reach the end polygon are worth sharing
+    if (m_pathCache && dtStatusSucceed(dtResult) && !dtStatusDetail(dtResult, DT_PARTIAL_RESULT) &&
+        *pathSize && path[*pathSize - 1] == endPoly)
+        m_pathCache->Store(startPoly, endPoly, m_filter, path, *pathSize);
+
+    return dtResult;
+}
+
 void PathInfo::BuildPointPath(const float* startPoint, const float* endPoint)
 {
     float pathPoints[MAX_POINT_PATH_LENGTH * VERTEX_SIZE];
@@ -29,6 +29,11 @@ using Movement::PointsArray;
 
 class Unit;
 
+namespace MMAP
+{
+    class NavMeshPathCache;
+}
+
 // 74*4.0f=296y  number_of_points*interval = max_path_len
 // this is way more than actual evade range
 // I think we can safely cut those down even more
@@ -171,6 +176,8 @@ class PathInfo
         const Unit* const       m_sourceUnit;       // the unit that is moving
         const dtNavMesh*       m_navMesh;          // the nav mesh
         const dtNavMeshQuery*  m_navMeshQuery;     // the nav mesh query used to find the path
+        MMAP::NavMeshPathCache* m_pathCache;        // corridors already found on this map
+        uint32          m_pathCacheHits;    // corridors taken from the cache during the last Update
 
         dtQueryFilter m_filter;                     // use single filter for all movements, update it when needed
 
@@ -207,6 +214,8 @@ class PathInfo
        bool HaveTile(const Vector3& p) const;
 
         void BuildPolyPath(const Vector3& startPos, const Vector3& endPos);
+        dtStatus findPolyPath(dtPolyRef startPoly, dtPolyRef endPoly, const float* startPos, const float* endPos,
+                              dtPolyRef* path, uint32* pathSize, uint32 maxPathSize);
         void BuildPointPath(const float* startPoint, const float* endPoint);
         void BuildShortcut();
 
@@ -101,6 +101,7 @@ void Pet::AddToWorld()
     if (!IsInWorld())
     {
         ObjectAccessor::Instance().AddObject(this);
+        GetMap()->AddToGuidStore(this);
         Unit::AddToWorld();
         AIM_Initialize();
     }
@@ -124,6 +125,7 @@ void Pet::RemoveFromWorld()
     {
         // Don't call the function for Creature, normal mobs + totems go in a different storage
         Unit::RemoveFromWorld();
+        GetMap()->RemoveFromGuidStore(this);
         ObjectAccessor::Instance().RemoveObject(this);
     }
 }
@@ -1357,6 +1359,7 @@ void Pet::_LoadAuras(uint32 timediff)
     m_Auras.clear();
     for (int i = 0; i < TOTAL_AURAS; i++)
         m_modAuras[i].clear();
+    ReindexProcAuras();
 
     // all aura related fields
     for (int i = UNIT_FIELD_AURA; i <= UNIT_FIELD_AURASTATE; ++i)
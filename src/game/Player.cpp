@@ -538,6 +538,12 @@ Player::Player(WorldSession* session) : Unit(true), m_reputationMgr(this)
         m_Tutorials[ aX ] = 0x00;
     m_TutorialsChanged = false;
 
+    for (uint8 i = 0; i < MAX_PLAYER_SAVE_SECTIONS; ++i)
+    {
+        m_savedSections[i].known = false;
+        m_savedSections[i].pending = false;
+    }
+
     m_DailyQuestChanged = false;
     m_lastDailyQuestTime = 0;
 
@@ -2608,7 +2614,7 @@ void Player::GiveXP(uint32 xp, Unit* victim, bool disableRafBonus)
     uint32 level = getLevel();
 
     // used by eluna
-    sEluna->OnGiveXP(this, xp, victim);
+    GetEluna()->OnGiveXP(this, xp, victim);
 
     // XP to money conversion processed in Player::RewardQuest
     if (level >= sWorld.getConfig(CONFIG_MAX_PLAYER_LEVEL))
@@ -2736,13 +2742,13 @@ void Player::GiveLevel(uint32 level, bool ignoreRAF)
             SetGrantableLevels(GetGrantableLevels() + sWorld.getRate(RATE_RAF_GRANTABLE_LEVELS_PER_LEVEL));
 
     // used by eluna
-    sEluna->OnLevelChanged(this, oldLevel);
+    GetEluna()->OnLevelChanged(this, oldLevel);
 }
 
 void Player::SetFreeTalentPoints(uint32 points)
 {
     // used by eluna
-    sEluna->OnFreeTalentPointsChanged(this, points);
+    GetEluna()->OnFreeTalentPointsChanged(this, points);
     SetUInt32Value(PLAYER_CHARACTER_POINTS1, points);
 }
 
@@ -2876,7 +2882,7 @@ void Player::LearnTalent(uint32 talentId, uint32 talentRank)
     // update free talent points
     SetFreeTalentPoints(CurTalentPoints - 1);
 
-    sEluna->OnLearnTalents(this, talentId, talentRank, spellid);
+    GetEluna()->OnLearnTalents(this, talentId, talentRank, spellid);
 }
 
 void Player::InitStatsForLevel(bool reapplyMods)
@@ -3755,7 +3761,7 @@ void Player::_LoadSpellCooldowns(QueryResult_AutoPtr result)
 
 void Player::_SaveSpellCooldowns()
 {
-    CharacterDatabase.PExecute("DELETE FROM character_spell_cooldown WHERE guid = '%u'", GetGUIDLow());
+    SqlBatchInsert batch(CharacterDatabase, "INSERT INTO character_spell_cooldown (guid,spell,item,time) VALUES ", 4);
 
     time_t curTime = time(NULL);
 
@@ -3766,10 +3772,13 @@ void Player::_SaveSpellCooldowns()
             m_spellCooldowns.erase(itr++);
         else
         {
-            CharacterDatabase.PExecute("INSERT INTO character_spell_cooldown (guid,spell,item,time) VALUES ('%u', '%u', '%u', '" UI64FMTD "')", GetGUIDLow(), itr->first, itr->second.itemid, uint64(itr->second.end));
+            batch << GetGUIDLow() << itr->first << uint32(itr->second.itemid) << uint64(itr->second.end);
+            batch.EndRow();
             ++itr;
         }
     }
+
+    _SaveSection(PLAYER_SAVE_SPELL_COOLDOWNS, "DELETE FROM character_spell_cooldown WHERE guid = ?", batch);
 }
 
 uint32 Player::ResetTalentsCost() const
@@ -3808,7 +3817,7 @@ uint32 Player::ResetTalentsCost() const
 bool Player::ResetTalents(bool no_cost)
 {
     // used by eluna
-    sEluna->OnTalentsReset(this, no_cost);
+    GetEluna()->OnTalentsReset(this, no_cost);
 
     sScriptMgr.OnPlayerTalentsReset(this, no_cost);
 
@@ -4531,7 +4540,7 @@ void Player::ResurrectPlayer(float restore_percent, bool applySickness)
 
     setDeathState(ALIVE);
 
-    sEluna->OnResurrect(this);
+    GetEluna()->OnResurrect(this);
 
     // some items limited to specific map
     DestroyZoneLimitedItem(true, GetZoneId());
@@ -6683,7 +6692,7 @@ void Player::UpdateZone(uint32 newZone)
     }
 
     // used by eluna
-    sEluna->OnUpdateZone(this, newZone, GetAreaId());
+    GetEluna()->OnUpdateZone(this, newZone, GetAreaId());
 
     // in PvP, any not controlled zone (except zone->team == 6, default case)
     // in PvE, only opposition team capital
@@ -6802,7 +6811,7 @@ void Player::DuelComplete(DuelCompleteType type)
     }
 
     // used by eluna
-    sEluna->OnDuelEnd(duel->opponent, this, type);
+    GetEluna()->OnDuelEnd(duel->opponent, this, type);
 
     switch (type)
     {
@@ -10527,7 +10536,7 @@ uint8 Player::CanUseItem(Item* pItem, bool not_loading) const
             if (getLevel() < pProto->RequiredLevel)
                 return EQUIP_ERR_CANT_EQUIP_LEVEL_I;
 
-            uint8 eres = sEluna->OnCanUseItem(this, pProto->ItemId);
+            uint8 eres = GetEluna()->OnCanUseItem(this, pProto->ItemId);
             if (eres != EQUIP_ERR_OK)
                 return eres;
 
@@ -10557,7 +10566,7 @@ bool Player::CanUseItem(ItemTemplate const* pProto)
         if (getLevel() < pProto->RequiredLevel)
             return false;
 
-        uint8 eres = sEluna->OnCanUseItem(this, pProto->ItemId);
+        uint8 eres = GetEluna()->OnCanUseItem(this, pProto->ItemId);
         if (eres != EQUIP_ERR_OK)
             return false;
 
@@ -10891,13 +10900,13 @@ Item* Player::EquipItem(uint16 pos, Item* pItem, bool update)
         ApplyEquipCooldown(pItem2);
 
         // used by eluna
-        sEluna->OnEquip(this, pItem2, bag, slot);
+        GetEluna()->OnEquip(this, pItem2, bag, slot);
 
         return pItem2;
     }
 
     // used by eluna
-    sEluna->OnEquip(this, pItem, bag, slot);
+    GetEluna()->OnEquip(this, pItem, bag, slot);
 
     return pItem;
 }
@@ -11115,7 +11124,7 @@ void Player::DestroyItem(uint8 bag, uint8 slot, bool update)
 
         ItemRemovedQuestCheck(pItem->GetEntry(), pItem->GetCount());
 
-        sEluna->OnRemove(this, pItem);
+        GetEluna()->OnRemove(this, pItem);
 
         if (bag == INVENTORY_SLOT_BAG_0)
         {
@@ -13541,10 +13550,10 @@ void Player::RewardQuest(Quest const* pQuest, uint32 reward, Object* questGiver,
     switch (questGiver->GetTypeId())
     {
     case TYPEID_UNIT:
-        sEluna->OnQuestReward(this, (Creature*)questGiver, pQuest, reward);
+        GetEluna()->OnQuestReward(this, (Creature*)questGiver, pQuest, reward);
         break;
     case TYPEID_GAMEOBJECT:
-        sEluna->OnQuestReward(this, (GameObject*)questGiver, pQuest, reward);
+        GetEluna()->OnQuestReward(this, (GameObject*)questGiver, pQuest, reward);
         break;
     }
 
@@ -15519,6 +15528,7 @@ void Player::_LoadAuras(QueryResult_AutoPtr result, uint32 timediff)
     //m_Auras.clear();
     for (int i = 0; i < TOTAL_AURAS; i++)
         m_modAuras[i].clear();
+    ReindexProcAuras();
 
     // all aura related fields
     for (int i = UNIT_FIELD_AURA; i <= UNIT_FIELD_AURASTATE; ++i)
@@ -16313,7 +16323,7 @@ InstancePlayerBind* Player::BindToInstance(InstanceSave* save, bool permanent, b
         #endif
 
         // used by eluna
-        sEluna->OnBindToInstance(this, save->GetDifficulty(), save->GetMapId(), permanent);
+        GetEluna()->OnBindToInstance(this, save->GetDifficulty(), save->GetMapId(), permanent);
 
         return &bind;
     }
@@ -16622,6 +16632,16 @@ bool Player::_LoadHomeBind(QueryResult_AutoPtr result)
 /***                  SAVE SYSTEM                     ***/
 /*********************************************************/
 
+// saves run on the map threads
+static ACE_Thread_Mutex s_saveStatsLock;
+static PlayerSaveStats s_saveStats = { 0, 0, 0, 0, 0 };
+
+void Player::GetSaveStats(PlayerSaveStats& stats)
+{
+    ACE_GUARD(ACE_Thread_Mutex, guard, s_saveStatsLock);
+    stats = s_saveStats;
+}
+
 void Player::SaveToDB()
 {
     // delay auto save at any saves (manual, in code, or autosave)
@@ -16665,7 +16685,7 @@ void Player::SaveToDB()
 
     // Hack to check that this is not on create save
     if (!HasAtLoginFlag(AT_LOGIN_FIRST))
-        sEluna->OnSave(this);
+        GetEluna()->OnSave(this);
 
     std::string sql_name = m_name;
     CharacterDatabase.escape_string(sql_name);
@@ -16790,9 +16810,15 @@ void Player::SaveToDB()
     ss << GetSession()->GetLatency();
     ss << "')";
 
+    std::string sql = ss.str();
+
+    m_saveStats = SqlWriteStats();
+    m_saveStats.rows = 1;
+    m_saveStats.bytes = sql.size();
+
     CharacterDatabase.BeginTransaction();
 
-    CharacterDatabase.Execute(ss.str().c_str());
+    CharacterDatabase.Execute(sql.c_str());
 
     if (m_mailsUpdated)                                     //save mails only when needed
         _SaveMail();
@@ -16809,7 +16835,29 @@ void Player::SaveToDB()
     _SaveSkills();
     m_reputationMgr.SaveToDB();
 
-    CharacterDatabase.CommitTransaction();
+    bool queued = CharacterDatabase.CommitTransaction();
+
+    for (uint8 i = 0; i < MAX_PLAYER_SAVE_SECTIONS; ++i)
+    {
+        SavedSection& saved = m_savedSections[i];
+        if (!saved.pending)
+            continue;
+
+        saved.pending = false;
+        saved.known = queued;
+        saved.rows.swap(saved.pendingRows);
+        saved.pendingRows.clear();
+    }
+
+    DEBUG_LOG("Player %s saved: %u rows, %u bytes", m_name.c_str(), m_saveStats.rows, m_saveStats.bytes);
+    {
+        ACE_GUARD(ACE_Thread_Mutex, guard, s_saveStatsLock);
+        ++s_saveStats.saves;
+        s_saveStats.rows += m_saveStats.rows;
+        s_saveStats.bytes += m_saveStats.bytes;
+        s_saveStats.maxRows = std::max(s_saveStats.maxRows, m_saveStats.rows);
+        s_saveStats.maxBytes = std::max(s_saveStats.maxBytes, m_saveStats.bytes);
+    }
 
     // restore state (before aura apply, if aura remove flag then aura must set it ack by self)
     SetDisplayId(tmp_displayid);
@@ -16837,41 +16885,47 @@ void Player::SaveGoldToDB()
 
 void Player::_SaveActions()
 {
+    SqlBatchInsert batch(CharacterDatabase, "REPLACE INTO character_action (guid,button,action,type,misc) VALUES ", 5);
+
     for (ActionButtonList::iterator itr = m_actionButtons.begin(); itr != m_actionButtons.end();)
     {
         switch (itr->second.uState)
         {
             case ACTIONBUTTON_NEW:
-                CharacterDatabase.PExecute("INSERT INTO character_action (guid,button,action,type,misc) VALUES ('%u', '%u', '%u', '%u', '%u')",
-                                           GetGUIDLow(), (uint32)itr->first, (uint32)itr->second.action, (uint32)itr->second.type, (uint32)itr->second.misc);
-                itr->second.uState = ACTIONBUTTON_UNCHANGED;
-                ++itr;
-                break;
             case ACTIONBUTTON_CHANGED:
-                CharacterDatabase.PExecute("UPDATE character_action  SET action = '%u', type = '%u', misc= '%u' WHERE guid= '%u' AND button= '%u' ",
-                                           (uint32)itr->second.action, (uint32)itr->second.type, (uint32)itr->second.misc, GetGUIDLow(), (uint32)itr->first);
+                batch << GetGUIDLow() << uint32(itr->first) << uint32(itr->second.action) << uint32(itr->second.type) << uint32(itr->second.misc);
+                batch.EndRow();
                 itr->second.uState = ACTIONBUTTON_UNCHANGED;
                 ++itr;
                 break;
             case ACTIONBUTTON_DELETED:
-                CharacterDatabase.PExecute("DELETE FROM character_action WHERE guid = '%u' and button = '%u'", GetGUIDLow(), (uint32)itr->first);
-                m_actionButtons.erase(itr++);
+                {
+                    PreparedValues values(2);
+                    values << GetGUIDLow() << uint32(itr->first);
+                    _SaveExecute("DELETE FROM character_action WHERE guid = ? AND button = ?", values);
+                    m_actionButtons.erase(itr++);
+                }
                 break;
             default:
                 ++itr;
                 break;
         }
     }
+
+    batch.Execute(&m_saveStats);
 }
 
 void Player::_SaveAuras()
 {
-    CharacterDatabase.PExecute("DELETE FROM character_aura WHERE guid = '%u'", GetGUIDLow());
+    SqlBatchInsert batch(CharacterDatabase, "INSERT INTO character_aura (guid,caster_guid,item_caster_guid,spell,effect_index,stackcount,amount,maxduration,remaintime,remaincharges) VALUES ", 10);
 
     AuraMap const& auras = GetAuras();
 
     if (auras.empty())
+    {
+        _SaveSection(PLAYER_SAVE_AURAS, "DELETE FROM character_aura WHERE guid = ?", batch);
         return;
+    }
 
     spellEffectPair lastEffectPair = auras.begin()->first;
     uint32 stackCounter = 1;
@@ -16911,9 +16965,10 @@ void Player::_SaveAuras()
 
                     if (i == 3)
                     {
-                        CharacterDatabase.PExecute("INSERT INTO character_aura (guid,caster_guid,item_caster_guid,spell,effect_index,stackcount,amount,maxduration,remaintime,remaincharges) "
-                                                   "VALUES ('%u', '" UI64FMTD "', '" UI64FMTD "', '%u', '%u', '%u', '%d', '%d', '%d', '%d')", GetGUIDLow(), aura->GetCasterGUID(),  aura->GetCastItemGUID(), (uint32)aura->GetId(),
-                                                   (uint32)aura->GetEffIndex(), (uint32)aura->GetStackAmount(), aura->GetModifier()->m_amount, int(aura->GetAuraMaxDuration()), int(aura->GetAuraDuration()), int(aura->m_procCharges));
+                        batch << GetGUIDLow() << uint64(aura->GetCasterGUID()) << uint64(aura->GetCastItemGUID()) << uint32(aura->GetId())
+                              << uint32(aura->GetEffIndex()) << uint32(aura->GetStackAmount()) << int32(aura->GetModifier()->m_amount)
+                              << int32(aura->GetAuraMaxDuration()) << int32(aura->GetAuraDuration()) << int32(aura->m_procCharges);
+                        batch.EndRow();
                     }
                 }
             }
@@ -16931,6 +16986,9 @@ void Player::_SaveAuras()
             stackCounter = 1;
         }
     }
+
+    // only permanent auras keep the same rows, anything with a duration left rewrites the section
+    _SaveSection(PLAYER_SAVE_AURAS, "DELETE FROM character_aura WHERE guid = ?", batch);
 }
 
 void Player::_SaveInventory()
@@ -17069,25 +17127,27 @@ void Player::_SaveMail()
 
 void Player::_SaveQuestStatus()
 {
-    // we don't need transactions here.
+    SqlBatchInsert batch(CharacterDatabase, "REPLACE INTO character_queststatus (guid,quest,status,rewarded,explored,timer,mobcount1,mobcount2,mobcount3,mobcount4,itemcount1,itemcount2,itemcount3,itemcount4) VALUES ", 14);
+
     for (QuestStatusMap::iterator i = mQuestStatus.begin(); i != mQuestStatus.end(); ++i)
     {
         switch (i->second.uState)
         {
             case QUEST_NEW:
-                CharacterDatabase.PExecute("INSERT INTO character_queststatus (guid,quest,status,rewarded,explored,timer,mobcount1,mobcount2,mobcount3,mobcount4,itemcount1,itemcount2,itemcount3,itemcount4) "
-                                           "VALUES ('%u', '%u', '%u', '%u', '%u', '" UI64FMTD "', '%u', '%u', '%u', '%u', '%u', '%u', '%u', '%u')",
-                                           GetGUIDLow(), i->first, i->second.m_status, i->second.m_rewarded, i->second.m_explored, uint64(i->second.m_timer / IN_MILLISECONDS + sWorld.GetGameTime()), i->second.m_creatureOrGOcount[0], i->second.m_creatureOrGOcount[1], i->second.m_creatureOrGOcount[2], i->second.m_creatureOrGOcount[3], i->second.m_itemcount[0], i->second.m_itemcount[1], i->second.m_itemcount[2], i->second.m_itemcount[3]);
-                break;
             case QUEST_CHANGED:
-                CharacterDatabase.PExecute("UPDATE character_queststatus SET status = '%u',rewarded = '%u',explored = '%u',timer = '" UI64FMTD "',mobcount1 = '%u',mobcount2 = '%u',mobcount3 = '%u',mobcount4 = '%u',itemcount1 = '%u',itemcount2 = '%u',itemcount3 = '%u',itemcount4 = '%u'  WHERE guid = '%u' AND quest = '%u' ",
-                                           i->second.m_status, i->second.m_rewarded, i->second.m_explored, uint64(i->second.m_timer / IN_MILLISECONDS + sWorld.GetGameTime()), i->second.m_creatureOrGOcount[0], i->second.m_creatureOrGOcount[1], i->second.m_creatureOrGOcount[2], i->second.m_creatureOrGOcount[3], i->second.m_itemcount[0], i->second.m_itemcount[1], i->second.m_itemcount[2], i->second.m_itemcount[3], GetGUIDLow(), i->first);
+                batch << GetGUIDLow() << i->first << uint32(i->second.m_status) << uint32(i->second.m_rewarded) << uint32(i->second.m_explored)
+                      << uint64(i->second.m_timer / IN_MILLISECONDS + sWorld.GetGameTime())
+                      << i->second.m_creatureOrGOcount[0] << i->second.m_creatureOrGOcount[1] << i->second.m_creatureOrGOcount[2] << i->second.m_creatureOrGOcount[3]
+                      << i->second.m_itemcount[0] << i->second.m_itemcount[1] << i->second.m_itemcount[2] << i->second.m_itemcount[3];
+                batch.EndRow();
                 break;
             case QUEST_UNCHANGED:
                 break;
         };
         i->second.uState = QUEST_UNCHANGED;
     }
+
+    batch.Execute(&m_saveStats);
 }
 
 void Player::_SaveDailyQuestStatus()
@@ -17098,18 +17158,27 @@ void Player::_SaveDailyQuestStatus()
     m_DailyQuestChanged = false;
 
     // save last daily quest time for all quests: we need only mostly reset time for reset check anyway
+    PreparedValues values(1);
+    values << GetGUIDLow();
+    _SaveExecute("DELETE FROM character_queststatus_daily WHERE guid = ?", values);
 
-    // we don't need transactions here.
-    CharacterDatabase.PExecute("DELETE FROM character_queststatus_daily WHERE guid = '%u'", GetGUIDLow());
+    SqlBatchInsert batch(CharacterDatabase, "INSERT INTO character_queststatus_daily (guid,quest,time) VALUES ", 3);
     for (uint32 quest_daily_idx = 0; quest_daily_idx < PLAYER_MAX_DAILY_QUESTS; ++quest_daily_idx)
-        if (GetUInt32Value(PLAYER_FIELD_DAILY_QUESTS_1 + quest_daily_idx))
-            CharacterDatabase.PExecute("INSERT INTO character_queststatus_daily (guid,quest,time) VALUES ('%u', '%u','" UI64FMTD "')",
-                                       GetGUIDLow(), GetUInt32Value(PLAYER_FIELD_DAILY_QUESTS_1 + quest_daily_idx), uint64(m_lastDailyQuestTime));
+    {
+        if (uint32 quest = GetUInt32Value(PLAYER_FIELD_DAILY_QUESTS_1 + quest_daily_idx))
+        {
+            batch << GetGUIDLow() << quest << uint64(m_lastDailyQuestTime);
+            batch.EndRow();
+        }
+    }
+
+    batch.Execute(&m_saveStats);
 }
 
 void Player::_SaveSkills()
 {
-    // we don't need transactions here.
+    SqlBatchInsert batch(CharacterDatabase, "REPLACE INTO character_skills (guid,skill,value,max) VALUES ", 4);
+
     for (SkillStatusMap::iterator itr = mSkillStatus.begin(); itr != mSkillStatus.end();)
     {
         if (itr->second.uState == SKILL_UNCHANGED)
@@ -17120,51 +17189,53 @@ void Player::_SaveSkills()
 
         if (itr->second.uState == SKILL_DELETED)
         {
-            CharacterDatabase.PExecute("DELETE FROM character_skills WHERE guid = '%u' AND skill = '%u'", GetGUIDLow(), itr->first);
+            PreparedValues values(2);
+            values << GetGUIDLow() << itr->first;
+            _SaveExecute("DELETE FROM character_skills WHERE guid = ? AND skill = ?", values);
             mSkillStatus.erase(itr++);
             continue;
         }
 
+        // SKILL_NEW and SKILL_CHANGED write the whole row
         uint32 valueData = GetUInt32Value(PLAYER_SKILL_VALUE_INDEX(itr->second.pos));
-        uint16 value = SKILL_VALUE(valueData);
-        uint16 max = SKILL_MAX(valueData);
+        batch << GetGUIDLow() << itr->first << uint32(SKILL_VALUE(valueData)) << uint32(SKILL_MAX(valueData));
+        batch.EndRow();
 
-        switch (itr->second.uState)
-        {
-            case SKILL_NEW:
-                CharacterDatabase.PExecute("INSERT INTO character_skills (guid, skill, value, max) VALUES ('%u', '%u', '%u', '%u')",
-                                           GetGUIDLow(), itr->first, value, max);
-                break;
-            case SKILL_CHANGED:
-                CharacterDatabase.PExecute("UPDATE character_skills SET value = '%u',max = '%u'WHERE guid = '%u' AND skill = '%u' ",
-                                           value, max, GetGUIDLow(), itr->first );
-                break;
-            case SKILL_UNCHANGED:
-            case SKILL_DELETED:
-                break;
-        };
         itr->second.uState = SKILL_UNCHANGED;
 
         ++itr;
     }
+
+    batch.Execute(&m_saveStats);
 }
 
 void Player::_SaveSpells()
 {
+    SqlBatchInsert batch(CharacterDatabase, "REPLACE INTO character_spell (guid,spell,active,disabled) VALUES ", 4);
+
     for (PlayerSpellMap::iterator itr = m_spells.begin(), next = itr; itr != m_spells.end(); itr = next)
     {
         ++next;
 
-        if (itr->second.state == PLAYERSPELL_REMOVED || itr->second.state == PLAYERSPELL_CHANGED)
-            CharacterDatabase.PExecute("DELETE FROM character_spell WHERE guid = '%u' and spell = '%u'", GetGUIDLow(), itr->first);
-        if (itr->second.state == PLAYERSPELL_NEW || itr->second.state == PLAYERSPELL_CHANGED)
-            CharacterDatabase.PExecute("INSERT INTO character_spell (guid,spell,active,disabled) VALUES ('%u', '%u', '%u', '%u')", GetGUIDLow(), itr->first, itr->second.active ? 1 : 0, itr->second.disabled ? 1 : 0);
+        if (itr->second.state == PLAYERSPELL_REMOVED)
+        {
+            PreparedValues values(2);
+            values << GetGUIDLow() << uint32(itr->first);
+            _SaveExecute("DELETE FROM character_spell WHERE guid = ? AND spell = ?", values);
+        }
+        else if (itr->second.state == PLAYERSPELL_NEW || itr->second.state == PLAYERSPELL_CHANGED)
+        {
+            batch << GetGUIDLow() << uint32(itr->first) << uint32(itr->second.active ? 1 : 0) << uint32(itr->second.disabled ? 1 : 0);
+            batch.EndRow();
+        }
 
         if (itr->second.state == PLAYERSPELL_REMOVED)
             m_spells.erase(itr->first);
         else
             itr->second.state = PLAYERSPELL_UNCHANGED;
     }
+
+    batch.Execute(&m_saveStats);
 }
 
 void Player::_SaveTutorials()
@@ -17172,19 +17243,12 @@ void Player::_SaveTutorials()
     if (!m_TutorialsChanged)
         return;
 
-    uint32 Rows = 0;
-    // it's better than rebuilding indexes multiple times
-    QueryResult_AutoPtr result = CharacterDatabase.PQuery("SELECT count(*) AS r FROM character_tutorial WHERE account = '%u' AND realmid = '%u'", GetSession()->GetAccountId(), realmID);
-    if (result)
-        Rows = result->Fetch()[0].GetUInt32();
-
-    if (Rows)
-    {
-        CharacterDatabase.PExecute("UPDATE character_tutorial SET tut0='%u', tut1='%u', tut2='%u', tut3='%u', tut4='%u', tut5='%u', tut6='%u', tut7='%u' WHERE account = '%u' AND realmid = '%u'",
-                                   m_Tutorials[0], m_Tutorials[1], m_Tutorials[2], m_Tutorials[3], m_Tutorials[4], m_Tutorials[5], m_Tutorials[6], m_Tutorials[7], GetSession()->GetAccountId(), realmID);
-    }
-    else
-        CharacterDatabase.PExecute("INSERT INTO character_tutorial (account,realmid,tut0,tut1,tut2,tut3,tut4,tut5,tut6,tut7) VALUES ('%u', '%u', '%u', '%u', '%u', '%u', '%u', '%u', '%u', '%u')", GetSession()->GetAccountId(), realmID, m_Tutorials[0], m_Tutorials[1], m_Tutorials[2], m_Tutorials[3], m_Tutorials[4], m_Tutorials[5], m_Tutorials[6], m_Tutorials[7]);;
+    // one row per account and realm, REPLACE avoids looking it up first
+    PreparedValues values(10);
+    values << GetSession()->GetAccountId() << uint32(realmID);
+    for (uint8 i = 0; i < 8; ++i)
+        values << m_Tutorials[i];
+    _SaveExecute("REPLACE INTO character_tutorial (account,realmid,tut0,tut1,tut2,tut3,tut4,tut5,tut6,tut7) VALUES (?,?,?,?,?,?,?,?,?,?)", values);
 
     m_TutorialsChanged = false;
 }
@@ -17503,7 +17567,7 @@ void Player::UpdateDuelFlag(time_t currTime)
         return;
 
     // used by eluna
-    sEluna->OnDuelStart(this, duel->opponent);
+    GetEluna()->OnDuelStart(this, duel->opponent);
 
     SetUInt32Value(PLAYER_DUEL_TEAM, 1);
     duel->opponent->SetUInt32Value(PLAYER_DUEL_TEAM, 2);
@@ -19082,7 +19146,7 @@ void Player::ReportedAfkBy(Player* reporter)
 
 bool Player::HaveAtClient(WorldObject const* u) const
 {
-    return u == this || m_clientGUIDs.find(u->GetGUID()) != m_clientGUIDs.end();
+    return u == this || m_clientGUIDs.contains(u->GetGUID());
 }
 
 bool Player::IsNeverVisible() const
@@ -19143,13 +19207,13 @@ bool Player::IsVisibleGloballyFor(Player* u) const
 }
 
 template<class T>
-inline void UpdateVisibilityOf_helper(std::set<uint64>& s64, T* target, std::set<Unit*>& /*v*/)
+inline void UpdateVisibilityOf_helper(Player::ClientGUIDs& s64, T* target, std::set<Unit*>& /*v*/)
 {
     s64.insert(target->GetGUID());
 }
 
 template<>
-inline void UpdateVisibilityOf_helper(std::set<uint64>& s64, GameObject* target, std::set<Unit*>& /*v*/)
+inline void UpdateVisibilityOf_helper(Player::ClientGUIDs& s64, GameObject* target, std::set<Unit*>& /*v*/)
 {
     // Don't update only GAMEOBJECT_TYPE_TRANSPORT
     if ((target->GetGOInfo()->type != GAMEOBJECT_TYPE_TRANSPORT))
@@ -19157,14 +19221,14 @@ inline void UpdateVisibilityOf_helper(std::set<uint64>& s64, GameObject* target,
 }
 
 template<>
-inline void UpdateVisibilityOf_helper(std::set<uint64>& s64, Creature* target, std::set<Unit*>& v)
+inline void UpdateVisibilityOf_helper(Player::ClientGUIDs& s64, Creature* target, std::set<Unit*>& v)
 {
     s64.insert(target->GetGUID());
     v.insert(target);
 }
 
 template<>
-inline void UpdateVisibilityOf_helper(std::set<uint64>& s64, Player* target, std::set<Unit*>& v)
+inline void UpdateVisibilityOf_helper(Player::ClientGUIDs& s64, Player* target, std::set<Unit*>& v)
 {
     s64.insert(target->GetGUID());
     v.insert(target);
@@ -20961,7 +21025,7 @@ void Player::SetHomebindToLocation(WorldLocation const& loc, uint32 area_id)
 void Player::ModifyMoney(int32 d)
 {
     // used by eluna
-    sEluna->OnMoneyChanged(this, d);
+    GetEluna()->OnMoneyChanged(this, d);
 
     if (d < 0)
         SetMoney(GetMoney() > uint32(-d) ? GetMoney() + d : 0);
@@ -20983,14 +21047,42 @@ void Player::RemoveAtLoginFlag(AtLoginFlags f, bool in_db_also /*= false*/)
 
 void Player::_SaveBGData()
 {
-    CharacterDatabase.PExecute("DELETE FROM character_battleground_data WHERE guid='%u'", GetGUIDLow());
+    SqlBatchInsert batch(CharacterDatabase, "INSERT INTO character_battleground_data VALUES ", 11);
     if (m_bgData.bgInstanceID)
     {
         /* guid, bgInstanceID, bgTeam, x, y, z, o, map, taxi[0], taxi[1], mountSpell */
-        CharacterDatabase.PExecute("INSERT INTO character_battleground_data VALUES ('%u', '%u', '%u', '%f', '%f', '%f', '%f', '%u', '%u', '%u', '%u')",
-                                   GetGUIDLow(), m_bgData.bgInstanceID, m_bgData.bgTeam, m_bgData.joinPos.GetPositionX(), m_bgData.joinPos.GetPositionY(), m_bgData.joinPos.GetPositionZ(),
-                                   m_bgData.joinPos.GetOrientation(), m_bgData.joinPos.GetMapId(), m_bgData.taxiPath[0], m_bgData.taxiPath[1], m_bgData.mountSpell);
+        batch << GetGUIDLow() << m_bgData.bgInstanceID << m_bgData.bgTeam
+              << m_bgData.joinPos.GetPositionX() << m_bgData.joinPos.GetPositionY() << m_bgData.joinPos.GetPositionZ() << m_bgData.joinPos.GetOrientation()
+              << uint32(m_bgData.joinPos.GetMapId()) << m_bgData.taxiPath[0] << m_bgData.taxiPath[1] << m_bgData.mountSpell;
+        batch.EndRow();
     }
+
+    _SaveSection(PLAYER_SAVE_BG_DATA, "DELETE FROM character_battleground_data WHERE guid = ?", batch);
+}
+
+void Player::_SaveExecute(const char* sql, PreparedValues& values)
+{
+    CharacterDatabase.PreparedExecute(sql, values);
+
+    ++m_saveStats.rows;
+    m_saveStats.bytes += strlen(sql) + values.GetDataSize();
+}
+
+// Rewrites a whole-section table unless the last save left exactly these rows in it
+void Player::_SaveSection(PlayerSaveSection section, const char* deleteSql, SqlBatchInsert& batch)
+{
+    SavedSection& saved = m_savedSections[section];
+    if (saved.known && saved.rows == batch.GetData())
+        return;
+
+    // remembered once the transaction is queued, see SaveToDB
+    saved.pending = true;
+    saved.pendingRows = batch.GetData();
+
+    PreparedValues values(1);
+    values << GetGUIDLow();
+    _SaveExecute(deleteSql, values);
+    batch.Execute(&m_saveStats);
 }
 
 void Player::SendClearCooldown(uint32 spell_id, Unit* target)
@@ -24,6 +24,7 @@
 #include "Item.h"
 
 #include "Database/DatabaseEnv.h"
+#include "Database/SqlBatchInsert.h"
 #include "DBCStores.h"
 #include "NPCHandler.h"
 #include "QuestDef.h"
@@ -35,6 +36,7 @@
 #include "MapReference.h"
 #include "Utilities/Util.h"                                           // for Tokens typedef
 #include "ReputationMgr.h"
+#include "VisibilitySet.h"
 
 #include<string>
 #include<vector>
@@ -738,6 +740,25 @@ enum PlayerDelayedOperations
     DELAYED_END
 };
 
+// Sections of SaveToDB that are rewritten as a whole, skipped while their content is unchanged
+enum PlayerSaveSection
+{
+    PLAYER_SAVE_AURAS           = 0,
+    PLAYER_SAVE_SPELL_COOLDOWNS = 1,
+    PLAYER_SAVE_BG_DATA         = 2,
+    MAX_PLAYER_SAVE_SECTIONS
+};
+
+// Totals of the rows and bytes written by Player::SaveToDB since startup
+struct PlayerSaveStats
+{
+    uint64 saves;
+    uint64 rows;
+    uint64 bytes;
+    uint32 maxRows;
+    uint32 maxBytes;
+};
+
 // Player summoning auto-decline time (in secs)
 #define MAX_PLAYER_SUMMON_DELAY                   (2*MINUTE)
 #define MAX_MONEY_AMOUNT                       (0x7FFFFFFF-1)
@@ -1528,6 +1549,7 @@ class Player : public Unit, public GridObject<Player>
         void SaveInventoryAndGoldToDB();                    // fast save function for item/money cheating preventing
         void SaveGoldToDB();
         void SaveDataFieldToDB();
+        static void GetSaveStats(PlayerSaveStats& stats);
         static bool SaveValuesArrayInDB(Tokens const& data, uint64 guid);
         static void SetUInt32ValueInArray(Tokens& data, uint16 index, uint32 value);
         static void SetFloatValueInArray(Tokens& data, uint16 index, float value);
@@ -2499,7 +2521,7 @@ class Player : public Unit, public GridObject<Player>
         WorldLocation GetStartPosition() const;
 
         // currently visible objects at player client
-        typedef std::set<uint64> ClientGUIDs;
+        typedef VisibilitySet ClientGUIDs;
         ClientGUIDs m_clientGUIDs;
 
         bool HaveAtClient(WorldObject const* u) const;
@@ -2791,6 +2813,8 @@ class Player : public Unit, public GridObject<Player>
         void _SaveSpells();
         void _SaveTutorials();
         void _SaveBGData();
+        void _SaveExecute(const char* sql, PreparedValues& values);
+        void _SaveSection(PlayerSaveSection section, const char* deleteSql, SqlBatchInsert& batch);
 
         void _SetCreateBits(UpdateMask* updateMask, Player* target) const override;
         void _SetUpdateBits(UpdateMask* updateMask, Player* target) const override;
@@ -2877,6 +2901,17 @@ class Player : public Unit, public GridObject<Player>
         uint32 m_Tutorials[8];
         bool   m_TutorialsChanged;
 
+        // values of the rows the last queued save wrote to the whole-section tables
+        struct SavedSection
+        {
+            bool known;                                     // false until a save of the section got queued
+            std::string rows;                               // SqlBatchInsert::GetData() of that save
+            bool pending;                                   // written by the save in progress
+            std::string pendingRows;
+        };
+        SavedSection m_savedSections[MAX_PLAYER_SAVE_SECTIONS];
+        SqlWriteStats m_saveStats;                          // of the save in progress
+
         bool   m_DailyQuestChanged;
         time_t m_lastDailyQuestTime;
 
@@ -412,7 +412,7 @@ void WorldSession::HandleQuestLogRemoveQuest(WorldPacket& recv_data)
             _player->SetQuestStatus(quest, QUEST_STATUS_NONE);
 
             // used by eluna
-            sEluna->OnQuestAbandon(_player, quest);
+            _player->GetEluna()->OnQuestAbandon(_player, quest);
         }
 
         _player->SetQuestSlot(slot, 0);
@@ -228,7 +228,7 @@ void ReputationMgr::Initialize()
 bool ReputationMgr::SetReputation(FactionEntry const* factionEntry, int32 standing, bool incremental)
 {
     // used by eluna
-    sEluna->OnReputationChange(_player, factionEntry->ID, standing, false);
+    _player->GetEluna()->OnReputationChange(_player, factionEntry->ID, standing, false);
 
     bool res = false;
     // if spillover definition exists in DB
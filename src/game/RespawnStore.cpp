@@ -0,0 +1,209 @@
+/*
+ * This file is part of the OregonCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "RespawnStore.h"
+#include "Database/DatabaseEnv.h"
+#include "Database/SqlBatchInsert.h"
+#include "Log.h"
+
+RespawnStore::RespawnStore(const char* table) : m_table(table)
+{
+}
+
+void RespawnStore::LoadFromDB()
+{
+    for (uint32 i = 0; i < RESPAWN_STORE_SHARDS; ++i)
+    {
+        m_shards[i].times.clear();
+        m_shards[i].changes.clear();
+    }
+
+    // page through the primary key, so the whole table is never held in one result
+    uint32 lastGuid = 0;
+    uint32 lastInstance = 0;
+    bool first = true;
+
+    while (true)
+    {
+        QueryResult_AutoPtr result;
+        if (first)
+            result = WorldDatabase.PQuery("SELECT guid,respawntime,instance FROM %s ORDER BY guid,instance LIMIT %u",
+                                          m_table.c_str(), RESPAWN_STORE_LOAD_ROWS);
+        else
+            result = WorldDatabase.PQuery("SELECT guid,respawntime,instance FROM %s WHERE guid > %u OR (guid = %u AND instance > %u) ORDER BY guid,instance LIMIT %u",
+                                          m_table.c_str(), lastGuid, lastGuid, lastInstance, RESPAWN_STORE_LOAD_ROWS);
+
+        if (!result)
+            break;
+
+        do
+        {
+            Field* fields = result->Fetch();
+
+            lastGuid            = fields[0].GetUInt32();
+            uint64 respawn_time = fields[1].GetUInt64();
+            lastInstance        = fields[2].GetUInt32();
+
+            if (respawn_time)
+                GetShard(lastGuid).times[MAKE_PAIR64(lastGuid, lastInstance)] = time_t(respawn_time);
+        }
+        while (result->NextRow());
+
+        if (result->GetRowCount() < RESPAWN_STORE_LOAD_ROWS)
+            break;
+
+        first = false;
+    }
+}
+
+void RespawnStore::SaveToDB()
+{
+    // taken before the changes: a time set after an instance got deleted must be written after its DELETE
+    std::set<uint32> deletedInstances;
+    {
+        ACE_GUARD(ACE_Thread_Mutex, guard, m_deletedLock);
+        deletedInstances.swap(m_deletedInstances);
+    }
+
+    std::vector<std::pair<uint64, time_t> > changes;
+
+    for (uint32 i = 0; i < RESPAWN_STORE_SHARDS; ++i)
+    {
+        Shard& shard = m_shards[i];
+        ACE_GUARD(ACE_Thread_Mutex, guard, shard.lock);
+
+        for (RespawnTimes::const_iterator itr = shard.changes.begin(); itr != shard.changes.end(); ++itr)
+            changes.push_back(*itr);
+        shard.changes.clear();
+    }
+
+    if (changes.empty() && deletedInstances.empty())
+        return;
+
+    std::string replaceHead = "REPLACE INTO " + m_table + " (guid,respawntime,instance) VALUES ";
+    SqlBatchInsert replaced(WorldDatabase, replaceHead.c_str(), 3);
+
+    // cleared guids by instance: MySQL before 5.7 can't use the primary key for (guid,instance) IN lists
+    typedef std::map<uint32, std::vector<uint32> > DeletedGuids;
+    DeletedGuids deleted;
+
+    for (std::vector<std::pair<uint64, time_t> >::const_iterator itr = changes.begin(); itr != changes.end(); ++itr)
+    {
+        uint32 loguid = PAIR64_LOPART(itr->first);
+        uint32 instance = PAIR64_HIPART(itr->first);
+
+        if (itr->second)
+        {
+            replaced << loguid << uint64(itr->second) << instance;
+            replaced.EndRow();
+        }
+        else
+            deleted[instance].push_back(loguid);
+    }
+
+    SqlWriteStats stats;
+
+    WorldDatabase.BeginTransaction();
+
+    for (std::set<uint32>::const_iterator itr = deletedInstances.begin(); itr != deletedInstances.end(); ++itr)
+        WorldDatabase.PExecute("DELETE FROM %s WHERE instance = '%u'", m_table.c_str(), *itr);
+
+    replaced.Execute(&stats);
+
+    for (DeletedGuids::const_iterator itr = deleted.begin(); itr != deleted.end(); ++itr)
+    {
+        std::ostringstream deleteHead;
+        deleteHead << "DELETE FROM " << m_table << " WHERE instance = " << itr->first << " AND guid IN (";
+
+        SqlBatchInsert guids(WorldDatabase, deleteHead.str().c_str(), 1, SQL_BATCH_MAX_ROWS, ")");
+        for (std::vector<uint32>::const_iterator guid = itr->second.begin(); guid != itr->second.end(); ++guid)
+        {
+            guids << *guid;
+            guids.EndRow();
+        }
+        guids.Execute(&stats);
+    }
+
+    WorldDatabase.CommitTransaction();
+
+    DEBUG_LOG("RespawnStore: saved %u changed respawn times of %s in %u bytes", stats.rows, m_table.c_str(), stats.bytes);
+}
+
+time_t RespawnStore::Get(uint32 loguid, uint32 instance)
+{
+    Shard& shard = GetShard(loguid);
+    ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, shard.lock, 0);
+
+    RespawnTimes::const_iterator itr = shard.times.find(MAKE_PAIR64(loguid, instance));
+    return itr != shard.times.end() ? itr->second : 0;
+}
+
+void RespawnStore::Set(uint32 loguid, uint32 instance, time_t t)
+{
+    uint64 key = MAKE_PAIR64(loguid, instance);
+
+    Shard& shard = GetShard(loguid);
+    ACE_GUARD(ACE_Thread_Mutex, guard, shard.lock);
+
+    if (t)
+        shard.times[key] = t;
+    else
+        shard.times.erase(key);
+
+    shard.changes[key] = t;
+}
+
+void RespawnStore::DeleteInstance(uint32 instance)
+{
+    for (uint32 i = 0; i < RESPAWN_STORE_SHARDS; ++i)
+    {
+        Shard& shard = m_shards[i];
+        ACE_GUARD(ACE_Thread_Mutex, guard, shard.lock);
+
+        for (RespawnTimes::iterator itr = shard.times.begin(); itr != shard.times.end();)
+        {
+            if (PAIR64_HIPART(itr->first) == instance)
+                shard.times.erase(itr++);
+            else
+                ++itr;
+        }
+
+        // the rows are deleted by the next save, pending changes must not bring them back
+        for (RespawnTimes::iterator itr = shard.changes.begin(); itr != shard.changes.end();)
+        {
+            if (PAIR64_HIPART(itr->first) == instance)
+                shard.changes.erase(itr++);
+            else
+                ++itr;
+        }
+    }
+
+    // deleted in the transaction of the next save, so it can't be reordered with its REPLACEs
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_deletedLock);
+    m_deletedInstances.insert(instance);
+}
+
+size_t RespawnStore::size()
+{
+    size_t count = 0;
+    for (uint32 i = 0; i < RESPAWN_STORE_SHARDS; ++i)
+    {
+        ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_shards[i].lock, count);
+        count += m_shards[i].times.size();
+    }
+    return count;
+}
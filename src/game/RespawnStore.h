@@ -0,0 +1,75 @@
+/*
+ * This file is part of the OregonCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __OREGON_RESPAWNSTORE_H
+#define __OREGON_RESPAWNSTORE_H
+
+#include "Common.h"
+#include "Utilities/UnorderedMap.h"
+#include <ace/Thread_Mutex.h>
+
+#define RESPAWN_STORE_SHARDS    16
+#define RESPAWN_STORE_LOAD_ROWS 10000
+
+/**
+ * Respawn times of the creatures or the gameobjects, by spawn guid and instance.
+ *
+ * The map threads read and change them concurrently, each spawn belongs to
+ * one of RESPAWN_STORE_SHARDS shards with its own lock. Changes are not
+ * written right away: only the latest time of each spawn is remembered and
+ * SaveToDB() writes all of them with multi-row REPLACEs, and DELETEs for
+ * the cleared ones and the deleted instances, in one transaction. It is
+ * called by the world thread every RespawnSaveInterval, while the maps are
+ * not updated.
+ */
+class RespawnStore
+{
+    public:
+        explicit RespawnStore(const char* table);
+
+        // reads the table in pages of RESPAWN_STORE_LOAD_ROWS rows
+        void LoadFromDB();
+        void SaveToDB();
+
+        time_t Get(uint32 loguid, uint32 instance);
+        // 0 clears the respawn time
+        void Set(uint32 loguid, uint32 instance, time_t t);
+        // forgets the respawn times of the instance, its rows are deleted by the next SaveToDB()
+        void DeleteInstance(uint32 instance);
+
+        size_t size();
+
+    private:
+        typedef UNORDERED_MAP<uint64/*(instance,guid) pair*/, time_t> RespawnTimes;
+
+        struct Shard
+        {
+            ACE_Thread_Mutex lock;
+            RespawnTimes times;
+            RespawnTimes changes;                           // not saved yet, 0 for deleted
+        };
+
+        Shard& GetShard(uint32 loguid) { return m_shards[loguid % RESPAWN_STORE_SHARDS]; }
+
+        std::string m_table;
+        Shard m_shards[RESPAWN_STORE_SHARDS];
+
+        ACE_Thread_Mutex m_deletedLock;
+        std::set<uint32> m_deletedInstances;               // rows not deleted yet
+};
+
+#endif
@@ -326,7 +326,7 @@ char const* ScriptMgr::ScriptsVersion()
 
 bool ScriptMgr::GossipHello (Player* pPlayer, Creature* pCreature)
 {
-    if (sEluna->OnGossipHello(pPlayer, pCreature))
+    if (pPlayer->GetEluna()->OnGossipHello(pPlayer, pCreature))
         return true;
 
     Script* tmpscript = m_scripts[pCreature->GetScriptId()];
@@ -340,7 +340,7 @@ bool ScriptMgr::GossipSelect(Player* pPlayer, Creature* pCreature, uint32 uiSend
 {
     debug_log("OSCR: Gossip selection, sender: %d, action: %d", uiSender, uiAction);
 
-    if (sEluna->OnGossipSelect(pPlayer, pCreature, uiSender, uiAction))
+    if (pPlayer->GetEluna()->OnGossipSelect(pPlayer, pCreature, uiSender, uiAction))
         return true;
 
     Script* tmpscript = m_scripts[pCreature->GetScriptId()];
@@ -354,7 +354,7 @@ bool ScriptMgr::GossipSelectWithCode(Player* pPlayer, Creature* pCreature, uint3
 {
     debug_log("OSCR: Gossip selection with code, sender: %d, action: %d", uiSender, uiAction);
 
-    if (sEluna->OnGossipSelectCode(pPlayer, pCreature, uiSender, uiAction, sCode))
+    if (pPlayer->GetEluna()->OnGossipSelectCode(pPlayer, pCreature, uiSender, uiAction, sCode))
         return true;
 
     Script* tmpscript = m_scripts[pCreature->GetScriptId()];
@@ -370,7 +370,7 @@ bool ScriptMgr::GOSelect(Player* pPlayer, GameObject* pGO, uint32 uiSender, uint
         return false;
     debug_log("OSCR: Gossip selection, sender: %d, action: %d", uiSender, uiAction);
 
-    if (sEluna->OnGossipSelect(pPlayer, pGO, uiSender, uiAction))
+    if (pPlayer->GetEluna()->OnGossipSelect(pPlayer, pGO, uiSender, uiAction))
         return true;
 
     Script* tmpscript = m_scripts[pGO->GetGOInfo()->ScriptId];
@@ -386,7 +386,7 @@ bool ScriptMgr::GOSelectWithCode(Player* pPlayer, GameObject* pGO, uint32 uiSend
         return false;
     debug_log("OSCR: Gossip selection, sender: %d, action: %d", uiSender, uiAction);
 
-    if (sEluna->OnGossipSelectCode(pPlayer, pGO, uiSender, uiAction, sCode))
+    if (pPlayer->GetEluna()->OnGossipSelectCode(pPlayer, pGO, uiSender, uiAction, sCode))
         return true;
 
     Script* tmpscript = m_scripts[pGO->GetGOInfo()->ScriptId];
@@ -398,7 +398,7 @@ bool ScriptMgr::GOSelectWithCode(Player* pPlayer, GameObject* pGO, uint32 uiSend
 
 bool ScriptMgr::QuestAccept(Player* pPlayer, Creature* pCreature, Quest const* pQuest)
 {
-    if (sEluna->OnQuestAccept(pPlayer, pCreature, pQuest))
+    if (pPlayer->GetEluna()->OnQuestAccept(pPlayer, pCreature, pQuest))
         return true;
 
     Script* tmpscript = m_scripts[pCreature->GetScriptId()];
@@ -438,7 +438,7 @@ bool ScriptMgr::ChooseReward(Player* pPlayer, Creature* pCreature, Quest const*
 uint32 ScriptMgr::NPCDialogStatus(Player* pPlayer, Creature* pCreature)
 {
     // used by eluna
-    if (uint32 dialogId = sEluna->GetDialogStatus(pPlayer, pCreature))
+    if (uint32 dialogId = pPlayer->GetEluna()->GetDialogStatus(pPlayer, pCreature))
         return dialogId;
 
     Script* tmpscript = m_scripts[pCreature->GetScriptId()];
@@ -451,7 +451,7 @@ uint32 ScriptMgr::NPCDialogStatus(Player* pPlayer, Creature* pCreature)
 uint32 ScriptMgr::GODialogStatus(Player* pPlayer, GameObject* pGO)
 {
     // used by eluna
-    if (uint32 dialogId = sEluna->GetDialogStatus(pPlayer, pGO))
+    if (uint32 dialogId = pPlayer->GetEluna()->GetDialogStatus(pPlayer, pGO))
         return dialogId;
 
     Script* tmpscript = m_scripts[pGO->GetGOInfo()->ScriptId];
@@ -472,7 +472,7 @@ bool ScriptMgr::ItemHello(Player* pPlayer, Item* pItem, Quest const* pQuest)
 
 bool ScriptMgr::ItemQuestAccept(Player* pPlayer, Item* pItem, Quest const* pQuest)
 {
-    if (sEluna->OnQuestAccept(pPlayer, pItem, pQuest))
+    if (pPlayer->GetEluna()->OnQuestAccept(pPlayer, pItem, pQuest))
         return true;
 
     Script* tmpscript = m_scripts[pItem->GetProto()->ScriptId];
@@ -484,10 +484,10 @@ bool ScriptMgr::ItemQuestAccept(Player* pPlayer, Item* pItem, Quest const* pQues
 
 bool ScriptMgr::GOHello(Player* pPlayer, GameObject* pGO)
 {
-    if (sEluna->OnGossipHello(pPlayer, pGO))
+    if (pPlayer->GetEluna()->OnGossipHello(pPlayer, pGO))
         return true;
 
-    if (sEluna->OnGameObjectUse(pPlayer, pGO))
+    if (pPlayer->GetEluna()->OnGameObjectUse(pPlayer, pGO))
         return true;
 
     Script* tmpscript = m_scripts[pGO->GetGOInfo()->ScriptId];
@@ -499,7 +499,7 @@ bool ScriptMgr::GOHello(Player* pPlayer, GameObject* pGO)
 
 bool ScriptMgr::GOQuestAccept(Player* pPlayer, GameObject* pGO, Quest const* pQuest)
 {
-    if (sEluna->OnQuestAccept(pPlayer, pGO, pQuest))
+    if (pPlayer->GetEluna()->OnQuestAccept(pPlayer, pGO, pQuest))
         return true;
 
     Script* tmpscript = m_scripts[pGO->GetGOInfo()->ScriptId];
@@ -520,7 +520,7 @@ bool ScriptMgr::GOChooseReward(Player* pPlayer, GameObject* pGO, Quest const* pQ
 
 bool ScriptMgr::AreaTrigger(Player* pPlayer, AreaTriggerEntry const* atEntry)
 {
-    if (sEluna->OnAreaTrigger(pPlayer, atEntry))
+    if (pPlayer->GetEluna()->OnAreaTrigger(pPlayer, atEntry))
         return true;
 
     Script* tmpscript = m_scripts[GetAreaTriggerScriptId(atEntry->id)];
@@ -532,7 +532,7 @@ bool ScriptMgr::AreaTrigger(Player* pPlayer, AreaTriggerEntry const* atEntry)
 CreatureAI* ScriptMgr::GetAI(Creature* pCreature)
 {
     // used by eluna
-    if (CreatureAI* luaAI = sEluna->GetAI(pCreature))
+    if (CreatureAI* luaAI = pCreature->GetEluna()->GetAI(pCreature))
         return luaAI;
 
     Script* tmpscript = m_scripts[pCreature->GetScriptId()];
@@ -543,7 +543,7 @@ CreatureAI* ScriptMgr::GetAI(Creature* pCreature)
 
 bool ScriptMgr::ItemUse(Player* pPlayer, Item* pItem, SpellCastTargets const& targets)
 {
-    if (!sEluna->OnUse(pPlayer, pItem, targets))
+    if (!pPlayer->GetEluna()->OnUse(pPlayer, pItem, targets))
         return true;
 
     Script* tmpscript = m_scripts[pItem->GetProto()->ScriptId];
@@ -554,7 +554,7 @@ bool ScriptMgr::ItemUse(Player* pPlayer, Item* pItem, SpellCastTargets const& ta
 
 bool ScriptMgr::EffectDummyCreature(Unit* caster, uint32 spellId, uint32 effIndex, Creature* crTarget)
 {
-    if (sEluna->OnDummyEffect(caster, spellId, (SpellEffIndex)effIndex, crTarget))
+    if (caster->GetEluna()->OnDummyEffect(caster, spellId, (SpellEffIndex)effIndex, crTarget))
         return true;
 
     Script* tmpscript = m_scripts[crTarget->GetScriptId()];
@@ -566,7 +566,7 @@ bool ScriptMgr::EffectDummyCreature(Unit* caster, uint32 spellId, uint32 effInde
 
 bool ScriptMgr::EffectDummyGO(Unit* caster, uint32 spellId, uint32 effIndex, GameObject* crTarget)
 {
-    if (sEluna->OnDummyEffect(caster, spellId, (SpellEffIndex)effIndex, crTarget))
+    if (caster->GetEluna()->OnDummyEffect(caster, spellId, (SpellEffIndex)effIndex, crTarget))
         return true;
 
     Script* tmpscript = m_scripts[crTarget->GetGOInfo()->ScriptId];
@@ -578,7 +578,7 @@ bool ScriptMgr::EffectDummyGO(Unit* caster, uint32 spellId, uint32 effIndex, Gam
 
 bool ScriptMgr::EffectDummyItem(Unit* caster, uint32 spellId, uint32 effIndex, Item* crTarget)
 {
-    if (sEluna->OnDummyEffect(caster, spellId, (SpellEffIndex)effIndex, crTarget))
+    if (caster->GetEluna()->OnDummyEffect(caster, spellId, (SpellEffIndex)effIndex, crTarget))
         return true;
 
     Script* tmpscript = m_scripts[crTarget->GetProto()->ScriptId];
@@ -15,7 +15,7 @@
 using namespace Hooks;
 
 #define START_HOOK(EVENT) \
-    if (!IsEnabled())\
+    if (!CanRunHooks("server", EVENT))\
         return;\
     auto key = EventKey<ServerEvents>(EVENT);\
     if (!ServerEventBindings->HasBindingsFor(key))\
@@ -23,7 +23,7 @@ using namespace Hooks;
     LOCK_ELUNA
 
 #define START_HOOK_WITH_RETVAL(EVENT, RETVAL) \
-    if (!IsEnabled())\
+    if (!CanRunHooks("server", EVENT))\
         return RETVAL;\
     auto key = EventKey<ServerEvents>(EVENT);\
     if (!ServerEventBindings->HasBindingsFor(key))\
@@ -85,6 +85,24 @@ void Eluna::OnLuaStateOpen()
     CallAllFunctions(ServerEventBindings, key);
 }
 
+void Eluna::OnStateMessage(ElunaStateMessage const& message)
+{
+    START_HOOK(ELUNA_EVENT_ON_STATE_MESSAGE);
+    Push(message.channel);
+    Push(message.data);
+    if (message.fromWorld)
+    {
+        Push();
+        Push();
+    }
+    else
+    {
+        Push(message.fromMapId);
+        Push(message.fromInstanceId);
+    }
+    CallAllFunctions(ServerEventBindings, key);
+}
+
 // AreaTrigger
 bool Eluna::OnAreaTrigger(Player* pPlayer, AreaTriggerEntry const* pTrigger)
 {
@@ -229,6 +247,8 @@ void Eluna::OnWorldUpdate(uint32 diff)
             _ReloadEluna();
     }
 
+    DeliverStateMessages();
+
     eventMgr->globalProcessor->Update(diff);
 
     START_HOOK(WORLD_EVENT_ON_UPDATE);
@@ -25,6 +25,7 @@
 #include "MapManager.h"
 #include "World.h"
 #include "Utilities/Util.h"
+#include "SharedWorldPacket.h"
 
 INSTANTIATE_SINGLETON_1(SocialMgr);
 
@@ -80,6 +81,9 @@ bool PlayerSocial::AddToSocialList(uint32 friend_guid, bool ignore)
         fi.Flags |= flag;
         m_playerSocialMap[friend_guid] = fi;
     }
+
+    if (flag & SOCIAL_FLAG_FRIEND)
+        sSocialMgr.AddFriendLister(friend_guid, GetPlayerGUID());
     return true;
 }
 
@@ -94,6 +98,9 @@ void PlayerSocial::RemoveFromSocialList(uint32 friend_guid, bool ignore)
         flag = SOCIAL_FLAG_IGNORED;
 
     itr->second.Flags &= ~flag;
+    if (flag & SOCIAL_FLAG_FRIEND)
+        sSocialMgr.RemoveFriendLister(friend_guid, GetPlayerGUID());
+
     if (itr->second.Flags == 0)
     {
         CharacterDatabase.PExecute("DELETE FROM character_social WHERE guid = '%u' AND friend = '%u'", GetPlayerGUID(), friend_guid);
@@ -175,6 +182,42 @@ SocialMgr::~SocialMgr()
 {
 }
 
+void SocialMgr::RemovePlayerSocial(uint32 guid)
+{
+    SocialMap::iterator itr = m_socialMap.find(guid);
+    if (itr == m_socialMap.end())
+        return;
+
+    RemoveFriendListers(itr->second);
+    m_socialMap.erase(itr);
+}
+
+void SocialMgr::AddFriendLister(uint32 friendGuid, uint32 listerGuid)
+{
+    ACE_Write_Guard<LockType> guard(m_friendListersLock);
+    m_friendListers[friendGuid].insert(listerGuid);
+}
+
+void SocialMgr::RemoveFriendLister(uint32 friendGuid, uint32 listerGuid)
+{
+    ACE_Write_Guard<LockType> guard(m_friendListersLock);
+
+    FriendListerMap::iterator itr = m_friendListers.find(friendGuid);
+    if (itr == m_friendListers.end())
+        return;
+
+    itr->second.erase(listerGuid);
+    if (itr->second.empty())
+        m_friendListers.erase(itr);
+}
+
+void SocialMgr::RemoveFriendListers(PlayerSocial const& social)
+{
+    for (PlayerSocialMap::const_iterator itr = social.m_playerSocialMap.begin(); itr != social.m_playerSocialMap.end(); ++itr)
+        if (itr->second.Flags & SOCIAL_FLAG_FRIEND)
+            RemoveFriendLister(itr->first, social.m_playerGUID);
+}
+
 void SocialMgr::GetFriendInfo(Player* player, uint32 friendGUID, FriendInfo& friendInfo)
 {
     if (!player)
@@ -288,27 +331,34 @@ void SocialMgr::BroadcastToFriendListers(Player* player, WorldPacket* packet)
     bool gmInWhoList = sWorld.getConfig(CONFIG_GM_IN_WHO_LIST);
     bool allowTwoSideWhoList = sWorld.getConfig(CONFIG_ALLOW_TWO_SIDE_WHO_LIST);
 
-    for (SocialMap::iterator itr = m_socialMap.begin(); itr != m_socialMap.end(); ++itr)
+    ACE_Read_Guard<LockType> guard(m_friendListersLock);
+
+    FriendListerMap::const_iterator listers = m_friendListers.find(guid);
+    if (listers == m_friendListers.end())
+        return;
+
+    SharedWorldPacketPtr shared(*packet);
+    for (std::set<uint32>::const_iterator itr = listers->second.begin(); itr != listers->second.end(); ++itr)
     {
-        PlayerSocialMap::iterator itr2 = itr->second.m_playerSocialMap.find(guid);
-        if (itr2 != itr->second.m_playerSocialMap.end() && (itr2->second.Flags & SOCIAL_FLAG_FRIEND))
-        {
-            Player* pFriend = ObjectAccessor::FindPlayer(MAKE_NEW_GUID(itr->first, 0, HIGHGUID_PLAYER));
-
-            // PLAYER see his team only and PLAYER can't see MODERATOR, GAME MASTER, ADMINISTRATOR characters
-            // MODERATOR, GAME MASTER, ADMINISTRATOR can see all
-            if (pFriend && pFriend->IsInWorld() &&
-                (pFriend->GetSession()->GetSecurity() > SEC_PLAYER ||
-                 ((pFriend->GetTeam() == team || allowTwoSideWhoList) &&
-                  (security == SEC_PLAYER || (gmInWhoList && player->IsVisibleGloballyFor(pFriend))))))
-                pFriend->GetSession()->SendPacket(packet);
-        }
+        Player* pFriend = ObjectAccessor::FindPlayer(MAKE_NEW_GUID(*itr, 0, HIGHGUID_PLAYER));
+
+        // PLAYER see his team only and PLAYER can't see MODERATOR, GAME MASTER, ADMINISTRATOR characters
+        // MODERATOR, GAME MASTER, ADMINISTRATOR can see all
+        if (pFriend && pFriend->IsInWorld() &&
+            (pFriend->GetSession()->GetSecurity() > SEC_PLAYER ||
+             ((pFriend->GetTeam() == team || allowTwoSideWhoList) &&
+              (security == SEC_PLAYER || (gmInWhoList && player->IsVisibleGloballyFor(pFriend))))))
+            pFriend->GetSession()->SendPacket(shared);
     }
 }
 
 PlayerSocial* SocialMgr::LoadFromDB(QueryResult_AutoPtr result, uint32 guid)
 {
     PlayerSocial* social = &m_socialMap[guid];
+
+    // a reload replaces the lists
+    RemoveFriendListers(*social);
+    social->m_playerSocialMap.clear();
     social->SetPlayerGUID(guid);
 
     if (!result)
@@ -327,6 +377,8 @@ PlayerSocial* SocialMgr::LoadFromDB(QueryResult_AutoPtr result, uint32 guid)
         note = fields[2].GetCppString();
 
         social->m_playerSocialMap[friend_guid] = FriendInfo(flags, note);
+        if (flags & SOCIAL_FLAG_FRIEND)
+            AddFriendLister(friend_guid, guid);
 
         // client limit
         if (social->m_playerSocialMap.size() >= (SOCIALMGR_FRIEND_LIMIT + SOCIALMGR_IGNORE_LIMIT))
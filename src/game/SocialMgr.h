@@ -21,6 +21,9 @@
 #include "Policies/Singleton.h"
 #include "Database/DatabaseEnv.h"
 #include "Common.h"
+#include "Utilities/UnorderedMap.h"
+
+#include <ace/RW_Thread_Mutex.h>
 
 class SocialMgr;
 class PlayerSocial;
@@ -76,6 +79,7 @@ struct FriendInfo
 
 typedef std::map<uint32, FriendInfo> PlayerSocialMap;
 typedef std::map<uint32, PlayerSocial> SocialMap;
+typedef UNORDERED_MAP<uint32, std::set<uint32> > FriendListerMap;
 
 // Results of friend related commands
 enum FriendsResult
@@ -147,10 +151,7 @@ class SocialMgr
         SocialMgr();
         ~SocialMgr();
         // Misc
-        void RemovePlayerSocial(uint32 guid)
-        {
-            m_socialMap.erase(guid);
-        }
+        void RemovePlayerSocial(uint32 guid);
 
         void GetFriendInfo(Player* player, uint32 friendGUID, FriendInfo& friendInfo);
         // Packet management
@@ -160,7 +161,18 @@ class SocialMgr
         // Loading
         PlayerSocial* LoadFromDB(QueryResult_AutoPtr result, uint32 guid);
     private:
+        friend class PlayerSocial;
+
+        // the reverse of the friend lists loaded in m_socialMap
+        void AddFriendLister(uint32 friendGuid, uint32 listerGuid);
+        void RemoveFriendLister(uint32 friendGuid, uint32 listerGuid);
+        void RemoveFriendListers(PlayerSocial const& social);
+
         SocialMap m_socialMap;
+
+        typedef ACE_RW_Thread_Mutex LockType;
+        LockType m_friendListersLock;                       // broadcasts also come from map threads
+        FriendListerMap m_friendListers;                    // friend guid -> guids of the players listing him
 };
 
 #define sSocialMgr Oregon::Singleton<SocialMgr>::Instance()
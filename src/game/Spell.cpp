@@ -2440,7 +2440,7 @@ void Spell::cast(bool skipCheck)
 	
     // used by eluna
     if (m_caster->GetTypeId() == TYPEID_PLAYER)
-        sEluna->OnSpellCast(m_caster->ToPlayer(), this, skipCheck);
+        m_caster->GetEluna()->OnSpellCast(m_caster->ToPlayer(), this, skipCheck);
 
     // triggered cast called from Spell::prepare where it was already checked
     if (!skipCheck)
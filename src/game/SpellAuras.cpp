@@ -317,7 +317,7 @@ pAuraHandler AuraHandler[TOTAL_AURAS] =
 
 Aura::Aura(SpellEntry const* spellproto, uint32 eff, int32* currentBasePoints, Unit* target, Unit* caster, Item* castItem) :
     m_procCharges(0), m_spellmod(NULL), m_effIndex(eff), m_caster_guid(0), m_target(target), m_tickNumber(0),
-    m_timeCla(1000), m_castItemGuid(castItem ? castItem->GetGUID() : 0), m_removeMode(AURA_REMOVE_BY_DEFAULT), m_auraSlot(MAX_AURAS),
+    m_timeCla(1000), m_castItemGuid(castItem ? castItem->GetGUID() : 0), m_removeMode(AURA_REMOVE_BY_DEFAULT), m_auraSlot(MAX_AURAS), m_procSlot(PROC_AURA_NO_SLOT),
     m_positive(false), m_permanent(false), m_isPeriodic(false), m_isAreaAura(false),
     m_isPersistent(false), m_isRemovedOnShapeLost(true), m_isRemoved(false), m_in_use(false),
     m_periodicTimer(0), m_amplitude(0), m_PeriodicEventId(0), m_AuraDRGroup(DIMINISHING_NONE)
@@ -45,6 +45,8 @@ struct ProcTriggerSpell;
 // forward decl
 class Aura;
 
+#define PROC_AURA_NO_SLOT 0xFFFFFFFF                        // aura not in the proc aura index
+
 typedef void(Aura::*pAuraHandler)(bool Apply, bool Real);
 // Real == true at aura add/remove
 // Real == false at aura mod unapply/reapply; when adding/removing dependent aura/item/stat mods
@@ -331,6 +333,14 @@ class Aura
         {
             m_auraSlot = slot;
         }
+        uint32 GetProcSlot() const
+        {
+            return m_procSlot;
+        }
+        void SetProcSlot(uint32 slot)
+        {
+            m_procSlot = slot;
+        }
         void UpdateAuraCharges()
         {
             uint8 slot = GetAuraSlot();
@@ -478,6 +488,7 @@ class Aura
         AuraRemoveMode m_removeMode;
 
         uint8 m_auraSlot;
+        uint32 m_procSlot;                                  // slot in the proc aura index of the target
 
         bool m_positive: 1;
         bool m_permanent: 1;
@@ -3681,7 +3681,7 @@ void Spell::EffectSummonType(SpellEffIndex effIndex)
                 }
 
                 if (Unit* summoner = m_caster->ToUnit())
-                    sEluna->OnSummoned(summon, summoner);
+                    summon->GetEluna()->OnSummoned(summon, summoner);
                 break;
             }
         case SUMMON_TYPE_MINIPET:
@@ -3739,7 +3739,7 @@ void Spell::EffectSummonType(SpellEffIndex effIndex)
                 }
 
                 if (Unit* summoner = m_originalCaster->ToUnit())
-                    sEluna->OnSummoned(summon, summoner);
+                    summon->GetEluna()->OnSummoned(summon, summoner);
             }
             return;
         }
@@ -6045,7 +6045,7 @@ void Spell::EffectDuel(SpellEffIndex effIndex)
     target->SetUInt64Value(PLAYER_DUEL_ARBITER, pGameObj->GetGUID());
 
     // used by eluna
-    sEluna->OnDuelRequest(target, caster);
+    target->GetEluna()->OnDuelRequest(target, caster);
 }
 
 void Spell::EffectStuck(SpellEffIndex /*effIndex*/)
@@ -7391,7 +7391,7 @@ void Spell::SummonGuardian(uint32 i, uint32 entry, SummonPropertiesEntry const*
         summon->AI()->EnterEvadeMode();
 
         if (Unit* summoner = m_caster->ToUnit())
-            sEluna->OnSummoned(summon, summoner);
+            summon->GetEluna()->OnSummoned(summon, summoner);
     }
 }
 
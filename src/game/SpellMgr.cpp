@@ -29,6 +29,8 @@ bool IsAreaEffectTarget[TOTAL_SPELL_TARGETS];
 
 SpellMgr::SpellMgr()
 {
+    mSpellProcEventGeneration = 0;
+
     for (int i = 0; i < TOTAL_SPELL_EFFECTS; ++i)
     {
         switch (i)
@@ -1089,6 +1091,7 @@ bool SpellMgr::IsAffectedBySpell(SpellEntry const* spellInfo, uint32 spellId, ui
 void SpellMgr::LoadSpellProcEvents()
 {
     mSpellProcEventMap.clear();                             // need for reload case
+    ++mSpellProcEventGeneration;                            // units index their proc auras again
 
     uint32 count = 0;
 
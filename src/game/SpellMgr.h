@@ -979,6 +979,12 @@ class SpellMgr
             return NULL;
         }
 
+        // changes with each load of spell_proc_event, see Unit::ReindexProcAuras
+        uint32 GetSpellProcEventGeneration() const
+        {
+            return mSpellProcEventGeneration;
+        }
+
         static bool IsSpellProcEventCanTriggeredBy(SpellProcEventEntry const* spellProcEvent, uint32 EventProcFlag, SpellEntry const* procSpell, uint32 procFlags, uint32 procExtra, bool active);
 
         SpellEnchantProcEntry const* GetSpellEnchantProcEvent(uint32 enchId) const
@@ -1227,6 +1233,7 @@ class SpellMgr
         SpellSpellGroupMap mSpellSpellGroup;
         SpellGroupSpellMap mSpellGroupSpell;
         SpellProcEventMap  mSpellProcEventMap;
+        uint32             mSpellProcEventGeneration;
         SkillLineAbilityMap mSkillLineAbilityMap;
         SpellPetAuraMap     mSpellPetAuraMap;
         SpellCustomAttribute  mSpellCustomAttr;
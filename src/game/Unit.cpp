@@ -411,6 +411,8 @@ Unit::Unit(bool isWorldObject):
     m_AuraFlags = 0;
 
     m_interruptMask = 0;
+    m_procAuraSerial = 0;
+    m_procAuraGeneration = sSpellMgr.GetSpellProcEventGeneration();
     m_transform = 0;
     m_ShapeShiftFormSpellId = 0;
     m_canModifyStats = false;
@@ -4003,6 +4005,7 @@ bool Unit::AddAura(Aura* Aur)
         if ((Aur->GetSpellProto()->Attributes & SPELL_ATTR0_HEARTBEAT_RESIST_CHECK)
             && (Aur->GetModifier()->m_auraname != SPELL_AURA_MOD_POSSESS)) //only dummy aura is breakable
             m_ccAuras.push_back(Aur);
+        AddProcAura(Aur);
     }
 
     Aur->ApplyModifier(true, true);
@@ -4494,6 +4497,8 @@ void Unit::RemoveAura(AuraMap::iterator& i, AuraRemoveMode mode)
         if ((Aur->GetSpellProto()->Attributes & SPELL_ATTR0_HEARTBEAT_RESIST_CHECK)
             && (Aur->GetModifier()->m_auraname != SPELL_AURA_MOD_POSSESS)) //only dummy aura is breakable
             m_ccAuras.remove(Aur);
+
+        RemoveProcAura(Aur);
     }
 
     // Set remove mode
@@ -9486,7 +9491,7 @@ void Unit::SetInCombatState(bool PvP, Unit* enemy)
 
     // used by eluna
     if (GetTypeId() == TYPEID_PLAYER)
-        sEluna->OnPlayerEnterCombat(ToPlayer(), enemy);
+        GetEluna()->OnPlayerEnterCombat(ToPlayer(), enemy);
 }
 
 void Unit::ClearInCombat()
@@ -9519,7 +9524,7 @@ void Unit::ClearInCombat()
 
     // used by eluna
     if (GetTypeId() == TYPEID_PLAYER)
-        sEluna->OnPlayerLeaveCombat(ToPlayer());
+        GetEluna()->OnPlayerLeaveCombat(ToPlayer());
 }
 
 void Unit::ClearInPetCombat()
@@ -11476,13 +11481,21 @@ bool Unit::isFrozen() const
 
 struct ProcTriggeredData
 {
-    ProcTriggeredData(SpellProcEventEntry const* _spellProcEvent, Aura* _triggeredByAura)
+    ProcTriggeredData(SpellProcEventEntry const* _spellProcEvent, Aura* _triggeredByAura, uint32 _procSlot, uint32 _procSerial)
         : spellProcEvent(_spellProcEvent), triggeredByAura(_triggeredByAura),
-          triggeredByAura_SpellPair(Unit::spellEffectPair(triggeredByAura->GetId(), triggeredByAura->GetEffIndex()))
+          triggeredByAura_SpellPair(Unit::spellEffectPair(triggeredByAura->GetId(), triggeredByAura->GetEffIndex())),
+          procSlot(_procSlot), procSerial(_procSerial)
     {}
+    // auras proc in the order of the aura map
+    bool operator<(ProcTriggeredData const& other) const
+    {
+        return triggeredByAura_SpellPair < other.triggeredByAura_SpellPair;
+    }
     SpellProcEventEntry const* spellProcEvent;
     Aura* triggeredByAura;
     Unit::spellEffectPair triggeredByAura_SpellPair;
+    uint32 procSlot;                                        // handle in the proc aura index
+    uint32 procSerial;
 };
 
 typedef std::list< ProcTriggeredData > ProcTriggeredList;
@@ -11535,6 +11548,91 @@ void InitTriggerAuraData()
     isNonTriggerAura[SPELL_AURA_RESIST_PUSHBACK] = true;
 }
 
+// Proc flags the aura can ever be triggered by, same rules as IsTriggeredAtSpellProcEvent
+static uint32 GetAuraProcFlags(Aura* aura)
+{
+    uint32 auraName = aura->GetModifier()->m_auraname;
+    if (auraName >= TOTAL_AURAS || isNonTriggerAura[auraName])
+        return 0;
+
+    SpellProcEventEntry const* spellProcEvent = sSpellMgr.GetSpellProcEvent(aura->GetId());
+    if (!isTriggerAura[auraName] && spellProcEvent == NULL)
+        return 0;
+
+    if (spellProcEvent && spellProcEvent->procFlags)
+        return spellProcEvent->procFlags;
+
+    return aura->GetSpellProto()->procFlags;
+}
+
+void Unit::AddProcAura(Aura* aura)
+{
+    uint32 procFlags = GetAuraProcFlags(aura);
+    if (!procFlags)
+        return;
+
+    uint32 slot;
+    if (m_freeProcAuraSlots.empty())
+    {
+        slot = m_procAuras.size();
+        m_procAuras.push_back(ProcAura());
+    }
+    else
+    {
+        slot = m_freeProcAuraSlots.back();
+        m_freeProcAuraSlots.pop_back();
+    }
+
+    SpellEntry const* spellproto = aura->GetSpellProto();
+
+    ProcAura& procAura = m_procAuras[slot];
+    procAura.aura = aura;
+    procAura.procFlags = procFlags;
+    procAura.serial = ++m_procAuraSerial;
+    procAura.triggerSpell = false;
+    for (uint32 i = 0; i < MAX_SPELL_EFFECTS; ++i)
+        if (spellproto->Effect[i] == SPELL_EFFECT_TRIGGER_SPELL)
+            procAura.triggerSpell = true;
+
+    aura->SetProcSlot(slot);
+}
+
+void Unit::RemoveProcAura(Aura* aura)
+{
+    uint32 slot = aura->GetProcSlot();
+    if (slot >= m_procAuras.size() || m_procAuras[slot].aura != aura)
+        return;
+
+    aura->SetProcSlot(PROC_AURA_NO_SLOT);
+
+    // the slot is kept, procs being handled check it by serial
+    ProcAura& procAura = m_procAuras[slot];
+    procAura.aura = NULL;
+    procAura.procFlags = 0;
+
+    if (m_freeProcAuraSlots.size() + 1 == m_procAuras.size())
+    {
+        m_procAuras.clear();
+        m_freeProcAuraSlots.clear();
+    }
+    else
+        m_freeProcAuraSlots.push_back(slot);
+}
+
+void Unit::ReindexProcAuras()
+{
+    for (ProcAuraList::const_iterator itr = m_procAuras.begin(); itr != m_procAuras.end(); ++itr)
+        if (itr->aura)
+            itr->aura->SetProcSlot(PROC_AURA_NO_SLOT);
+
+    m_procAuras.clear();
+    m_freeProcAuraSlots.clear();
+    m_procAuraGeneration = sSpellMgr.GetSpellProcEventGeneration();
+
+    for (AuraMap::const_iterator itr = m_Auras.begin(); itr != m_Auras.end(); ++itr)
+        AddProcAura(itr->second);
+}
+
 uint32 createProcExtendMask(SpellNonMeleeDamage* damageInfo, SpellMissInfo missCondition)
 {
     uint32 procEx = PROC_EX_NONE;
@@ -11683,53 +11781,37 @@ void Unit::ProcDamageAndSpellFor(bool isVictim, Unit* pTarget, uint32 procFlag,
         }
     }
 
+    // spell_proc_event reloaded since the proc auras were indexed
+    if (m_procAuraGeneration != sSpellMgr.GetSpellProcEventGeneration())
+        ReindexProcAuras();
+
     RemoveSpellList removedSpells;
     ProcTriggeredList procTriggered;
-    // Fill procTriggered list
-    for (AuraMap::const_iterator itr = GetAuras().begin(); itr != GetAuras().end(); ++itr)
+    // Fill procTriggered list, only auras listening to one of the proc flags are checked
+    bool damageActive = damage || (procExtra & PROC_EX_BLOCK && isVictim);
+    for (uint32 slot = 0; slot < m_procAuras.size(); ++slot)
     {
-        SpellProcEventEntry const* spellProcEvent = NULL;
-        bool active = damage || (procExtra & PROC_EX_BLOCK && isVictim);
-
-        SpellEntry const* spellproto = sSpellStore.LookupEntry(itr->second->GetId());
+        if (!(m_procAuras[slot].procFlags & procFlag))
+            continue;
 
-        for (uint32 i = 0; i < MAX_SPELL_EFFECTS; ++i)
-            if (spellproto->Effect[i] == SPELL_EFFECT_TRIGGER_SPELL)
-                active = true;
+        // the index can grow while checking, don't keep a reference into it
+        Aura* aura = m_procAuras[slot].aura;
+        uint32 serial = m_procAuras[slot].serial;
+        bool active = damageActive || m_procAuras[slot].triggerSpell;
 
-        if (!IsTriggeredAtSpellProcEvent(pTarget, itr->second, procSpell, procFlag, procExtra, attType, isVictim, active, spellProcEvent))
+        SpellProcEventEntry const* spellProcEvent = NULL;
+        if (!IsTriggeredAtSpellProcEvent(pTarget, aura, procSpell, procFlag, procExtra, attType, isVictim, active, spellProcEvent))
             continue;
 
-        procTriggered.push_back(ProcTriggeredData(spellProcEvent, itr->second));
+        procTriggered.push_back(ProcTriggeredData(spellProcEvent, aura, slot, serial));
     }
+    procTriggered.sort();
     // Handle effects proceed this time
     for (ProcTriggeredList::iterator i = procTriggered.begin(); i != procTriggered.end(); ++i)
     {
         // Some auras can be deleted in function called in this loop (except first, ofc)
-        // Until storing auars in std::multimap to hard check deleting by another way
-        if (i != procTriggered.begin())
-        {
-            bool found = false;
-            AuraMap::const_iterator lower = GetAuras().lower_bound(i->triggeredByAura_SpellPair);
-            AuraMap::const_iterator upper = GetAuras().upper_bound(i->triggeredByAura_SpellPair);
-            for (AuraMap::const_iterator itr = lower; itr != upper; ++itr)
-            {
-                if (itr->second == i->triggeredByAura)
-                {
-                    found = true;
-                    break;
-                }
-            }
-            if (!found)
-            {
-                //                sLog.outDebug("Spell aura %u (id:%u effect:%u) has been deleted before call spell proc event handler", i->triggeredByAura->GetModifier()->m_auraname, i->triggeredByAura_SpellPair.first, i->triggeredByAura_SpellPair.second);
-                //                sLog.outDebug("It can be deleted one from early proccesed auras:");
-                //                for (ProcTriggeredList::iterator i2 = procTriggered.begin(); i != i2; ++i2)
-                //                    sLog.outDebug("     Spell aura %u (id:%u effect:%u)", i->triggeredByAura->GetModifier()->m_auraname,i2->triggeredByAura_SpellPair.first,i2->triggeredByAura_SpellPair.second);
-                //                    sLog.outDebug("     <end of list>");
-                continue;
-            }
-        }
+        if (!IsProcAuraValid(i->procSlot, i->procSerial))
+            continue;
 
         SpellProcEventEntry const* spellProcEvent = i->spellProcEvent;
         Aura* triggeredByAura = i->triggeredByAura;
@@ -11852,22 +11934,13 @@ void Unit::ProcDamageAndSpellFor(bool isVictim, Unit* pTarget, uint32 procFlag,
             break;
         }
         // Remove charge (aura can be removed by triggers)
-        if (useCharges)
+        // need found aura on drop (can be dropped by triggers)
+        if (useCharges && IsProcAuraValid(i->procSlot, i->procSerial))
         {
-            // need found aura on drop (can be dropped by triggers)
-            AuraMap::const_iterator lower = GetAuras().lower_bound(i->triggeredByAura_SpellPair);
-            AuraMap::const_iterator upper = GetAuras().upper_bound(i->triggeredByAura_SpellPair);
-            for (AuraMap::const_iterator itr = lower; itr != upper; ++itr)
-            {
-                if (itr->second == i->triggeredByAura)
-                {
-                    triggeredByAura->m_procCharges -= 1;
-                    triggeredByAura->UpdateAuraCharges();
-                    if (triggeredByAura->m_procCharges <= 0)
-                        removedSpells.push_back(triggeredByAura->GetId());
-                    break;
-                }
-            }
+            triggeredByAura->m_procCharges -= 1;
+            triggeredByAura->UpdateAuraCharges();
+            if (triggeredByAura->m_procCharges <= 0)
+                removedSpells.push_back(triggeredByAura->GetId());
         }
 
         if (spellInfo->AttributesEx3 & SPELL_ATTR3_DISABLE_PROC)
@@ -12163,10 +12236,19 @@ Unit* Unit::SelectNearbyTarget(Unit* exclude, float dist) const
     if (exclude)
         targets.remove(exclude);
 
-    // remove not LoS targets
-    for (std::list<Unit* >::iterator tIter = targets.begin(); tIter != targets.end();)
+    // remove not LoS targets, checked together
+    std::vector<VMAP::LineOfSightQuery> queries(targets.size());
+    uint32 i = 0;
+    for (std::list<Unit* >::const_iterator tIter = targets.begin(); tIter != targets.end(); ++tIter, ++i)
+        GetLineOfSightTo(*tIter, queries[i]);
+
+    if (!queries.empty())
+        GetMap()->isInLineOfSight(&queries[0], queries.size());
+
+    i = 0;
+    for (std::list<Unit* >::iterator tIter = targets.begin(); tIter != targets.end(); ++i)
     {
-        if (!IsWithinLOSInMap(*tIter))
+        if (!queries[i].result)
         {
             std::list<Unit* >::iterator tIter2 = tIter;
             ++tIter;
@@ -12876,7 +12958,7 @@ void Unit::Kill(Unit* victim, bool durabilityLoss)
             {
                 // used by eluna
                 if (Player* killed = victim->ToPlayer())
-                    sEluna->OnPlayerKilledByCreature(killer, killed);
+                    killer->GetEluna()->OnPlayerKilledByCreature(killer, killed);
             }
         }
         else if (Guardian* pPet = GetGuardianPet())
@@ -12897,7 +12979,7 @@ void Unit::Kill(Unit* victim, bool durabilityLoss)
                 if (Player* killer = ToPlayer())
                 {
                     // used by eluna
-                    sEluna->OnPVPKill(killer, killed);
+                    killer->GetEluna()->OnPVPKill(killer, killed);
                 }
             }
         }
@@ -12929,7 +13011,7 @@ void Unit::Kill(Unit* victim, bool durabilityLoss)
             {
                 // used by eluna
                 if (Player* killer = ToPlayer())
-                    sEluna->OnCreatureKill(killer, killed);
+                    killer->GetEluna()->OnCreatureKill(killer, killed);
             }
         }
 
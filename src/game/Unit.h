@@ -915,6 +915,16 @@ class Unit : public WorldObject
         typedef std::pair<uint32, uint8> spellEffectPair;
         typedef std::multimap< spellEffectPair, Aura*> AuraMap;
         typedef std::list<Aura*> AuraList;
+
+        // aura able to react to procs, with the proc flags it listens to
+        struct ProcAura
+        {
+            Aura* aura;                                     // NULL for a free slot
+            uint32 procFlags;
+            uint32 serial;                                  // changes each time the slot is reused
+            bool triggerSpell;                              // has a SPELL_EFFECT_TRIGGER_SPELL effect, procs without damage
+        };
+        typedef std::vector<ProcAura> ProcAuraList;
         typedef std::list<DiminishingReturn> Diminishing;
         typedef std::set<AuraType> AuraTypeSet;
         typedef std::set<uint32> ComboPointHolderSet;
@@ -2050,6 +2060,20 @@ class Unit : public WorldObject
         AuraList m_ccAuras;
         uint32 m_interruptMask;
 
+        // flat index of the auras that can proc, slots stay in place while the aura exists
+        ProcAuraList m_procAuras;
+        std::vector<uint32> m_freeProcAuraSlots;
+        uint32 m_procAuraSerial;
+        uint32 m_procAuraGeneration;               // spell_proc_event data the index was built from
+
+        void AddProcAura(Aura* aura);
+        void RemoveProcAura(Aura* aura);
+        void ReindexProcAuras();
+        bool IsProcAuraValid(uint32 slot, uint32 serial) const
+        {
+            return slot < m_procAuras.size() && m_procAuras[slot].serial == serial && m_procAuras[slot].aura;
+        }
+
         float m_auraModifiersGroup[UNIT_MOD_END][MODIFIER_TYPE_END];
         float m_weaponDamage[MAX_ATTACK][2];
         bool m_canModifyStats;
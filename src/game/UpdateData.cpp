@@ -24,6 +24,8 @@
 #include "World.h"
 #include "zlib.h"
 
+#include <ace/TSS_T.h>
+
 UpdateData::UpdateData() : m_blockCount(0)
 {
 }
@@ -44,29 +46,96 @@ void UpdateData::AddUpdateBlock(const ByteBuffer& block)
     ++m_blockCount;
 }
 
-void UpdateData::Compress(void* dst, uint32* dst_size, void* src, int src_size)
+// Each thread building update packets keeps its own deflate stream, reset
+// between packets instead of being created and destroyed for each of them,
+// and its own buffer for the packet header.
+class UpdateCompressor
 {
-    z_stream c_stream;
+    public:
+        UpdateCompressor() : m_level(-1)
+        {
+            memset(&m_stream, 0, sizeof(m_stream));
+            m_stream.zalloc = &UpdateCompressor::Alloc;
+            m_stream.zfree = &UpdateCompressor::Free;
+            m_stream.opaque = (voidpf)this;
+        }
+
+        ~UpdateCompressor()
+        {
+            if (m_level >= 0)
+                deflateEnd(&m_stream);
+        }
+
+        ByteBuffer& GetHeader()
+        {
+            m_header.clear();
+            return m_header;
+        }
+
+        // compress header and data as one stream, dst_size is 0 on failure
+        void Compress(uint8* dst, uint32* dst_size, ByteBuffer const& header, ByteBuffer const& data);
+
+        UpdateCompressionStats stats;
+
+    private:
+        static voidpf Alloc(voidpf opaque, uInt items, uInt size)
+        {
+            ++((UpdateCompressor*)opaque)->stats.zlibAllocs;
+            return malloc(items * size);
+        }
+
+        static void Free(voidpf /*opaque*/, voidpf address)
+        {
+            free(address);
+        }
 
-    c_stream.zalloc = (alloc_func)0;
-    c_stream.zfree = (free_func)0;
-    c_stream.opaque = (voidpf)0;
+        z_stream m_stream;
+        int m_level;                                        // level of the initialized stream, -1 if none
+        ByteBuffer m_header;
+};
 
+typedef ACE_TSS<UpdateCompressor> UpdateCompressorTSS;
+static UpdateCompressorTSS updateCompressor;
+
+void UpdateCompressor::Compress(uint8* dst, uint32* dst_size, ByteBuffer const& header, ByteBuffer const& data)
+{
     // default Z_BEST_SPEED (1)
-    int z_res = deflateInit(&c_stream, sWorld.getConfig(CONFIG_COMPRESSION));
-    if (z_res != Z_OK)
+    int level = sWorld.getConfig(CONFIG_COMPRESSION);
+
+    int z_res;
+    if (level != m_level)
     {
-        sLog.outError("Can't compress update packet (zlib: deflateInit) Error code: %i (%s)", z_res, zError(z_res));
-        *dst_size = 0;
-        return;
+        if (m_level >= 0)
+            deflateEnd(&m_stream);
+
+        m_level = -1;
+        z_res = deflateInit(&m_stream, level);
+        if (z_res != Z_OK)
+        {
+            sLog.outError("Can't compress update packet (zlib: deflateInit) Error code: %i (%s)", z_res, zError(z_res));
+            *dst_size = 0;
+            return;
+        }
+
+        m_level = level;
+    }
+    else
+    {
+        z_res = deflateReset(&m_stream);
+        if (z_res != Z_OK)
+        {
+            sLog.outError("Can't compress update packet (zlib: deflateReset) Error code: %i (%s)", z_res, zError(z_res));
+            *dst_size = 0;
+            return;
+        }
     }
 
-    c_stream.next_out = (Bytef*)dst;
-    c_stream.avail_out = *dst_size;
-    c_stream.next_in = (Bytef*)src;
-    c_stream.avail_in = (uInt)src_size;
+    m_stream.next_out = (Bytef*)dst;
+    m_stream.avail_out = *dst_size;
+    m_stream.next_in = (Bytef*)header.contents();
+    m_stream.avail_in = (uInt)header.wpos();
 
-    z_res = deflate(&c_stream, Z_NO_FLUSH);
+    z_res = deflate(&m_stream, Z_NO_FLUSH);
     if (z_res != Z_OK)
     {
         sLog.outError("Can't compress update packet (zlib: deflate) Error code: %i (%s)", z_res, zError(z_res));
@@ -74,35 +143,61 @@ void UpdateData::Compress(void* dst, uint32* dst_size, void* src, int src_size)
         return;
     }
 
-    if (c_stream.avail_in != 0)
+    if (m_stream.avail_in != 0)
     {
         sLog.outError("Can't compress update packet (zlib: deflate not greedy)");
         *dst_size = 0;
         return;
     }
 
-    z_res = deflate(&c_stream, Z_FINISH);
-    if (z_res != Z_STREAM_END)
+    if (data.wpos())
     {
-        sLog.outError("Can't compress update packet (zlib: deflate should report Z_STREAM_END instead %i (%s)", z_res, zError(z_res));
-        *dst_size = 0;
-        return;
+        m_stream.next_in = (Bytef*)data.contents();
+        m_stream.avail_in = (uInt)data.wpos();
     }
 
-    z_res = deflateEnd(&c_stream);
-    if (z_res != Z_OK)
+    z_res = deflate(&m_stream, Z_FINISH);
+    if (z_res != Z_STREAM_END)
     {
-        sLog.outError("Can't compress update packet (zlib: deflateEnd) Error code: %i (%s)", z_res, zError(z_res));
+        sLog.outError("Can't compress update packet (zlib: deflate should report Z_STREAM_END instead %i (%s)", z_res, zError(z_res));
         *dst_size = 0;
         return;
     }
 
-    *dst_size = c_stream.total_out;
+    *dst_size = m_stream.total_out;
+
+    ++stats.packets;
+    stats.bytesIn += m_stream.total_in;
+    stats.bytesOut += m_stream.total_out;
+}
+
+UpdateCompressionStats const& UpdateData::GetCompressionStats()
+{
+    return updateCompressor->stats;
+}
+
+bool UpdateData::CompressPacket(WorldPacket* packet, ByteBuffer const& data)
+{
+    UpdateCompressor* compressor = updateCompressor;
+
+    uint32 destsize = compressBound(data.wpos());
+    packet->resize(destsize + sizeof(uint32));
+
+    packet->put<uint32>(0, data.wpos());
+    // the data goes in as the header, it must not be empty
+    compressor->Compress(const_cast<uint8*>(packet->contents()) + sizeof(uint32), &destsize, data, compressor->GetHeader());
+    if (destsize == 0)
+        return false;
+
+    packet->resize(destsize + sizeof(uint32));
+    return true;
 }
 
 bool UpdateData::BuildPacket(WorldPacket* packet, bool hasTransport)
 {
-    ByteBuffer buf(4 + 1 + (m_outOfRangeGUIDs.empty() ? 0 : 1 + 4 + 9 * m_outOfRangeGUIDs.size()) + m_data.size());
+    UpdateCompressor* compressor = updateCompressor;
+
+    ByteBuffer& buf = compressor->GetHeader();
 
     buf << (uint32) (!m_outOfRangeGUIDs.empty() ? m_blockCount + 1 : m_blockCount);
     buf << (uint8) (hasTransport ? 1 : 0);
@@ -120,9 +215,7 @@ bool UpdateData::BuildPacket(WorldPacket* packet, bool hasTransport)
         }
     }
 
-    buf.append(m_data);
-
-    size_t pSize = buf.wpos();                              // use real used data size
+    size_t pSize = buf.wpos() + m_data.wpos();              // use real used data size
 
     if (pSize > 100)                                       // compress large packets
     {
@@ -130,7 +223,7 @@ bool UpdateData::BuildPacket(WorldPacket* packet, bool hasTransport)
         packet->resize(destsize + sizeof(uint32));
 
         packet->put<uint32>(0, pSize);
-        Compress(const_cast<uint8*>(packet->contents()) + sizeof(uint32), &destsize, (void*)buf.contents(), pSize);
+        compressor->Compress(const_cast<uint8*>(packet->contents()) + sizeof(uint32), &destsize, buf, m_data);
         if (destsize == 0)
             return false;
 
@@ -140,6 +233,7 @@ bool UpdateData::BuildPacket(WorldPacket* packet, bool hasTransport)
     else                                                    // send small packets without compression
     {
         packet->append(buf);
+        packet->append(m_data);
         packet->SetOpcode(SMSG_UPDATE_OBJECT);
     }
 
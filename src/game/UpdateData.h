@@ -43,6 +43,17 @@ enum ObjectUpdateFlags
     UPDATEFLAG_HAS_POSITION         = 0x0040,
 };
 
+// counters of the update packet compression done by the calling thread
+struct UpdateCompressionStats
+{
+    UpdateCompressionStats() : packets(0), bytesIn(0), bytesOut(0), zlibAllocs(0) {}
+
+    uint64 packets;
+    uint64 bytesIn;
+    uint64 bytesOut;
+    uint64 zlibAllocs;                                      // allocations done by zlib, only at stream (re)initialization
+};
+
 class UpdateData
 {
     public:
@@ -63,12 +74,15 @@ class UpdateData
             return m_outOfRangeGUIDs;
         }
 
+        static UpdateCompressionStats const& GetCompressionStats();
+
+        // deflates data into packet behind its uncompressed size, for the other compressed opcodes
+        static bool CompressPacket(WorldPacket* packet, ByteBuffer const& data);
+
     protected:
         uint32 m_blockCount;
         std::set<uint64> m_outOfRangeGUIDs;
         ByteBuffer m_data;
-
-        void Compress(void* dst, uint32* dst_size, void* src, int src_size);
 };
 #endif
 
@@ -0,0 +1,171 @@
+/*
+ * This file is part of the OregonCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "VisibilitySet.h"
+
+#define MIN_VISIBILITY_SET_SLOTS 64
+
+VisibilitySet::VisibilitySet() : m_shift(64), m_size(0), m_removed(0), m_generation(1)
+{
+}
+
+VisibilitySet::Slot* VisibilitySet::Find(uint64 guid)
+{
+    return const_cast<Slot*>(static_cast<VisibilitySet const*>(this)->Find(guid));
+}
+
+VisibilitySet::Slot const* VisibilitySet::Find(uint64 guid) const
+{
+    if (!m_size || guid == EMPTY || guid == REMOVED)
+        return NULL;
+
+    size_t mask = m_slots.size() - 1;
+    for (size_t i = Index(guid); ; i = (i + 1) & mask)
+    {
+        Slot const& slot = m_slots[i];
+        if (slot.guid == guid)
+            return &slot;
+        if (slot.guid == EMPTY)
+            return NULL;
+    }
+}
+
+void VisibilitySet::insert(uint64 guid)
+{
+    if (guid == EMPTY || guid == REMOVED)
+        return;
+
+    // keep a quarter of the slots empty so lookups stop early
+    if ((m_size + m_removed + 1) * 4 > m_slots.size() * 3)
+        Rehash(std::max<size_t>(MIN_VISIBILITY_SET_SLOTS, (m_size + 1) * 2));
+
+    size_t mask = m_slots.size() - 1;
+    Slot* reuse = NULL;
+    for (size_t i = Index(guid); ; i = (i + 1) & mask)
+    {
+        Slot& slot = m_slots[i];
+        if (slot.guid == guid)
+            return;
+
+        if (slot.guid == REMOVED)
+        {
+            if (!reuse)
+                reuse = &slot;
+        }
+        else if (slot.guid == EMPTY)
+        {
+            if (reuse)
+                --m_removed;
+            else
+                reuse = &slot;
+            break;
+        }
+    }
+
+    reuse->guid = guid;
+    reuse->stamp = m_generation;
+    ++m_size;
+}
+
+void VisibilitySet::erase(uint64 guid)
+{
+    if (Slot* slot = Find(guid))
+    {
+        slot->guid = REMOVED;
+        --m_size;
+        ++m_removed;
+    }
+}
+
+void VisibilitySet::clear()
+{
+    for (std::vector<Slot>::iterator itr = m_slots.begin(); itr != m_slots.end(); ++itr)
+        itr->guid = EMPTY;
+
+    m_size = 0;
+    m_removed = 0;
+}
+
+void VisibilitySet::BeginPass()
+{
+    // on wrap around old stamps could match again, clear them
+    if (!++m_generation)
+    {
+        for (std::vector<Slot>::iterator itr = m_slots.begin(); itr != m_slots.end(); ++itr)
+            itr->stamp = 0;
+        m_generation = 1;
+    }
+}
+
+bool VisibilitySet::Mark(uint64 guid)
+{
+    Slot* slot = Find(guid);
+    if (!slot || slot->stamp == m_generation)
+        return false;
+
+    slot->stamp = m_generation;
+    return true;
+}
+
+std::vector<uint64> const& VisibilitySet::EraseUnmarked()
+{
+    m_unmarked.clear();
+
+    for (std::vector<Slot>::iterator itr = m_slots.begin(); itr != m_slots.end(); ++itr)
+    {
+        if (itr->guid == EMPTY || itr->guid == REMOVED || itr->stamp == m_generation)
+            continue;
+
+        m_unmarked.push_back(itr->guid);
+        itr->guid = REMOVED;
+        --m_size;
+        ++m_removed;
+    }
+
+    return m_unmarked;
+}
+
+void VisibilitySet::Rehash(size_t capacity)
+{
+    size_t slots = MIN_VISIBILITY_SET_SLOTS;
+    uint32 shift = 64 - 6;
+    while (slots < capacity)
+    {
+        slots <<= 1;
+        --shift;
+    }
+
+    std::vector<Slot> old;
+    old.swap(m_slots);
+
+    Slot empty = { EMPTY, 0 };
+    m_slots.assign(slots, empty);
+    m_shift = shift;
+    m_removed = 0;
+
+    size_t mask = slots - 1;
+    for (std::vector<Slot>::const_iterator itr = old.begin(); itr != old.end(); ++itr)
+    {
+        if (itr->guid == EMPTY || itr->guid == REMOVED)
+            continue;
+
+        size_t i = Index(itr->guid);
+        while (m_slots[i].guid != EMPTY)
+            i = (i + 1) & mask;
+        m_slots[i] = *itr;
+    }
+}
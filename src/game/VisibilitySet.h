@@ -0,0 +1,115 @@
+/*
+ * This file is part of the OregonCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef OREGON_VISIBILITYSET_H
+#define OREGON_VISIBILITYSET_H
+
+#include "Common.h"
+#include <iterator>
+#include <vector>
+
+/**
+ * Set of the guids a client knows about, stored flat with open addressing.
+ *
+ * Visibility updates run in passes: BeginPass() starts one, every object
+ * still in sight is marked, and EraseUnmarked() removes the others. Marks
+ * are generation stamps kept in the slots, so a pass needs neither a copy
+ * of the set nor any allocation. Guids inserted during a pass count as
+ * marked.
+ */
+class VisibilitySet
+{
+    private:
+        struct Slot
+        {
+            uint64 guid;
+            uint32 stamp;                                   // generation of the pass that last marked it
+        };
+
+    public:
+        class const_iterator
+        {
+            public:
+                typedef std::forward_iterator_tag iterator_category;
+                typedef uint64 value_type;
+                typedef ptrdiff_t difference_type;
+                typedef uint64 const* pointer;
+                typedef uint64 const& reference;
+
+                const_iterator() : m_slot(NULL), m_end(NULL) {}
+                const_iterator(Slot const* slot, Slot const* end) : m_slot(slot), m_end(end) { Skip(); }
+
+                uint64 const& operator*() const { return m_slot->guid; }
+                const_iterator& operator++() { ++m_slot; Skip(); return *this; }
+                bool operator==(const_iterator const& other) const { return m_slot == other.m_slot; }
+                bool operator!=(const_iterator const& other) const { return m_slot != other.m_slot; }
+
+            private:
+                void Skip()
+                {
+                    while (m_slot != m_end && (m_slot->guid == EMPTY || m_slot->guid == REMOVED))
+                        ++m_slot;
+                }
+
+                Slot const* m_slot;
+                Slot const* m_end;
+        };
+        typedef const_iterator iterator;
+
+        VisibilitySet();
+
+        bool empty() const { return !m_size; }
+        size_t size() const { return m_size; }
+
+        bool contains(uint64 guid) const { return Find(guid) != NULL; }
+        void insert(uint64 guid);
+        void erase(uint64 guid);
+        void clear();
+
+        const_iterator begin() const { return const_iterator(m_slots.empty() ? NULL : &m_slots[0], End()); }
+        const_iterator end() const { return const_iterator(End(), End()); }
+
+        void BeginPass();
+        // Marks the guid as still visible, false if it is not in the set or already marked
+        bool Mark(uint64 guid);
+        // Erases the guids not marked since BeginPass(), the returned list is valid until the next call
+        std::vector<uint64> const& EraseUnmarked();
+
+    private:
+        static const uint64 EMPTY = 0;
+        static const uint64 REMOVED = UI64LIT(0xFFFFFFFFFFFFFFFF);
+
+        size_t Index(uint64 guid) const
+        {
+            // fibonacci hashing, guids of one type only differ in their low bits
+            return size_t((guid * UI64LIT(0x9E3779B97F4A7C15)) >> m_shift);
+        }
+
+        Slot const* End() const { return m_slots.empty() ? NULL : &m_slots[0] + m_slots.size(); }
+        Slot* Find(uint64 guid);
+        Slot const* Find(uint64 guid) const;
+        void Rehash(size_t capacity);
+
+        std::vector<Slot> m_slots;                          // power of two sized
+        uint32 m_shift;
+        size_t m_size;
+        size_t m_removed;                                   // REMOVED slots, reused by inserts
+        uint32 m_generation;
+        std::vector<uint64> m_unmarked;
+};
+
+#endif
@@ -0,0 +1,247 @@
+/*
+ * This file is part of the OregonCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "WhoListCache.h"
+#include "ObjectAccessor.h"
+#include "ObjectMgr.h"
+#include "Player.h"
+#include "MapManager.h"
+#include "DBCStores.h"
+#include "World.h"
+#include "Utilities/Util.h"
+
+INSTANTIATE_SINGLETON_1(WhoListCache);
+
+namespace
+{
+    bool LevelLess(WhoListEntry const& a, WhoListEntry const& b)
+    {
+        return a.level < b.level;
+    }
+
+    bool EntryLevelBelow(WhoListEntry const& entry, uint32 level)
+    {
+        return entry.level < level;
+    }
+
+    uint32 TeamIndex(uint32 team)
+    {
+        return team == ALLIANCE ? 0 : 1;
+    }
+}
+
+WhoListCache::WhoListCache() : m_players(0), m_timer(0), m_buildMSTime(0), m_buildTime(0),
+    m_queries(0), m_queryTime(0), m_maxQueryTime(0)
+{
+}
+
+void WhoListCache::Update(uint32 diff)
+{
+    uint32 interval = sWorld.getConfig(CONFIG_WHO_LIST_UPDATE_INTERVAL);
+    if (!interval)
+        return;
+
+    m_timer += diff;
+    if (m_timer < interval)
+        return;
+
+    m_timer = 0;
+    Rebuild();
+}
+
+void WhoListCache::Rebuild()
+{
+    ACE_Time_Value start = ACE_OS::gettimeofday();
+
+    bool hideInArena = sWorld.getConfig(CONFIG_ARENA_HIDE_FROM_SOCIAL);
+
+    for (uint32 i = 0; i < 2; ++i)
+    {
+        m_teams[i].entries.clear();
+        m_teams[i].zones.clear();
+    }
+
+    {
+        HashMapHolder<Player>::ReadGuard guard;
+        HashMapHolder<Player>::MapType& m = ObjectAccessor::Instance().GetPlayers();
+        for (HashMapHolder<Player>::MapType::const_iterator itr = m.begin(); itr != m.end(); ++itr)
+        {
+            Player* player = itr->second;
+
+            //do not process players which are not in world
+            if (!player->IsInWorld())
+                continue;
+
+            WhoListEntry entry;
+            entry.guid = player->GetGUID();
+            entry.team = player->GetTeam();
+            entry.security = player->GetSession()->GetSecurity();
+            entry.visible = player->IsVisible();
+            entry.level = player->getLevel();
+            entry.class_ = player->getClass();
+            entry.race = player->getRace();
+            entry.gender = player->getGender();
+            entry.areaZoneId = player->GetZoneId();
+
+            if (hideInArena && player->InBattleground())
+            {
+                WorldLocation const& entryPoint = player->GetBattlegroundEntryPoint();
+                if (entryPoint.GetMapId() == MAPID_INVALID)
+                    entry.zoneId = 0; // unknown
+                else
+                    entry.zoneId = MapManager::Instance().GetZoneId(entryPoint.GetMapId(),
+                        entryPoint.GetPositionX(), entryPoint.GetPositionY(), entryPoint.GetPositionZ());
+            }
+            else
+                entry.zoneId = entry.areaZoneId;
+
+            entry.name = player->GetName();
+            entry.guildName = sObjectMgr.GetGuildNameById(player->GetGuildId());
+            if (!Utf8toWStr(entry.name, entry.wname) || !Utf8toWStr(entry.guildName, entry.wguildName))
+                continue;
+            wstrToLower(entry.wname);
+            wstrToLower(entry.wguildName);
+
+            m_teams[TeamIndex(entry.team)].entries.push_back(entry);
+        }
+    }
+
+    m_players = 0;
+    for (uint32 i = 0; i < 2; ++i)
+    {
+        TeamList& list = m_teams[i];
+        std::stable_sort(list.entries.begin(), list.entries.end(), LevelLess);
+
+        for (uint32 j = 0; j < list.entries.size(); ++j)
+            list.zones[list.entries[j].zoneId].push_back(j);
+
+        m_players += list.entries.size();
+    }
+
+    m_buildMSTime = getMSTime();
+
+    ACE_Time_Value elapsed = ACE_OS::gettimeofday() - start;
+    m_buildTime = uint32(uint64(elapsed.sec()) * 1000000 + elapsed.usec());
+}
+
+bool WhoListCache::Matches(WhoListEntry const& entry, WhoListQuery const& query, uint64 viewerGuid, uint32 security, bool gmInWhoList) const
+{
+    // player can see MODERATOR, GAME MASTER, ADMINISTRATOR only if CONFIG_GM_IN_WHO_LIST
+    if (security == SEC_PLAYER && entry.security > SEC_PLAYER && !gmInWhoList)
+        return false;
+
+    // check if target is globally visible for player, as Player::IsVisibleGloballyFor
+    if (entry.guid != viewerGuid && !entry.visible && security > SEC_PLAYER && entry.security > security)
+        return false;
+
+    if (!(query.classMask & (1 << entry.class_)) || !(query.raceMask & (1 << entry.race)))
+        return false;
+
+    if (!query.name.empty() && entry.wname.find(query.name) == std::wstring::npos)
+        return false;
+
+    if (!query.guildName.empty() && entry.wguildName.find(query.guildName) == std::wstring::npos)
+        return false;
+
+    if (query.strings.empty())
+        return true;
+
+    std::string areaName;
+    if (AreaTableEntry const* areaEntry = GetAreaEntryByAreaID(entry.areaZoneId))
+        areaName = areaEntry->area_name[query.locale];
+
+    for (std::vector<std::wstring>::const_iterator itr = query.strings.begin(); itr != query.strings.end(); ++itr)
+        if (entry.wguildName.find(*itr) != std::wstring::npos ||
+            entry.wname.find(*itr) != std::wstring::npos ||
+            Utf8FitTo(areaName, *itr))
+            return true;
+
+    return false;
+}
+
+void WhoListCache::Query(Player* viewer, WhoListQuery const& query, std::vector<WhoListEntry const*>& matches)
+{
+    // without an interval the list is as fresh as it was without the cache
+    if (!sWorld.getConfig(CONFIG_WHO_LIST_UPDATE_INTERVAL))
+        Rebuild();
+
+    ACE_Time_Value start = ACE_OS::gettimeofday();
+
+    uint64 viewerGuid = viewer->GetGUID();
+    uint32 security = viewer->GetSession()->GetSecurity();
+    bool allowTwoSideWhoList = sWorld.getConfig(CONFIG_ALLOW_TWO_SIDE_WHO_LIST);
+    bool gmInWhoList         = sWorld.getConfig(CONFIG_GM_IN_WHO_LIST);
+
+    std::vector<uint32> zones(query.zones);
+    std::sort(zones.begin(), zones.end());
+    zones.erase(std::unique(zones.begin(), zones.end()), zones.end());
+
+    for (uint32 i = 0; i < 2; ++i)
+    {
+        // player can see member of other team only if CONFIG_ALLOW_TWO_SIDE_WHO_LIST
+        if (security == SEC_PLAYER && i != TeamIndex(viewer->GetTeam()) && !allowTwoSideWhoList)
+            continue;
+
+        TeamList const& list = m_teams[i];
+        if (zones.empty())
+        {
+            EntryList::const_iterator itr = std::lower_bound(list.entries.begin(), list.entries.end(), query.levelMin, EntryLevelBelow);
+            for (; itr != list.entries.end() && itr->level <= query.levelMax; ++itr)
+                if (Matches(*itr, query, viewerGuid, security, gmInWhoList))
+                    matches.push_back(&*itr);
+            continue;
+        }
+
+        for (std::vector<uint32>::const_iterator zone = zones.begin(); zone != zones.end(); ++zone)
+        {
+            ZoneIndex::const_iterator players = list.zones.find(*zone);
+            if (players == list.zones.end())
+                continue;
+
+            for (std::vector<uint32>::const_iterator itr = players->second.begin(); itr != players->second.end(); ++itr)
+            {
+                WhoListEntry const& entry = list.entries[*itr];
+                if (entry.level < query.levelMin)
+                    continue;
+                if (entry.level > query.levelMax)
+                    break;
+
+                if (Matches(entry, query, viewerGuid, security, gmInWhoList))
+                    matches.push_back(&entry);
+            }
+        }
+    }
+
+    ACE_Time_Value elapsed = ACE_OS::gettimeofday() - start;
+    uint32 queryTime = uint32(uint64(elapsed.sec()) * 1000000 + elapsed.usec());
+
+    ++m_queries;
+    m_queryTime += queryTime;
+    m_maxQueryTime = std::max(m_maxQueryTime, queryTime);
+}
+
+WhoListStats WhoListCache::GetStats() const
+{
+    WhoListStats stats;
+    stats.players = m_players;
+    stats.age = m_buildMSTime ? getMSTimeDiff(m_buildMSTime, getMSTime()) : 0;
+    stats.buildTime = m_buildTime;
+    stats.queries = m_queries;
+    stats.queryTime = m_queryTime;
+    stats.maxQueryTime = m_maxQueryTime;
+    return stats;
+}
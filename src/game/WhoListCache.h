@@ -0,0 +1,114 @@
+/*
+ * This file is part of the OregonCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __OREGON_WHOLISTCACHE_H
+#define __OREGON_WHOLISTCACHE_H
+
+#include "Common.h"
+#include "Policies/Singleton.h"
+#include "Utilities/UnorderedMap.h"
+
+class Player;
+
+// what /who knows of an online player
+struct WhoListEntry
+{
+    uint64 guid;
+    uint32 team;
+    uint32 security;
+    bool visible;                                           // Player::IsVisible(), for IsVisibleGloballyFor
+    uint32 level;
+    uint8 class_;
+    uint8 race;
+    uint8 gender;
+    uint32 zoneId;                                          // as shown, the entry point zone for hidden arena players
+    uint32 areaZoneId;                                      // matched by the search strings
+    std::string name;
+    std::string guildName;
+    std::wstring wname;                                     // lower case
+    std::wstring wguildName;                                // lower case
+};
+
+struct WhoListQuery
+{
+    uint32 levelMin;
+    uint32 levelMax;
+    uint32 raceMask;
+    uint32 classMask;
+    std::vector<uint32> zones;                              // empty for all
+    std::wstring name;                                      // lower case, empty for all
+    std::wstring guildName;                                 // lower case, empty for all
+    std::vector<std::wstring> strings;                      // lower case, one of them has to match
+    LocaleConstant locale;                                  // of the area names
+};
+
+struct WhoListStats
+{
+    uint32 players;
+    uint32 age;                                             // ms since the snapshot was built
+    uint32 buildTime;                                       // us
+    uint64 queries;
+    uint64 queryTime;                                       // us, all queries
+    uint32 maxQueryTime;                                    // us
+};
+
+/**
+ * Snapshot of the online players answering /who.
+ *
+ * It is rebuilt by the world thread every WhoList.UpdateInterval, the only
+ * time the player storage lock is taken. Queries read it without any lock,
+ * they run on the world thread too. Players are split by team, sorted by
+ * level and indexed by zone, names are kept lower case for the matching.
+ */
+class WhoListCache
+{
+    public:
+        WhoListCache();
+
+        void Update(uint32 diff);
+        void Rebuild();
+
+        // the entries stay valid until the next Update()
+        void Query(Player* viewer, WhoListQuery const& query, std::vector<WhoListEntry const*>& matches);
+
+        WhoListStats GetStats() const;
+
+    private:
+        typedef std::vector<WhoListEntry> EntryList;
+        typedef UNORDERED_MAP<uint32, std::vector<uint32> > ZoneIndex;
+
+        struct TeamList
+        {
+            EntryList entries;                              // sorted by level
+            ZoneIndex zones;                                // zone id -> entries, by level too
+        };
+
+        bool Matches(WhoListEntry const& entry, WhoListQuery const& query, uint64 viewerGuid, uint32 security, bool gmInWhoList) const;
+
+        TeamList m_teams[2];
+        uint32 m_players;
+        uint32 m_timer;
+        uint32 m_buildMSTime;
+        uint32 m_buildTime;
+
+        uint64 m_queries;
+        uint64 m_queryTime;
+        uint32 m_maxQueryTime;
+};
+
+#define sWhoListCache Oregon::Singleton<WhoListCache>::Instance()
+#endif
@@ -67,6 +67,7 @@
 #include "VMapManager2.h"
 #include "M2Stores.h"
 #include "LuaEngine.h"
+#include "WhoListCache.h"
 
 #include <ace/Dirent.h>
 
@@ -550,8 +551,12 @@ void World::LoadConfigSettings(bool reload)
     }
     m_configs[CONFIG_ADDON_CHANNEL] = sConfig.GetBoolDefault("AddonChannel", true);
     m_configs[CONFIG_GRID_UNLOAD] = sConfig.GetBoolDefault("GridUnload", true);
+    m_configs[CONFIG_GRID_MEMORY_MAPPED] = sConfig.GetBoolDefault("GridMemoryMapped", true);
     m_configs[CONFIG_INTERVAL_SAVE] = sConfig.GetIntDefault("PlayerSaveInterval", 900000);
     m_configs[CONFIG_INTERVAL_DISCONNECT_TOLERANCE] = sConfig.GetIntDefault("DisconnectToleranceInterval", 0);
+    m_configs[CONFIG_INTERVAL_RESPAWN_SAVE] = sConfig.GetIntDefault("RespawnSaveInterval", 10000);
+    if (reload)
+        m_timers[WUPDATE_RESPAWNS].SetInterval(m_configs[CONFIG_INTERVAL_RESPAWN_SAVE]);
 
     m_configs[CONFIG_INTERVAL_GRIDCLEAN] = sConfig.GetIntDefault("GridCleanUpDelay", 60000);
     //if (m_configs[CONFIG_INTERVAL_GRIDCLEAN] < MIN_GRID_DELAY)
@@ -987,7 +992,9 @@ void World::LoadConfigSettings(bool reload)
 
     m_configs[CONFIG_PET_LOS] = enablePetLOS;
     m_configs[CONFIG_VMAP_TOTEM] = sConfig.GetBoolDefault("vmap.totem", false);
+    m_configs[CONFIG_VMAP_LOS_CACHE_TIME] = sConfig.GetIntDefault("vmap.losCacheTime", 500);
     m_configs[CONFIG_MAX_WHO] = sConfig.GetIntDefault("MaxWhoListReturns", 49);
+    m_configs[CONFIG_WHO_LIST_UPDATE_INTERVAL] = sConfig.GetIntDefault("WhoList.UpdateInterval", 5000);
 
     m_configs[CONFIG_BG_START_MUSIC] = sConfig.GetBoolDefault("MusicInBattleground", false);
     m_configs[CONFIG_START_ALL_SPELLS] = sConfig.GetBoolDefault("PlayerStart.AllSpells", false);
@@ -1004,6 +1011,12 @@ void World::LoadConfigSettings(bool reload)
     m_configs[CONFIG_INTERVAL_LOG_UPDATE] = sConfig.GetIntDefault("RecordUpdateTimeDiffInterval", 60000);
     m_configs[CONFIG_MIN_LOG_UPDATE] = sConfig.GetIntDefault("MinRecordUpdateTimeDiff", 100);
     m_configs[CONFIG_NUMTHREADS] = sConfig.GetIntDefault("MapUpdate.Threads", 1);
+    m_configs[CONFIG_MAPUPDATE_SESSION_PACKETS] = sConfig.GetBoolDefault("MapUpdate.SessionPackets", false);
+    m_configs[CONFIG_MAPUPDATE_REGION_THREADS] = sConfig.GetIntDefault("MapUpdate.Regions.Threads", 0);
+    m_configs[CONFIG_MAPUPDATE_REGION_MIN_PLAYERS] = sConfig.GetIntDefault("MapUpdate.Regions.MinPlayers", 200);
+    m_configs[CONFIG_GRID_PREFETCH_THREADS] = sConfig.GetIntDefault("MapUpdate.Prefetch.Threads", 1);
+    m_configs[CONFIG_MOVEMENT_BATCHING] = sConfig.GetBoolDefault("Movement.Batching", false);
+    m_configs[CONFIG_MOVEMENT_BATCHING_DELAY] = sConfig.GetIntDefault("Movement.Batching.MaxDelay", 0);
     m_configs[CONFIG_DUEL_MOD] = sConfig.GetBoolDefault("DuelMod.Enable", false);
     m_configs[CONFIG_DUEL_CD_RESET] = sConfig.GetBoolDefault("DuelMod.Cooldowns", false);
     m_configs[CONFIG_AUTOBROADCAST_TIMER] = sConfig.GetIntDefault("AutoBroadcast.Timer", 60000);
@@ -1598,6 +1611,8 @@ void World::SetInitialWorldSettings()
 
     m_timers[WUPDATE_DELETECHARS].SetInterval(DAY * IN_MILLISECONDS); // check for chars to delete every day
 
+    m_timers[WUPDATE_RESPAWNS].SetInterval(m_configs[CONFIG_INTERVAL_RESPAWN_SAVE]);
+
     //to set mailtimer to return mails every day between 4 and 5 am
     //mailtimer is increased when updating auctions
     //one second is 1000 -(tested on win system)
@@ -1931,6 +1946,13 @@ void World::Update(uint32 diff)
     // Update objects when the timer has passed (maps, transport, creatures,...)
     MapManager::Instance().Update(diff);                // As interval = 0
 
+    ///- Write the respawn times changed by the maps
+    if (m_timers[WUPDATE_RESPAWNS].Passed())
+    {
+        m_timers[WUPDATE_RESPAWNS].Reset();
+        sObjectMgr.SaveRespawnTimes();
+    }
+
     if (m_configs[CONFIG_AUTOBROADCAST_ENABLED])
     {
         if (m_timers[WUPDATE_AUTOBROADCAST].Passed())
@@ -1946,6 +1968,9 @@ void World::Update(uint32 diff)
     sOutdoorPvPMgr.Update(diff);
     RecordTimeDiff("UpdateOutdoorPvPMgr");
 
+    sWhoListCache.Update(diff);
+    RecordTimeDiff("UpdateWhoListCache");
+
     ///- used by eluna
     sEluna->OnWorldUpdate(diff);
 
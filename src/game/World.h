@@ -75,7 +75,8 @@ enum WorldTimers
     WUPDATE_CLEANDB     = 7,
     WUPDATE_DELETECHARS = 8,
     WUPDATE_AUTOBROADCAST = 9,
-    WUPDATE_COUNT       = 10
+    WUPDATE_RESPAWNS    = 10,
+    WUPDATE_COUNT       = 11
 };
 
 // Configuration elements
@@ -83,11 +84,13 @@ enum WorldConfigs
 {
     CONFIG_COMPRESSION = 0,
     CONFIG_GRID_UNLOAD,
+    CONFIG_GRID_MEMORY_MAPPED,
     CONFIG_INTERVAL_SAVE,
     CONFIG_INTERVAL_GRIDCLEAN,
     CONFIG_INTERVAL_MAPUPDATE,
     CONFIG_INTERVAL_CHANGEWEATHER,
     CONFIG_INTERVAL_DISCONNECT_TOLERANCE,
+    CONFIG_INTERVAL_RESPAWN_SAVE,
     CONFIG_PORT_WORLD,
     CONFIG_SOCKET_SELECTTIME,
     CONFIG_SOCKET_TIMEOUTTIME,
@@ -214,6 +217,7 @@ enum WorldConfigs
     CONFIG_ARENA_HIDE_FROM_SOCIAL,
     CONFIG_ARENA_LOG_EXTENDED_INFO,
     CONFIG_MAX_WHO,
+    CONFIG_WHO_LIST_UPDATE_INTERVAL,
     CONFIG_BG_START_MUSIC,
     CONFIG_START_ALL_SPELLS,
     CONFIG_HONOR_AFTER_DUEL,
@@ -231,7 +235,14 @@ enum WorldConfigs
     CONFIG_ENABLE_SINFO_LOGIN,
     CONFIG_PET_LOS,
     CONFIG_VMAP_TOTEM,
+    CONFIG_VMAP_LOS_CACHE_TIME,
     CONFIG_NUMTHREADS,
+    CONFIG_MAPUPDATE_SESSION_PACKETS,
+    CONFIG_MAPUPDATE_REGION_THREADS,
+    CONFIG_GRID_PREFETCH_THREADS,
+    CONFIG_MAPUPDATE_REGION_MIN_PLAYERS,
+    CONFIG_MOVEMENT_BATCHING,
+    CONFIG_MOVEMENT_BATCHING_DELAY,
     CONFIG_CHATLOG_CHANNEL,
     CONFIG_CHATLOG_WHISPER,
     CONFIG_CHATLOG_SYSCHAN,
@@ -35,6 +35,7 @@
 #include "WardenWin.h"
 #include "WardenMac.h"
 #include "LuaEngine.h"
+#include "UpdateData.h"
 
 // WorldSession constructor
 WorldSession::WorldSession(uint32 id, WorldSocket* sock, uint32 sec, uint8 expansion, time_t mute_time, LocaleConstant locale) :
@@ -42,7 +43,7 @@ WorldSession::WorldSession(uint32 id, WorldSocket* sock, uint32 sec, uint8 expan
     _player(NULL), m_Socket(sock), _security(sec), _accountId(id), m_expansion(expansion), m_Warden(NULL),
     m_inQueue(false), m_playerLoading(false), m_playerLogout(false), m_playerRecentlyLogout(false), m_playerSave(false),
     m_sessionDbcLocale(sWorld.GetAvailableDbcLocale(locale)), m_sessionDbLocaleIndex(sObjectMgr.GetIndexForLocale(locale)),
-    _logoutTime(0), m_latency(0), m_clientTimeDelay(0)
+    _logoutTime(0), m_latency(0), m_clientTimeDelay(0), m_movementBatch(0), m_movementBatchCount(0), m_movementBatchTime(0)
 {
     if (sock)
     {
@@ -98,6 +99,9 @@ void WorldSession::SendPacket(WorldPacket const* packet)
     if (!m_Socket)
         return;
 
+    // batched moves go first, the packet may be about one of the movers
+    SendMovementBatch(true);
+
     #ifdef OREGON_DEBUG
 
     // Code for network use statistic
@@ -138,12 +142,143 @@ void WorldSession::SendPacket(WorldPacket const* packet)
         m_Socket->CloseSocket();
 }
 
+// Send a packet built once for several clients
+void WorldSession::SendPacket(SharedWorldPacketPtr& packet)
+{
+    if (!m_Socket)
+        return;
+
+    SendMovementBatch(true);
+
+    if (m_Socket->SendPacket(packet) == -1)
+        m_Socket->CloseSocket();
+}
+
+namespace
+{
+    ACE_Atomic_Op<ACE_Thread_Mutex, uint64> movementBatchMoves;
+    ACE_Atomic_Op<ACE_Thread_Mutex, uint64> movementBatchPackets;
+    ACE_Atomic_Op<ACE_Thread_Mutex, uint64> movementBatchBytesIn;
+    ACE_Atomic_Op<ACE_Thread_Mutex, uint64> movementBatchBytesOut;
+}
+
+// Queue a move of another unit, it is sent with the others at the end of the map update
+void WorldSession::SendMovementPacket(WorldPacket const* packet)
+{
+    // the entry size is one byte and covers the opcode, SendPacket keeps the order of the moves
+    if (packet->size() + sizeof(uint16) > 0xFF)
+    {
+        SendPacket(packet);
+        return;
+    }
+
+    ACE_Guard<ACE_Thread_Mutex> guard(m_movementBatchLock);
+
+    if (!m_movementBatchCount)
+        m_movementBatchTime = getMSTime();
+
+    m_movementBatch << uint8(packet->size() + sizeof(uint16));
+    m_movementBatch << uint16(packet->GetOpcode());
+    m_movementBatch.append(packet->contents(), packet->size());
+    ++m_movementBatchCount;
+}
+
+void WorldSession::SendMovementBatch(bool force)
+{
+    WorldPacket data;
+    ByteBuffer moves;
+    uint32 count;
+    {
+        ACE_Guard<ACE_Thread_Mutex> guard(m_movementBatchLock);
+
+        if (!m_movementBatchCount)
+            return;
+
+        if (!force && getMSTimeDiff(m_movementBatchTime, getMSTime()) < sWorld.getConfig(CONFIG_MOVEMENT_BATCHING_DELAY))
+            return;
+
+        count = m_movementBatchCount;
+        if (count == 1)
+        {
+            // nothing to gain, send the move as it is
+            data.SetOpcode(m_movementBatch.read<uint16>(1));
+            data.append(m_movementBatch.contents() + 3, m_movementBatch.size() - 3);
+        }
+        else if (UpdateData::CompressPacket(&data, m_movementBatch))
+            data.SetOpcode(SMSG_COMPRESSED_MOVES);
+        else
+            moves = m_movementBatch;
+
+        if (moves.empty())
+            movementBatchBytesIn += m_movementBatch.size();
+        m_movementBatch.clear();
+        m_movementBatchCount = 0;
+    }
+
+    // SendPacket flushes the batch, it must be empty and unlocked by now
+    if (!moves.empty())
+    {
+        // compression failed, send the moves one by one
+        for (size_t pos = 0; pos < moves.size(); pos += 1 + moves[pos])
+        {
+            WorldPacket move(moves.read<uint16>(pos + 1), moves[pos] - sizeof(uint16));
+            move.append(moves.contents() + pos + 3, moves[pos] - sizeof(uint16));
+            SendPacket(&move);
+        }
+        return;
+    }
+
+    movementBatchMoves += count;
+    ++movementBatchPackets;
+    movementBatchBytesOut += data.size();
+
+    SendPacket(&data);
+}
+
+void WorldSession::ClearMovementBatch()
+{
+    ACE_Guard<ACE_Thread_Mutex> guard(m_movementBatchLock);
+    m_movementBatch.clear();
+    m_movementBatchCount = 0;
+}
+
+MovementBatchStats WorldSession::GetMovementBatchStats()
+{
+    MovementBatchStats stats;
+    stats.moves = movementBatchMoves.value();
+    stats.packets = movementBatchPackets.value();
+    stats.bytesIn = movementBatchBytesIn.value();
+    stats.bytesOut = movementBatchBytesOut.value();
+    return stats;
+}
+
 // Add an incoming packet to the queue
 void WorldSession::QueuePacket(WorldPacket* new_packet)
 {
     _recvQueue.add(new_packet);
 }
 
+// Takes the packets at the front of the queue that the current thread handles,
+// stops at the first one left to the other thread so all keep their order
+class WorldSession::PacketFilter
+{
+    public:
+        PacketFilter(Player* player, Map* map) : m_player(player), m_map(map) {}
+
+        bool Process(WorldPacket* packet) const
+        {
+            // map-affine packets of an in-world player are handled by its map
+            bool byMap = sWorld.getConfig(CONFIG_MAPUPDATE_SESSION_PACKETS) && m_player && m_player->IsInWorld() &&
+                packet->GetOpcode() < NUM_MSG_TYPES && opcodeTable[packet->GetOpcode()].packetProcessing == PROCESS_THREADSAFE;
+
+            return byMap == (m_map != NULL);
+        }
+
+    private:
+        Player* m_player;
+        Map* m_map;
+};
+
 // Logging helper for unexpected opcodes
 void WorldSession::LogUnexpectedOpcode(WorldPacket* packet, const char* reason)
 {
@@ -179,140 +314,163 @@ bool WorldSession::Update(uint32 diff)
     if (IsConnectionIdle())
         m_Socket->CloseSocket();
 
-    // Retrieve packets from the receive queue and call the appropriate handlers
-    // not proccess packets if socket already closed
+    // Retrieve packets from the receive queue and call the appropriate handlers,
+    // up to the first map-affine one that the map of an in-world player handles
+    ProcessPackets(NULL);
+
+    if (m_Socket && !m_Socket->IsClosed() && m_Warden)
+        m_Warden->Update();
+
+    // If necessary, log the player out (normal logout)
+    if (ShouldLogOut(time(0)) && !m_playerLoading)
+        LogoutPlayer(true);
+
+    // Cleanup socket pointer if need (disconnect)
+    if (m_Socket && m_Socket->IsClosed())
+    {
+        m_Socket->RemoveReference();
+        m_Socket = NULL;
+        return false;
+    }
+
+    return true;
+}
+
+// Process the map-affine packets at the front of the queue (triggered by Map update)
+void WorldSession::UpdateMap(Map* map)
+{
+    ProcessPackets(map);
+}
+
+// Retrieve packets from the receive queue and call the appropriate handlers
+// not proccess packets if socket already closed or, for map-affine packets,
+// if the player left the map that processes them
+void WorldSession::ProcessPackets(Map* map)
+{
+    // keep the async queries of the handlers on one read worker
+    Database::KeyGuard dbKey(GetAccountId());
+
     WorldPacket* packet;
     uint64 now = getMSTime64();
     uint32 packetsThisCycle = 0;
-    while (m_Socket && !m_Socket->IsClosed() && ++packetsThisCycle <= 20 && _recvQueue.next(packet))
+    while (m_Socket && !m_Socket->IsClosed() && ++packetsThisCycle <= 20)
     {
-        /*#if 1
-        sLog.outError("MOEP: %s (0x%.4X)",
-                        LookupOpcodeName(packet->GetOpcode()),
-                        packet->GetOpcode());
-        #endif*/
+        if (map && (!_player || !_player->IsInWorld() || _player->GetMap() != map))
+            break;
 
-        if (packet->GetOpcode() >= NUM_MSG_TYPES)
-        {
-            sLog.outError("SESSION: received invalid opcode %s (0x%.4X)",
-                          LookupOpcodeName(packet->GetOpcode()),
-                          packet->GetOpcode());
-        }
-        else
-        {
-            OpcodeHandler const& opHandle = opcodeTable[packet->GetOpcode()];
-            unsigned long opStatus = opHandle.status;
+        PacketFilter filter(_player, map);
+        if (!_recvQueue.next(packet, filter))
+            break;
+
+        HandlePacket(packet, now);
+        delete packet;
+    }
+}
+
+// Validate session state for a single packet and call its handler
+void WorldSession::HandlePacket(WorldPacket* packet, uint64 now)
+{
+    if (packet->GetOpcode() >= NUM_MSG_TYPES)
+    {
+        sLog.outError("SESSION: received invalid opcode %s (0x%.4X)",
+                      LookupOpcodeName(packet->GetOpcode()),
+                      packet->GetOpcode());
+    }
+    else
+    {
+        OpcodeHandler const& opHandle = opcodeTable[packet->GetOpcode()];
+        unsigned long opStatus = opHandle.status;
 
-            if (opStatus & STATUS_PROTECTED)
+        if (opStatus & STATUS_PROTECTED)
+        {
+            ProtectedOpcodeMap::iterator op = _protectedOpcodes.find(packet->GetOpcode());
+            if (op == _protectedOpcodes.end())
             {
-                ProtectedOpcodeMap::iterator op = _protectedOpcodes.find(packet->GetOpcode());
-                if (op == _protectedOpcodes.end())
-                {
-                    ProtectedOpcodeStatus status;
-                    status.lastUsed = now;
-                    status.timesUsed = 1;
+                ProtectedOpcodeStatus status;
+                status.lastUsed = now;
+                status.timesUsed = 1;
 
-                    _protectedOpcodes.insert(std::pair<uint32, ProtectedOpcodeStatus>(packet->GetOpcode(), status));
-                }
-                else
+                _protectedOpcodes.insert(std::pair<uint32, ProtectedOpcodeStatus>(packet->GetOpcode(), status));
+            }
+            else
+            {
+                ProtectedOpcodeProperties const& prop = sWorld.GetProtectedOpcodeProperties(packet->GetOpcode());
+                if (++op->second.timesUsed > prop.threshold)
                 {
-                    ProtectedOpcodeProperties const& prop = sWorld.GetProtectedOpcodeProperties(packet->GetOpcode());
-                    if (++op->second.timesUsed > prop.threshold)
+                    if (getMSTimeDiff64(now, op->second.lastUsed) <= prop.interval)
                     {
-                        if (getMSTimeDiff64(now, op->second.lastUsed) <= prop.interval)
+                        switch (prop.penalty)
                         {
-                            switch (prop.penalty)
-                            {
-                                case OPCODE_PENALTY_SKIP:
-                                    continue;
-                                case OPCODE_PENALTY_KICK:
-                                    KickPlayer();
-                            }
+                            case OPCODE_PENALTY_SKIP:
+                                return;
+                            case OPCODE_PENALTY_KICK:
+                                KickPlayer();
                         }
-                        else
-                            op->second.timesUsed = 1;
                     }
-
-                    op->second.lastUsed = now;
+                    else
+                        op->second.timesUsed = 1;
                 }
 
-                opStatus &= ~STATUS_PROTECTED;
+                op->second.lastUsed = now;
             }
 
-            try
+            opStatus &= ~STATUS_PROTECTED;
+        }
+
+        try
+        {
+            switch (opStatus)
             {
-                switch (opStatus)
+            case STATUS_LOGGEDIN:
+                if (!_player)
                 {
-                case STATUS_LOGGEDIN:
-                    if (!_player)
-                    {
-                        // skip STATUS_LOGGEDIN opcode unexpected errors if player logout sometime ago - this can be network lag delayed packets
-                        if (!m_playerRecentlyLogout)
-                            LogUnexpectedOpcode(packet, "the player has not logged in yet");
-                    }
-                    else if (_player->IsInWorld())
-                        ExecuteOpcode(opHandle, packet);
-
-                    // lag can cause STATUS_LOGGEDIN opcodes to arrive after the player started a transfer
-                    break;
-                case STATUS_TRANSFER_PENDING:
-                    if (!_player)
+                    // skip STATUS_LOGGEDIN opcode unexpected errors if player logout sometime ago - this can be network lag delayed packets
+                    if (!m_playerRecentlyLogout)
                         LogUnexpectedOpcode(packet, "the player has not logged in yet");
-                    else if (_player->IsInWorld())
-                        LogUnexpectedOpcode(packet, "the player is still in world");
-                    else
-                        ExecuteOpcode(opHandle, packet);
-                    break;
-                case STATUS_AUTHED:
-                    // prevent cheating with skip queue wait
-                    if (m_inQueue)
-                    {
-                        LogUnexpectedOpcode(packet, "the player not pass queue yet");
-                        break;
-                    }
-
-                    m_playerRecentlyLogout = false;
+                }
+                else if (_player->IsInWorld())
+                    ExecuteOpcode(opHandle, packet);
 
+                // lag can cause STATUS_LOGGEDIN opcodes to arrive after the player started a transfer
+                break;
+            case STATUS_TRANSFER_PENDING:
+                if (!_player)
+                    LogUnexpectedOpcode(packet, "the player has not logged in yet");
+                else if (_player->IsInWorld())
+                    LogUnexpectedOpcode(packet, "the player is still in world");
+                else
                     ExecuteOpcode(opHandle, packet);
-                    break;
-                case STATUS_NEVER:
-                    sLog.outError("SESSION: received not allowed opcode %s (0x%.4X)",
-                                  LookupOpcodeName(packet->GetOpcode()),
-                                  packet->GetOpcode());
+                break;
+            case STATUS_AUTHED:
+                // prevent cheating with skip queue wait
+                if (m_inQueue)
+                {
+                    LogUnexpectedOpcode(packet, "the player not pass queue yet");
                     break;
                 }
+
+                m_playerRecentlyLogout = false;
+
+                ExecuteOpcode(opHandle, packet);
+                break;
+            case STATUS_NEVER:
+                sLog.outError("SESSION: received not allowed opcode %s (0x%.4X)",
+                              LookupOpcodeName(packet->GetOpcode()),
+                              packet->GetOpcode());
+                break;
             }
-            catch (ByteBufferException&)
+        }
+        catch (ByteBufferException&)
+        {
+            sLog.outError("WorldSession::Update ByteBufferException occured while parsing a packet (opcode: %u) from client %s, accountid=%i. Skipped packet.",
+                          packet->GetOpcode(), GetRemoteAddress().c_str(), GetAccountId());
+            if (sLog.IsOutDebug())
             {
-                sLog.outError("WorldSession::Update ByteBufferException occured while parsing a packet (opcode: %u) from client %s, accountid=%i. Skipped packet.",
-                              packet->GetOpcode(), GetRemoteAddress().c_str(), GetAccountId());
-                if (sLog.IsOutDebug())
-                {
-                    sLog.outDebug("Dumping error causing packet:");
-                    packet->hexlike();
-                }
+                sLog.outDebug("Dumping error causing packet:");
+                packet->hexlike();
             }
         }
-
-        delete packet;
     }
-
-    if (m_Socket && !m_Socket->IsClosed() && m_Warden)
-        m_Warden->Update();
-
-    // If necessary, log the player out (normal logout)
-    if (ShouldLogOut(time(0)) && !m_playerLoading)
-        LogoutPlayer(true);
-
-    // Cleanup socket pointer if need (disconnect)
-    if (m_Socket && m_Socket->IsClosed())
-    {
-        m_Socket->RemoveReference();
-        m_Socket = NULL;
-        return false;
-    }
-
-    return true;
 }
 
 #if COMPILER == COMPILER_GNU
@@ -322,6 +480,8 @@ bool WorldSession::Update(uint32 diff)
 // Log the player out
 void WorldSession::LogoutPlayer(bool Save)
 {
+    Database::KeyGuard dbKey(GetAccountId());
+
     // finish pending transfers before starting the logout
     while (_player && _player->IsBeingTeleportedFar())
         HandleMoveWorldportAckOpcode();
@@ -454,7 +614,7 @@ void WorldSession::LogoutPlayer(bool Save)
         sSocialMgr.RemovePlayerSocial (_player->GetGUIDLow ());
 
         ///- used by eluna
-        sEluna->OnLogout(_player);
+        _player->GetEluna()->OnLogout(_player);
 
         // Remove the player from the world
         // the player may not be in the world when logging out
@@ -605,7 +765,7 @@ void WorldSession::InitWarden(BigNumber* K, std::string os)
 }
 void WorldSession::ExecuteOpcode(OpcodeHandler const& opHandle, WorldPacket* packet)
 {
-    if (!sEluna->OnPacketReceive(this, *packet))
+    if (!Eluna::GetPacketState()->OnPacketReceive(this, *packet))
         return;
 
     // need prevent do internal far teleports in handlers because some handlers do lot steps
@@ -22,6 +22,7 @@
 #include "QueryResult.h"
 #include "World.h"
 #include "WardenBase.h"
+#include "ByteBuffer.h"
 
 struct ItemTemplate;
 struct AuctionEntry;
@@ -29,10 +30,12 @@ struct DeclinedName;
 
 class Creature;
 class Item;
+class Map;
 class Object;
 class Player;
 class Unit;
 class WorldPacket;
+class SharedWorldPacketPtr;
 class WorldSocket;
 class QueryResult;
 class LoginQueryHolder;
@@ -40,6 +43,17 @@ class CharacterHandler;
 
 struct OpcodeHandler;
 
+// counters of the movement sent in SMSG_COMPRESSED_MOVES
+struct MovementBatchStats
+{
+    MovementBatchStats() : moves(0), packets(0), bytesIn(0), bytesOut(0) {}
+
+    uint64 moves;                                           // moves that went into a batch
+    uint64 packets;                                         // packets sent for them
+    uint64 bytesIn;                                         // batched moves, uncompressed
+    uint64 bytesOut;
+};
+
 enum PartyOperation
 {
     PARTY_OP_INVITE = 0,
@@ -86,6 +100,15 @@ class WorldSession
         void SizeError(WorldPacket const& packet, uint32 size) const;
 
         void SendPacket(WorldPacket const* packet);
+        void SendPacket(SharedWorldPacketPtr& packet);
+
+        // Movement of others, batched until the end of the map update if enabled.
+        // Any other packet sends the batch first, nothing overtakes a batched move.
+        void SendMovementPacket(WorldPacket const* packet);
+        // Sends the batched movement once it waited long enough, or right away if forced
+        void SendMovementBatch(bool force);
+        void ClearMovementBatch();
+        static MovementBatchStats GetMovementBatchStats();
         void SendNotification(const char* format, ...) ATTR_PRINTF(2, 3);
         void SendNotification(int32 string_id, ...);
         void SendPetNameInvalid(uint32 error, const std::string& name, DeclinedName* declinedName);
@@ -154,6 +177,7 @@ class WorldSession
 
         void QueuePacket(WorldPacket* new_packet);
         bool Update(uint32 diff);
+        void UpdateMap(Map* map);
 
         // Handle the authentication waiting queue (to be completed)
         void SendAuthWaitQue(uint32 position);
@@ -713,6 +737,12 @@ class WorldSession
         // private trade methods
         void moveItems(Item* myItems[], Item* hisItems[]);
 
+        typedef ACE_Based::LockedQueue<WorldPacket*, ACE_Thread_Mutex> PacketQueue;
+
+        class PacketFilter;
+
+        void ProcessPackets(Map* map);
+        void HandlePacket(WorldPacket* packet, uint64 now);
         void ExecuteOpcode(OpcodeHandler const& opHandle, WorldPacket* packet);
 
         // logging helper
@@ -759,7 +789,12 @@ class WorldSession
         typedef UNORDERED_MAP<uint32, ProtectedOpcodeStatus> ProtectedOpcodeMap;
         ProtectedOpcodeMap _protectedOpcodes;
 
-        ACE_Based::LockedQueue<WorldPacket*, ACE_Thread_Mutex> _recvQueue;
+        PacketQueue _recvQueue;                             // map-affine packets may be handled in Map::Update
+
+        ACE_Thread_Mutex m_movementBatchLock;               // movers may be handled by another region thread
+        ByteBuffer m_movementBatch;                         // SMSG_COMPRESSED_MOVES entries, uncompressed
+        uint32 m_movementBatchCount;
+        uint32 m_movementBatchTime;                         // time the oldest entry was batched
 };
 #endif
 
@@ -31,6 +31,7 @@
 #include "Utilities/Util.h"
 #include "World.h"
 #include "WorldPacket.h"
+#include "SharedWorldPacket.h"
 #include "SharedDefines.h"
 #include "ByteBuffer.h"
 #include "AddonHandler.h"
@@ -94,9 +95,9 @@ WorldSocket::~WorldSocket (void)
 
     peer().close();
 
-    WorldPacket* pct;
+    SharedWorldPacket* pct;
     while (m_PacketQueue.dequeue_head (pct) == 0)
-        delete pct;
+        pct->RemoveReference();
 }
 
 bool WorldSocket::IsClosed (void) const
@@ -135,8 +136,45 @@ int WorldSocket::SendPacket (const WorldPacket& pct)
     if (closing_)
         return -1;
 
-    WorldPacket pkt = pct;
+    if (!iPrepareSend (pct))
+        return 0;
+
+    if (iSendPacket (pct) == -1)
+    {
+        SharedWorldPacket* npct;
+
+        ACE_NEW_RETURN (npct, SharedWorldPacket (pct), -1);
+
+        return iQueuePacket (npct);
+    }
+
+    return 0;
+}
+
+int WorldSocket::SendPacket (SharedWorldPacketPtr& pct)
+{
+    ACE_GUARD_RETURN (LockType, Guard, m_OutBufferLock, -1);
+
+    if (closing_)
+        return -1;
+
+    if (!iPrepareSend (pct.GetPacket()))
+        return 0;
+
+    if (iSendPacket (pct.GetPacket()) == -1)
+    {
+        // the payload is immutable, queue a reference instead of a copy
+        SharedWorldPacket* npct = pct.Share();
+        npct->AddReference();
+
+        return iQueuePacket (npct);
+    }
+
+    return 0;
+}
 
+bool WorldSocket::iPrepareSend (const WorldPacket& pct)
+{
     // Dump outgoing packet.
     if (sLog.IsLogTypeEnabled(LOG_TYPE_NETWORK))
     {
@@ -157,23 +195,28 @@ int WorldSocket::SendPacket (const WorldPacket& pct)
         sLog.outNetwork("");
     }
 
-    if (!sEluna->OnPacketSend(m_Session, pkt))
-        return 0;
-
-    if (iSendPacket (pct) == -1)
+    // scripts get their own copy, only made when one hooked the opcode
+    Eluna* E = Eluna::GetPacketState();
+    if (E->HasPacketSendHooks(pct.GetOpcode()))
     {
-        WorldPacket* npct;
+        WorldPacket pkt = pct;
 
-        ACE_NEW_RETURN (npct, WorldPacket (pct), -1);
+        if (!E->OnPacketSend(m_Session, pkt))
+            return false;
+    }
 
-        // NOTE maybe check of the size of the queue can be good ?
-        // to make it bounded instead of unbounded
-        if (m_PacketQueue.enqueue_tail (npct) == -1)
-        {
-            delete npct;
-            sLog.outError ("WorldSocket::SendPacket: m_PacketQueue.enqueue_tail failed");
-            return -1;
-        }
+    return true;
+}
+
+int WorldSocket::iQueuePacket (SharedWorldPacket* pct)
+{
+    // NOTE maybe check of the size of the queue can be good ?
+    // to make it bounded instead of unbounded
+    if (m_PacketQueue.enqueue_tail (pct) == -1)
+    {
+        pct->RemoveReference();
+        sLog.outError ("WorldSocket::SendPacket: m_PacketQueue.enqueue_tail failed");
+        return -1;
     }
 
     return 0;
@@ -602,14 +645,14 @@ int WorldSocket::ProcessIncoming (WorldPacket* new_pct)
                 return -1;
             }
 
-            if (!sEluna->OnPacketReceive(m_Session, *new_pct))
+            if (!Eluna::GetPacketState()->OnPacketReceive(m_Session, *new_pct))
                 return 0;
 
             return HandleAuthSession (*new_pct);
         case CMSG_KEEP_ALIVE:
             DEBUG_LOG ("CMSG_KEEP_ALIVE ,size: %lu", new_pct->size());
 
-            sEluna->OnPacketReceive(m_Session, *new_pct);
+            Eluna::GetPacketState()->OnPacketReceive(m_Session, *new_pct);
             return 0;
         default:
             {
@@ -986,16 +1029,16 @@ int WorldSocket::iSendPacket (const WorldPacket& pct)
 
 bool WorldSocket::iFlushPacketQueue ()
 {
-    WorldPacket* pct;
+    SharedWorldPacket* pct;
     bool haveone = false;
 
     while (m_PacketQueue.dequeue_head (pct) == 0)
     {
-        if (iSendPacket (*pct) == -1)
+        if (iSendPacket (pct->GetPacket()) == -1)
         {
             if (m_PacketQueue.enqueue_head (pct) == -1)
             {
-                delete pct;
+                pct->RemoveReference();
                 sLog.outError ("WorldSocket::iFlushPacketQueue m_PacketQueue->enqueue_head");
                 return false;
             }
@@ -1005,7 +1048,7 @@ bool WorldSocket::iFlushPacketQueue ()
         else
         {
             haveone = true;
-            delete pct;
+            pct->RemoveReference();
         }
     }
 
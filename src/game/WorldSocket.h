@@ -38,6 +38,8 @@
 
 class ACE_Message_Block;
 class WorldPacket;
+class SharedWorldPacket;
+class SharedWorldPacketPtr;
 class WorldSession;
 
 // Handler that can communicate over stream sockets.
@@ -95,7 +97,7 @@ class WorldSocket : protected WorldHandler
         typedef ACE_Guard<LockType> GuardType;
 
         // Queue for storing packets for which there is no space.
-        typedef ACE_Unbounded_Queue< WorldPacket* > PacketQueueT;
+        typedef ACE_Unbounded_Queue< SharedWorldPacket* > PacketQueueT;
 
         // Check if socket is closed.
         bool IsClosed (void) const;
@@ -111,6 +113,10 @@ class WorldSocket : protected WorldHandler
         // return -1 of failure
         int SendPacket (const WorldPacket& pct);
 
+        // Send a packet shared with other sockets, a reference to its
+        // shared copy is kept while it waits in the queue.
+        int SendPacket (SharedWorldPacketPtr& pct);
+
         // Add reference to this object.
         long AddReference (void);
 
@@ -166,6 +172,12 @@ class WorldSocket : protected WorldHandler
         // Need to be called with m_OutBufferLock lock held
         int iSendPacket (const WorldPacket& pct);
 
+        // Logs the packet and runs the send hooks, false if a script dropped it.
+        bool iPrepareSend (const WorldPacket& pct);
+
+        // Queues a packet reference for later, takes over the reference.
+        int iQueuePacket (SharedWorldPacket* pct);
+
         // Flush m_PacketQueue if there are packets in it
         // Need to be called with m_OutBufferLock lock held
         // return true if it wrote to the buffer (AKA you need
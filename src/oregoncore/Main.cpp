@@ -69,6 +69,7 @@ void usage(const char* prog)
                    "    -s uninstall             uninstall service\n\r"
                    #endif
                    "    -t --run-tests           run regression tests and exit\n\r"
+                   "    -b --run-benchmarks      run benchmarks and exit\n\r"
                    , prog);
 }
 
@@ -85,10 +86,12 @@ extern int main(int argc, char** argv)
     #endif
 
     bool runRegressionTtests = false;
+    bool runBenchmarks = false;
 
     ACE_Get_Opt cmd_opts(argc, argv, options);
     cmd_opts.long_option("version", 'v');
     cmd_opts.long_option("run-tests", 't');
+    cmd_opts.long_option("run-benchmarks", 'b');
 
     int option;
     while ((option = cmd_opts()) != EOF)
@@ -132,6 +135,9 @@ extern int main(int argc, char** argv)
         case 't':
             runRegressionTtests = true;
             break;
+        case 'b':
+            runBenchmarks = true;
+            break;
         case ':':
             sLog.outError("Runtime-Error: -%c option requires an input argument", cmd_opts.opt_opt());
             usage(argv[0]);
@@ -168,7 +174,7 @@ extern int main(int argc, char** argv)
 
     // and run the 'Master'
     // todo - Why do we need this 'Master'? Can't all of this be in the Main as for Realmd?
-    int exitcode = sMaster.Run(runRegressionTtests);
+    int exitcode = sMaster.Run(runRegressionTtests, runBenchmarks);
     if (exitcode == 2)
     {
         /* We need to close all fds except the standard ones,
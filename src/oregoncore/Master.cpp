@@ -33,6 +33,7 @@
 #include "OCSoap.h"
 #include "Console.h"
 #include "ObjectAccessor.h"
+#include "ObjectMgr.h"
 #include "MapManager.h"
 #include "BattlegroundMgr.h"
 #include "CreatureGroups.h"
@@ -105,7 +106,7 @@ Master::~Master()
 }
 
 // Main function
-int Master::Run(bool runTests)
+int Master::Run(bool runTests, bool runBenchmarks)
 {
     int defaultStderr = dup(2);
 
@@ -251,6 +252,13 @@ int Master::Run(bool runTests)
             World::StopNow(ERROR_EXIT_CODE);
     }
 
+    // Run benchmarks, then exit
+    if (runBenchmarks)
+    {
+        RunBenchmarks();
+        World::StopNow(SHUTDOWN_EXIT_CODE);
+    }
+
     // Run our World, we use main thread for this,
     MainLoop();
 
@@ -264,6 +272,7 @@ int Master::Run(bool runTests)
     sWorldSocketMgr->StopNetwork();
 
     MapManager::Instance().UnloadAll();            // unload all grids (including locked in memory)
+    sObjectMgr.SaveRespawnTimes();                 // write the respawn times not saved yet
 
     // End the database thread
     WorldDatabase.ThreadEnd();                     // free mySQL thread resources
@@ -298,6 +307,9 @@ int Master::Run(bool runTests)
     // Clean account database before leaving
     clearOnlineAccounts();
 
+    // Queue pending log lines for the logs table before stopping the database workers
+    sLog.Flush();
+
     // Wait for delay threads to end
     CharacterDatabase.HaltDelayThread();
     WorldDatabase.HaltDelayThread();
@@ -339,7 +351,8 @@ void Master::_StartDB()
         sLog.outFatal("World database not specified in configuration file");
 
     // Initialise the world database
-    if (!WorldDatabase.Initialize(dbstring.c_str()))
+    if (!WorldDatabase.Initialize(dbstring.c_str(), sConfig.GetIntDefault("WorldDatabase.Connections", 1),
+        sConfig.GetIntDefault("WorldDatabase.WorkerThreads", 1)))
         sLog.outFatal("Cannot connect to world database %s", dbstring.c_str());
 
     // Get character database info from configuration file
@@ -348,7 +361,8 @@ void Master::_StartDB()
         sLog.outFatal("Character database not specified in configuration file");
 
     // Initialise the Character database
-    if (!CharacterDatabase.Initialize(dbstring.c_str()))
+    if (!CharacterDatabase.Initialize(dbstring.c_str(), sConfig.GetIntDefault("CharacterDatabase.Connections", 1),
+        sConfig.GetIntDefault("CharacterDatabase.WorkerThreads", 1)))
         sLog.outFatal("Cannot connect to Character database %s", dbstring.c_str());
 
     // Get login database info from configuration file
@@ -357,7 +371,8 @@ void Master::_StartDB()
         sLog.outFatal("Login database not specified in configuration file");
 
     // Initialise the login database
-    if (!LoginDatabase.Initialize(dbstring.c_str()))
+    if (!LoginDatabase.Initialize(dbstring.c_str(), sConfig.GetIntDefault("LoginDatabase.Connections", 1),
+        sConfig.GetIntDefault("LoginDatabase.WorkerThreads", 1)))
         sLog.outFatal("Cannot connect to login database %s", dbstring.c_str());
 
     // Get the realm Id from the configuration file
@@ -431,6 +446,12 @@ bool Master::RunRegressionTests()
     return suite.RunAll();
 }
 
+void Master::RunBenchmarks()
+{
+    BenchmarkSuite suite;
+    suite.RunAll();
+}
+
 // Heartbeat for the World
 void Master::MainLoop()
 {
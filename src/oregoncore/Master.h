@@ -21,6 +21,7 @@
 #include "Common.h"
 #include "Policies/Singleton.h"
 #include "RegressionTests/RegressionTest.h"
+#include "RegressionTests/Benchmark.h"
 
 // Start the server
 class Master
@@ -28,10 +29,11 @@ class Master
     public:
         Master();
         ~Master();
-        int Run(bool runTests);
+        int Run(bool runTests, bool runBenchmarks);
         static volatile uint32 m_masterLoopCounter;
 
         bool RunRegressionTests();
+        void RunBenchmarks();
     private:
         void _StartDB();
 
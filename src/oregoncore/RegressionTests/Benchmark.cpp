@@ -0,0 +1,43 @@
+/*
+ * This file is part of the OregonCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Log.h"
+#include "Benchmark.h"
+
+BenchmarkSuite::BenchmarkSuite()
+{
+}
+
+BenchmarkSuite::~BenchmarkSuite()
+{
+}
+
+void BenchmarkSuite::RunAll()
+{
+    sLog.outString("Running Benchmarks...");
+
+    Run(&BenchmarkSuite::BenchUpdateCompression, "Update packet compression");
+    Run(&BenchmarkSuite::BenchVisibility, "Visibility diffing");
+
+    sLog.outString("Benchmarks Finished.");
+}
+
+void BenchmarkSuite::Run(void(BenchmarkSuite::*benchmark)(), const char* comment)
+{
+    sLog.outString("  [..] Benchmark %s:", comment);
+    (this->*benchmark)();
+}
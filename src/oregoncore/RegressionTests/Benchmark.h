@@ -0,0 +1,41 @@
+/*
+ * This file is part of the OregonCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __OREGON_BENCHMARK_H_DEFINED__
+#define __OREGON_BENCHMARK_H_DEFINED__
+
+#include "Common.h"
+
+/**
+  * Microbenchmarks of hot code paths, run with --run-benchmarks.
+  * They only report their numbers, comparing them is up to the reader.
+  */
+class BenchmarkSuite
+{
+    public:
+        BenchmarkSuite();
+        ~BenchmarkSuite();
+
+        void RunAll();
+    protected:
+        void Run(void(BenchmarkSuite::*)(), const char* comment);
+
+        void BenchUpdateCompression();
+        void BenchVisibility();
+};
+
+#endif // __OREGON_BENCHMARK_H_DEFINED__
@@ -17,6 +17,7 @@
 
 #include "RegressionTest.h"
 #include <PrecompiledHeaders/gamePCH.h>
+#include "Database/SqlBatchInsert.h"
 
 /**
   * Test for issue #1334.
@@ -62,3 +63,62 @@ bool RegressionTestSuite::TestBreathingIssues()
 
     return result;
 }
+
+namespace
+{
+    std::string BatchStatement(const char* head, uint32 rows, const char* tail)
+    {
+        std::string sql = head;
+        for (uint32 row = 0; row < rows; ++row)
+            sql += row ? ",(?,?)" : "(?,?)";
+        return sql + tail;
+    }
+
+    bool CheckBatch(uint32 rows, uint32 maxRows, const char* head, const char* tail)
+    {
+        SqlBatchInsert batch(WorldDatabase, head, 2, maxRows, tail);
+        for (uint32 row = 0; row < rows; ++row)
+        {
+            batch << row << uint64(row) * 3;
+            batch.EndRow();
+        }
+
+        if (batch.GetRowCount() != rows)
+            return false;
+
+        std::vector<std::pair<std::string, uint32> > statements;
+        batch.GetStatements(statements);
+
+        // full chunks first, then the remainder, never an empty statement
+        if (statements.size() != (rows + maxRows - 1) / maxRows)
+            return false;
+
+        for (size_t i = 0; i < statements.size(); ++i)
+        {
+            uint32 expected = i + 1 < statements.size() || !(rows % maxRows) ? maxRows : rows % maxRows;
+            if (statements[i].second != expected || statements[i].first != BatchStatement(head, expected, tail))
+                return false;
+        }
+
+        return true;
+    }
+}
+
+/**
+  * Rows of a SqlBatchInsert are split in statements of maxRows rows plus
+  * one remainder, and the tail closes every statement.
+  */
+bool RegressionTestSuite::TestSqlBatchInsert()
+{
+    const char* insert = "REPLACE INTO creature_respawn (guid,instance) VALUES ";
+    const char* upsert = "INSERT INTO character_stats (guid,maxhealth) VALUES ";
+    const char* update = " ON DUPLICATE KEY UPDATE maxhealth=VALUES(maxhealth)";
+
+    return CheckBatch(0, SQL_BATCH_MAX_ROWS, insert, "") &&
+           CheckBatch(1, SQL_BATCH_MAX_ROWS, insert, "") &&
+           CheckBatch(SQL_BATCH_MAX_ROWS, SQL_BATCH_MAX_ROWS, insert, "") &&
+           CheckBatch(SQL_BATCH_MAX_ROWS * 2 + 5, SQL_BATCH_MAX_ROWS, insert, "") &&
+           CheckBatch(7, 1, insert, "") &&
+           CheckBatch(SQL_BATCH_MAX_ROWS + 1, SQL_BATCH_MAX_ROWS, upsert, update) &&
+           CheckBatch(3, SQL_BATCH_MAX_ROWS, upsert, update);
+}
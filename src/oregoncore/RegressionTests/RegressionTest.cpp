@@ -34,6 +34,8 @@ bool RegressionTestSuite::RunAll()
     sLog.outString("Running Regression Tests...");
 
     Run(&RegressionTestSuite::TestBreathingIssues, "Breathing issues Maraudon");
+    Run(&RegressionTestSuite::TestVisibilitySet, "Visibility set tombstones and rehash");
+    Run(&RegressionTestSuite::TestSqlBatchInsert, "Batch insert chunks and tail");
 
     sLog.outString("Regression Tests Finished. Total: %u, Passed: %u, Failed: %u",
                     m_passedTestsCounter + m_failedTestsCounter,
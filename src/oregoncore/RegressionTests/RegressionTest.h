@@ -31,6 +31,8 @@ class RegressionTestSuite
         bool Run(bool(RegressionTestSuite::*)(), const char* comment);
 
         bool TestBreathingIssues();
+        bool TestVisibilitySet();
+        bool TestSqlBatchInsert();
 
         uint32 m_failedTestsCounter = 0;
         uint32 m_passedTestsCounter = 0;
@@ -0,0 +1,95 @@
+/*
+ * This file is part of the OregonCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Benchmark.h"
+#include <PrecompiledHeaders/gamePCH.h>
+#include "WorldPacket.h"
+#include "UpdateData.h"
+#include "UpdateMask.h"
+
+/**
+  * Compression of SMSG_UPDATE_OBJECT packets as built by Map::SendObjectUpdates.
+  * Payloads are made of values update blocks of creatures, like what players
+  * around a fight receive: a few changed fields per creature, 1 to 40 creatures.
+  */
+void BenchmarkSuite::BenchUpdateCompression()
+{
+    const uint32 payloadCount = 256;
+    const uint32 rounds = 40;
+
+    std::vector<UpdateData> payloads(payloadCount);
+    for (uint32 i = 0; i < payloadCount; ++i)
+    {
+        uint32 blocks = urand(1, 40);
+        for (uint32 j = 0; j < blocks; ++j)
+        {
+            ByteBuffer block(200);
+            block << uint8(UPDATETYPE_VALUES);
+            block << uint8(0xFF);
+            block << uint64(MAKE_NEW_GUID(urand(1, 200000), urand(1, 25000), HIGHGUID_UNIT));
+
+            UpdateMask mask;
+            mask.SetCount(UNIT_END);
+            uint32 fields = urand(1, 8);
+            for (uint32 k = 0; k < fields; ++k)
+                mask.SetBit(urand(OBJECT_END, UNIT_END - 1));
+
+            block << uint8(mask.GetBlockCount());
+            block.append(mask.GetMask(), mask.GetLength());
+            for (uint32 index = 0; index < UNIT_END; ++index)
+                if (mask.GetBit(index))
+                    block << uint32(index < UNIT_FIELD_MAXHEALTH ? urand(0, 10000) : urand(0, 100));
+
+            payloads[i].AddUpdateBlock(block);
+        }
+    }
+
+    UpdateCompressionStats const& stats = UpdateData::GetCompressionStats();
+    WorldPacket packet;
+
+    // the first packet of a thread initializes its stream
+    payloads[0].BuildPacket(&packet);
+    packet.clear();
+
+    uint64 packets = stats.packets;
+    uint64 bytesIn = stats.bytesIn;
+    uint64 bytesOut = stats.bytesOut;
+    uint64 allocs = stats.zlibAllocs;
+
+    ACE_Time_Value start = ACE_OS::gettimeofday();
+
+    for (uint32 round = 0; round < rounds; ++round)
+    {
+        for (uint32 i = 0; i < payloadCount; ++i)
+        {
+            payloads[i].BuildPacket(&packet);
+            packet.clear();
+        }
+    }
+
+    ACE_Time_Value elapsed = ACE_OS::gettimeofday() - start;
+    double seconds = elapsed.sec() + elapsed.usec() / 1000000.0;
+
+    packets = stats.packets - packets;
+    bytesIn = stats.bytesIn - bytesIn;
+    bytesOut = stats.bytesOut - bytesOut;
+    allocs = stats.zlibAllocs - allocs;
+
+    sLog.outString("       " UI64FMTD " packets compressed in %.3f s: %.1f MB/s, %.1f%% of the original size, %.3f zlib allocations per packet",
+                   packets, seconds, seconds > 0.0 ? bytesIn / seconds / (1024 * 1024) : 0.0,
+                   bytesIn ? bytesOut * 100.0 / bytesIn : 0.0, packets ? double(allocs) / packets : 0.0);
+}
@@ -0,0 +1,254 @@
+/*
+ * This file is part of the OregonCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Benchmark.h"
+#include "RegressionTest.h"
+#include "Log.h"
+#include "Utilities/Util.h"
+#include "VisibilitySet.h"
+
+namespace
+{
+    const uint32 observerCount = 100;
+    const uint32 objectCount = 1200;
+    const uint32 ticks = 50;
+
+    // objects in sight of each observer at each relocation, in visiting order
+    typedef std::vector<std::vector<uint64> > Scenario;
+
+    // a crowded city: 1200 players and creatures on 300 x 300 yards, a third
+    // of them moving every tick, each observer seeing about 300 of them
+    void BuildScenario(Scenario& scenario)
+    {
+        const float size = 300.0f;
+        const float range = 100.0f;
+
+        std::vector<float> x(objectCount), y(objectCount);
+        for (uint32 i = 0; i < objectCount; ++i)
+        {
+            x[i] = frand(0.0f, size);
+            y[i] = frand(0.0f, size);
+        }
+
+        scenario.resize(ticks * observerCount);
+        for (uint32 tick = 0; tick < ticks; ++tick)
+        {
+            for (uint32 i = 0; i < objectCount; ++i)
+            {
+                if (urand(0, 2))
+                    continue;
+
+                x[i] = std::min(size, std::max(0.0f, x[i] + frand(-5.0f, 5.0f)));
+                y[i] = std::min(size, std::max(0.0f, y[i] + frand(-5.0f, 5.0f)));
+            }
+
+            for (uint32 observer = 0; observer < observerCount; ++observer)
+            {
+                std::vector<uint64>& visible = scenario[tick * observerCount + observer];
+                for (uint32 i = 0; i < objectCount; ++i)
+                {
+                    float dx = x[i] - x[observer];
+                    float dy = y[i] - y[observer];
+                    if (i != observer && dx * dx + dy * dy <= range * range)
+                        visible.push_back(i < observerCount ? uint64(i + 1) : (UI64LIT(0xF130000000000000) | (i + 1)));
+                }
+            }
+        }
+    }
+
+    // VisibleNotifier as it was: copy the client guids, erase the ones seen
+    double ReplayStdSet(Scenario const& scenario, uint64& outOfSight)
+    {
+        std::vector<std::set<uint64> > clients(observerCount);
+
+        ACE_Time_Value start = ACE_OS::gettimeofday();
+
+        for (uint32 pass = 0; pass < scenario.size(); ++pass)
+        {
+            std::set<uint64>& client = clients[pass % observerCount];
+            std::set<uint64> visGuids(client);
+
+            std::vector<uint64> const& visible = scenario[pass];
+            for (std::vector<uint64>::const_iterator itr = visible.begin(); itr != visible.end(); ++itr)
+            {
+                if (client.find(*itr) == client.end())
+                    client.insert(*itr);
+                visGuids.erase(*itr);
+            }
+
+            for (std::set<uint64>::const_iterator itr = visGuids.begin(); itr != visGuids.end(); ++itr)
+            {
+                client.erase(*itr);
+                ++outOfSight;
+            }
+        }
+
+        ACE_Time_Value elapsed = ACE_OS::gettimeofday() - start;
+        return elapsed.sec() + elapsed.usec() / 1000000.0;
+    }
+
+    double ReplayVisibilitySet(Scenario const& scenario, uint64& outOfSight)
+    {
+        std::vector<VisibilitySet> clients(observerCount);
+
+        ACE_Time_Value start = ACE_OS::gettimeofday();
+
+        for (uint32 pass = 0; pass < scenario.size(); ++pass)
+        {
+            VisibilitySet& client = clients[pass % observerCount];
+            client.BeginPass();
+
+            std::vector<uint64> const& visible = scenario[pass];
+            for (std::vector<uint64>::const_iterator itr = visible.begin(); itr != visible.end(); ++itr)
+            {
+                if (!client.contains(*itr))
+                    client.insert(*itr);
+                client.Mark(*itr);
+            }
+
+            outOfSight += client.EraseUnmarked().size();
+        }
+
+        ACE_Time_Value elapsed = ACE_OS::gettimeofday() - start;
+        return elapsed.sec() + elapsed.usec() / 1000000.0;
+    }
+}
+
+/**
+  * Relocation notifies of a crowded city replayed on the std::set client
+  * guids with the per notify copy, and on the generation stamped VisibilitySet.
+  */
+void BenchmarkSuite::BenchVisibility()
+{
+    Scenario scenario;
+    BuildScenario(scenario);
+
+    uint64 objects = 0;
+    for (Scenario::const_iterator itr = scenario.begin(); itr != scenario.end(); ++itr)
+        objects += itr->size();
+
+    uint64 outOfSightSet = 0;
+    uint64 outOfSightFlat = 0;
+
+    double setTime = ReplayStdSet(scenario, outOfSightSet);
+    double flatTime = ReplayVisibilitySet(scenario, outOfSightFlat);
+
+    sLog.outString("       %u notifies, %.0f objects in sight on average", uint32(scenario.size()), double(objects) / scenario.size());
+    sLog.outString("       std::set: " UI64FMTD " out of sight in %.3f s, VisibilitySet: " UI64FMTD " out of sight in %.3f s (%.2fx)",
+                   outOfSightSet, setTime, outOfSightFlat, flatTime, flatTime > 0.0 ? setTime / flatTime : 0.0);
+}
+
+namespace
+{
+    bool SameGuids(VisibilitySet const& set, std::set<uint64> const& model)
+    {
+        if (set.size() != model.size())
+            return false;
+
+        std::set<uint64> iterated(set.begin(), set.end());
+        return iterated == model;
+    }
+}
+
+/**
+  * VisibilitySet against a std::set: erased guids leave tombstones that
+  * lookups must probe past and inserts reuse, growing rehashes without
+  * them, and a pass erases exactly the guids not marked.
+  */
+bool RegressionTestSuite::TestVisibilitySet()
+{
+    VisibilitySet set;
+    std::set<uint64> model;
+
+    // creature guids of one type only differ in their low bits, the worst case for the hash
+    for (uint64 i = 1; i <= 1000; ++i)
+    {
+        set.insert(UI64LIT(0xF130000000000000) | i);
+        model.insert(UI64LIT(0xF130000000000000) | i);
+    }
+
+    if (!SameGuids(set, model))
+        return false;
+
+    // churn at a constant size: tombstones pile up until an insert rehashes them away
+    for (uint32 i = 0; i < 20000; ++i)
+    {
+        uint64 guid = UI64LIT(0xF130000000000000) | urand(1, 2000);
+        if (model.count(guid))
+        {
+            set.erase(guid);
+            model.erase(guid);
+            if (set.contains(guid))
+                return false;
+        }
+        else
+        {
+            set.insert(guid);
+            model.insert(guid);
+            if (!set.contains(guid))
+                return false;
+        }
+    }
+
+    if (!SameGuids(set, model))
+        return false;
+
+    for (uint64 i = 1; i <= 2000; ++i)
+        if (set.contains(UI64LIT(0xF130000000000000) | i) != (model.count(UI64LIT(0xF130000000000000) | i) != 0))
+            return false;
+
+    // a pass: marked guids stay, guids inserted during the pass count as marked
+    set.BeginPass();
+    std::set<uint64> unmarked;
+    for (std::set<uint64>::const_iterator itr = model.begin(); itr != model.end(); ++itr)
+    {
+        if (urand(0, 1))
+        {
+            if (!set.Mark(*itr) || set.Mark(*itr))
+                return false;
+        }
+        else
+            unmarked.insert(*itr);
+    }
+
+    if (set.Mark(1))
+        return false;
+
+    set.insert(1);
+    model.insert(1);
+
+    std::vector<uint64> const& erased = set.EraseUnmarked();
+    if (std::set<uint64>(erased.begin(), erased.end()) != unmarked || erased.size() != unmarked.size())
+        return false;
+
+    for (std::set<uint64>::const_iterator itr = unmarked.begin(); itr != unmarked.end(); ++itr)
+        model.erase(*itr);
+
+    if (!SameGuids(set, model))
+        return false;
+
+    // erased guids come back in place of their tombstones
+    for (std::set<uint64>::const_iterator itr = unmarked.begin(); itr != unmarked.end(); ++itr)
+        set.insert(*itr);
+    model.insert(unmarked.begin(), unmarked.end());
+
+    if (!SameGuids(set, model))
+        return false;
+
+    set.clear();
+    return set.empty() && set.begin() == set.end() && !set.contains(UI64LIT(0xF130000000000000) | 1);
+}
@@ -23,6 +23,7 @@
 #include "AuthSocket.h"
 #include "AuthCodes.h"
 #include "PatchHandler.h"
+#include "AuthWorkerPool.h"
 
 #include <openssl/md5.h>
 //#include "Util.h" -- for commented utf8ToUpperOnlyLatin
@@ -171,11 +172,17 @@ AuthSocket::AuthSocket()
 
     _build = 0;
     patch_ = ACE_INVALID_HANDLE;
+
+    _pending = false;
+    _socketId = sAuthWorkerPool->RegisterSocket(this);
 }
 
 // Close patch file descriptor before leaving
 AuthSocket::~AuthSocket()
 {
+    // a logon job still running for this socket gets its result dropped
+    sAuthWorkerPool->UnregisterSocket(_socketId);
+
     if (patch_ != ACE_INVALID_HANDLE)
         ACE_OS::close(patch_);
 }
@@ -195,6 +202,10 @@ void AuthSocket::OnRead()
     uint8 _cmd;
     while (1)
     {
+        // keep the input buffered while a logon job runs
+        if (_pending)
+            return;
+
         if(!recv_soft((char*)&_cmd, 1))
             return;
 
@@ -241,10 +252,48 @@ void AuthSocket::OnRead()
     }
 }
 
+// Continue with the input received while a logon job was running
+void AuthSocket::_ResumeRead()
+{
+    _pending = false;
+
+    if (recv_len())
+        OnRead();
+}
+
+// Account lookups and SRP6 setup of a logon challenge
+class LogonChallengeJob : public AuthJob
+{
+    public:
+        explicit LogonChallengeJob(AuthSocket* socket) : AuthJob(socket->_socketId),
+            N(socket->N), g(socket->g), _login(socket->_login), _safelogin(socket->_safelogin),
+            _localizationName(socket->_localizationName), _remoteAddress(socket->getRemoteAddress()),
+            _accountSecurityLevel(SEC_PLAYER), _challenged(false)
+        {
+        }
+
+        void Process() override;
+        void Complete(AuthSocket* socket) override;
+
+    private:
+        void _SetVSFields(const std::string& rI);
+
+        BigNumber N, g, s, v, b, B;
+
+        std::string _login;
+        std::string _safelogin;
+        std::string _localizationName;
+        std::string _remoteAddress;
+
+        ByteBuffer pkt;
+        AccountTypes _accountSecurityLevel;
+        bool _challenged;                                   // the account may send its proof
+};
+
 // Make the SRP6 calculation from hash in dB
-void AuthSocket::_SetVSFields(const std::string& rI)
+void LogonChallengeJob::_SetVSFields(const std::string& rI)
 {
-    s.SetRand(s_BYTE_SIZE * 8);
+    s.SetRand(AuthSocket::s_BYTE_SIZE * 8);
 
     BigNumber I;
     I.SetHexStr(rI.c_str());
@@ -273,6 +322,353 @@ void AuthSocket::_SetVSFields(const std::string& rI)
     OPENSSL_free((void*)s_hex);
 }
 
+void LogonChallengeJob::Process()
+{
+    pkt << (uint8) CMD_AUTH_LOGON_CHALLENGE;
+    pkt << (uint8) 0x00;
+
+    // Verify that this IP is not in the ip_banned table
+    // No SQL injection possible (paste the IP address as passed by the socket)
+    std::string address = _remoteAddress;
+    LoginDatabase.escape_string(address);
+    QueryResult_AutoPtr result = LoginDatabase.PQuery("SELECT unbandate FROM ip_banned WHERE "
+                                 //    permanent                    still banned
+                                 "(unbandate = bandate OR unbandate > UNIX_TIMESTAMP()) AND ip = '%s'", address.c_str());
+    if (result)
+    {
+        pkt << (uint8)WOW_FAIL_BANNED;
+        sLog.outBasic("'%s' [AuthChallenge] Banned ip tries to login!", _remoteAddress.c_str());
+        return;
+    }
+
+    // Get the account details from the account table
+    // No SQL injection (escaped user name)
+    result =
+        LoginDatabase.PQuery("SELECT a.sha_pass_hash,a.id,a.locked,a.last_ip,aa.gmlevel,a.v,a.s "
+                             "FROM account a "
+                             "LEFT JOIN account_access aa "
+                             "ON (a.id = aa.id) "
+                             "WHERE a.username = '%s'", _safelogin.c_str ());
+    if (!result)                                            // no account
+    {
+        pkt << (uint8) WOW_FAIL_UNKNOWN_ACCOUNT;
+        return;
+    }
+
+    // If the IP is 'locked', check that the player comes indeed from the correct IP address
+    if ((*result)[2].GetUInt8() == 1)                       // if ip is locked
+    {
+        DEBUG_LOG("[AuthChallenge] Account '%s' is locked to IP - '%s'", _login.c_str(), (*result)[3].GetString());
+        DEBUG_LOG("[AuthChallenge] Player address is '%s'", _remoteAddress.c_str());
+        if ( strcmp((*result)[3].GetString(), _remoteAddress.c_str()) )
+        {
+            DEBUG_LOG("[AuthChallenge] Account IP differs");
+            pkt << (uint8) WOW_FAIL_LOCKED_ENFORCED;
+            return;
+        }
+        else
+            DEBUG_LOG("[AuthChallenge] Account IP matches");
+    }
+    else
+        DEBUG_LOG("[AuthChallenge] Account '%s' is not locked to ip", _login.c_str());
+
+    // If the account is banned, reject the logon attempt
+    QueryResult_AutoPtr banresult = LoginDatabase.PQuery("SELECT bandate,unbandate FROM account_banned WHERE "
+                                    "id = %u AND active = 1 AND (unbandate > UNIX_TIMESTAMP() OR unbandate = bandate)", (*result)[1].GetUInt32());
+    if (banresult)
+    {
+        if ((*banresult)[0].GetUInt64() == (*banresult)[1].GetUInt64())
+        {
+            pkt << (uint8) WOW_FAIL_BANNED;
+            sLog.outBasic("[AuthChallenge] Banned account %s tries to login!", _login.c_str ());
+        }
+        else
+        {
+            pkt << (uint8) WOW_FAIL_SUSPENDED;
+            sLog.outBasic("[AuthChallenge] Temporarily banned account %s tries to login!", _login.c_str ());
+        }
+        return;
+    }
+
+    // Get the password from the account table, upper it, and make the SRP6 calculation
+    std::string rI = (*result)[0].GetCppString();
+
+    // Don't calculate (v, s) if there are already some in the database
+    std::string databaseV = (*result)[5].GetCppString();
+    std::string databaseS = (*result)[6].GetCppString();
+
+    DEBUG_LOG("database authentication values: v='%s' s='%s'", databaseV.c_str(), databaseS.c_str());
+
+    // multiply with 2, bytes are stored as hexstring
+    if (databaseV.size() != AuthSocket::s_BYTE_SIZE * 2 || databaseS.size() != AuthSocket::s_BYTE_SIZE * 2)
+        _SetVSFields(rI);
+    else
+    {
+        s.SetHexStr(databaseS.c_str());
+        v.SetHexStr(databaseV.c_str());
+    }
+
+    b.SetRand(19 * 8);
+    BigNumber gmod = g.ModExp(b, N);
+    B = ((v * 3) + gmod) % N;
+
+    ASSERT(gmod.GetNumBytes() <= 32);
+
+    BigNumber unk3;
+    unk3.SetRand(16 * 8);
+
+    // Fill the response packet with the result
+    pkt << uint8(WOW_SUCCESS);
+
+    // B may be calculated < 32B so we force minimal length to 32B
+    pkt.append(B.AsByteArray(32), 32);                      // 32 bytes
+    pkt << uint8(1);
+    pkt.append(g.AsByteArray(), 1);
+    pkt << uint8(32);
+    pkt.append(N.AsByteArray(32), 32);
+    pkt.append(s.AsByteArray(), s.GetNumBytes());           // 32 bytes
+    pkt.append(unk3.AsByteArray(16), 16);
+    uint8 securityFlags = 0;
+    pkt << uint8(securityFlags);                            // security flags (0x0...0x04)
+
+    if (securityFlags & 0x01)                               // PIN input
+    {
+        pkt << uint32(0);
+        pkt << uint64(0) << uint64(0);                      // 16 bytes hash?
+    }
+
+    if (securityFlags & 0x02)                               // Matrix input
+    {
+        pkt << uint8(0);
+        pkt << uint8(0);
+        pkt << uint8(0);
+        pkt << uint8(0);
+        pkt << uint64(0);
+    }
+
+    if (securityFlags & 0x04)                               // Security token input
+        pkt << uint8(1);
+
+    uint8 secLevel = (*result)[4].GetUInt8();
+    _accountSecurityLevel = secLevel <= SEC_ADMINISTRATOR ? AccountTypes(secLevel) : SEC_ADMINISTRATOR;
+
+    sLog.outBasic("[AuthChallenge] account %s is using '%s' locale (%u)", _login.c_str (), _localizationName.c_str(), GetLocaleByName(_localizationName));
+
+    _challenged = true;
+}
+
+void LogonChallengeJob::Complete(AuthSocket* socket)
+{
+    if (!socket)
+        return;
+
+    if (_challenged)
+    {
+        socket->s = s;
+        socket->v = v;
+        socket->b = b;
+        socket->B = B;
+        socket->_accountSecurityLevel = _accountSecurityLevel;
+        socket->_status = STATUS_LOGON_PROOF;
+    }
+
+    socket->send((char const*)pkt.contents(), pkt.size());
+    socket->_ResumeRead();
+}
+
+// SRP6 verification of a logon proof and the account updates following it
+class LogonProofJob : public AuthJob
+{
+    public:
+        LogonProofJob(AuthSocket* socket, BigNumber const& A, uint8 const* M1) : AuthJob(socket->_socketId),
+            N(socket->N), g(socket->g), s(socket->s), v(socket->v), b(socket->b), B(socket->B), A(A),
+            _login(socket->_login), _safelogin(socket->_safelogin), _os(socket->_os),
+            _remoteAddress(socket->getRemoteAddress()), _locale(GetLocaleByName(socket->_localizationName)),
+            _maxWrongPassCount(sConfig.GetIntDefault("WrongPass.MaxCount", 0)),
+            _wrongPassBanTime(sConfig.GetIntDefault("WrongPass.BanTime", 600)),
+            _wrongPassBanType(sConfig.GetBoolDefault("WrongPass.BanType", false)),
+            _authenticated(false)
+        {
+            memcpy(_M1, M1, 20);
+        }
+
+        void Process() override;
+        void Complete(AuthSocket* socket) override;
+
+    private:
+        void _HandleWrongPass();
+
+        BigNumber N, g, s, v, b, B, A;
+        BigNumber K;
+        uint8 _M1[20];
+
+        std::string _login;
+        std::string _safelogin;
+        std::string _os;
+        std::string _remoteAddress;
+        uint32 _locale;
+
+        // read on the reactor thread, the config is not thread safe
+        uint32 _maxWrongPassCount;
+        uint32 _wrongPassBanTime;
+        bool _wrongPassBanType;
+
+        Sha1Hash _proof;
+        bool _authenticated;
+};
+
+void LogonProofJob::Process()
+{
+    Sha1Hash sha;
+    sha.UpdateBigNumbers(&A, &B, NULL);
+    sha.Finalize();
+    BigNumber u;
+    u.SetBinary(sha.GetDigest(), 20);
+    BigNumber S = (A * (v.ModExp(u, N))).ModExp(b, N);
+
+    uint8 t[32];
+    uint8 t1[16];
+    uint8 vK[40];
+    memcpy(t, S.AsByteArray(32), 32);
+    for (int i = 0; i < 16; ++i)
+        t1[i] = t[i * 2];
+    sha.Initialize();
+    sha.UpdateData(t1, 16);
+    sha.Finalize();
+    for (int i = 0; i < 20; ++i)
+        vK[i * 2] = sha.GetDigest()[i];
+    for (int i = 0; i < 16; ++i)
+        t1[i] = t[i * 2 + 1];
+    sha.Initialize();
+    sha.UpdateData(t1, 16);
+    sha.Finalize();
+    for (int i = 0; i < 20; ++i)
+        vK[i * 2 + 1] = sha.GetDigest()[i];
+    K.SetBinary(vK, 40);
+
+    uint8 hash[20];
+
+    sha.Initialize();
+    sha.UpdateBigNumbers(&N, NULL);
+    sha.Finalize();
+    memcpy(hash, sha.GetDigest(), 20);
+    sha.Initialize();
+    sha.UpdateBigNumbers(&g, NULL);
+    sha.Finalize();
+    for (int i = 0; i < 20; ++i)
+        hash[i] ^= sha.GetDigest()[i];
+    BigNumber t3;
+    t3.SetBinary(hash, 20);
+
+    sha.Initialize();
+    sha.UpdateData(_login);
+    sha.Finalize();
+    uint8 t4[SHA_DIGEST_LENGTH];
+    memcpy(t4, sha.GetDigest(), SHA_DIGEST_LENGTH);
+
+    sha.Initialize();
+    sha.UpdateBigNumbers(&t3, NULL);
+    sha.UpdateData(t4, SHA_DIGEST_LENGTH);
+    sha.UpdateBigNumbers(&s, &A, &B, &K, NULL);
+    sha.Finalize();
+    BigNumber M;
+    M.SetBinary(sha.GetDigest(), 20);
+
+    // Check if SRP6 results match (password is correct), else the account gets an error
+    if (memcmp(M.AsByteArray(), _M1, 20))
+    {
+        sLog.outBasic("[AuthChallenge] account %s tried to login with wrong password!", _login.c_str ());
+        _HandleWrongPass();
+        return;
+    }
+
+    sLog.outBasic("User '%s' successfully authenticated", _login.c_str());
+
+    // Update the sessionkey, last_ip, last login time and reset number of failed logins in the account table for this account
+    // No SQL injection (escaped user name) and IP address as received by socket
+    const char* K_hex = K.AsHexStr();
+    LoginDatabase.PExecute("UPDATE account SET sessionkey = '%s', last_ip = '%s', last_login = NOW(), locale = '%u', os = '%s', failed_logins = 0 WHERE username = '%s'", K_hex, _remoteAddress.c_str(), _locale, _os.c_str(), _safelogin.c_str() );
+    OPENSSL_free((void*)K_hex);
+
+    // Finish SRP6, the result is sent to the client by Complete()
+    _proof.Initialize();
+    _proof.UpdateBigNumbers(&A, &M, &K, NULL);
+    _proof.Finalize();
+
+    _authenticated = true;
+}
+
+void LogonProofJob::_HandleWrongPass()
+{
+    if (!_maxWrongPassCount)
+        return;
+
+    // Increment number of failed logins by one and if it reaches the limit temporarily ban that account or IP
+    LoginDatabase.PExecute("UPDATE account SET failed_logins = failed_logins + 1 WHERE username = '%s'", _safelogin.c_str());
+
+    QueryResult_AutoPtr loginfail = LoginDatabase.PQuery("SELECT id, failed_logins FROM account WHERE username = '%s'", _safelogin.c_str());
+    if (!loginfail)
+        return;
+
+    Field* fields = loginfail->Fetch();
+    uint32 failed_logins = fields[1].GetUInt32();
+
+    if ( failed_logins < _maxWrongPassCount )
+        return;
+
+    if (_wrongPassBanType)
+    {
+        uint32 acc_id = fields[0].GetUInt32();
+        LoginDatabase.PExecute("INSERT INTO account_banned VALUES ('%u',UNIX_TIMESTAMP(),UNIX_TIMESTAMP()+'%u','Oregon realmd','Failed login autoban',1)",
+                               acc_id, _wrongPassBanTime);
+        sLog.outBasic("[AuthChallenge] account %s got banned for '%u' seconds because it failed to authenticate '%u' times",
+                      _login.c_str(), _wrongPassBanTime, failed_logins);
+    }
+    else
+    {
+        std::string current_ip = _remoteAddress;
+        LoginDatabase.escape_string(current_ip);
+        LoginDatabase.PExecute("INSERT INTO ip_banned VALUES ('%s',UNIX_TIMESTAMP(),UNIX_TIMESTAMP()+'%u','Oregon realmd','Failed login autoban')",
+                               current_ip.c_str(), _wrongPassBanTime);
+        sLog.outBasic("[AuthChallenge] IP %s got banned for '%u' seconds because account %s failed to authenticate '%u' times",
+                      current_ip.c_str(), _wrongPassBanTime, _login.c_str(), failed_logins);
+    }
+}
+
+void LogonProofJob::Complete(AuthSocket* socket)
+{
+    if (!socket)
+        return;
+
+    if (_authenticated)
+    {
+        socket->K = K;
+        socket->SendProof(_proof);
+
+        // Set _status to authed
+        socket->_status = STATUS_AUTHED;
+    }
+    else
+    {
+        if (socket->_build > 6005)                          // > 1.12.2
+        {
+            char data[4] = { CMD_AUTH_LOGON_PROOF, WOW_FAIL_UNKNOWN_ACCOUNT, 3, 0};
+            socket->send(data, sizeof(data));
+        }
+        else
+        {
+            // 1.x not react incorrectly at 4-byte message use 3 as real error
+            char data[2] = { CMD_AUTH_LOGON_PROOF, WOW_FAIL_UNKNOWN_ACCOUNT};
+            socket->send(data, sizeof(data));
+        }
+
+        // the client may try again
+        socket->_status = STATUS_LOGON_PROOF;
+    }
+
+    socket->_ResumeRead();
+}
+
 void AuthSocket::SendProof(Sha1Hash sha)
 {
     switch (_build)
@@ -353,8 +749,6 @@ bool AuthSocket::_HandleLogonChallenge()
     EndianConvert(ch->timezone_bias);
     EndianConvert(ch->ip);
 
-    ByteBuffer pkt;
-
     _login = (const char*)ch->I;
     _build = ch->build;
 
@@ -371,149 +765,13 @@ bool AuthSocket::_HandleLogonChallenge()
     _safelogin = _login;
     LoginDatabase.escape_string(_safelogin);
 
-    pkt << (uint8) CMD_AUTH_LOGON_CHALLENGE;
-    pkt << (uint8) 0x00;
-
-    // Verify that this IP is not in the ip_banned table
-    // No SQL injection possible (paste the IP address as passed by the socket)
-    std::string address = getRemoteAddress();
-    LoginDatabase.escape_string(address);
-    QueryResult_AutoPtr result = LoginDatabase.PQuery("SELECT unbandate FROM ip_banned WHERE "
-                                 //    permanent                    still banned
-                                 "(unbandate = bandate OR unbandate > UNIX_TIMESTAMP()) AND ip = '%s'", address.c_str());
-    if (result)
-    {
-        pkt << (uint8)WOW_FAIL_BANNED;
-        sLog.outBasic("'%s' [AuthChallenge] Banned ip tries to login!", getRemoteAddress().c_str());
+    _localizationName.resize(4);
+    for (int i = 0; i < 4; ++i)
+        _localizationName[i] = ch->country[4 - i - 1];
 
-    }
-    else
-    {
-        // Get the account details from the account table
-        // No SQL injection (escaped user name)
-
-        result =
-            LoginDatabase.PQuery("SELECT a.sha_pass_hash,a.id,a.locked,a.last_ip,aa.gmlevel,a.v,a.s "
-                                 "FROM account a "
-                                 "LEFT JOIN account_access aa "
-                                 "ON (a.id = aa.id) "
-                                 "WHERE a.username = '%s'", _safelogin.c_str ());
-        if (result)
-        {
-            // If the IP is 'locked', check that the player comes indeed from the correct IP address
-            bool locked = false;
-            if ((*result)[2].GetUInt8() == 1)                // if ip is locked
-            {
-                DEBUG_LOG("[AuthChallenge] Account '%s' is locked to IP - '%s'", _login.c_str(), (*result)[3].GetString());
-                DEBUG_LOG("[AuthChallenge] Player address is '%s'", getRemoteAddress().c_str());
-                if ( strcmp((*result)[3].GetString(), getRemoteAddress().c_str()) )
-                {
-                    DEBUG_LOG("[AuthChallenge] Account IP differs");
-                    pkt << (uint8) WOW_FAIL_LOCKED_ENFORCED;
-                    locked = true;
-                }
-                else
-                    DEBUG_LOG("[AuthChallenge] Account IP matches");
-            }
-            else
-                DEBUG_LOG("[AuthChallenge] Account '%s' is not locked to ip", _login.c_str());
-
-            if (!locked)
-            {
-                // If the account is banned, reject the logon attempt
-                QueryResult_AutoPtr banresult = LoginDatabase.PQuery("SELECT bandate,unbandate FROM account_banned WHERE "
-                                                "id = %u AND active = 1 AND (unbandate > UNIX_TIMESTAMP() OR unbandate = bandate)", (*result)[1].GetUInt32());
-                if (banresult)
-                {
-                    if ((*banresult)[0].GetUInt64() == (*banresult)[1].GetUInt64())
-                    {
-                        pkt << (uint8) WOW_FAIL_BANNED;
-                        sLog.outBasic("[AuthChallenge] Banned account %s tries to login!", _login.c_str ());
-                    }
-                    else
-                    {
-                        pkt << (uint8) WOW_FAIL_SUSPENDED;
-                        sLog.outBasic("[AuthChallenge] Temporarily banned account %s tries to login!", _login.c_str ());
-                    }
-                }
-                else
-                {
-                    // Get the password from the account table, upper it, and make the SRP6 calculation
-                    std::string rI = (*result)[0].GetCppString();
-
-                    // Don't calculate (v, s) if there are already some in the database
-                    std::string databaseV = (*result)[5].GetCppString();
-                    std::string databaseS = (*result)[6].GetCppString();
-
-                    DEBUG_LOG("database authentication values: v='%s' s='%s'", databaseV.c_str(), databaseS.c_str());
-
-                    // multiply with 2, bytes are stored as hexstring
-                    if (databaseV.size() != s_BYTE_SIZE * 2 || databaseS.size() != s_BYTE_SIZE * 2)
-                        _SetVSFields(rI);
-                    else
-                    {
-                        s.SetHexStr(databaseS.c_str());
-                        v.SetHexStr(databaseV.c_str());
-                    }
-
-                    b.SetRand(19 * 8);
-                    BigNumber gmod = g.ModExp(b, N);
-                    B = ((v * 3) + gmod) % N;
-
-                    ASSERT(gmod.GetNumBytes() <= 32);
-
-                    BigNumber unk3;
-                    unk3.SetRand(16 * 8);
-
-                    // Fill the response packet with the result
-                    pkt << uint8(WOW_SUCCESS);
-
-                    // B may be calculated < 32B so we force minimal length to 32B
-                    pkt.append(B.AsByteArray(32), 32);      // 32 bytes
-                    pkt << uint8(1);
-                    pkt.append(g.AsByteArray(), 1);
-                    pkt << uint8(32);
-                    pkt.append(N.AsByteArray(32), 32);
-                    pkt.append(s.AsByteArray(), s.GetNumBytes());// 32 bytes
-                    pkt.append(unk3.AsByteArray(16), 16);
-                    uint8 securityFlags = 0;
-                    pkt << uint8(securityFlags);            // security flags (0x0...0x04)
-
-                    if (securityFlags & 0x01)                // PIN input
-                    {
-                        pkt << uint32(0);
-                        pkt << uint64(0) << uint64(0);      // 16 bytes hash?
-                    }
-
-                    if (securityFlags & 0x02)                // Matrix input
-                    {
-                        pkt << uint8(0);
-                        pkt << uint8(0);
-                        pkt << uint8(0);
-                        pkt << uint8(0);
-                        pkt << uint64(0);
-                    }
-
-                    if (securityFlags & 0x04)                // Security token input
-                        pkt << uint8(1);
-
-                    uint8 secLevel = (*result)[4].GetUInt8();
-                    _accountSecurityLevel = secLevel <= SEC_ADMINISTRATOR ? AccountTypes(secLevel) : SEC_ADMINISTRATOR;
-
-                    _localizationName.resize(4);
-                    for (int i = 0; i < 4; ++i)
-                        _localizationName[i] = ch->country[4 - i - 1];
-
-                    sLog.outBasic("[AuthChallenge] account %s is using '%c%c%c%c' locale (%u)", _login.c_str (), ch->country[3], ch->country[2], ch->country[1], ch->country[0], GetLocaleByName(_localizationName));
-
-                    _status = STATUS_LOGON_PROOF;
-                }
-            }
-        }
-        else                                                // no account
-            pkt << (uint8) WOW_FAIL_UNKNOWN_ACCOUNT;
-    }
-    send((char const*)pkt.contents(), pkt.size());
+    // The account lookups run on the logon workers, the socket reads nothing more until they are done
+    _pending = true;
+    sAuthWorkerPool->Queue(new LogonChallengeJob(this));
     return true;
 }
 
@@ -595,134 +853,9 @@ bool AuthSocket::_HandleLogonProof()
     if (A.isZero() || (A % N).isZero())
         return false;
 
-    Sha1Hash sha;
-    sha.UpdateBigNumbers(&A, &B, NULL);
-    sha.Finalize();
-    BigNumber u;
-    u.SetBinary(sha.GetDigest(), 20);
-    BigNumber S = (A * (v.ModExp(u, N))).ModExp(b, N);
-
-    uint8 t[32];
-    uint8 t1[16];
-    uint8 vK[40];
-    memcpy(t, S.AsByteArray(32), 32);
-    for (int i = 0; i < 16; ++i)
-        t1[i] = t[i * 2];
-    sha.Initialize();
-    sha.UpdateData(t1, 16);
-    sha.Finalize();
-    for (int i = 0; i < 20; ++i)
-        vK[i * 2] = sha.GetDigest()[i];
-    for (int i = 0; i < 16; ++i)
-        t1[i] = t[i * 2 + 1];
-    sha.Initialize();
-    sha.UpdateData(t1, 16);
-    sha.Finalize();
-    for (int i = 0; i < 20; ++i)
-        vK[i * 2 + 1] = sha.GetDigest()[i];
-    K.SetBinary(vK, 40);
-
-    uint8 hash[20];
-
-    sha.Initialize();
-    sha.UpdateBigNumbers(&N, NULL);
-    sha.Finalize();
-    memcpy(hash, sha.GetDigest(), 20);
-    sha.Initialize();
-    sha.UpdateBigNumbers(&g, NULL);
-    sha.Finalize();
-    for (int i = 0; i < 20; ++i)
-        hash[i] ^= sha.GetDigest()[i];
-    BigNumber t3;
-    t3.SetBinary(hash, 20);
-
-    sha.Initialize();
-    sha.UpdateData(_login);
-    sha.Finalize();
-    uint8 t4[SHA_DIGEST_LENGTH];
-    memcpy(t4, sha.GetDigest(), SHA_DIGEST_LENGTH);
-
-    sha.Initialize();
-    sha.UpdateBigNumbers(&t3, NULL);
-    sha.UpdateData(t4, SHA_DIGEST_LENGTH);
-    sha.UpdateBigNumbers(&s, &A, &B, &K, NULL);
-    sha.Finalize();
-    BigNumber M;
-    M.SetBinary(sha.GetDigest(), 20);
-
-    // Check if SRP6 results match (password is correct), else send an error
-    if (!memcmp(M.AsByteArray(), lp.M1, 20))
-    {
-        sLog.outBasic("User '%s' successfully authenticated", _login.c_str());
-
-        // Update the sessionkey, last_ip, last login time and reset number of failed logins in the account table for this account
-        // No SQL injection (escaped user name) and IP address as received by socket
-        const char* K_hex = K.AsHexStr();
-        LoginDatabase.PExecute("UPDATE account SET sessionkey = '%s', last_ip = '%s', last_login = NOW(), locale = '%u', os = '%s', failed_logins = 0 WHERE username = '%s'", K_hex, getRemoteAddress().c_str(), GetLocaleByName(_localizationName), _os.c_str(), _safelogin.c_str() );
-        OPENSSL_free((void*)K_hex);
-
-        // Finish SRP6 and send the final result to the client
-        sha.Initialize();
-        sha.UpdateBigNumbers(&A, &M, &K, NULL);
-        sha.Finalize();
-
-        SendProof(sha);
-
-        // Set _status to authed
-        _status = STATUS_AUTHED;
-    }
-    else
-    {
-        if (_build > 6005)                                  // > 1.12.2
-        {
-            char data[4] = { CMD_AUTH_LOGON_PROOF, WOW_FAIL_UNKNOWN_ACCOUNT, 3, 0};
-            send(data, sizeof(data));
-        }
-        else
-        {
-            // 1.x not react incorrectly at 4-byte message use 3 as real error
-            char data[2] = { CMD_AUTH_LOGON_PROOF, WOW_FAIL_UNKNOWN_ACCOUNT};
-            send(data, sizeof(data));
-        }
-        sLog.outBasic("[AuthChallenge] account %s tried to login with wrong password!", _login.c_str ());
-
-        uint32 MaxWrongPassCount = sConfig.GetIntDefault("WrongPass.MaxCount", 0);
-        if (MaxWrongPassCount > 0)
-        {
-            // Increment number of failed logins by one and if it reaches the limit temporarily ban that account or IP
-            LoginDatabase.PExecute("UPDATE account SET failed_logins = failed_logins + 1 WHERE username = '%s'", _safelogin.c_str());
-
-            if (QueryResult_AutoPtr loginfail = LoginDatabase.PQuery("SELECT id, failed_logins FROM account WHERE username = '%s'", _safelogin.c_str()))
-            {
-                Field* fields = loginfail->Fetch();
-                uint32 failed_logins = fields[1].GetUInt32();
-
-                if ( failed_logins >= MaxWrongPassCount )
-                {
-                    uint32 WrongPassBanTime = sConfig.GetIntDefault("WrongPass.BanTime", 600);
-                    bool WrongPassBanType = sConfig.GetBoolDefault("WrongPass.BanType", false);
-
-                    if (WrongPassBanType)
-                    {
-                        uint32 acc_id = fields[0].GetUInt32();
-                        LoginDatabase.PExecute("INSERT INTO account_banned VALUES ('%u',UNIX_TIMESTAMP(),UNIX_TIMESTAMP()+'%u','Oregon realmd','Failed login autoban',1)",
-                                               acc_id, WrongPassBanTime);
-                        sLog.outBasic("[AuthChallenge] account %s got banned for '%u' seconds because it failed to authenticate '%u' times",
-                                      _login.c_str(), WrongPassBanTime, failed_logins);
-                    }
-                    else
-                    {
-                        std::string current_ip = getRemoteAddress();
-                        LoginDatabase.escape_string(current_ip);
-                        LoginDatabase.PExecute("INSERT INTO ip_banned VALUES ('%s',UNIX_TIMESTAMP(),UNIX_TIMESTAMP()+'%u','Oregon realmd','Failed login autoban')",
-                                               current_ip.c_str(), WrongPassBanTime);
-                        sLog.outBasic("[AuthChallenge] IP %s got banned for '%u' seconds because account %s failed to authenticate '%u' times",
-                                      current_ip.c_str(), WrongPassBanTime, _login.c_str(), failed_logins);
-                    }
-                }
-            }
-        }
-    }
+    // The verification runs on the logon workers, the socket reads nothing more until it is done
+    _pending = true;
+    sAuthWorkerPool->Queue(new LogonProofJob(this, A, lp.M1));
     return true;
 }
 
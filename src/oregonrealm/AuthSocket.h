@@ -38,6 +38,9 @@ enum eStatus
 // Handle login commands
 class AuthSocket: public BufferedSocket
 {
+    friend class LogonChallengeJob;
+    friend class LogonProofJob;
+
     public:
         const static int s_BYTE_SIZE = 32;
 
@@ -60,9 +63,8 @@ class AuthSocket: public BufferedSocket
         bool _HandleXferCancel();
         bool _HandleXferAccept();
 
-        void _SetVSFields(const std::string& rI);
-
     private:
+        void _ResumeRead();
 
         BigNumber N, s, g, v;
         BigNumber b, B;
@@ -83,6 +85,9 @@ class AuthSocket: public BufferedSocket
 
         ACE_HANDLE patch_;
 
+        uint32 _socketId;                                   // see AuthWorkerPool
+        bool _pending;                                      // a logon job runs for this socket
+
         void InitPatch();
 };
 #endif
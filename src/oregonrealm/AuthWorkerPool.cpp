@@ -0,0 +1,173 @@
+/*
+ * This file is part of the OregonCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "AuthWorkerPool.h"
+#include "Database/DatabaseEnv.h"
+#include "Log.h"
+
+#include <ace/Singleton.h>
+#include <ace/Reactor.h>
+#include <ace/Method_Request.h>
+
+extern DatabaseType LoginDatabase;
+
+class AuthJobRequest : public ACE_Method_Request
+{
+    private:
+
+        AuthWorkerPool& m_pool;
+        AuthJob* m_job;
+
+    public:
+
+        AuthJobRequest(AuthWorkerPool& pool, AuthJob* job) : m_pool(pool), m_job(job) {}
+
+        virtual int call()
+        {
+            m_job->Process();
+            m_pool.JobProcessed(m_job);
+            return 0;
+        }
+};
+
+// mysql needs every thread using a connection to be initialized
+class LoginDatabaseThreadStart : public ACE_Method_Request
+{
+    public:
+        virtual int call()
+        {
+            LoginDatabase.ThreadStart();
+            return 0;
+        }
+};
+
+class LoginDatabaseThreadEnd : public ACE_Method_Request
+{
+    public:
+        virtual int call()
+        {
+            LoginDatabase.ThreadEnd();
+            return 0;
+        }
+};
+
+AuthWorkerPool* AuthWorkerPool::instance()
+{
+    return ACE_Singleton<AuthWorkerPool, ACE_Thread_Mutex>::instance();
+}
+
+AuthWorkerPool::AuthWorkerPool() : m_notified(false), m_nextSocketId(0)
+{
+}
+
+AuthWorkerPool::~AuthWorkerPool()
+{
+    deactivate();
+}
+
+int AuthWorkerPool::activate(uint32 threads, ACE_Reactor* reactor)
+{
+    this->reactor(reactor);
+
+    if (!threads)
+        return 0;
+
+    return m_executor.activate(int(threads), new LoginDatabaseThreadStart(), new LoginDatabaseThreadEnd());
+}
+
+int AuthWorkerPool::deactivate()
+{
+    if (!activated())
+        return -1;
+
+    m_executor.deactivate();
+
+    // drop what finished after the reactor stopped
+    ACE_Guard<ACE_Thread_Mutex> guard(m_lock);
+    for (std::deque<AuthJob*>::const_iterator itr = m_finished.begin(); itr != m_finished.end(); ++itr)
+        delete *itr;
+    m_finished.clear();
+    return 0;
+}
+
+void AuthWorkerPool::Queue(AuthJob* job)
+{
+    if (activated() && m_executor.execute(new AuthJobRequest(*this, job)) != -1)
+        return;
+
+    // no workers, process it on the reactor thread as before; it still
+    // completes through the notification so the socket is not reentered
+    job->Process();
+    JobProcessed(job);
+}
+
+void AuthWorkerPool::JobProcessed(AuthJob* job)
+{
+    {
+        ACE_Guard<ACE_Thread_Mutex> guard(m_lock);
+        m_finished.push_back(job);
+
+        // one notification drains every job finished until it is handled
+        if (m_notified)
+            return;
+        m_notified = true;
+    }
+
+    if (reactor()->notify(this, ACE_Event_Handler::EXCEPT_MASK) == -1)
+    {
+        sLog.outError("AuthWorkerPool: cannot notify the reactor of finished logon jobs");
+        ACE_Guard<ACE_Thread_Mutex> guard(m_lock);
+        m_notified = false;
+    }
+}
+
+int AuthWorkerPool::handle_exception(ACE_HANDLE)
+{
+    std::deque<AuthJob*> finished;
+    {
+        ACE_Guard<ACE_Thread_Mutex> guard(m_lock);
+        finished.swap(m_finished);
+        m_notified = false;
+    }
+
+    for (std::deque<AuthJob*>::const_iterator itr = finished.begin(); itr != finished.end(); ++itr)
+        CompleteJob(*itr);
+
+    return 0;
+}
+
+void AuthWorkerPool::CompleteJob(AuthJob* job)
+{
+    SocketMap::const_iterator itr = m_sockets.find(job->GetSocketId());
+    job->Complete(itr != m_sockets.end() ? itr->second : NULL);
+    delete job;
+}
+
+uint32 AuthWorkerPool::RegisterSocket(AuthSocket* socket)
+{
+    // 0 is never handed out
+    if (!++m_nextSocketId)
+        ++m_nextSocketId;
+
+    m_sockets[m_nextSocketId] = socket;
+    return m_nextSocketId;
+}
+
+void AuthWorkerPool::UnregisterSocket(uint32 socketId)
+{
+    m_sockets.erase(socketId);
+}
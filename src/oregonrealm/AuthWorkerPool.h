@@ -0,0 +1,102 @@
+/*
+ * This file is part of the OregonCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _AUTHWORKERPOOL_H
+#define _AUTHWORKERPOOL_H
+
+#include "Common.h"
+#include "DelayExecutor.h"
+#include "Utilities/UnorderedMap.h"
+
+#include <ace/Event_Handler.h>
+#include <ace/Thread_Mutex.h>
+
+#include <deque>
+
+class AuthSocket;
+
+// Logon work handed from the reactor thread to the worker pool
+class AuthJob
+{
+    public:
+        explicit AuthJob(uint32 socketId) : m_socketId(socketId) {}
+        virtual ~AuthJob() {}
+
+        uint32 GetSocketId() const { return m_socketId; }
+
+        // Runs on a worker thread: database lookups and SRP6 math, must not touch the socket
+        virtual void Process() = 0;
+
+        // Runs on the reactor thread afterwards, socket is NULL if it was closed meanwhile
+        virtual void Complete(AuthSocket* socket) = 0;
+
+    private:
+        uint32 m_socketId;
+};
+
+/**
+ * Runs the logon challenges and proofs of oregonrealm on a pool of threads so
+ * the reactor thread never waits on the login database or on SRP6 math.
+ *
+ * Finished jobs are queued back to the reactor with a notification; sockets
+ * are only referenced by id, so a client disconnecting while its job runs
+ * just gets the result dropped. Without workers the jobs are processed on the
+ * reactor thread.
+ */
+class AuthWorkerPool : public ACE_Event_Handler
+{
+    public:
+        AuthWorkerPool();
+        ~AuthWorkerPool();
+
+        static AuthWorkerPool* instance();
+
+        int activate(uint32 threads, ACE_Reactor* reactor);
+        int deactivate();
+        bool activated() { return m_executor.activated(); }
+
+        // Takes ownership of the job
+        void Queue(AuthJob* job);
+
+        // Called by the sockets on the reactor thread
+        uint32 RegisterSocket(AuthSocket* socket);
+        void UnregisterSocket(uint32 socketId);
+
+        // Completes the finished jobs, called through the reactor notification
+        int handle_exception(ACE_HANDLE) override;
+
+    private:
+        friend class AuthJobRequest;
+
+        typedef UNORDERED_MAP<uint32, AuthSocket*> SocketMap;
+
+        void JobProcessed(AuthJob* job);
+        void CompleteJob(AuthJob* job);
+
+        DelayExecutor m_executor;
+
+        ACE_Thread_Mutex m_lock;                            // guards the finished jobs
+        std::deque<AuthJob*> m_finished;
+        bool m_notified;                                    // a notification is pending in the reactor
+
+        SocketMap m_sockets;                                // reactor thread only
+        uint32 m_nextSocketId;
+};
+
+#define sAuthWorkerPool AuthWorkerPool::instance()
+
+#endif
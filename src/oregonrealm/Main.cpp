@@ -30,6 +30,7 @@
 #include "Config/Config.h"
 #include "Log.h"
 #include "AuthSocket.h"
+#include "AuthWorkerPool.h"
 #include "SystemConfig.h"
 #include "Utilities/Util.h"
 
@@ -208,6 +209,14 @@ extern int main(int argc, char** argv)
     if (!StartDB())
         return 1;
 
+    // Logon challenges and proofs are processed by the worker threads
+    uint32 logonWorkers = sConfig.GetIntDefault("LogonWorkerThreads", 4);
+    if (sAuthWorkerPool->activate(logonWorkers, ACE_Reactor::instance()) == -1)
+    {
+        sLog.outError("Cannot start the %u logon worker threads", logonWorkers);
+        return 1;
+    }
+
     // Get the list of realms for the server
     sRealmList->Initialize(sConfig.GetIntDefault("RealmsStateUpdateDelay", 20));
     if (sRealmList->size() == 0)
@@ -304,6 +313,12 @@ extern int main(int argc, char** argv)
         #endif
     }
 
+    // Finish the logon jobs still queued, their results are dropped
+    sAuthWorkerPool->deactivate();
+
+    // Queue pending log lines for the logs table before stopping the database workers
+    sLog.Flush();
+
     // Wait for the delay thread to exit
     LoginDatabase.HaltDelayThread();
 
@@ -345,7 +360,8 @@ bool StartDB()
     }
 
     sLog.outString("Database: %s", dbstring.c_str() );
-    if (!LoginDatabase.Initialize(dbstring.c_str()))
+    // one synchronous connection for the reactor thread and one for each logon worker
+    if (!LoginDatabase.Initialize(dbstring.c_str(), sConfig.GetIntDefault("LogonWorkerThreads", 4) + 1))
     {
         sLog.outError("Cannot connect to database");
         return false;
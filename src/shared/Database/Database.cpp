@@ -19,7 +19,6 @@
 #include "Config/Config.h"
 
 #include "Common.h"
-#include "../../game/UpdateFields.h"
 
 #include "Utilities/Util.h"
 #include "Platform/Define.h"
@@ -32,15 +31,31 @@
 #include <ctime>
 #include <iostream>
 #include <fstream>
-#if PLATFORM == PLATFORM_UNIX
-#include <sys/file.h>
-#endif
 
-static const my_bool my_true = 1;
+#include <ace/TSS_T.h>
 
 size_t Database::db_count = 0;
 
-Database::Database() : mMysql(NULL), m_connected(false)
+// key of the innermost Database::KeyGuard of each thread, 0 for none
+static ACE_TSS<ACE_TSS_Type_Adapter<uint32> > threadKey;
+
+Database::KeyGuard::KeyGuard(uint32 key) : m_previousKey(_GetThreadKey())
+{
+    threadKey->operator uint32& () = key;
+}
+
+Database::KeyGuard::~KeyGuard()
+{
+    threadKey->operator uint32& () = m_previousKey;
+}
+
+uint32 Database::_GetThreadKey()
+{
+    return threadKey->operator uint32 ();
+}
+
+Database::Database() : m_queuedWrites(0), m_doneWrites(0), m_doneCond(m_doneLock),
+    m_nextConnection(0), m_connected(false)
 {
     // before first connection
     if (db_count++ == 0)
@@ -55,24 +70,17 @@ Database::Database() : mMysql(NULL), m_connected(false)
 
 Database::~Database()
 {
-    if (m_delayThread)
-        HaltDelayThread();
+    HaltDelayThread();
 
-    for (PreparedStatementsMap::iterator it = m_preparedStatements.begin(); it != m_preparedStatements.end(); ++it)
-    {
-        mysql_stmt_close(it->second->stmt);
-        delete it->second;
-    }
-
-    if (mMysql)
-        mysql_close(mMysql);
+    for (std::vector<SqlConnection*>::iterator itr = m_connections.begin(); itr != m_connections.end(); ++itr)
+        delete *itr;
 
     // Free Mysql library pointers for last ~DB
     if (--db_count == 0)
         mysql_library_end();
 }
 
-bool Database::Initialize(const char* infoString)
+bool Database::Initialize(const char* infoString, uint32 connections, uint32 asyncThreads)
 {
     // Enable logging of SQL commands (usally only GM commands)
     // (See method: PExecuteLog)
@@ -85,107 +93,26 @@ bool Database::Initialize(const char* infoString)
     }
 
     tranThread = NULL;
-    MYSQL* mysqlInit;
-    mysqlInit = mysql_init(NULL);
-    if (!mysqlInit)
-    {
-        sLog.outError("Could not initialize Mysql connection");
-        return false;
-    }
-
-    InitDelayThread();
-
-    Tokens tokens = StrSplit(infoString, ";");
-
-    Tokens::iterator iter;
 
-    std::string host, port_or_socket, user, password, database;
-    int port;
-    char const* unix_socket;
+    SqlConnectionInfo info(infoString);
 
-    iter = tokens.begin();
-
-    if (iter != tokens.end())
-        host = *iter++;
-    if (iter != tokens.end())
-        port_or_socket = *iter++;
-    if (iter != tokens.end())
-        user = *iter++;
-    if (iter != tokens.end())
-        password = *iter++;
-    if (iter != tokens.end())
-        database = *iter++;
-
-    mysql_options(mysqlInit, MYSQL_SET_CHARSET_NAME, "utf8");
-    #ifdef _WIN32
-    if (host == ".")                                         // named pipe use option (Windows)
-    {
-        unsigned int opt = MYSQL_PROTOCOL_PIPE;
-        mysql_options(mysqlInit, MYSQL_OPT_PROTOCOL, (char const*)&opt);
-        port = 0;
-        unix_socket = 0;
-    }
-    else                                                    // generic case
+    for (uint32 i = 0; i < std::max<uint32>(connections, 1); ++i)
     {
-        port = atoi(port_or_socket.c_str());
-        unix_socket = 0;
-    }
-    #else
-    if (host == ".")                                         // socket use option (Unix/Linux)
-    {
-        unsigned int opt = MYSQL_PROTOCOL_SOCKET;
-        mysql_options(mysqlInit, MYSQL_OPT_PROTOCOL, (char const*)&opt);
-        host = "localhost";
-        port = 0;
-        unix_socket = port_or_socket.c_str();
-    }
-    else                                                    // generic case
-    {
-        port = atoi(port_or_socket.c_str());
-        unix_socket = 0;
-    }
-    #endif
-
-    mMysql = mysql_real_connect(mysqlInit, host.c_str(), user.c_str(),
-                                password.c_str(), database.c_str(), port, unix_socket, 0);
+        SqlConnection* conn = new SqlConnection();
+        if (!conn->Open(info))
+        {
+            delete conn;
+            return false;
+        }
 
-    if (mMysql)
-    {
-        sLog.outDetail("Connected to MySQL database at %s", host.c_str());
-        sLog.outDebug("MySQL client library: %s", mysql_get_client_info());
-        sLog.outDebug("MySQL server ver: %s ", mysql_get_server_info( mMysql));
-
-        if (!mysql_autocommit(mMysql, 1))
-            sLog.outDebug("AUTOCOMMIT SUCCESSFULLY SET TO 1");
-        else
-            sLog.outDebug("AUTOCOMMIT NOT SET TO 1");
-
-        // set connection properties to UTF8 to properly handle locales for different
-        // server configs - core sends data in UTF8, so MySQL must expect UTF8 too
-        // mysql_set_character_set is just like SET NAMES, but also sets encoding in client library
-        // which enforces mysql_real_escape_string to be safe
-        mysql_set_character_set(mMysql, "utf8");
-        Execute("SET CHARACTER SET `utf8`");
-
-        #if MYSQL_VERSION_ID >= 50003
-        my_bool my_true = (my_bool)1;
-        if (mysql_options(mMysql, MYSQL_OPT_RECONNECT, &my_true))
-            sLog.outDebug("Failed to turn on MYSQL_OPT_RECONNECT.");
-        else
-            sLog.outDebug("Successfully turned on MYSQL_OPT_RECONNECT.");
-        #else
-#warning "Your mySQL client lib version does not support reconnecting after a timeout.\nIf this causes you any trouble we advice you to upgrade your mySQL client libs to at least mySQL 5.0.13 to resolve this problem."
-        #endif
-        
-        m_connected = true;
-        return true;
+        m_connections.push_back(conn);
     }
-    else
-    {
-        sLog.outError("Could not connect to MySQL database at %s: %s", host.c_str(), mysql_error(mysqlInit));
-        mysql_close(mysqlInit);
+
+    if (!_InitDelayThreads(info, std::max<uint32>(asyncThreads, 1)))
         return false;
-    }
+
+    m_connected = true;
+    return true;
 }
 
 void Database::ThreadStart()
@@ -211,10 +138,10 @@ void Database::escape_string(std::string& str)
 
 unsigned long Database::escape_string(char* to, const char* from, unsigned long length)
 {
-    if (!mMysql || !to || !from || !length)
+    if (m_connections.empty())
         return 0;
 
-    return (mysql_real_escape_string(mMysql, to, from, length));
+    return m_connections.front()->EscapeString(to, from, length);
 }
 
 
@@ -247,7 +174,7 @@ bool Database::PreparedExecuteLog(const char* sql, const char* format, ...)
 
         va_list ap;
         va_start(ap, format);
-        _ConvertValistToPreparedValues(ap, values, format);
+        SqlConnection::ConvertValistToPreparedValues(ap, values, format);
         va_end(ap);
 
         return PreparedExecuteLog(sql, values);
@@ -334,67 +261,40 @@ void Database::SetResultQueue(SqlResultQueue* queue)
     m_queryQueues[ACE_Based::Thread::current()] = queue;
 }
 
-bool Database::_Query(const char* sql, MYSQL_RES** pResult, MYSQL_FIELD** pFields, uint64* pRowCount, uint32* pFieldCount)
+SqlConnection* Database::_AcquireConnection()
 {
-    if (!mMysql)
-        return 0;
+    size_t count = m_connections.size();
+    size_t start = size_t(m_nextConnection++) % count;
 
+    // take the first idle connection, only block if all of them are busy
+    for (size_t i = 0; i < count; ++i)
     {
-        // guarded block for thread-safe mySQL request
-        ACE_Guard<ACE_Thread_Mutex> query_connection_guard(mMutex);
-        #ifdef OREGON_DEBUG
-        uint32 _s = getMSTime();
-        #endif
-        if (mysql_query(mMysql, sql))
-        {
-            sLog.outErrorDb("SQL: %s", sql);
-            sLog.outErrorDb("query ERROR: %s", mysql_error(mMysql));
-            return false;
-        }
-        else
-        {
-            #ifdef OREGON_DEBUG
-            // prevent recursive death
-            unsigned long oldMask = sLog.GetDBLogMask();
-            sLog.SetDBLogMask(oldMask & ~(1 << LOG_TYPE_DEBUG));
-            sLog.outDebug("[%u ms] SQL: %s", getMSTimeDiff(_s, getMSTime()), sql);
-            sLog.SetDBLogMask(oldMask);
-            #endif
-        }
-
-        *pResult = mysql_store_result(mMysql);
-        *pRowCount = mysql_affected_rows(mMysql);
-        *pFieldCount = mysql_field_count(mMysql);
+        SqlConnection* conn = m_connections[(start + i) % count];
+        if (conn->TryAcquire())
+            return conn;
     }
 
-    if (!*pResult )
-        return false;
+    SqlConnection* conn = m_connections[start];
+    conn->Acquire();
+    return conn;
+}
 
-    if (!*pRowCount)
-    {
-        mysql_free_result(*pResult);
+bool Database::_Query(const char* sql, MYSQL_RES** pResult, MYSQL_FIELD** pFields, uint64* pRowCount, uint32* pFieldCount)
+{
+    if (m_connections.empty())
         return false;
-    }
 
-    *pFields = mysql_fetch_fields(*pResult);
-    return true;
+    ConnectionGuard conn(*this);
+    return conn->RawQuery(sql, pResult, pFields, pRowCount, pFieldCount);
 }
 
 QueryResult_AutoPtr Database::Query(const char* sql)
 {
-    MYSQL_RES* result = NULL;
-    MYSQL_FIELD* fields = NULL;
-    uint64 rowCount = 0;
-    uint32 fieldCount = 0;
-
-    if (!_Query(sql, &result, &fields, &rowCount, &fieldCount))
+    if (m_connections.empty())
         return QueryResult_AutoPtr(NULL);
 
-    QueryResult* queryResult = new QueryResult(result, fields, rowCount, fieldCount);
-
-    queryResult->NextRow();
-
-    return QueryResult_AutoPtr(queryResult);
+    ConnectionGuard conn(*this);
+    return conn->Query(sql);
 }
 
 QueryResult_AutoPtr Database::PQuery(const char* format, ...)
@@ -419,11 +319,11 @@ QueryResult_AutoPtr Database::PQuery(const char* format, ...)
 
 bool Database::Execute(const char* sql)
 {
-    if (!mMysql)
+    if (m_connections.empty())
         return false;
 
     // don't use queued execution if it has not been initialized
-    if (!m_threadBody)
+    if (m_asyncBodies.empty())
         return DirectExecute(sql);
 
     nMutex.acquire();
@@ -432,7 +332,7 @@ bool Database::Execute(const char* sql)
     if (i != m_tranQueues.end() && i->second != NULL)
         i->second->DelayExecute(sql);                       // Statement for transaction
     else
-        m_threadBody->Delay(new SqlStatement(sql));         // Simple sql statement
+        _DelayWrite(new SqlStatement(sql));                 // Simple sql statement
 
     nMutex.release();
     return true;
@@ -458,40 +358,13 @@ bool Database::PExecute(const char* format, ...)
     return Execute(szQuery);
 }
 
-bool Database::DirectExecute(bool lock, const char* sql)
+bool Database::DirectExecute(const char* sql)
 {
-    if (!mMysql)
+    if (m_connections.empty())
         return false;
 
-    if (lock)
-        mMutex.acquire();
-
-    #ifdef OREGON_DEBUG
-    uint32 _s = getMSTime();
-    #endif
-    if (mysql_query(mMysql, sql))
-    {
-        sLog.outErrorDb("SQL: %s", sql);
-        sLog.outErrorDb("SQL ERROR: %s", mysql_error(mMysql));
-        if (lock)
-            mMutex.release();
-        return false;
-    }
-    else
-    {
-        #ifdef OREGON_DEBUG
-        // prevent recursive death
-        unsigned long oldMask = sLog.GetDBLogMask();
-        sLog.SetDBLogMask(oldMask & ~(1 << LOG_TYPE_DEBUG));
-        sLog.outDebug("[%u ms] SQL: %s", getMSTimeDiff(_s, getMSTime()), sql);
-        sLog.SetDBLogMask(oldMask);
-        #endif
-    }
-
-    if (lock)
-        mMutex.release();
-
-    return true;
+    ConnectionGuard conn(*this);
+    return conn->Execute(sql);
 }
 
 bool Database::DirectPExecute(const char* format, ...)
@@ -514,25 +387,9 @@ bool Database::DirectPExecute(const char* format, ...)
     return DirectExecute(szQuery);
 }
 
-bool Database::_TransactionCmd(const char* sql)
-{
-    if (mysql_query(mMysql, sql))
-    {
-        sLog.outError("SQL: %s", sql);
-        sLog.outError("SQL ERROR: %s", mysql_error(mMysql));
-        return false;
-    }
-    #if OREGON_DEBUG
-    else
-        DEBUG_LOG("SQL: %s", sql);
-    #endif
-
-    return true;
-}
-
 bool Database::BeginTransaction()
 {
-    if (!mMysql)
+    if (m_connections.empty())
         return false;
 
     nMutex.acquire();
@@ -550,7 +407,7 @@ bool Database::BeginTransaction()
 
 bool Database::CommitTransaction()
 {
-    if (!mMysql)
+    if (m_connections.empty())
         return false;
 
     bool _res = false;
@@ -560,7 +417,7 @@ bool Database::CommitTransaction()
     TransactionQueues::iterator i = m_tranQueues.find(tranThread);
     if (i != m_tranQueues.end() && i->second != NULL)
     {
-        m_threadBody->Delay(i->second);
+        _DelayWrite(i->second);
         m_tranQueues.erase(i);
         _res = true;
     }
@@ -570,7 +427,7 @@ bool Database::CommitTransaction()
 
 bool Database::RollbackTransaction()
 {
-    if (!mMysql)
+    if (m_connections.empty())
         return false;
 
     nMutex.acquire();
@@ -586,422 +443,115 @@ bool Database::RollbackTransaction()
     return true;
 }
 
-/**
-  * @brief Atomically executed SqlTransaction.
-  * Don't call this directly, use \ref BeginTransaction and \ref CommitTransaction instead.
-  */
-bool Database::ExecuteTransaction(SqlTransaction* transaction)
+bool Database::_InitDelayThreads(SqlConnectionInfo const& info, uint32 count)
 {
-    SqlTransaction::QueuedItem item;
-
-    ACE_Guard<ACE_Thread_Mutex> connection_guard(mMutex);
-    ACE_Guard<ACE_Thread_Mutex> transaction_guard(transaction->mutex);
-
-    if (transaction->queue.empty())
-        return true;
-
-    if (mysql_autocommit(mMysql, 0))
-        return false;
+    ASSERT(m_asyncBodies.empty());
 
-    if (mysql_real_query(mMysql, "START TRANSACTION", sizeof("START TRANSACTION")-1))
-        return false;
-    
-    while (!transaction->queue.empty())
+    for (uint32 i = 0; i < count; ++i)
     {
-        item = transaction->queue.front();
-
-        bool ok = (item.isStmt) ? _ExecutePreparedStatement(item.stmt, item.values, NULL, false) : DirectExecute(false, item.sql);
-        if (!ok)
+        SqlConnection* conn = new SqlConnection();
+        if (!conn->Open(info))
         {
-            transaction->queue.pop();
-            mysql_rollback(mMysql);
-            mysql_autocommit(mMysql, 1);
+            delete conn;
             return false;
         }
 
-        if (!item.isStmt)
-            free (item.sql);
-        else
-            delete item.values;
-        transaction->queue.pop();
+        //New delay thread for delay execute
+        SqlDelayThread* body = new SqlDelayThread(conn);    // will deleted at thread delete
+        m_asyncBodies.push_back(body);
+        m_asyncThreads.push_back(new ACE_Based::Thread(body));
     }
 
-    if (mysql_commit(mMysql))
-        return false;
-
-    mysql_autocommit(mMysql, 1);
     return true;
 }
 
-void Database::InitDelayThread()
+bool Database::_DelayWrite(SqlOperation* op)
 {
-    assert(!m_delayThread);
+    SqlDelayThread* writer = m_asyncBodies.front();
 
-    //New delay thread for delay execute
-    m_threadBody = new SqlDelayThread(this);              // will deleted at m_delayThread delete
-    m_delayThread = new ACE_Based::Thread(m_threadBody);
-}
+    // a single worker runs everything in queue order already
+    if (m_asyncBodies.size() == 1)
+        return writer->Delay(op);
 
-void Database::HaltDelayThread()
-{
-    if (!m_threadBody || !m_delayThread)
-        return;
+    if (!writer->Delay(new SqlOrderedWrite(op, *this, m_queuedWrites + 1)))
+        return false;
 
-    m_threadBody->Stop();                                   //Stop event
-    m_delayThread->wait();                                  //Wait for flush to DB
-    delete m_delayThread;                                   //This also deletes m_threadBody
-    m_delayThread = NULL;
-    m_threadBody = NULL;
+    ++m_queuedWrites;
+    return true;
 }
 
-bool Database::ExecuteFile(const char* file)
+bool Database::_DelayRead(SqlOperation* op)
 {
-    if (!mMysql)
-        return false;
-
-    if (mysql_set_server_option(mMysql, MYSQL_OPTION_MULTI_STATEMENTS_ON))
-    {
-        sLog.outErrorDb("Cannot turn multi-statements on: %s", mysql_error(mMysql));
-        return false;
-    }
-
-    mysql_autocommit(mMysql, 0);
-    if (mysql_real_query(mMysql, "START TRANSACTION", sizeof("START TRANSACTION")-1))
-    {
-        sLog.outErrorDb("Couldn't start transaction for db update file: %s", file);
-        return false;
-    }
-
-    bool in_transaction = true;
-    bool success = false;
-
-    if (FILE* fp = ACE_OS::fopen(file, "rb"))
-    {
-        #if PLATFORM == PLATFORM_UNIX
-        flock(fileno(fp), LOCK_SH);
-        #endif
-        //------
-        
-        struct stat info;
-        fstat(fileno(fp), &info);
-
-        // if less than 1MB allocate on stack, else on heap
-        char* contents = (info.st_size > 1024*1024) ? new char[info.st_size] : (char*) alloca(info.st_size);
-
-        if (ACE_OS::fread(contents, info.st_size, 1, fp) == 1)
-        {
-            if (mysql_real_query(mMysql, contents, info.st_size))
-            {
-                sLog.outErrorDb("Cannot execute file %s, size: %lu: %s", file, info.st_size, mysql_error(mMysql));
-            }
-            else
-            {
-                do
-                {
-                    if (mysql_field_count(mMysql))
-                        if (MYSQL_RES* result = mysql_use_result(mMysql))
-                            mysql_free_result(result);
-                }
-                while (0 == mysql_next_result(mMysql));
-
-                // check whether the last mysql_next_result ended with an error
-                if (*mysql_error(mMysql))
-                {
-                    success = false;
-                    sLog.outErrorDb("Cannot execute file %s, size: %lu: %s", file, info.st_size, mysql_error(mMysql));
-                    if (mysql_rollback(mMysql))
-                        sLog.outErrorDb("ExecuteFile(): Rollback ended with an error!");
-                    else
-                        in_transaction = false;
-                }
-                else
-                {
-                    if (mysql_commit(mMysql))
-                        sLog.outErrorDb("mysql_commit() failed. Update %s will not be applied!", file);
-                    else
-                        in_transaction = false;
-                success = true;
-            }
-        }
-        }
-        else
-        {
-           sLog.outErrorDb("Couldn't read file %s, size: %lu", file, info.st_size);
-           return false;
-        }
-
-        // if allocated on heap, free memory
-        if (info.st_size > 1024*1024)
-            delete [] contents;
+    if (m_asyncBodies.size() == 1)
+        return m_asyncBodies.front()->Delay(op);
 
-        //------
-        #if PLATFORM == PLATFORM_UNIX
-        flock(fileno(fp), LOCK_UN);
-        #endif
-        ACE_OS::fclose(fp);
-    }
+    nMutex.acquire();
+    uint64 after = m_queuedWrites;
+    nMutex.release();
 
-    mysql_set_server_option(mMysql, MYSQL_OPTION_MULTI_STATEMENTS_OFF);
-    mysql_autocommit(mMysql, 1);
-    if (in_transaction)
-        mysql_rollback(mMysql);
-    return success;
+    // multiplicative hash, spreads sequential ids over the read workers
+    uint32 readers = uint32(m_asyncBodies.size()) - 1;
+    SqlDelayThread* reader = m_asyncBodies[1 + (_GetThreadKey() * 2654435761U) % readers];
+    return reader->Delay(new SqlOrderedRead(op, *this, after));
 }
 
-PreparedStatement* Database::_GetOrMakePreparedStatement(const char* query, const char* format, PreparedValues* values)
+void Database::_WaitForWrite(uint64 seq)
 {
-    ACE_Guard<ACE_Thread_Mutex> guardian(pMutex);
-    PreparedStatementsMap::iterator it = m_preparedStatements.find(query);
-
-    if (it != m_preparedStatements.end())
-        return it->second; // found, ok
- 
-    MYSQL_STMT* stmt = mysql_stmt_init(mMysql);
-
-    if (!stmt)
-    {
-        sLog.outError("mysql_stmt_init() failed: %s", mysql_error(mMysql));
-        return 0;
-    }
-
-    {
-        // set prefetch rows to maximum, thus making results buffered
-        unsigned long rows = (unsigned long) -1;
-        if (mysql_stmt_attr_set(stmt, STMT_ATTR_PREFETCH_ROWS, &rows))
-            sLog.outError("mysql_stmt_attr_set() failed.");
+    ACE_Guard<ACE_Thread_Mutex> guard(m_doneLock);
+    while (m_doneWrites < seq)
+        m_doneCond.wait();
+}
 
-        if (mysql_stmt_attr_set(stmt, STMT_ATTR_UPDATE_MAX_LENGTH, &my_true))
-            sLog.outError("mysql_stmt_attr_set() failed.");
-    }
+void Database::_WriteDone(uint64 seq)
+{
+    ACE_Guard<ACE_Thread_Mutex> guard(m_doneLock);
+    m_doneWrites = seq;
+    m_doneCond.broadcast();
+}
 
-    PreparedStatement* prepStmt = new PreparedStatement;
-    prepStmt->stmt = stmt;
-    
-    if (format)
-    {
-        prepStmt->types = format;
-        
-        for (const char* it = format; *it != '\0'; ++it)
-        {
-            switch (*it)
-            {
-                case ARG_TYPE_STRING:
-                case ARG_TYPE_STRING_ALT:
-                case ARG_TYPE_NUMBER:
-                case ARG_TYPE_NUMBER_ALT:
-                case ARG_TYPE_UNSIGNED_NUMBER:
-                case ARG_TYPE_LARGE_NUMBER:
-                case ARG_TYPE_LARGE_NUMBER_ALT:
-                case ARG_TYPE_LARGE_UNSIGNED_NUMBER:
-                case ARG_TYPE_FLOAT:
-                case ARG_TYPE_DOUBLE:
-                case ARG_TYPE_BINARY:
-                case ARG_TYPE_BINARY_ALT:
-                    break;
-                default:
-                    sLog.outError("Unknown format type '%c' for prepared statement (%s)", *it, query);
-                    delete prepStmt;
-                    return 0;
-            }
-        }
-    }
-    else if (values)
-    {
-        for (size_t i = 0; i < values->m_values.size(); ++i)
-            prepStmt->types.append(1, static_cast<char>(values->m_values[i].type));
-    }
+void Database::HaltDelayThread()
+{
+    // flush every worker before waiting, so they empty their queues in parallel
+    for (std::vector<SqlDelayThread*>::iterator itr = m_asyncBodies.begin(); itr != m_asyncBodies.end(); ++itr)
+        (*itr)->Stop();                                     //Stop event
 
+    for (std::vector<ACE_Based::Thread*>::iterator itr = m_asyncThreads.begin(); itr != m_asyncThreads.end(); ++itr)
     {
-        if (mysql_stmt_prepare(stmt, query, strlen(query)))
-        {
-            sLog.outErrorDb("mysql_stmt_prepare() failed: %s, sql: %s", mysql_stmt_error(stmt), query);
-            delete prepStmt;
-            return 0;
-        }
+        (*itr)->wait();                                     //Wait for flush to DB
+        delete *itr;                                        //This also deletes the thread body
     }
 
-    return m_preparedStatements.insert(std::pair<std::string, PreparedStatement*>(query, prepStmt)).first->second;
+    m_asyncThreads.clear();
+    m_asyncBodies.clear();
 }
 
-bool Database::_ExecutePreparedStatement(PreparedStatement* ps, PreparedValues* values, va_list* args, bool resultset)
+void Database::GetConnectionStats(std::vector<SqlConnectionStats>& stats)
 {
-    size_t paramCount = mysql_stmt_param_count(ps->stmt);
-    MYSQL_BIND* binding = NULL;
-    bool myValues = false;
-
-    if (paramCount)
-    {
-        if (args)
-        {
-            if (paramCount != ps->types.size())
-            {
-                sLog.outErrorDb("Count of parameters passed doesn't equal to count of parameters in prepared statement!");
-                delete[] binding;
-                return false;
-            }
-
-            if (!values)
-            {
-                values = new PreparedValues(paramCount);
-                myValues = true;
-            }
-
-            _ConvertValistToPreparedValues(*args, *values, ps->types.c_str());
-        }
-        else
-        {
-            ASSERT (values);
-
-            if (paramCount != values->m_values.size())
-            {
-                sLog.outErrorDb("Count of parameters passed doesn't equal to count of parameters in prepared statement!");
-                delete[] binding;
-                return false;
-            }
-        }
-
-        binding = new MYSQL_BIND[paramCount];
-        memset(binding, 0, sizeof(MYSQL_BIND)*paramCount);
+    SqlConnectionStats s;
 
-        for (size_t i = 0; i < paramCount; ++i)
-        {
-            switch ((*values)[i].type)
-            {
-                case ARG_TYPE_STRING:
-                case ARG_TYPE_STRING_ALT:
-                    binding[i].buffer_type = MYSQL_TYPE_STRING;
-                    binding[i].buffer = const_cast<char*> ((*values)[i].data.string);
-                    binding[i].buffer_length = (*values)[i].data.length;
-                    break;
-                case ARG_TYPE_BINARY:
-                case ARG_TYPE_BINARY_ALT:
-                    binding[i].buffer_type = MYSQL_TYPE_BLOB;
-                    binding[i].buffer = const_cast<void*> ((*values)[i].data.binary);
-                    binding[i].buffer_length = (*values)[i].data.length;
-                    break;
-                case ARG_TYPE_UNSIGNED_NUMBER:
-                    binding[i].is_unsigned = my_true; 
-                    /* FALLTHROUGH */
-                case ARG_TYPE_NUMBER:
-                case ARG_TYPE_NUMBER_ALT:
-                    binding[i].buffer_type = MYSQL_TYPE_LONG;
-                    binding[i].buffer = &(*values)[i].data.number;
-                    binding[i].buffer_length = sizeof((*values)[i].data.number);
-                    break;
-                case ARG_TYPE_LARGE_UNSIGNED_NUMBER:
-                    binding[i].is_unsigned = my_true; 
-                    /* FALLTHROUGH */
-                case ARG_TYPE_LARGE_NUMBER:
-                case ARG_TYPE_LARGE_NUMBER_ALT:
-                    binding[i].buffer_type = MYSQL_TYPE_LONGLONG;
-                    binding[i].buffer = &(*values)[i].data.largeNumber;
-                    binding[i].buffer_length = sizeof(&(*values)[i].data.largeNumber);
-                    break;
-                case ARG_TYPE_FLOAT:
-                    binding[i].buffer_type = MYSQL_TYPE_FLOAT;
-                    binding[i].buffer = &(*values)[i].data.float_;
-                    binding[i].buffer_length = sizeof(&(*values)[i].data.float_);
-                    break;
-                case ARG_TYPE_DOUBLE:
-                    binding[i].buffer_type = MYSQL_TYPE_DOUBLE;
-                    binding[i].buffer = &(*values)[i].data.double_;
-                    binding[i].buffer_length = sizeof((*values)[i].data.double_);
-                    break;
-            }
-        }
-
-        if (mysql_stmt_bind_param(ps->stmt, binding))
-        {
-            sLog.outError("mysql_stmt_bind_param() failed: %s", mysql_stmt_error(ps->stmt));
-            delete[] binding;
-            if (myValues)
-                delete values;
-            return false;
-        }
-    }
-
-    if (mysql_stmt_execute(ps->stmt))
+    for (std::vector<SqlConnection*>::const_iterator itr = m_connections.begin(); itr != m_connections.end(); ++itr)
     {
-        sLog.outError("mysql_stmt_execute() failed: %s", mysql_stmt_error(ps->stmt));
-        delete[] binding;
-        if (myValues)
-            delete values;
-        return false;
+        (*itr)->GetStats(s);
+        s.async = false;
+        stats.push_back(s);
     }
 
-    if (myValues)
-        delete values;
-
-    // this is safe, even if there's no result
-    mysql_stmt_store_result(ps->stmt);
-
-    if (resultset)
+    for (std::vector<SqlDelayThread*>::const_iterator itr = m_asyncBodies.begin(); itr != m_asyncBodies.end(); ++itr)
     {
-        if (!mysql_stmt_field_count(ps->stmt))
-        {
-            delete[] binding;
-            return false;
-        }
-
-        if (!mysql_stmt_num_rows(ps->stmt))
-        {
-            mysql_stmt_free_result(ps->stmt);
-            delete[] binding;
-            return false;
-        }
+        (*itr)->GetConnection()->GetStats(s);
+        s.async = true;
+        s.queued += (*itr)->GetQueueSize();
+        stats.push_back(s);
     }
-    else
-    {
-        if (mysql_stmt_field_count(ps->stmt))
-            mysql_stmt_free_result(ps->stmt);
-        mysql_stmt_reset(ps->stmt);
-    }
-
-    delete[] binding;
-    return true;
 }
 
-void Database::_ConvertValistToPreparedValues(va_list args, PreparedValues& values, const char* fmt)
+bool Database::ExecuteFile(const char* file)
 {
-    for (const char* i = fmt; *i != '\0'; ++i)
-    {
-        switch (*i)
-        {
-            case ARG_TYPE_STRING:
-            case ARG_TYPE_STRING_ALT:
-                values << va_arg(args, const char*);
-                break;
-            case ARG_TYPE_BINARY:
-            case ARG_TYPE_BINARY_ALT:
-                {
-                    size_t size = va_arg(args, size_t);
-                    const void* data = va_arg(args, const void*);
-                    values << std::pair<const void*, size_t>(data, size);
-                }
-                break;
-            case ARG_TYPE_UNSIGNED_NUMBER:
-                values << va_arg(args, uint32);
-                break;
-            case ARG_TYPE_NUMBER:
-            case ARG_TYPE_NUMBER_ALT:
-                values << va_arg(args, int32);
-                break;
-            case ARG_TYPE_LARGE_UNSIGNED_NUMBER:
-                values << va_arg(args, uint64);
-                break;
-            case ARG_TYPE_LARGE_NUMBER:
-            case ARG_TYPE_LARGE_NUMBER_ALT:
-                values << va_arg(args, int64);
-                break;
-            case ARG_TYPE_FLOAT:
-                // passed floats are promoted to doubles
-                values << (float) va_arg(args, double);
-                break;
-            case ARG_TYPE_DOUBLE:
-                values << va_arg(args, double);
-                break;
-        }
-    }
+    if (m_connections.empty())
+        return false;
+
+    ConnectionGuard conn(*this);
+    return conn->ExecuteFile(file);
 }
 
 /**
@@ -1023,102 +573,72 @@ void Database::_ConvertValistToPreparedValues(va_list args, PreparedValues& valu
   */
 PreparedQueryResult_AutoPtr Database::PreparedQuery(const char* sql, const char* format, ...)
 {
-    ACE_Guard<ACE_Thread_Mutex> guardian(mMutex);
-    PreparedStatement* stmt = _GetOrMakePreparedStatement(sql, format, NULL);
-
-    if (!stmt)
+    if (m_connections.empty())
         return PreparedQueryResult_AutoPtr(NULL);
 
+    ConnectionGuard conn(*this);
+
     va_list ap;
     va_start(ap, format);
-
-    if (!_ExecutePreparedStatement(stmt, NULL, &ap, true))
-    {
-        va_end(ap);
-        return PreparedQueryResult_AutoPtr(NULL);
-    }
-    
+    PreparedQueryResult_AutoPtr result = conn->PreparedQuery(sql, format, NULL, &ap);
     va_end(ap);
 
-    return PreparedQueryResult_AutoPtr(new PreparedQueryResult(stmt->stmt));
+    return result;
 }
 
 PreparedQueryResult_AutoPtr Database::PreparedQuery(const char* sql, PreparedValues& values)
 {
-    ACE_Guard<ACE_Thread_Mutex> guardian(mMutex);
-    PreparedStatement* stmt = _GetOrMakePreparedStatement(sql, NULL, &values);
-
-    if (!stmt)
-        return PreparedQueryResult_AutoPtr(NULL);
-
-    if (!_ExecutePreparedStatement(stmt, &values, NULL, true))
+    if (m_connections.empty())
         return PreparedQueryResult_AutoPtr(NULL);
 
-    return PreparedQueryResult_AutoPtr(new PreparedQueryResult(stmt->stmt));
+    ConnectionGuard conn(*this);
+    return conn->PreparedQuery(sql, NULL, &values, NULL);
 }
 
-bool Database::DirectExecute(PreparedStatement* stmt, PreparedValues& values, va_list* args)
-{
-    ACE_Guard<ACE_Thread_Mutex> guardian(mMutex);
-
-    return _ExecutePreparedStatement(stmt, &values, args, false);
-}
-
-
 /**
   * @brief Executes Query via Prepared Statements.
   */
 bool Database::PreparedExecute(const char* sql, const char* format, ...)
 {
-    if (!mMysql)
+    if (m_connections.empty())
         return false;
 
-    PreparedValues values(strlen(format));
-
-    va_list args;
-    va_start(args, format);
-    _ConvertValistToPreparedValues(args, values, format);
-    va_end(args);
-    
-    PreparedStatement* stmt = _GetOrMakePreparedStatement(sql, NULL, &values);
+    PreparedValues values(format ? strlen(format) : 0);
 
-    // don't use queued execution if it has not been initialized
-    if (!m_threadBody)
-        return DirectExecute(stmt, values, NULL);
-
-    nMutex.acquire();
-    tranThread = ACE_Based::Thread::current();              // owner of this transaction
-    TransactionQueues::iterator i = m_tranQueues.find(tranThread);
-    if (i != m_tranQueues.end() && i->second != NULL)
-        i->second->DelayExecute(stmt, values);                        // Statement for transaction
-    else
-        m_threadBody->Delay(new SqlPreparedStatement(stmt, values));         // Simple sql statement
+    if (format)
+    {
+        va_list args;
+        va_start(args, format);
+        SqlConnection::ConvertValistToPreparedValues(args, values, format);
+        va_end(args);
+    }
 
-    nMutex.release();
-    return true;
+    return PreparedExecute(sql, values);
 }
 
 /**
   * @brief Executes Query via Prepared Statements.
+  * The statement is prepared on the connection that runs it.
   */
 bool Database::PreparedExecute(const char* sql, PreparedValues& values)
 {
-    if (!mMysql)
+    if (m_connections.empty())
         return false;
 
-    PreparedStatement* stmt = _GetOrMakePreparedStatement(sql, NULL, &values);
-
     // don't use queued execution if it has not been initialized
-    if (!m_threadBody)
-        return DirectExecute(stmt, values, NULL);
+    if (m_asyncBodies.empty())
+    {
+        ConnectionGuard conn(*this);
+        return conn->PreparedExecute(sql, NULL, &values, NULL);
+    }
 
     nMutex.acquire();
     tranThread = ACE_Based::Thread::current();              // owner of this transaction
     TransactionQueues::iterator i = m_tranQueues.find(tranThread);
     if (i != m_tranQueues.end() && i->second != NULL)
-        i->second->DelayExecute(stmt, values);                        // Statement for transaction
+        i->second->DelayExecute(sql, values);               // Statement for transaction
     else
-        m_threadBody->Delay(new SqlPreparedStatement(stmt, values));  // Simple sql statement
+        _DelayWrite(new SqlPreparedStatement(sql, values)); // Simple sql statement
 
     nMutex.release();
     return true;
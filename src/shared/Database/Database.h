@@ -25,8 +25,10 @@
 #include "ace/Thread_Mutex.h"
 #include "ace/Guard_T.h"
 #include "ace/Atomic_Op.h"
+#include "ace/Condition_Thread_Mutex.h"
 #include "PreparedStatement.h"
 #include "QueryResult.h"
+#include "SqlConnection.h"
 
 #ifdef WIN32
 #define FD_SETSIZE 1024
@@ -37,6 +39,7 @@
 class SqlTransaction;
 class SqlResultQueue;
 class SqlQueryHolder;
+class SqlOperation;
 
 typedef UNORDERED_MAP<ACE_Based::Thread*, SqlTransaction*> TransactionQueues;
 typedef UNORDERED_MAP<ACE_Based::Thread*, SqlResultQueue*> QueryQueues;
@@ -48,8 +51,8 @@ class Database
     protected:
         TransactionQueues m_tranQueues;                            // Transaction queues from diff. threads
         QueryQueues m_queryQueues;                                 // Query queues from diff threads
-        SqlDelayThread* m_threadBody;                              // Pointer to delay sql executer (owned by m_delayThread)
-        ACE_Based::Thread* m_delayThread;                          // Pointer to executer thread
+        std::vector<SqlDelayThread*> m_asyncBodies;                // Delay sql executers (owned by m_asyncThreads)
+        std::vector<ACE_Based::Thread*> m_asyncThreads;            // Executer threads, one connection each
 
     public:
 
@@ -57,11 +60,12 @@ class Database
         ~Database();
 
         /// @param infoString should be formated like hostname;username;password;database.
-        bool Initialize(const char* infoString);
+        /// @param connections number of connections shared by synchronous queries
+        /// @param asyncThreads number of async workers, each with its own connection
+        bool Initialize(const char* infoString, uint32 connections = 1, uint32 asyncThreads = 1);
 
         bool IsConnected() const { return m_connected; }
 
-        void InitDelayThread();
         void HaltDelayThread();
 
         QueryResult_AutoPtr Query(const char* sql);
@@ -111,15 +115,26 @@ class Database
         template<class Class, typename ParamType1>
         bool DelayQueryHolder(Class* object, void (Class::*method)(QueryResult_AutoPtr, SqlQueryHolder*, ParamType1), SqlQueryHolder* holder, ParamType1 param1);
 
+        // Statements and transactions all run in the order they were queued on
+        // the first async worker, async queries run on the others once every
+        // write queued before them is done
         bool Execute(const char* sql);
         bool PExecute(const char* format, ...) ATTR_PRINTF(2, 3);
 
-        bool DirectExecute(const char* sql)
+        // Async queries queued by the current thread are spread over the read
+        // workers by the key of the innermost guard, e.g. the account of the
+        // session being handled, so the callbacks of one key keep their order
+        class KeyGuard
         {
-            return DirectExecute(true, sql);
-        }
+            public:
+                explicit KeyGuard(uint32 key);
+                ~KeyGuard();
+            private:
+                uint32 m_previousKey;
+        };
+
+        bool DirectExecute(const char* sql);
         bool DirectPExecute(const char* format, ...) ATTR_PRINTF(2, 3);
-        bool DirectExecute(PreparedStatement* stmt, PreparedValues& values, va_list* args);
 
         // Writes SQL commands to a LOG file (see Oregond.conf "LogSQL")
         bool PExecuteLog(const char* format, ...) ATTR_PRINTF(2, 3);
@@ -133,8 +148,6 @@ class Database
         bool CommitTransaction();
         bool RollbackTransaction();
 
-        bool ExecuteTransaction(SqlTransaction* transaction);
-
         PreparedQueryResult_AutoPtr PreparedQuery(const char* sql, const char* format = NULL, ...);
         PreparedQueryResult_AutoPtr PreparedQuery(const char* sql, PreparedValues& values);
         bool PreparedExecute(const char* sql, const char* format = NULL, ...);
@@ -142,7 +155,7 @@ class Database
 
         operator bool () const
         {
-            return mMysql != NULL;
+            return !m_connections.empty();
         }
         unsigned long escape_string(char* to, const char* from, unsigned long length);
         void escape_string(std::string& str);
@@ -153,30 +166,53 @@ class Database
         // sets the result queue of the current thread, be careful what thread you call this from
         void SetResultQueue(SqlResultQueue* queue);
 
+        // usage of the synchronous connections followed by the async workers' ones
+        void GetConnectionStats(std::vector<SqlConnectionStats>& stats);
+
     protected:
-        bool DirectExecute(bool lock, const char* sql);
+        // Queues a statement or transaction on the write worker, nMutex must be held
+        bool _DelayWrite(SqlOperation* op);
+        // Queues an async query on a read worker
+        bool _DelayRead(SqlOperation* op);
+        static uint32 _GetThreadKey();
     private:
+        friend class SqlOrderedWrite;
+        friend class SqlOrderedRead;
+
+        void _WaitForWrite(uint64 seq);
+        void _WriteDone(uint64 seq);
+
+        // Borrows a connection of the synchronous pool while in scope
+        class ConnectionGuard
+        {
+            public:
+                explicit ConnectionGuard(Database& db) : m_conn(db._AcquireConnection()) {}
+                ~ConnectionGuard() { m_conn->Release(); }
+
+                SqlConnection* operator->() const { return m_conn; }
+            private:
+                SqlConnection* m_conn;
+        };
+
         bool m_logSQL;
         std::string m_logsDir;
-        ACE_Thread_Mutex mMutex;        // For thread safe operations between core and mySQL server
         ACE_Thread_Mutex nMutex;        // For thread safe operations on m_transQueues
-        ACE_Thread_Mutex pMutex;        // For thread safe operations on m_preparedStatements
 
         ACE_Based::Thread* tranThread;
 
-        MYSQL* mMysql;
+        uint64 m_queuedWrites;          // Writes given to the write worker, under nMutex
+        uint64 m_doneWrites;            // Writes it has run, under m_doneLock
+        ACE_Thread_Mutex m_doneLock;
+        ACE_Condition_Thread_Mutex m_doneCond;
+
+        std::vector<SqlConnection*> m_connections;
+        ACE_Atomic_Op<ACE_Thread_Mutex, long> m_nextConnection;
         bool m_connected;
 
         static size_t db_count;
 
-        bool _TransactionCmd(const char* sql);
-
-        PreparedStatement* _GetOrMakePreparedStatement(const char* query, const char* format, PreparedValues* values);
-        bool _ExecutePreparedStatement(PreparedStatement* ps, PreparedValues* values, va_list* args, bool resultset);
-        void _ConvertValistToPreparedValues(va_list ap, PreparedValues& values, const char* fmt);
-
-        typedef UNORDERED_MAP<std::string, PreparedStatement*> PreparedStatementsMap;
-        PreparedStatementsMap m_preparedStatements;
+        bool _InitDelayThreads(SqlConnectionInfo const& info, uint32 count);
+        SqlConnection* _AcquireConnection();
 };
 #endif
 
@@ -68,7 +68,7 @@ bool
 Database::AsyncQuery(Class* object, void (Class::*method)(QueryResult_AutoPtr), const char* sql)
 {
     ASYNC_QUERY_BODY(sql, itr)
-    return m_threadBody->Delay(new SqlQuery(sql, new Oregon::QueryCallback<Class>(object, method), itr->second));
+    return _DelayRead(new SqlQuery(sql, new Oregon::QueryCallback<Class>(object, method), itr->second));
 }
 
 template<class Class, typename ParamType1>
@@ -76,7 +76,7 @@ bool
 Database::AsyncQuery(Class* object, void (Class::*method)(QueryResult_AutoPtr, ParamType1), ParamType1 param1, const char* sql)
 {
     ASYNC_QUERY_BODY(sql, itr)
-    return m_threadBody->Delay(new SqlQuery(sql, new Oregon::QueryCallback<Class, ParamType1>(object, method, QueryResult_AutoPtr(NULL), param1), itr->second));
+    return _DelayRead(new SqlQuery(sql, new Oregon::QueryCallback<Class, ParamType1>(object, method, QueryResult_AutoPtr(NULL), param1), itr->second));
 }
 
 template<class Class, typename ParamType1, typename ParamType2>
@@ -84,7 +84,7 @@ bool
 Database::AsyncQuery(Class* object, void (Class::*method)(QueryResult_AutoPtr, ParamType1, ParamType2), ParamType1 param1, ParamType2 param2, const char* sql)
 {
     ASYNC_QUERY_BODY(sql, itr)
-    return m_threadBody->Delay(new SqlQuery(sql, new Oregon::QueryCallback<Class, ParamType1, ParamType2>(object, method, QueryResult_AutoPtr(NULL), param1, param2), itr->second));
+    return _DelayRead(new SqlQuery(sql, new Oregon::QueryCallback<Class, ParamType1, ParamType2>(object, method, QueryResult_AutoPtr(NULL), param1, param2), itr->second));
 }
 
 template<class Class, typename ParamType1, typename ParamType2, typename ParamType3>
@@ -92,7 +92,7 @@ bool
 Database::AsyncQuery(Class* object, void (Class::*method)(QueryResult_AutoPtr, ParamType1, ParamType2, ParamType3), ParamType1 param1, ParamType2 param2, ParamType3 param3, const char* sql)
 {
     ASYNC_QUERY_BODY(sql, itr)
-    return m_threadBody->Delay(new SqlQuery(sql, new Oregon::QueryCallback<Class, ParamType1, ParamType2, ParamType3>(object, method, QueryResult_AutoPtr(NULL), param1, param2, param3), itr->second));
+    return _DelayRead(new SqlQuery(sql, new Oregon::QueryCallback<Class, ParamType1, ParamType2, ParamType3>(object, method, QueryResult_AutoPtr(NULL), param1, param2, param3), itr->second));
 }
 
 // Query / static
@@ -102,7 +102,7 @@ bool
 Database::AsyncQuery(void (*method)(QueryResult_AutoPtr, ParamType1), ParamType1 param1, const char* sql)
 {
     ASYNC_QUERY_BODY(sql, itr)
-    return m_threadBody->Delay(new SqlQuery(sql, new Oregon::SQueryCallback<ParamType1>(method, QueryResult_AutoPtr(NULL), param1), itr->second));
+    return _DelayRead(new SqlQuery(sql, new Oregon::SQueryCallback<ParamType1>(method, QueryResult_AutoPtr(NULL), param1), itr->second));
 }
 
 template<typename ParamType1, typename ParamType2>
@@ -110,7 +110,7 @@ bool
 Database::AsyncQuery(void (*method)(QueryResult_AutoPtr, ParamType1, ParamType2), ParamType1 param1, ParamType2 param2, const char* sql)
 {
     ASYNC_QUERY_BODY(sql, itr)
-    return m_threadBody->Delay(new SqlQuery(sql, new Oregon::SQueryCallback<ParamType1, ParamType2>(method, QueryResult_AutoPtr(NULL), param1, param2), itr->second));
+    return _DelayRead(new SqlQuery(sql, new Oregon::SQueryCallback<ParamType1, ParamType2>(method, QueryResult_AutoPtr(NULL), param1, param2), itr->second));
 }
 
 template<typename ParamType1, typename ParamType2, typename ParamType3>
@@ -118,7 +118,7 @@ bool
 Database::AsyncQuery(void (*method)(QueryResult_AutoPtr, ParamType1, ParamType2, ParamType3), ParamType1 param1, ParamType2 param2, ParamType3 param3, const char* sql)
 {
     ASYNC_QUERY_BODY(sql, itr)
-    return m_threadBody->Delay(new SqlQuery(sql, new Oregon::SQueryCallback<ParamType1, ParamType2, ParamType3>(method, QueryResult_AutoPtr(NULL), param1, param2, param3), itr->second));
+    return _DelayRead(new SqlQuery(sql, new Oregon::SQueryCallback<ParamType1, ParamType2, ParamType3>(method, QueryResult_AutoPtr(NULL), param1, param2, param3), itr->second));
 }
 
 // PQuery / member
@@ -188,7 +188,7 @@ bool
 Database::DelayQueryHolder(Class* object, void (Class::*method)(QueryResult_AutoPtr, SqlQueryHolder*), SqlQueryHolder* holder)
 {
     ASYNC_DELAYHOLDER_BODY(holder, itr)
-    return holder->Execute(new Oregon::QueryCallback<Class, SqlQueryHolder*>(object, method, QueryResult_AutoPtr(NULL), holder), m_threadBody, itr->second);
+    return _DelayRead(new SqlQueryHolderEx(holder, new Oregon::QueryCallback<Class, SqlQueryHolder*>(object, method, QueryResult_AutoPtr(NULL), holder), itr->second));
 }
 
 template<class Class, typename ParamType1>
@@ -196,7 +196,7 @@ bool
 Database::DelayQueryHolder(Class* object, void (Class::*method)(QueryResult_AutoPtr, SqlQueryHolder*, ParamType1), SqlQueryHolder* holder, ParamType1 param1)
 {
     ASYNC_DELAYHOLDER_BODY(holder, itr)
-    return holder->Execute(new Oregon::QueryCallback<Class, SqlQueryHolder*, ParamType1>(object, method, QueryResult_AutoPtr(NULL), holder, param1), m_threadBody, itr->second);
+    return _DelayRead(new SqlQueryHolderEx(holder, new Oregon::QueryCallback<Class, SqlQueryHolder*, ParamType1>(object, method, QueryResult_AutoPtr(NULL), holder, param1), itr->second));
 }
 
 #undef ASYNC_QUERY_BODY
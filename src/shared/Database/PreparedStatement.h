@@ -71,6 +71,7 @@ class PreparedValues
 {
     protected:
         friend class Database;
+        friend class SqlConnection;
         struct Value
         {
             PreparedArgType type;
@@ -140,6 +141,34 @@ class PreparedValues
             return m_values.size();
         }
 
+        // bytes of bound data, as sent to the server
+        size_t GetDataSize() const
+        {
+            size_t bytes = 0;
+            for (size_t i = 0; i < m_values.size(); ++i)
+            {
+                switch (m_values[i].type)
+                {
+                    case ARG_TYPE_STRING:
+                    case ARG_TYPE_STRING_ALT:
+                    case ARG_TYPE_BINARY:
+                    case ARG_TYPE_BINARY_ALT:
+                        bytes += m_values[i].data.length;
+                        break;
+                    case ARG_TYPE_LARGE_NUMBER:
+                    case ARG_TYPE_LARGE_NUMBER_ALT:
+                    case ARG_TYPE_LARGE_UNSIGNED_NUMBER:
+                    case ARG_TYPE_DOUBLE:
+                        bytes += 8;
+                        break;
+                    default:
+                        bytes += 4;
+                        break;
+                }
+            }
+            return bytes;
+        }
+
         Value& operator[] (size_t index)
         {
             return m_values[index];
@@ -0,0 +1,74 @@
+/*
+ * This file is part of the OregonCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "SqlBatchInsert.h"
+#include "Database.h"
+
+SqlBatchInsert::SqlBatchInsert(Database& db, const char* head, uint32 columns, uint32 maxRows, const char* tail)
+    : m_db(db), m_head(head), m_tail(tail), m_columns(columns), m_maxRows(maxRows), m_rows(0)
+{
+    ASSERT(columns && maxRows);
+}
+
+void SqlBatchInsert::Execute(SqlWriteStats* stats)
+{
+    for (size_t i = 0; i < m_chunks.size(); ++i)
+    {
+        PreparedValues& values = m_chunks[i];
+        uint32 rows = values.size() / m_columns;
+        if (!rows)
+            continue;
+
+        std::string sql = BuildStatement(rows);
+        m_db.PreparedExecute(sql.c_str(), values);
+
+        if (stats)
+        {
+            stats->rows += rows;
+            stats->bytes += sql.size() + values.GetDataSize();
+        }
+    }
+
+    m_chunks.clear();
+    m_data.clear();
+    m_rows = 0;
+}
+
+void SqlBatchInsert::GetStatements(std::vector<std::pair<std::string, uint32> >& statements) const
+{
+    for (size_t i = 0; i < m_chunks.size(); ++i)
+        if (uint32 rows = m_chunks[i].size() / m_columns)
+            statements.push_back(std::make_pair(BuildStatement(rows), rows));
+}
+
+std::string SqlBatchInsert::BuildStatement(uint32 rows) const
+{
+    std::string sql;
+    sql.reserve(m_head.size() + rows * (m_columns * 2 + 2) + m_tail.size());
+    sql = m_head;
+
+    for (uint32 row = 0; row < rows; ++row)
+    {
+        sql += row ? ",(" : "(";
+        for (uint32 col = 0; col < m_columns; ++col)
+            sql += col ? ",?" : "?";
+        sql += ')';
+    }
+    sql += m_tail;
+
+    return sql;
+}
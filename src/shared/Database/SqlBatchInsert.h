@@ -0,0 +1,97 @@
+/*
+ * This file is part of the OregonCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __SQLBATCHINSERT_H
+#define __SQLBATCHINSERT_H
+
+#include "Common.h"
+#include "PreparedStatement.h"
+
+#include <type_traits>
+
+class Database;
+
+#define SQL_BATCH_MAX_ROWS 16
+
+/// Rows and bytes a group of statements handed to the database
+struct SqlWriteStats
+{
+    SqlWriteStats() : rows(0), bytes(0) {}
+
+    uint32 rows;
+    uint32 bytes;
+};
+
+/**
+  * @brief Collects the rows of one multi-row INSERT (or REPLACE) and writes
+  * them through prepared statements of at most maxRows rows each. With a
+  * tail the rows can also form a list, e.g. for a DELETE ... IN (rows).
+  *
+  * Rows are split in full chunks plus one remainder, so a table never needs
+  * more than maxRows distinct statements per connection and they are reused
+  * by every later save. Only numeric columns may be bound: queued prepared
+  * statements keep pointers to string data, not copies.
+  *
+  * A copy of all bound values is kept, callers can compare it with the one
+  * of the previous write and skip the statements when nothing changed.
+  */
+class SqlBatchInsert
+{
+    public:
+        // head is the statement up to and including "VALUES ", tail follows the rows
+        SqlBatchInsert(Database& db, const char* head, uint32 columns, uint32 maxRows = SQL_BATCH_MAX_ROWS, const char* tail = "");
+
+        template<class T>
+        SqlBatchInsert& operator<<(T value)
+        {
+            // strings would be bound and compared by their pointers
+            static_assert(std::is_arithmetic<T>::value, "SqlBatchInsert only binds numeric columns");
+
+            if (m_chunks.empty() || m_chunks.back().size() == size_t(m_columns * m_maxRows))
+                m_chunks.push_back(PreparedValues(m_columns * m_maxRows));
+
+            m_chunks.back() << value;
+            m_data.append(reinterpret_cast<char const*>(&value), sizeof(T));
+            return *this;
+        }
+
+        void EndRow() { ++m_rows; }
+
+        uint32 GetRowCount() const { return m_rows; }
+        // raw bytes of all bound values, in order
+        std::string const& GetData() const { return m_data; }
+
+        // queue (or join the current transaction with) all collected rows
+        void Execute(SqlWriteStats* stats = NULL);
+
+        // statements Execute() would run and their row counts, in order
+        void GetStatements(std::vector<std::pair<std::string, uint32> >& statements) const;
+
+    private:
+        std::string BuildStatement(uint32 rows) const;
+
+        Database& m_db;
+        std::string m_head;
+        std::string m_tail;
+        uint32 m_columns;
+        uint32 m_maxRows;
+        uint32 m_rows;
+        std::string m_data;
+        std::vector<PreparedValues> m_chunks;
+};
+
+#endif
@@ -0,0 +1,712 @@
+/*
+ * This file is part of the OregonCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "DatabaseEnv.h"
+#include "Database/SqlConnection.h"
+#include "Database/SqlOperations.h"
+#include "Utilities/Util.h"
+#include "Platform/Define.h"
+#include "Timer.h"
+
+#if PLATFORM == PLATFORM_UNIX
+#include <sys/file.h>
+#endif
+
+static const my_bool my_true = 1;
+
+SqlConnectionInfo::SqlConnectionInfo(const char* infoString)
+{
+    Tokens tokens = StrSplit(infoString, ";");
+
+    Tokens::iterator iter = tokens.begin();
+
+    if (iter != tokens.end())
+        host = *iter++;
+    if (iter != tokens.end())
+        port_or_socket = *iter++;
+    if (iter != tokens.end())
+        user = *iter++;
+    if (iter != tokens.end())
+        password = *iter++;
+    if (iter != tokens.end())
+        database = *iter++;
+}
+
+SqlConnection::SqlConnection() : m_mysql(NULL), m_waiting(0), m_executed(0), m_totalTime(0), m_maxTime(0)
+{
+}
+
+SqlConnection::~SqlConnection()
+{
+    for (PreparedStatementsMap::iterator it = m_preparedStatements.begin(); it != m_preparedStatements.end(); ++it)
+    {
+        mysql_stmt_close(it->second->stmt);
+        delete it->second;
+    }
+
+    if (m_mysql)
+        mysql_close(m_mysql);
+}
+
+bool SqlConnection::Open(SqlConnectionInfo const& info)
+{
+    MYSQL* mysqlInit;
+    mysqlInit = mysql_init(NULL);
+    if (!mysqlInit)
+    {
+        sLog.outError("Could not initialize Mysql connection");
+        return false;
+    }
+
+    std::string host = info.host;
+    int port;
+    char const* unix_socket;
+
+    mysql_options(mysqlInit, MYSQL_SET_CHARSET_NAME, "utf8");
+    #ifdef _WIN32
+    if (host == ".")                                         // named pipe use option (Windows)
+    {
+        unsigned int opt = MYSQL_PROTOCOL_PIPE;
+        mysql_options(mysqlInit, MYSQL_OPT_PROTOCOL, (char const*)&opt);
+        port = 0;
+        unix_socket = 0;
+    }
+    else                                                    // generic case
+    {
+        port = atoi(info.port_or_socket.c_str());
+        unix_socket = 0;
+    }
+    #else
+    if (host == ".")                                         // socket use option (Unix/Linux)
+    {
+        unsigned int opt = MYSQL_PROTOCOL_SOCKET;
+        mysql_options(mysqlInit, MYSQL_OPT_PROTOCOL, (char const*)&opt);
+        host = "localhost";
+        port = 0;
+        unix_socket = info.port_or_socket.c_str();
+    }
+    else                                                    // generic case
+    {
+        port = atoi(info.port_or_socket.c_str());
+        unix_socket = 0;
+    }
+    #endif
+
+    m_mysql = mysql_real_connect(mysqlInit, host.c_str(), info.user.c_str(),
+                                 info.password.c_str(), info.database.c_str(), port, unix_socket, 0);
+
+    if (!m_mysql)
+    {
+        sLog.outError("Could not connect to MySQL database at %s: %s", host.c_str(), mysql_error(mysqlInit));
+        mysql_close(mysqlInit);
+        return false;
+    }
+
+    sLog.outDetail("Connected to MySQL database at %s", host.c_str());
+    sLog.outDebug("MySQL client library: %s", mysql_get_client_info());
+    sLog.outDebug("MySQL server ver: %s ", mysql_get_server_info(m_mysql));
+
+    if (!mysql_autocommit(m_mysql, 1))
+        sLog.outDebug("AUTOCOMMIT SUCCESSFULLY SET TO 1");
+    else
+        sLog.outDebug("AUTOCOMMIT NOT SET TO 1");
+
+    // set connection properties to UTF8 to properly handle locales for different
+    // server configs - core sends data in UTF8, so MySQL must expect UTF8 too
+    // mysql_set_character_set is just like SET NAMES, but also sets encoding in client library
+    // which enforces mysql_real_escape_string to be safe
+    mysql_set_character_set(m_mysql, "utf8");
+    Execute("SET CHARACTER SET `utf8`");
+
+    #if MYSQL_VERSION_ID >= 50003
+    my_bool my_true = (my_bool)1;
+    if (mysql_options(m_mysql, MYSQL_OPT_RECONNECT, &my_true))
+        sLog.outDebug("Failed to turn on MYSQL_OPT_RECONNECT.");
+    else
+        sLog.outDebug("Successfully turned on MYSQL_OPT_RECONNECT.");
+    #else
+#warning "Your mySQL client lib version does not support reconnecting after a timeout.\nIf this causes you any trouble we advice you to upgrade your mySQL client libs to at least mySQL 5.0.13 to resolve this problem."
+    #endif
+
+    return true;
+}
+
+void SqlConnection::Acquire()
+{
+    ++m_waiting;
+    m_mutex.acquire();
+    m_acquireTime = ACE_OS::gettimeofday();
+}
+
+bool SqlConnection::TryAcquire()
+{
+    if (m_mutex.tryacquire() == -1)
+        return false;
+
+    ++m_waiting;
+    m_acquireTime = ACE_OS::gettimeofday();
+    return true;
+}
+
+void SqlConnection::Release()
+{
+    ACE_Time_Value elapsed = ACE_OS::gettimeofday() - m_acquireTime;
+    uint32 usec = uint32(elapsed.sec() * IN_MILLISECONDS * IN_MILLISECONDS + elapsed.usec());
+
+    {
+        ACE_GUARD(ACE_Thread_Mutex, guard, m_statsLock);
+        ++m_executed;
+        m_totalTime += usec;
+        if (usec > m_maxTime)
+            m_maxTime = usec;
+    }
+
+    m_mutex.release();
+    --m_waiting;
+}
+
+void SqlConnection::GetStats(SqlConnectionStats& stats)
+{
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_statsLock);
+    stats.queued = GetWaiting();
+    stats.executed = m_executed;
+    stats.totalTime = m_totalTime;
+    stats.maxTime = m_maxTime;
+}
+
+unsigned long SqlConnection::EscapeString(char* to, const char* from, unsigned long length)
+{
+    if (!m_mysql || !to || !from || !length)
+        return 0;
+
+    // only the character set of the handle is used, no need to lock it
+    return mysql_real_escape_string(m_mysql, to, from, length);
+}
+
+bool SqlConnection::RawQuery(const char* sql, MYSQL_RES** pResult, MYSQL_FIELD** pFields, uint64* pRowCount, uint32* pFieldCount)
+{
+    if (!m_mysql)
+        return false;
+
+    #ifdef OREGON_DEBUG
+    uint32 _s = getMSTime();
+    #endif
+    if (mysql_query(m_mysql, sql))
+    {
+        sLog.outErrorDb("SQL: %s", sql);
+        sLog.outErrorDb("query ERROR: %s", mysql_error(m_mysql));
+        return false;
+    }
+    else
+    {
+        #ifdef OREGON_DEBUG
+        // prevent recursive death
+        unsigned long oldMask = sLog.GetDBLogMask();
+        sLog.SetDBLogMask(oldMask & ~(1 << LOG_TYPE_DEBUG));
+        sLog.outDebug("[%u ms] SQL: %s", getMSTimeDiff(_s, getMSTime()), sql);
+        sLog.SetDBLogMask(oldMask);
+        #endif
+    }
+
+    *pResult = mysql_store_result(m_mysql);
+    *pRowCount = mysql_affected_rows(m_mysql);
+    *pFieldCount = mysql_field_count(m_mysql);
+
+    if (!*pResult )
+        return false;
+
+    if (!*pRowCount)
+    {
+        mysql_free_result(*pResult);
+        return false;
+    }
+
+    *pFields = mysql_fetch_fields(*pResult);
+    return true;
+}
+
+QueryResult_AutoPtr SqlConnection::Query(const char* sql)
+{
+    MYSQL_RES* result = NULL;
+    MYSQL_FIELD* fields = NULL;
+    uint64 rowCount = 0;
+    uint32 fieldCount = 0;
+
+    if (!RawQuery(sql, &result, &fields, &rowCount, &fieldCount))
+        return QueryResult_AutoPtr(NULL);
+
+    QueryResult* queryResult = new QueryResult(result, fields, rowCount, fieldCount);
+
+    queryResult->NextRow();
+
+    return QueryResult_AutoPtr(queryResult);
+}
+
+bool SqlConnection::Execute(const char* sql)
+{
+    if (!m_mysql)
+        return false;
+
+    #ifdef OREGON_DEBUG
+    uint32 _s = getMSTime();
+    #endif
+    if (mysql_query(m_mysql, sql))
+    {
+        sLog.outErrorDb("SQL: %s", sql);
+        sLog.outErrorDb("SQL ERROR: %s", mysql_error(m_mysql));
+        return false;
+    }
+    else
+    {
+        #ifdef OREGON_DEBUG
+        // prevent recursive death
+        unsigned long oldMask = sLog.GetDBLogMask();
+        sLog.SetDBLogMask(oldMask & ~(1 << LOG_TYPE_DEBUG));
+        sLog.outDebug("[%u ms] SQL: %s", getMSTimeDiff(_s, getMSTime()), sql);
+        sLog.SetDBLogMask(oldMask);
+        #endif
+    }
+
+    return true;
+}
+
+/**
+  * @brief Atomically executed SqlTransaction.
+  * Don't call this directly, use \ref Database::BeginTransaction and
+  * \ref Database::CommitTransaction instead.
+  */
+bool SqlConnection::ExecuteTransaction(SqlTransaction* transaction)
+{
+    SqlTransaction::QueuedItem item;
+
+    ACE_Guard<ACE_Thread_Mutex> transaction_guard(transaction->mutex);
+
+    if (transaction->queue.empty())
+        return true;
+
+    if (mysql_autocommit(m_mysql, 0))
+        return false;
+
+    if (mysql_real_query(m_mysql, "START TRANSACTION", sizeof("START TRANSACTION")-1))
+        return false;
+
+    while (!transaction->queue.empty())
+    {
+        item = transaction->queue.front();
+
+        bool ok = false;
+        if (item.isStmt)
+        {
+            if (PreparedStatement* stmt = _GetOrMakePreparedStatement(item.sql, NULL, item.values))
+                ok = _ExecutePreparedStatement(stmt, item.values, NULL, false);
+        }
+        else
+            ok = Execute(item.sql);
+
+        if (!ok)
+        {
+            transaction->queue.pop();
+            free(item.sql);
+            delete item.values;
+            mysql_rollback(m_mysql);
+            mysql_autocommit(m_mysql, 1);
+            return false;
+        }
+
+        free(item.sql);
+        delete item.values;
+        transaction->queue.pop();
+    }
+
+    if (mysql_commit(m_mysql))
+        return false;
+
+    mysql_autocommit(m_mysql, 1);
+    return true;
+}
+
+bool SqlConnection::ExecuteFile(const char* file)
+{
+    if (!m_mysql)
+        return false;
+
+    if (mysql_set_server_option(m_mysql, MYSQL_OPTION_MULTI_STATEMENTS_ON))
+    {
+        sLog.outErrorDb("Cannot turn multi-statements on: %s", mysql_error(m_mysql));
+        return false;
+    }
+
+    mysql_autocommit(m_mysql, 0);
+    if (mysql_real_query(m_mysql, "START TRANSACTION", sizeof("START TRANSACTION")-1))
+    {
+        sLog.outErrorDb("Couldn't start transaction for db update file: %s", file);
+        return false;
+    }
+
+    bool in_transaction = true;
+    bool success = false;
+
+    if (FILE* fp = ACE_OS::fopen(file, "rb"))
+    {
+        #if PLATFORM == PLATFORM_UNIX
+        flock(fileno(fp), LOCK_SH);
+        #endif
+        //------
+        
+        struct stat info;
+        fstat(fileno(fp), &info);
+
+        // if less than 1MB allocate on stack, else on heap
+        char* contents = (info.st_size > 1024*1024) ? new char[info.st_size] : (char*) alloca(info.st_size);
+
+        if (ACE_OS::fread(contents, info.st_size, 1, fp) == 1)
+        {
+            if (mysql_real_query(m_mysql, contents, info.st_size))
+            {
+                sLog.outErrorDb("Cannot execute file %s, size: %lu: %s", file, info.st_size, mysql_error(m_mysql));
+            }
+            else
+            {
+                do
+                {
+                    if (mysql_field_count(m_mysql))
+                        if (MYSQL_RES* result = mysql_use_result(m_mysql))
+                            mysql_free_result(result);
+                }
+                while (0 == mysql_next_result(m_mysql));
+
+                // check whether the last mysql_next_result ended with an error
+                if (*mysql_error(m_mysql))
+                {
+                    success = false;
+                    sLog.outErrorDb("Cannot execute file %s, size: %lu: %s", file, info.st_size, mysql_error(m_mysql));
+                    if (mysql_rollback(m_mysql))
+                        sLog.outErrorDb("ExecuteFile(): Rollback ended with an error!");
+                    else
+                        in_transaction = false;
+                }
+                else
+                {
+                    if (mysql_commit(m_mysql))
+                        sLog.outErrorDb("mysql_commit() failed. Update %s will not be applied!", file);
+                    else
+                        in_transaction = false;
+                success = true;
+            }
+        }
+        }
+        else
+        {
+           sLog.outErrorDb("Couldn't read file %s, size: %lu", file, info.st_size);
+           return false;
+        }
+
+        // if allocated on heap, free memory
+        if (info.st_size > 1024*1024)
+            delete [] contents;
+
+        //------
+        #if PLATFORM == PLATFORM_UNIX
+        flock(fileno(fp), LOCK_UN);
+        #endif
+        ACE_OS::fclose(fp);
+    }
+
+    mysql_set_server_option(m_mysql, MYSQL_OPTION_MULTI_STATEMENTS_OFF);
+    mysql_autocommit(m_mysql, 1);
+    if (in_transaction)
+        mysql_rollback(m_mysql);
+    return success;
+}
+
+PreparedStatement* SqlConnection::_GetOrMakePreparedStatement(const char* query, const char* format, PreparedValues* values)
+{
+    PreparedStatementsMap::iterator it = m_preparedStatements.find(query);
+
+    if (it != m_preparedStatements.end())
+        return it->second; // found, ok
+ 
+    MYSQL_STMT* stmt = mysql_stmt_init(m_mysql);
+
+    if (!stmt)
+    {
+        sLog.outError("mysql_stmt_init() failed: %s", mysql_error(m_mysql));
+        return 0;
+    }
+
+    {
+        // set prefetch rows to maximum, thus making results buffered
+        unsigned long rows = (unsigned long) -1;
+        if (mysql_stmt_attr_set(stmt, STMT_ATTR_PREFETCH_ROWS, &rows))
+            sLog.outError("mysql_stmt_attr_set() failed.");
+
+        if (mysql_stmt_attr_set(stmt, STMT_ATTR_UPDATE_MAX_LENGTH, &my_true))
+            sLog.outError("mysql_stmt_attr_set() failed.");
+    }
+
+    PreparedStatement* prepStmt = new PreparedStatement;
+    prepStmt->stmt = stmt;
+    
+    if (format)
+    {
+        prepStmt->types = format;
+        
+        for (const char* it = format; *it != '\0'; ++it)
+        {
+            switch (*it)
+            {
+                case ARG_TYPE_STRING:
+                case ARG_TYPE_STRING_ALT:
+                case ARG_TYPE_NUMBER:
+                case ARG_TYPE_NUMBER_ALT:
+                case ARG_TYPE_UNSIGNED_NUMBER:
+                case ARG_TYPE_LARGE_NUMBER:
+                case ARG_TYPE_LARGE_NUMBER_ALT:
+                case ARG_TYPE_LARGE_UNSIGNED_NUMBER:
+                case ARG_TYPE_FLOAT:
+                case ARG_TYPE_DOUBLE:
+                case ARG_TYPE_BINARY:
+                case ARG_TYPE_BINARY_ALT:
+                    break;
+                default:
+                    sLog.outError("Unknown format type '%c' for prepared statement (%s)", *it, query);
+                    delete prepStmt;
+                    return 0;
+            }
+        }
+    }
+    else if (values)
+    {
+        for (size_t i = 0; i < values->m_values.size(); ++i)
+            prepStmt->types.append(1, static_cast<char>(values->m_values[i].type));
+    }
+
+    {
+        if (mysql_stmt_prepare(stmt, query, strlen(query)))
+        {
+            sLog.outErrorDb("mysql_stmt_prepare() failed: %s, sql: %s", mysql_stmt_error(stmt), query);
+            delete prepStmt;
+            return 0;
+        }
+    }
+
+    return m_preparedStatements.insert(std::pair<std::string, PreparedStatement*>(query, prepStmt)).first->second;
+}
+
+bool SqlConnection::_ExecutePreparedStatement(PreparedStatement* ps, PreparedValues* values, va_list* args, bool resultset)
+{
+    size_t paramCount = mysql_stmt_param_count(ps->stmt);
+    MYSQL_BIND* binding = NULL;
+    bool myValues = false;
+
+    if (paramCount)
+    {
+        if (args)
+        {
+            if (paramCount != ps->types.size())
+            {
+                sLog.outErrorDb("Count of parameters passed doesn't equal to count of parameters in prepared statement!");
+                delete[] binding;
+                return false;
+            }
+
+            if (!values)
+            {
+                values = new PreparedValues(paramCount);
+                myValues = true;
+            }
+
+            ConvertValistToPreparedValues(*args, *values, ps->types.c_str());
+        }
+        else
+        {
+            ASSERT (values);
+
+            if (paramCount != values->m_values.size())
+            {
+                sLog.outErrorDb("Count of parameters passed doesn't equal to count of parameters in prepared statement!");
+                delete[] binding;
+                return false;
+            }
+        }
+
+        binding = new MYSQL_BIND[paramCount];
+        memset(binding, 0, sizeof(MYSQL_BIND)*paramCount);
+
+        for (size_t i = 0; i < paramCount; ++i)
+        {
+            switch ((*values)[i].type)
+            {
+                case ARG_TYPE_STRING:
+                case ARG_TYPE_STRING_ALT:
+                    binding[i].buffer_type = MYSQL_TYPE_STRING;
+                    binding[i].buffer = const_cast<char*> ((*values)[i].data.string);
+                    binding[i].buffer_length = (*values)[i].data.length;
+                    break;
+                case ARG_TYPE_BINARY:
+                case ARG_TYPE_BINARY_ALT:
+                    binding[i].buffer_type = MYSQL_TYPE_BLOB;
+                    binding[i].buffer = const_cast<void*> ((*values)[i].data.binary);
+                    binding[i].buffer_length = (*values)[i].data.length;
+                    break;
+                case ARG_TYPE_UNSIGNED_NUMBER:
+                    binding[i].is_unsigned = my_true; 
+                    /* FALLTHROUGH */
+                case ARG_TYPE_NUMBER:
+                case ARG_TYPE_NUMBER_ALT:
+                    binding[i].buffer_type = MYSQL_TYPE_LONG;
+                    binding[i].buffer = &(*values)[i].data.number;
+                    binding[i].buffer_length = sizeof((*values)[i].data.number);
+                    break;
+                case ARG_TYPE_LARGE_UNSIGNED_NUMBER:
+                    binding[i].is_unsigned = my_true; 
+                    /* FALLTHROUGH */
+                case ARG_TYPE_LARGE_NUMBER:
+                case ARG_TYPE_LARGE_NUMBER_ALT:
+                    binding[i].buffer_type = MYSQL_TYPE_LONGLONG;
+                    binding[i].buffer = &(*values)[i].data.largeNumber;
+                    binding[i].buffer_length = sizeof(&(*values)[i].data.largeNumber);
+                    break;
+                case ARG_TYPE_FLOAT:
+                    binding[i].buffer_type = MYSQL_TYPE_FLOAT;
+                    binding[i].buffer = &(*values)[i].data.float_;
+                    binding[i].buffer_length = sizeof(&(*values)[i].data.float_);
+                    break;
+                case ARG_TYPE_DOUBLE:
+                    binding[i].buffer_type = MYSQL_TYPE_DOUBLE;
+                    binding[i].buffer = &(*values)[i].data.double_;
+                    binding[i].buffer_length = sizeof((*values)[i].data.double_);
+                    break;
+            }
+        }
+
+        if (mysql_stmt_bind_param(ps->stmt, binding))
+        {
+            sLog.outError("mysql_stmt_bind_param() failed: %s", mysql_stmt_error(ps->stmt));
+            delete[] binding;
+            if (myValues)
+                delete values;
+            return false;
+        }
+    }
+
+    if (mysql_stmt_execute(ps->stmt))
+    {
+        sLog.outError("mysql_stmt_execute() failed: %s", mysql_stmt_error(ps->stmt));
+        delete[] binding;
+        if (myValues)
+            delete values;
+        return false;
+    }
+
+    if (myValues)
+        delete values;
+
+    // this is safe, even if there's no result
+    mysql_stmt_store_result(ps->stmt);
+
+    if (resultset)
+    {
+        if (!mysql_stmt_field_count(ps->stmt))
+        {
+            delete[] binding;
+            return false;
+        }
+
+        if (!mysql_stmt_num_rows(ps->stmt))
+        {
+            mysql_stmt_free_result(ps->stmt);
+            delete[] binding;
+            return false;
+        }
+    }
+    else
+    {
+        if (mysql_stmt_field_count(ps->stmt))
+            mysql_stmt_free_result(ps->stmt);
+        mysql_stmt_reset(ps->stmt);
+    }
+
+    delete[] binding;
+    return true;
+}
+
+void SqlConnection::ConvertValistToPreparedValues(va_list args, PreparedValues& values, const char* fmt)
+{
+    for (const char* i = fmt; *i != '\0'; ++i)
+    {
+        switch (*i)
+        {
+            case ARG_TYPE_STRING:
+            case ARG_TYPE_STRING_ALT:
+                values << va_arg(args, const char*);
+                break;
+            case ARG_TYPE_BINARY:
+            case ARG_TYPE_BINARY_ALT:
+                {
+                    size_t size = va_arg(args, size_t);
+                    const void* data = va_arg(args, const void*);
+                    values << std::pair<const void*, size_t>(data, size);
+                }
+                break;
+            case ARG_TYPE_UNSIGNED_NUMBER:
+                values << va_arg(args, uint32);
+                break;
+            case ARG_TYPE_NUMBER:
+            case ARG_TYPE_NUMBER_ALT:
+                values << va_arg(args, int32);
+                break;
+            case ARG_TYPE_LARGE_UNSIGNED_NUMBER:
+                values << va_arg(args, uint64);
+                break;
+            case ARG_TYPE_LARGE_NUMBER:
+            case ARG_TYPE_LARGE_NUMBER_ALT:
+                values << va_arg(args, int64);
+                break;
+            case ARG_TYPE_FLOAT:
+                // passed floats are promoted to doubles
+                values << (float) va_arg(args, double);
+                break;
+            case ARG_TYPE_DOUBLE:
+                values << va_arg(args, double);
+                break;
+        }
+    }
+}
+
+PreparedQueryResult_AutoPtr SqlConnection::PreparedQuery(const char* sql, const char* format, PreparedValues* values, va_list* args)
+{
+    PreparedStatement* stmt = _GetOrMakePreparedStatement(sql, format, values);
+
+    if (!stmt)
+        return PreparedQueryResult_AutoPtr(NULL);
+
+    if (!_ExecutePreparedStatement(stmt, values, args, true))
+        return PreparedQueryResult_AutoPtr(NULL);
+
+    return PreparedQueryResult_AutoPtr(new PreparedQueryResult(stmt->stmt));
+}
+
+bool SqlConnection::PreparedExecute(const char* sql, const char* format, PreparedValues* values, va_list* args)
+{
+    PreparedStatement* stmt = _GetOrMakePreparedStatement(sql, format, values);
+
+    if (!stmt)
+        return false;
+
+    return _ExecutePreparedStatement(stmt, values, args, false);
+}
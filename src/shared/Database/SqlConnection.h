@@ -0,0 +1,109 @@
+/*
+ * This file is part of the OregonCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __SQLCONNECTION_H
+#define __SQLCONNECTION_H
+
+#include "Common.h"
+#include "Utilities/UnorderedMap.h"
+#include "ace/Thread_Mutex.h"
+#include "ace/Atomic_Op.h"
+#include "PreparedStatement.h"
+#include "QueryResult.h"
+
+#ifdef WIN32
+#include <winsock2.h>
+#endif
+#include <mysql.h>
+
+class SqlTransaction;
+
+/// Parsed form of a "hostname;port;username;password;database" string
+struct SqlConnectionInfo
+{
+    explicit SqlConnectionInfo(const char* infoString);
+
+    std::string host;
+    std::string port_or_socket;
+    std::string user;
+    std::string password;
+    std::string database;
+};
+
+/// Snapshot of the usage of one pooled connection
+struct SqlConnectionStats
+{
+    bool async;                                             // owned by an async worker
+    uint32 queued;                                          // operations waiting for this connection
+    uint64 executed;                                        // operations run since startup
+    uint64 totalTime;                                       // in microseconds
+    uint32 maxTime;                                         // in microseconds
+};
+
+/**
+  * @brief One MySQL connection of a Database pool.
+  * Every connection keeps its own prepared statements, since a MYSQL_STMT
+  * is bound to the handle it was prepared on. All calls except
+  * \ref Open and \ref EscapeString must be made between
+  * \ref Acquire and \ref Release.
+  */
+class SqlConnection
+{
+    public:
+        SqlConnection();
+        ~SqlConnection();
+
+        bool Open(SqlConnectionInfo const& info);
+
+        void Acquire();
+        bool TryAcquire();
+        void Release();
+
+        uint32 GetWaiting() const { return uint32(m_waiting.value()); }
+        void GetStats(SqlConnectionStats& stats);
+
+        QueryResult_AutoPtr Query(const char* sql);
+        bool RawQuery(const char* sql, MYSQL_RES** pResult, MYSQL_FIELD** pFields, uint64* pRowCount, uint32* pFieldCount);
+        bool Execute(const char* sql);
+        bool ExecuteTransaction(SqlTransaction* transaction);
+        bool ExecuteFile(const char* file);
+
+        PreparedQueryResult_AutoPtr PreparedQuery(const char* sql, const char* format, PreparedValues* values, va_list* args);
+        bool PreparedExecute(const char* sql, const char* format, PreparedValues* values, va_list* args);
+
+        unsigned long EscapeString(char* to, const char* from, unsigned long length);
+
+        static void ConvertValistToPreparedValues(va_list args, PreparedValues& values, const char* fmt);
+
+    private:
+        PreparedStatement* _GetOrMakePreparedStatement(const char* query, const char* format, PreparedValues* values);
+        bool _ExecutePreparedStatement(PreparedStatement* ps, PreparedValues* values, va_list* args, bool resultset);
+
+        MYSQL* m_mysql;
+        ACE_Thread_Mutex m_mutex;                           // held while a thread uses the handle
+        ACE_Atomic_Op<ACE_Thread_Mutex, long> m_waiting;    // threads holding or waiting for m_mutex
+
+        ACE_Thread_Mutex m_statsLock;
+        ACE_Time_Value m_acquireTime;
+        uint64 m_executed;
+        uint64 m_totalTime;
+        uint32 m_maxTime;
+
+        typedef UNORDERED_MAP<std::string, PreparedStatement*> PreparedStatementsMap;
+        PreparedStatementsMap m_preparedStatements;
+};
+#endif                                                      //__SQLCONNECTION_H
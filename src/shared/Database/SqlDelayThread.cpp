@@ -16,13 +16,19 @@
  */
 
 #include "Database/SqlDelayThread.h"
+#include "Database/SqlConnection.h"
 #include "Database/SqlOperations.h"
 #include "DatabaseEnv.h"
 
-SqlDelayThread::SqlDelayThread(Database* db) : m_dbEngine(db), m_running(true)
+SqlDelayThread::SqlDelayThread(SqlConnection* conn) : m_conn(conn), m_running(true)
 {
 }
 
+SqlDelayThread::~SqlDelayThread()
+{
+    delete m_conn;
+}
+
 void SqlDelayThread::run()
 {
     mysql_thread_init();
@@ -37,7 +43,9 @@ void SqlDelayThread::run()
         s = dynamic_cast<SqlAsyncTask*> (m_sqlQueue.dequeue());
         if (s)
         {
+            m_conn->Acquire();
             s->call();
+            m_conn->Release();
             delete s;
         }
     }
@@ -58,7 +66,7 @@ void SqlDelayThread::Stop()
 
 bool SqlDelayThread::Delay(SqlOperation* sql)
 {
-    int res = m_sqlQueue.enqueue(new SqlAsyncTask(m_dbEngine, sql));
+    int res = m_sqlQueue.enqueue(new SqlAsyncTask(m_conn, sql));
     return (res != -1);
 }
 
@@ -18,11 +18,12 @@
 #ifndef __SQLDELAYTHREAD_H
 #define __SQLDELAYTHREAD_H
 
+#include "Common.h"
 #include "ace/Thread_Mutex.h"
 #include "ace/Activation_Queue.h"
 #include "Threading.h"
 
-class Database;
+class SqlConnection;
 class SqlOperation;
 
 class SqlDelayThread : public ACE_Based::Runnable
@@ -31,16 +32,20 @@ class SqlDelayThread : public ACE_Based::Runnable
 
     private:
         SqlQueue m_sqlQueue;                                // Queue of SQL statements
-        Database* m_dbEngine;                               // Pointer to used Database engine
+        SqlConnection* m_conn;                              // Connection used only by this thread (owned)
         volatile bool m_running;
 
         SqlDelayThread();
     public:
-        SqlDelayThread(Database* db);
+        SqlDelayThread(SqlConnection* conn);
+        ~SqlDelayThread();
 
         // Put sql statement to delay queue
         bool Delay(SqlOperation* sql);
 
+        SqlConnection* GetConnection() const { return m_conn; }
+        uint32 GetQueueSize() { return uint32(m_sqlQueue.method_count()); }
+
         void Stop();                                // Stop event
         void run() override;                                 // Main Thread loop
 };
@@ -16,27 +16,51 @@
  */
 
 #include "SqlOperations.h"
+#include "SqlConnection.h"
 #include "SqlDelayThread.h"
 #include "DatabaseEnv.h"
 #include "DatabaseImpl.h"
 
 // ASYNC STATEMENTS / TRANSACTIONS
 
-void SqlStatement::Execute(Database* db)
+void SqlStatement::Execute(SqlConnection* conn)
 {
     // just do it
-    db->DirectExecute(m_sql);
+    conn->Execute(m_sql);
+}
+
+void SqlPreparedStatement::Execute(SqlConnection* conn)
+{
+    conn->PreparedExecute(m_sql.c_str(), NULL, &m_values, NULL);
+}
+
+void SqlTransaction::Execute(SqlConnection* conn)
+{
+    conn->ExecuteTransaction(this);
+}
+
+void SqlOrderedWrite::Execute(SqlConnection* conn)
+{
+    m_op->Execute(conn);
+    m_db._WriteDone(m_seq);
 }
 
 // ASYNC QUERIES
 
-void SqlQuery::Execute(Database* db)
+void SqlOrderedRead::Execute(SqlConnection* conn)
+{
+    // see the rows of every write queued before the query
+    m_db._WaitForWrite(m_after);
+    m_op->Execute(conn);
+}
+
+void SqlQuery::Execute(SqlConnection* conn)
 {
     if (!m_callback || !m_queue)
         return;
 
     // execute the query and store the result in the callback
-    m_callback->SetResult(db->Query(m_sql));
+    m_callback->SetResult(conn->Query(m_sql));
     // add the callback to the sql result queue of the thread it originated from
     m_queue->add(m_callback);
 }
@@ -52,18 +76,6 @@ void SqlResultQueue::Update()
     }
 }
 
-bool SqlQueryHolder::Execute(Oregon::IQueryCallback* callback, SqlDelayThread* thread, SqlResultQueue* queue)
-{
-    if (!callback || !thread || !queue)
-        return false;
-
-    // delay the execution of the queries, sync them with the delay thread
-    // which will in turn resync on execution (via the queue) and call back
-    SqlQueryHolderEx* holderEx = new SqlQueryHolderEx(this, callback, queue);
-    thread->Delay(holderEx);
-    return true;
-}
-
 bool SqlQueryHolder::SetQuery(size_t index, const char* sql)
 {
     if (m_queries.size() <= index)
@@ -148,7 +160,7 @@ void SqlQueryHolder::SetSize(size_t size)
     m_queries.resize(size);
 }
 
-void SqlQueryHolderEx::Execute(Database* db)
+void SqlQueryHolderEx::Execute(SqlConnection* conn)
 {
     if (!m_holder || !m_callback || !m_queue)
         return;
@@ -160,7 +172,7 @@ void SqlQueryHolderEx::Execute(Database* db)
     {
         // execute all queries in the holder and pass the results
         char const* sql = queries[i].first;
-        if (sql) m_holder->SetResult(i, db->Query(sql));
+        if (sql) m_holder->SetResult(i, conn->Query(sql));
     }
 
     // sync with the caller thread
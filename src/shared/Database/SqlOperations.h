@@ -31,8 +31,8 @@
 // BASE
 
 class Database;
+class SqlConnection;
 class SqlDelayThread;
-struct PreparedStatement;
 
 class SqlOperation
 {
@@ -41,7 +41,7 @@ class SqlOperation
         {
             delete this;
         }
-        virtual void Execute(Database* db) = 0;
+        virtual void Execute(SqlConnection* conn) = 0;
         virtual ~SqlOperation() {}
 };
 
@@ -58,39 +58,28 @@ class SqlStatement : public SqlOperation
             void* tofree = const_cast<char*>(m_sql);
             free(tofree);
         }
-        void Execute(Database* db);
+        void Execute(SqlConnection* conn);
 };
 
 class SqlPreparedStatement : public SqlOperation
 {
     private:
-        PreparedStatement* m_stmt;
+        std::string m_sql;                                  // statements are prepared per connection
         PreparedValues m_values;
     public:
-        SqlPreparedStatement(PreparedStatement* stmt, PreparedValues& values) : m_stmt(stmt), m_values(values) {}
+        SqlPreparedStatement(const char* sql, PreparedValues& values) : m_sql(sql), m_values(values) {}
 
-        void Execute(Database* db)
-        {
-            db->DirectExecute(m_stmt, m_values, NULL);
-        }
+        void Execute(SqlConnection* conn);
 };
 
 class SqlTransaction : public SqlOperation
 {
     protected:
-        friend class Database;
+        friend class SqlConnection;
         struct QueuedItem
         {
-            union
-            {
-                char* sql;
-                struct
-                {
-                    PreparedStatement* stmt;
-                    PreparedValues* values;
-                };
-            };
-
+            char* sql;
+            PreparedValues* values;                         // only set for prepared statements
             bool isStmt;
         };
 
@@ -102,10 +91,8 @@ class SqlTransaction : public SqlOperation
             while (!queue.empty())
             {
                 QueuedItem item = queue.front();
-                if (!item.isStmt)
-                    free (item.sql);
-                else
-                    delete item.values;
+                free(item.sql);
+                delete item.values;
                 queue.pop();
             }
         }
@@ -114,16 +101,17 @@ class SqlTransaction : public SqlOperation
         {
             QueuedItem item;
             item.sql = strdup(sql);
+            item.values = NULL;
             item.isStmt = false;
 
             mutex.acquire();
             queue.push(item);
             mutex.release();
         }
-        void DelayExecute(PreparedStatement* stmt, PreparedValues& values)
+        void DelayExecute(const char* sql, PreparedValues& values)
         {
             QueuedItem item;
-            item.stmt = stmt;
+            item.sql = strdup(sql);
             item.values = new PreparedValues(values.size());
             *item.values = values;
             item.isStmt = true;
@@ -132,10 +120,21 @@ class SqlTransaction : public SqlOperation
             queue.push(item);
             mutex.release();
         }
-        void Execute(Database* db)
-        {
-            db->ExecuteTransaction(this);
-        }
+        void Execute(SqlConnection* conn);
+};
+
+// runs a statement or transaction on the write worker and wakes up the
+// async queries waiting for it
+class SqlOrderedWrite : public SqlOperation
+{
+    private:
+        SqlOperation* m_op;
+        Database& m_db;
+        uint64 m_seq;
+    public:
+        SqlOrderedWrite(SqlOperation* op, Database& db, uint64 seq) : m_op(op), m_db(db), m_seq(seq) {}
+        ~SqlOrderedWrite() { delete m_op; }
+        void Execute(SqlConnection* conn);
 };
 
 // ASYNC QUERIES
@@ -167,7 +166,7 @@ class SqlQuery : public SqlOperation
             void* tofree = const_cast<char*>(m_sql);
             free(tofree);
         }
-        void Execute(Database* db);
+        void Execute(SqlConnection* conn);
 };
 
 class SqlQueryHolder
@@ -184,7 +183,6 @@ class SqlQueryHolder
         void SetSize(size_t size);
         QueryResult_AutoPtr GetResult(size_t index);
         void SetResult(size_t index, QueryResult_AutoPtr result);
-        bool Execute(Oregon::IQueryCallback* callback, SqlDelayThread* thread, SqlResultQueue* queue);
 };
 
 class SqlQueryHolderEx : public SqlOperation
@@ -196,13 +194,26 @@ class SqlQueryHolderEx : public SqlOperation
     public:
         SqlQueryHolderEx(SqlQueryHolder* holder, Oregon::IQueryCallback* callback, SqlResultQueue* queue)
             : m_holder(holder), m_callback(callback), m_queue(queue) {}
-        void Execute(Database* db);
+        void Execute(SqlConnection* conn);
+};
+
+// runs an async query on a read worker once the writes queued before it are done
+class SqlOrderedRead : public SqlOperation
+{
+    private:
+        SqlOperation* m_op;
+        Database& m_db;
+        uint64 m_after;
+    public:
+        SqlOrderedRead(SqlOperation* op, Database& db, uint64 after) : m_op(op), m_db(db), m_after(after) {}
+        ~SqlOrderedRead() { delete m_op; }
+        void Execute(SqlConnection* conn);
 };
 
 class SqlAsyncTask : public ACE_Method_Request
 {
     public:
-        SqlAsyncTask(Database* db, SqlOperation* op) : m_db(db), m_op(op) {}
+        SqlAsyncTask(SqlConnection* conn, SqlOperation* op) : m_conn(conn), m_op(op) {}
         ~SqlAsyncTask()
         {
             if (!m_op)
@@ -214,12 +225,12 @@ class SqlAsyncTask : public ACE_Method_Request
 
         int call()
         {
-            if (m_db == NULL || m_op == NULL)
+            if (m_conn == NULL || m_op == NULL)
                 return -1;
 
             try
             {
-                m_op->Execute(m_db);
+                m_op->Execute(m_conn);
             }
             catch (...)
             {
@@ -230,7 +241,7 @@ class SqlAsyncTask : public ACE_Method_Request
         }
 
     private:
-        Database* m_db;
+        SqlConnection* m_conn;
         SqlOperation* m_op;
 };
 #endif                                                      //__SQLOPERATIONS_H
@@ -81,6 +81,24 @@ class LockedQueue
             return true;
         }
 
+        // Gets the next result in the queue, if any and if the checker accepts it.
+        template<class Checker>
+        bool next(T& result, Checker& check)
+        {
+            ACE_GUARD_RETURN (LockType, g, this->_lock, false);
+
+            if (_queue.empty())
+                return false;
+
+            if (!check.Process(_queue.front()))
+                return false;
+
+            result = _queue.front();
+            _queue.pop_front();
+
+            return true;
+        }
+
         // Peeks at the top of the queue. Remember to unlock after use.
         T& peek()
         {
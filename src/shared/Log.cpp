@@ -17,6 +17,7 @@
 
 #include "Common.h"
 #include "Log.h"
+#include "LogWriter.h"
 #include "Config/Config.h"
 #include "Console.h"
 #include "Utilities/Util.h"
@@ -51,7 +52,8 @@ static const ColorTypes colorPrefixTable[MAX_COLORS]
 
 INSTANTIATE_SINGLETON_1(Log);
 
-Log::Log() : m_gmlog_per_account(false), m_logMask(0), m_logMaskDatabase(0)
+Log::Log() : m_gmlog_per_account(false), m_logMask(0), m_logMaskDatabase(0),
+    m_writer(NULL), m_writerThread(NULL), m_dbBatchSize(1)
 {
     memset(m_logFiles, 0, sizeof(m_logFiles));
     memset(m_colors, 0, sizeof(m_colors));
@@ -61,6 +63,8 @@ Log::Log() : m_gmlog_per_account(false), m_logMask(0), m_logMaskDatabase(0)
 
 Log::~Log()
 {
+    StopWriter();
+
     std::set<FILE*> openfiles;
 
     for (size_t i = 0; i < MAX_LOG_TYPES; ++i)
@@ -204,6 +208,42 @@ void Log::Initialize()
     m_logMaskDatabase |= static_cast<unsigned char>(sConfig.GetBoolDefault("LogDB.RA",   false)) << LOG_TYPE_REMOTE;
     m_logMaskDatabase |= static_cast<unsigned char>(sConfig.GetBoolDefault("LogDB.GM",   false)) << LOG_TYPE_COMMAND;
     m_logMaskDatabase |= static_cast<unsigned char>(sConfig.GetBoolDefault("LogDB.Chat", false)) << LOG_TYPE_CHAT;
+
+    if (sConfig.GetBoolDefault("Log.Async.Enable", false))
+        StartWriter();
+}
+
+void Log::StartWriter()
+{
+    if (m_writer)
+        return;
+
+    m_dbBatchSize = std::max(sConfig.GetIntDefault("LogDB.BatchSize", 100), 1);
+
+    m_writer = new LogWriter(*this, sConfig.GetIntDefault("Log.Async.QueueSize", 16384),
+                             sConfig.GetIntDefault("Log.Async.FlushInterval", 100),
+                             sConfig.GetBoolDefault("Log.Async.DropWhenFull", false));
+    m_writerThread = new ACE_Based::Thread(m_writer);      // owns m_writer
+}
+
+void Log::StopWriter()
+{
+    if (!m_writer)
+        return;
+
+    LogWriter* writer = m_writer;
+    m_writer = NULL;                                        // log in place from now on
+
+    writer->Stop();
+    m_writerThread->wait();
+    delete m_writerThread;
+    m_writerThread = NULL;
+}
+
+void Log::Flush()
+{
+    if (m_writer)
+        m_writer->Flush();
 }
 
 
@@ -264,8 +304,13 @@ void Log::CreateUpdateFile(const char* description, const char* str)
 
 void Log::outTimestamp(FILE* file)
 {
-    time_t t = time(NULL);
-    tm* aTm = localtime(&t);
+    outTimestamp(file, time(NULL));
+}
+
+void Log::outTimestamp(FILE* file, time_t t)
+{
+    tm tmBuf;
+    tm* aTm = ACE_OS::localtime_r(&t, &tmBuf);
     //       YYYY   year
     //       MM     month (2 digits 01-12)
     //       DD     day (2 digits 01-31)
@@ -393,7 +438,8 @@ void Log::ResetColor()
 std::string Log::GetTimestampStr()
 {
     time_t t = time(NULL);
-    tm* aTm = localtime(&t);
+    tm tmBuf;
+    tm* aTm = ACE_OS::localtime_r(&t, &tmBuf);
     //       YYYY   year
     //       MM     month (2 digits 01-12)
     //       DD     day (2 digits 01-31)
@@ -420,73 +466,197 @@ void Log::outDB(LogTypes type, const char* str)
   * @param prefix prefix, usually the LogTypes as string
   * @param fmt printf-like formatting message
   * @param ap list of arguments
-  * @param file if set, use this file instead of m_logFiles[type]
+  * @param perAccount if set, write to the GM log of the account instead of m_logFiles[type]
+  * @param account account of the per account GM log
   */
-void Log::DoLog(LogTypes type, bool newline, const char* prefix, const char* fmt, va_list ap, FILE* file)
+void Log::DoLog(LogTypes type, bool newline, const char* prefix, const char* fmt, va_list ap, bool perAccount, uint64 account)
 {
+    // format once on the stack, only long messages need a second pass
+    char stackBuffer[1024];
     va_list ap2;
     va_copy(ap2, ap);
+    int res = vsnprintf(stackBuffer, sizeof(stackBuffer), fmt, ap2);
+    va_end(ap2);
 
-    size_t len = vsnprintf(NULL, 0, fmt, ap2) + 1;
-    char* buffer = (char*) ((len > 1024) ? malloc(len * sizeof(char)) : alloca(len * sizeof(char)));
-    
-	va_end(ap2);
-	vsprintf(buffer, fmt, ap);
+    if (res < 0)
+        return;
 
-    if (m_logMaskDatabase & (1 << type))
+    size_t len = size_t(res);
+    char* buffer = stackBuffer;
+    if (len >= sizeof(stackBuffer))
     {
-        // we don't want empty strings in the DB
-        if (*buffer && *buffer != ' ' && *buffer != '\n')
-            outDB(type, buffer);
+        buffer = (char*) malloc(len + 1);
+        vsnprintf(buffer, len + 1, fmt, ap);
     }
 
-    if (m_logMask & (1 << type))
+    bool toLog = m_logMask & (1 << type);
+    // we don't want empty strings in the DB
+    bool toDB = (m_logMaskDatabase & (1 << type)) && *buffer && *buffer != ' ' && *buffer != '\n';
+
+    if (m_writer)
     {
-        if (FILE* logFile = (file ? file : m_logFiles[type]))
+        LogRecord* record = new LogRecord;
+        record->type = uint8(type);
+        record->newline = newline;
+        record->toLog = toLog;
+        record->toDB = toDB;
+        record->raw = false;
+        record->perAccount = perAccount;
+        record->account = account;
+        record->prefix = prefix;
+        record->time = time(NULL);
+        record->text.assign(buffer, len);
+        m_writer->Push(record);
+    }
+    else
+    {
+        if (toDB)
+            outDB(type, buffer);
+
+        if (toLog)
         {
-            outTimestamp(logFile);
-            fwrite(buffer, len-1, 1, logFile);
-            if (newline)
-                fputc('\n', logFile);
-            fflush(logFile);
+            FILE* logFile = perAccount ? openGmlogPerAccount(account) : m_logFiles[type];
+            WriteLine(type, newline, prefix, time(NULL), buffer, len, logFile);
+            if (logFile)
+            {
+                // per account GM logs are not kept open
+                if (perAccount)
+                    fclose(logFile);
+                else
+                    fflush(logFile);
+            }
+
+            // just to be sure, stderr should be unbuffered anyway
+            fflush(stderr);
         }
+    }
+
+    if (buffer != stackBuffer)
+        free(buffer);
+}
+
+void Log::WriteLine(LogTypes type, bool newline, const char* prefix, time_t t, char* buffer, size_t len, FILE* logFile)
+{
+    if (logFile)
+    {
+        outTimestamp(logFile, t);
+        fwrite(buffer, len, 1, logFile);
+        if (newline)
+            fputc('\n', logFile);
+    }
+
+    if (prefix)
+    {
+        if (colorPrefixTable[m_colors[type]])
+            SetColor(colorPrefixTable[m_colors[type]]);
+
+        fprintf(stderr, "[%s] ", prefix);
+    }
+
+    if (m_colors[type])
+        SetColor(m_colors[type]);
+
+    #if PLATFORM == PLATFORM_WINDOWS
+    wchar_t* wtemp_buf = (wchar_t*) _malloca((len + 1) * sizeof(wchar_t));
+    size_t siz = len;
+    if (Utf8toWStr(buffer, len, wtemp_buf, siz))
+    {
+        CharToOemBuffW(wtemp_buf, buffer, siz);
+        fwrite(buffer, siz, 1, stderr);
+    }
+    _freea(wtemp_buf);
+    #else
+    fwrite(buffer, len, 1, stderr);
+    #endif
+
+    if (m_colors[type])
+        ResetColor();
+
+    if (newline)
+        fputc('\n', stderr);
+}
+
+/**
+  * Writes a batch taken from the async writer: every touched file is flushed
+  * once, per account GM logs are opened once and closed at the end, and
+  * database lines are grouped into multi-row INSERTs.
+  */
+void Log::WriteBatch(std::vector<LogRecord*> const& records, uint32 dropped)
+{
+    FILE* touched[MAX_LOG_TYPES];
+    size_t touchedCount = 0;
+    std::map<uint64, FILE*> gmLogs;
+
+    bool dbLog = LoginDatabase.IsConnected();
+    std::string insert;
+    uint32 rows = 0;
+
+    for (std::vector<LogRecord*>::const_iterator itr = records.begin(); itr != records.end(); ++itr)
+    {
+        LogRecord* record = *itr;
+        LogTypes type = LogTypes(record->type);
+        FILE* logFile = m_logFiles[type];
 
-        if (prefix)
+        if (record->perAccount)
         {
-            if (colorPrefixTable[m_colors[type]])
-                SetColor(colorPrefixTable[m_colors[type]]);
+            std::map<uint64, FILE*>::iterator gmLog = gmLogs.find(record->account);
+            if (gmLog == gmLogs.end())
+                gmLog = gmLogs.insert(std::make_pair(record->account, openGmlogPerAccount(record->account))).first;
+            logFile = gmLog->second;
+        }
 
-            fprintf(stderr, "[%s] ", prefix);
+        if (record->raw)
+        {
+            if (logFile)
+                fwrite(record->text.c_str(), record->text.size(), 1, logFile);
         }
+        else if (record->toLog)
+            WriteLine(type, record->newline, record->prefix, record->time, &record->text[0], record->text.size(), logFile);
+        else
+            logFile = NULL;
 
-        if (m_colors[type])
-            SetColor(m_colors[type]);
+        if (logFile && !record->perAccount && std::find(touched, touched + touchedCount, logFile) == touched + touchedCount)
+            touched[touchedCount++] = logFile;
 
-        #if PLATFORM == PLATFORM_WINDOWS
-        wchar_t* wtemp_buf = (wchar_t*) _malloca(len * sizeof(wchar_t));
-        size_t siz = len - 1;
-        if (Utf8toWStr(buffer, len-1, wtemp_buf, siz))
+        if (record->toDB && dbLog)
         {
-            CharToOemBuffW(wtemp_buf, buffer, siz);
-            fwrite(buffer, siz, 1, stderr);
+            std::string str(record->text);
+            LoginDatabase.escape_string(str);
+
+            std::ostringstream row;
+            row << (rows ? ",(" : "INSERT INTO logs (time, realm, type, string) VALUES (")
+                << uint64(record->time) << ", " << realmID << ", " << uint32(type) << ", '" << str << "')";
+            insert += row.str();
+
+            if (++rows >= m_dbBatchSize)
+            {
+                LoginDatabase.Execute(insert.c_str());
+                insert.clear();
+                rows = 0;
+            }
         }
-        _freea(wtemp_buf);
-        #else
-        fwrite(buffer, len-1, 1, stderr);
-        #endif
+    }
 
-        if (m_colors[type])
-            ResetColor();
+    if (rows)
+        LoginDatabase.Execute(insert.c_str());
 
-        if (newline)
-            fputc('\n', stderr);
-        
-        // just to be sure, stderr should be unbuffered anyway
-        fflush(stderr);
+    if (dropped)
+    {
+        char buffer[64];
+        int len = snprintf(buffer, sizeof(buffer), "Log queue full, %u messages dropped", dropped);
+        WriteLine(LOG_TYPE_ERROR, true, "Err", time(NULL), buffer, size_t(len), m_logFiles[LOG_TYPE_ERROR]);
+        if (m_logFiles[LOG_TYPE_ERROR] && std::find(touched, touched + touchedCount, m_logFiles[LOG_TYPE_ERROR]) == touched + touchedCount)
+            touched[touchedCount++] = m_logFiles[LOG_TYPE_ERROR];
     }
 
-    if (len > 1024)
-        free(buffer);
+    for (size_t i = 0; i < touchedCount; ++i)
+        fflush(touched[i]);
+
+    for (std::map<uint64, FILE*>::const_iterator itr = gmLogs.begin(); itr != gmLogs.end(); ++itr)
+        if (itr->second)
+            fclose(itr->second);
+
+    fflush(stderr);
 }
 
 void Log::outFatal(const char* err, ...)
@@ -503,6 +673,7 @@ void Log::outFatal(const char* err, ...)
 
     m_logMask |= LOG_TYPE_ERROR;
     outError("%s", buffer);
+    Flush();
 
     if (sConsole.IsEnabled())
         sConsole.FatalError(buffer);
@@ -515,27 +686,33 @@ void Log::outCommand(uint64 account, const char* str, ...)
     if (!((m_logMask | m_logMaskDatabase) & (1 << LOG_TYPE_COMMAND)))
         return;
 
-    FILE* file;
-    if (m_gmlog_per_account)
-        file = openGmlogPerAccount(account);
-    else
-        file = m_logFiles[LOG_TYPE_COMMAND];
-
     va_list ap;
     va_start(ap, str);
-    DoLog(LOG_TYPE_COMMAND, true, "CMD", str, ap, file);
+    DoLog(LOG_TYPE_COMMAND, true, "CMD", str, ap, m_gmlog_per_account, account);
     va_end(ap);
-
-    if (m_gmlog_per_account)
-    {
-        fflush(file);
-        fclose(file);
-    }
 }
 
 void Log::outCharDump(const char* str, uint32 account_id, uint32 guid, const char* name)
 {
-    if (m_logFiles[LOG_TYPE_CHAR])
+    if (m_logFiles[LOG_TYPE_CHAR] && m_writer)
+    {
+        std::ostringstream dump;
+        dump << "== START DUMP == (account: " << account_id << " guid: " << guid << " name: " << name << ")\n" << str << "\n== END DUMP ==\n";
+
+        LogRecord* record = new LogRecord;
+        record->type = uint8(LOG_TYPE_CHAR);
+        record->newline = false;
+        record->toLog = true;
+        record->toDB = false;
+        record->raw = true;
+        record->perAccount = false;
+        record->account = 0;
+        record->prefix = NULL;
+        record->time = time(NULL);
+        record->text = dump.str();
+        m_writer->Push(record);
+    }
+    else if (m_logFiles[LOG_TYPE_CHAR])
     {
         fprintf(m_logFiles[LOG_TYPE_CHAR], "== START DUMP == (account: %u guid: %u name: %s)\n%s\n== END DUMP ==\n", account_id, guid, name, str);
         fflush(m_logFiles[LOG_TYPE_CHAR]);
@@ -550,7 +727,7 @@ void Log::outCharDump(const char* str, uint32 account_id, uint32 guid, const cha
                                                                \
                 va_list ap;                                    \
                 va_start(ap, fmt);                             \
-                DoLog(type, newline, prefix, fmt, ap, NULL);   \
+                DoLog(type, newline, prefix, fmt, ap);         \
                 va_end(ap);                                    \
             }                                                          
 
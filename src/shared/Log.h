@@ -24,6 +24,8 @@
 #include <string>
 
 class Config;
+class LogWriter;
+struct LogRecord;
 
 /// LogTypes, each value is bit position in logmask
 enum LogTypes
@@ -137,8 +139,15 @@ class Log : public Oregon::Singleton<Log, Oregon::ClassLevelLockable<Log, ACE_Th
         void CreateUpdateFile(const char* description, const char* str);
 
         static void outTimestamp(FILE* file);
+        static void outTimestamp(FILE* file, time_t t);
         static std::string GetTimestampStr();
 
+        /// Waits until the async writer has written everything queued so far
+        void Flush();
+
+        /// Writes records queued by DoLog, called by the async writer thread
+        void WriteBatch(std::vector<LogRecord*> const& records, uint32 dropped);
+
         void SetLogMask(unsigned long mask);
         void SetDBLogMask(unsigned long mask);
 
@@ -165,7 +174,13 @@ class Log : public Oregon::Singleton<Log, Oregon::ClassLevelLockable<Log, ACE_Th
 
     private:
         /// Performs logging
-        void DoLog(LogTypes type, bool newline, const char* prefix, const char* fmt, va_list ap, FILE* file = NULL);
+        void DoLog(LogTypes type, bool newline, const char* prefix, const char* fmt, va_list ap, bool perAccount = false, uint64 account = 0);
+
+        /// Writes one message to the file and the console, without flushing
+        void WriteLine(LogTypes type, bool newline, const char* prefix, time_t t, char* buffer, size_t len, FILE* logFile);
+
+        void StartWriter();
+        void StopWriter();
 
         FILE* openLogFile(char const* configFileName, char const* configTimeStampFlag, char const* mode);
 
@@ -184,6 +199,10 @@ class Log : public Oregon::Singleton<Log, Oregon::ClassLevelLockable<Log, ACE_Th
 
         unsigned long m_logMask;          //!< mask to filter messages sent to console and files
         unsigned long m_logMaskDatabase;  //!< mask to filter messages sent to db
+
+        LogWriter* m_writer;                    //!< async writer, NULL when writing in place
+        ACE_Based::Thread* m_writerThread;
+        uint32 m_dbBatchSize;                   //!< rows per INSERT into the logs table
 };
 
 /// Log class singleton
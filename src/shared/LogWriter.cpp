@@ -0,0 +1,144 @@
+/*
+ * This file is part of the OregonCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "LogWriter.h"
+#include "Log.h"
+
+LogWriter::LogWriter(Log& log, uint32 capacity, uint32 flushInterval, bool dropWhenFull) :
+    m_log(log), m_ring(std::max<uint32>(capacity, 64), (LogRecord*)NULL), m_head(0), m_count(0),
+    m_pushed(0), m_written(0), m_dropped(0), m_flushInterval(std::max<uint32>(flushInterval, 1)),
+    m_dropWhenFull(dropWhenFull), m_running(true), m_threadId(ACE_OS::NULL_thread),
+    m_wakeup(m_lock), m_space(m_lock), m_done(m_lock)
+{
+}
+
+LogWriter::~LogWriter()
+{
+    for (size_t i = 0; i < m_count; ++i)
+        delete m_ring[(m_head + i) % m_ring.size()];
+}
+
+bool LogWriter::IsWriterThread() const
+{
+    return ACE_OS::thr_equal(ACE_Thread::self(), m_threadId);
+}
+
+bool LogWriter::Push(LogRecord* record)
+{
+    ACE_GUARD_RETURN(ACE_Thread_Mutex, guard, m_lock, false);
+
+    // the writer itself may log (database errors), it must never wait on its own queue
+    while (m_count == m_ring.size())
+    {
+        if (m_dropWhenFull || !m_running || IsWriterThread())
+        {
+            ++m_dropped;
+            delete record;
+            return false;
+        }
+
+        m_wakeup.signal();
+        m_space.wait();
+    }
+
+    m_ring[(m_head + m_count) % m_ring.size()] = record;
+    ++m_count;
+    ++m_pushed;
+
+    // don't wait for the flush interval once the ring fills up
+    if (m_count == m_ring.size() / 2)
+        m_wakeup.signal();
+
+    return true;
+}
+
+void LogWriter::Flush()
+{
+    if (IsWriterThread())
+        return;
+
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_lock);
+
+    uint64 target = m_pushed;
+    while (m_written < target && m_running)
+    {
+        m_wakeup.signal();
+        m_done.wait();
+    }
+}
+
+void LogWriter::Stop()
+{
+    ACE_GUARD(ACE_Thread_Mutex, guard, m_lock);
+    m_running = false;
+    m_wakeup.signal();
+    m_space.broadcast();
+}
+
+void LogWriter::run()
+{
+    m_threadId = ACE_Thread::self();
+
+    std::vector<LogRecord*> batch;
+    batch.reserve(m_ring.size());
+
+    for (;;)
+    {
+        uint32 dropped;
+        bool running;
+        {
+            ACE_GUARD(ACE_Thread_Mutex, guard, m_lock);
+
+            if (m_running && !m_count)
+            {
+                ACE_Time_Value timeout;
+                timeout.msec(long(m_flushInterval));
+                timeout += ACE_OS::gettimeofday();
+                m_wakeup.wait(&timeout);
+            }
+
+            for (; m_count; --m_count)
+            {
+                batch.push_back(m_ring[m_head]);
+                m_head = (m_head + 1) % m_ring.size();
+            }
+
+            dropped = m_dropped;
+            m_dropped = 0;
+            running = m_running;
+            m_space.broadcast();
+        }
+
+        // writing happens outside of the lock, producers keep queueing meanwhile
+        if (!batch.empty() || dropped)
+            m_log.WriteBatch(batch, dropped);
+
+        for (std::vector<LogRecord*>::iterator itr = batch.begin(); itr != batch.end(); ++itr)
+            delete *itr;
+
+        {
+            ACE_GUARD(ACE_Thread_Mutex, guard, m_lock);
+            m_written += batch.size();
+            m_done.broadcast();
+
+            if (!running && !m_count)
+                break;
+        }
+
+        batch.clear();
+    }
+}
@@ -0,0 +1,87 @@
+/*
+ * This file is part of the OregonCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef OREGONCORE_LOGWRITER_H
+#define OREGONCORE_LOGWRITER_H
+
+#include "Common.h"
+#include "Threading.h"
+#include <ace/Thread_Mutex.h>
+#include <ace/Condition_Thread_Mutex.h>
+
+class Log;
+
+/// One formatted message waiting for the log writer thread
+struct LogRecord
+{
+    uint8 type;                                             // LogTypes
+    bool newline;
+    bool toLog;                                             // file and console, see Log::m_logMask
+    bool toDB;                                              // logs table, see Log::m_logMaskDatabase
+    bool raw;                                               // file only, no timestamp (char dumps)
+    bool perAccount;                                        // written to the GM log of account, see GmLogPerAccount
+    uint64 account;
+    const char* prefix;                                     // console prefix, static strings only
+    time_t time;
+    std::string text;
+};
+
+/**
+  * @brief Bounded queue of log records drained by a dedicated thread.
+  * Producers only format their message and append a pointer under a short
+  * lock, the writer takes whole batches and hands them to Log::WriteBatch,
+  * which flushes every touched file once per batch.
+  */
+class LogWriter : public ACE_Based::Runnable
+{
+    public:
+        LogWriter(Log& log, uint32 capacity, uint32 flushInterval, bool dropWhenFull);
+        ~LogWriter();
+
+        /// Queues the record, the writer takes ownership. Returns false if it was dropped.
+        bool Push(LogRecord* record);
+
+        /// Blocks until everything queued so far has been written.
+        void Flush();
+
+        void Stop();
+        void run() override;
+
+    private:
+        bool IsWriterThread() const;
+
+        Log& m_log;                                         // not sLog, the writer starts while it is constructed
+        std::vector<LogRecord*> m_ring;
+        size_t m_head;                                      // oldest record
+        size_t m_count;
+
+        uint64 m_pushed;                                    // records accepted since startup
+        uint64 m_written;                                   // records handed to Log::WriteBatch
+        uint32 m_dropped;                                   // dropped since last report
+
+        uint32 m_flushInterval;                             // in milliseconds
+        bool m_dropWhenFull;
+        bool m_running;
+        ACE_thread_t m_threadId;
+
+        ACE_Thread_Mutex m_lock;
+        ACE_Condition_Thread_Mutex m_wakeup;                // records to write or stop requested
+        ACE_Condition_Thread_Mutex m_space;                 // room freed in the ring
+        ACE_Condition_Thread_Mutex m_done;                  // a batch has been written
+};
+
+#endif
@@ -0,0 +1,92 @@
+/*
+ * This file is part of the OregonCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef OREGONCORE_SHAREDWORLDPACKET_H
+#define OREGONCORE_SHAREDWORLDPACKET_H
+
+#include "WorldPacket.h"
+#include <ace/Atomic_Op.h>
+#include <ace/Thread_Mutex.h>
+
+/**
+ * Reference counted, immutable copy of a WorldPacket.
+ *
+ * Sockets with a full output buffer queue a reference to it, so a broadcast
+ * makes at most one copy however many of its receivers have to wait.
+ */
+class SharedWorldPacket
+{
+    public:
+        explicit SharedWorldPacket(WorldPacket const& packet) : m_packet(packet), m_refs(1) {}
+
+        WorldPacket const& GetPacket() const { return m_packet; }
+        uint16 GetOpcode() const { return m_packet.GetOpcode(); }
+        size_t size() const { return m_packet.size(); }
+
+        void AddReference() { ++m_refs; }
+        void RemoveReference()
+        {
+            if (!--m_refs)
+                delete this;
+        }
+
+    private:
+        ~SharedWorldPacket() {}
+
+        SharedWorldPacket(SharedWorldPacket const&);
+        SharedWorldPacket& operator=(SharedWorldPacket const&);
+
+        WorldPacket const m_packet;
+        ACE_Atomic_Op<ACE_Thread_Mutex, long> m_refs;
+};
+
+// A packet sent to several sockets by one thread. Sockets copy it straight
+// into their output buffer; the shared copy is only built for the first
+// one that has to queue it. The packet must outlive the pointer.
+class SharedWorldPacketPtr
+{
+    public:
+        explicit SharedWorldPacketPtr(WorldPacket const& packet) : m_packet(&packet), m_ptr(NULL) {}
+        SharedWorldPacketPtr(SharedWorldPacketPtr const& other) : m_packet(other.m_packet), m_ptr(other.m_ptr)
+        {
+            if (m_ptr)
+                m_ptr->AddReference();
+        }
+        ~SharedWorldPacketPtr()
+        {
+            if (m_ptr)
+                m_ptr->RemoveReference();
+        }
+
+        WorldPacket const& GetPacket() const { return *m_packet; }
+
+        // the shared copy, the caller adds its own reference
+        SharedWorldPacket* Share()
+        {
+            if (!m_ptr)
+                m_ptr = new SharedWorldPacket(*m_packet);
+            return m_ptr;
+        }
+
+    private:
+        WorldPacket const* m_packet;
+        SharedWorldPacket* m_ptr;
+
+        SharedWorldPacketPtr& operator=(SharedWorldPacketPtr const&);
+};
+
+#endif
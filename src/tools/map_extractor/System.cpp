@@ -302,6 +302,23 @@ static char const* MAP_AREA_MAGIC    = "AREA";
 static char const* MAP_HEIGHT_MAGIC  = "MHGT";
 static char const* MAP_LIQUID_MAGIC  = "MLIQ";
 
+// Sections start on 16 byte boundaries, the worldserver can then use their
+// arrays in place through a memory mapping. Older readers follow the offsets
+// and are not affected by the padding.
+#define MAP_SECTION_ALIGN 16
+
+static uint32 AlignSection(uint32 offset)
+{
+    return (offset + MAP_SECTION_ALIGN - 1) & ~uint32(MAP_SECTION_ALIGN - 1);
+}
+
+static void PadSection(FILE* output)
+{
+    static char const padding[MAP_SECTION_ALIGN] = { 0 };
+    long pos = ftell(output);
+    fwrite(padding, 1, AlignSection(pos) - pos, output);
+}
+
 struct map_fileheader
 {
     uint32 mapMagic;
@@ -447,7 +464,7 @@ bool ConvertADT(char* filename, char* filename2, int /*cell_y*/, int /*cell_x*/,
         }
     }
 
-    map.areaMapOffset = sizeof(map);
+    map.areaMapOffset = AlignSection(sizeof(map));
     map.areaMapSize   = sizeof(map_areaHeader);
 
     map_areaHeader areaHeader;
@@ -576,7 +593,7 @@ bool ConvertADT(char* filename, char* filename2, int /*cell_y*/, int /*cell_x*/,
             maxHeight = CONF_use_minHeight;
     }
 
-    map.heightMapOffset = map.areaMapOffset + map.areaMapSize;
+    map.heightMapOffset = AlignSection(map.areaMapOffset + map.areaMapSize);
     map.heightMapSize = sizeof(map_heightHeader);
 
     map_heightHeader heightHeader;
@@ -820,7 +837,7 @@ bool ConvertADT(char* filename, char* filename2, int /*cell_y*/, int /*cell_x*/,
                     liquid_height[y][x] = CONF_use_minHeight;
             }
         }
-        map.liquidMapOffset = map.heightMapOffset + map.heightMapSize;
+        map.liquidMapOffset = AlignSection(map.heightMapOffset + map.heightMapSize);
         map.liquidMapSize = sizeof(map_liquidHeader);
         liquidHeader.fourcc = *reinterpret_cast<uint32 const*>(MAP_LIQUID_MAGIC);
         liquidHeader.flags = 0;
@@ -854,9 +871,9 @@ bool ConvertADT(char* filename, char* filename2, int /*cell_y*/, int /*cell_x*/,
     uint16 holes[ADT_CELLS_PER_GRID][ADT_CELLS_PER_GRID];
 
     if (map.liquidMapOffset)
-        map.holesOffset = map.liquidMapOffset + map.liquidMapSize;
+        map.holesOffset = AlignSection(map.liquidMapOffset + map.liquidMapSize);
     else
-        map.holesOffset = map.heightMapOffset + map.heightMapSize;
+        map.holesOffset = AlignSection(map.heightMapOffset + map.heightMapSize);
 
     memset(holes, 0, sizeof(holes));
     bool hasHoles = false;
@@ -889,10 +906,12 @@ bool ConvertADT(char* filename, char* filename2, int /*cell_y*/, int /*cell_x*/,
     }
 
     fwrite(&map, sizeof(map), 1, output);
+    PadSection(output);
     // Store area data
     fwrite(&areaHeader, sizeof(areaHeader), 1, output);
     if (!(areaHeader.flags & MAP_AREA_NO_AREA))
         fwrite(area_flags, sizeof(area_flags), 1, output);
+    PadSection(output);
 
     // Store height data
     fwrite(&heightHeader, sizeof(heightHeader), 1, output);
@@ -914,6 +933,7 @@ bool ConvertADT(char* filename, char* filename2, int /*cell_y*/, int /*cell_x*/,
             fwrite(V8, sizeof(V8), 1, output);
         }
     }
+    PadSection(output);
 
     // Store liquid data if need
     if (map.liquidMapOffset)
@@ -930,6 +950,7 @@ bool ConvertADT(char* filename, char* filename2, int /*cell_y*/, int /*cell_x*/,
             for (int y = 0; y < liquidHeader.height; y++)
                 fwrite(&liquid_height[y + liquidHeader.offsetY][liquidHeader.offsetX], sizeof(float), liquidHeader.width, output);
         }
+        PadSection(output);
     }
 
     // store hole data